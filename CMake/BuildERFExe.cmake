@@ -40,6 +40,17 @@ function(build_erf_lib erf_lib_name)
     target_compile_definitions(${erf_lib_name} PUBLIC ERF_USE_PARTICLES)
   endif()
 
+  if(ERF_ENABLE_REDUCED_ADV_TABLE)
+    target_compile_definitions(${erf_lib_name} PUBLIC ERF_USE_REDUCED_ADV_TABLE)
+  endif()
+
+  if(ERF_ENABLE_FAST_EOS)
+    target_compile_definitions(${erf_lib_name} PUBLIC ERF_USE_FAST_EOS)
+    if(ERF_FAST_EOS_TIER STREQUAL "LOW")
+      target_compile_definitions(${erf_lib_name} PUBLIC ERF_FAST_EOS_LOW)
+    endif()
+  endif()
+
   if(ERF_ENABLE_NETCDF)
     target_sources(${erf_lib_name} PRIVATE
                    ${SRC_DIR}/IO/NCBuildFABs.cpp
@@ -49,6 +60,7 @@ function(build_erf_lib erf_lib_name)
                    ${SRC_DIR}/IO/NCMultiFabFile.cpp
                    ${SRC_DIR}/IO/ReadFromMetgrid.cpp
                    ${SRC_DIR}/IO/ReadFromWRFBdy.cpp
+                   ${SRC_DIR}/IO/ERF_WRFBdyProvider.cpp
                    ${SRC_DIR}/IO/ReadFromWRFInput.cpp
                    ${SRC_DIR}/IO/NCColumnFile.cpp)
     target_compile_definitions(${erf_lib_name} PUBLIC ERF_USE_NETCDF)
@@ -61,6 +73,8 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/Microphysics/IceFall.cpp
        ${SRC_DIR}/Microphysics/Precip.cpp
        ${SRC_DIR}/Microphysics/PrecipFall.cpp
+       ${SRC_DIR}/Microphysics/Column.cpp
+       ${SRC_DIR}/Microphysics/SatVapTable.cpp
        ${SRC_DIR}/Microphysics/Diagnose.cpp
        ${SRC_DIR}/Microphysics/Update.cpp)
     target_compile_definitions(${erf_lib_name} PUBLIC ERF_USE_MOISTURE)
@@ -76,6 +90,7 @@ function(build_erf_lib erf_lib_name)
                    ${SRC_DIR}/Radiation/Aero_rad_props.cpp
                    ${SRC_DIR}/Radiation/Optics.cpp
                    ${SRC_DIR}/Radiation/Radiation.cpp
+                   ${SRC_DIR}/TimeIntegration/ERF_advance_radiation.cpp
                    ${CMAKE_SOURCE_DIR}/Submodules/RRTMGP/cpp/examples/mo_load_coefficients.cpp
                    ${CMAKE_SOURCE_DIR}/Submodules/RRTMGP/cpp/extensions/fluxes_byband/mo_fluxes_byband_kernels.cpp
                   )
@@ -97,8 +112,10 @@ function(build_erf_lib erf_lib_name)
   target_sources(${erf_lib_name}
      PRIVATE
        ${SRC_DIR}/Derive.cpp
+       ${SRC_DIR}/EOS.cpp
        ${SRC_DIR}/ERF.cpp
        ${SRC_DIR}/ERF_make_new_level.cpp
+       ${SRC_DIR}/ERF_LoadBalance.cpp
        ${SRC_DIR}/ERF_Tagging.cpp
        ${SRC_DIR}/Advection/AdvectionSrcForMom.cpp
        ${SRC_DIR}/Advection/AdvectionSrcForState.cpp
@@ -121,6 +138,7 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/Diffusion/ComputeStress_T.cpp
        ${SRC_DIR}/Diffusion/ComputeStrain_N.cpp
        ${SRC_DIR}/Diffusion/ComputeStrain_T.cpp
+       ${SRC_DIR}/Diffusion/ComputeTileStress_N.cpp
        ${SRC_DIR}/Diffusion/ComputeTurbulentViscosity.cpp
        ${SRC_DIR}/Diffusion/NumericalDiffusion.cpp
        ${SRC_DIR}/Diffusion/PBLModels.cpp
@@ -145,6 +163,7 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/TimeIntegration/ERF_make_condensation_source.cpp
        ${SRC_DIR}/TimeIntegration/ERF_make_fast_coeffs.cpp
        ${SRC_DIR}/TimeIntegration/ERF_slow_rhs_pre.cpp
+       ${SRC_DIR}/TimeIntegration/ERF_slow_rhs_fused.cpp
        ${SRC_DIR}/TimeIntegration/ERF_ApplySpongeZoneBCs.cpp
        ${SRC_DIR}/TimeIntegration/ERF_slow_rhs_post.cpp
        ${SRC_DIR}/TimeIntegration/ERF_fast_rhs_N.cpp
@@ -154,6 +173,7 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/Utils/TerrainMetrics.cpp
        ${SRC_DIR}/Utils/VelocityToMomentum.cpp
        ${SRC_DIR}/Utils/InteriorGhostCells.cpp 
+       ${SRC_DIR}/Utils/FillBoundaryMulti.cpp
   )
 
   if(NOT "${erf_exe_name}" STREQUAL "erf_unit_tests")
@@ -0,0 +1,138 @@
+#include <AMReX.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Random.H>
+
+#include <AdvectionSrcForState_N.H>
+
+using namespace amrex;
+
+/**
+ * Standalone timing of the scalar advection kernels on a fixed box
+ *
+ * The same WENO tendency is computed with the pointwise interpolation structs
+ * (AdvectionSrcForScalarsWrapper_N) and with the pencil kernel
+ * (AdvectionSrcForScalarsWENO_N), with and without the scratch arena, and the
+ * time per call and per cell of each is printed with the difference of the results.
+ */
+
+namespace {
+
+template<typename F>
+Real
+time_kernel (int ntimes, F&& f)
+{
+    f(); // warm up
+    Real t0 = amrex::second();
+    for (int it = 0; it < ntimes; ++it) {
+        f();
+    }
+    return (amrex::second() - t0) / ntimes;
+}
+
+template<typename InterpType>
+void
+run (const std::string& name, const Box& bx, int ncomp, int ntimes)
+{
+    const int icomp = 2;
+    const int ngrow = 3;
+
+    FArrayBox prim_fab(amrex::grow(bx,ngrow), icomp + ncomp);
+    FArrayBox xmom_fab(amrex::surroundingNodes(bx,0), 1);
+    FArrayBox ymom_fab(amrex::surroundingNodes(bx,1), 1);
+    FArrayBox zmom_fab(amrex::surroundingNodes(bx,2), 1);
+    FArrayBox detJ_fab(amrex::grow(bx,1), 1);
+    FArrayBox mf_fab(amrex::grow(bx,1), 1);
+    FArrayBox src_ref(bx, icomp + ncomp);
+    FArrayBox src_new(bx, icomp + ncomp);
+
+    // Smooth fields with some noise so that the WENO weights are not all equal
+    const auto prim = prim_fab.array();
+    amrex::LoopOnCpu(prim_fab.box(), prim_fab.nComp(), [&] (int i, int j, int k, int n)
+    {
+        prim(i,j,k,n) = std::sin(0.1*i + 0.2*j + 0.3*k + n) + 0.1*amrex::Random();
+    });
+    const auto xmom = xmom_fab.array();
+    const auto ymom = ymom_fab.array();
+    const auto zmom = zmom_fab.array();
+    amrex::LoopOnCpu(xmom_fab.box(), [&] (int i, int j, int k) { xmom(i,j,k) = std::cos(0.1*j + 0.2*k + i); });
+    amrex::LoopOnCpu(ymom_fab.box(), [&] (int i, int j, int k) { ymom(i,j,k) = std::cos(0.1*k + 0.2*i + j); });
+    amrex::LoopOnCpu(zmom_fab.box(), [&] (int i, int j, int k) { zmom(i,j,k) = std::cos(0.1*i + 0.2*j + k); });
+    detJ_fab.setVal<RunOn::Host>(1.0);
+    mf_fab.setVal<RunOn::Host>(1.0);
+    src_ref.setVal<RunOn::Host>(0.0);
+    src_new.setVal<RunOn::Host>(0.0);
+
+    const GpuArray<Real,AMREX_SPACEDIM> cellSizeInv = {1.0, 1.0, 1.0};
+    const auto cprim = prim_fab.const_array();
+    const auto cxmom = xmom_fab.const_array();
+    const auto cymom = ymom_fab.const_array();
+    const auto czmom = zmom_fab.const_array();
+    const auto cdetJ = detJ_fab.const_array();
+    const auto cmf   = mf_fab.const_array();
+    const auto aref  = src_ref.array();
+    const auto anew  = src_new.array();
+
+    Real t_point = time_kernel(ntimes, [&] () {
+        AdvectionSrcForScalarsWrapper_N<InterpType,InterpType,false,false>(
+            bx, ncomp, icomp, aref, cprim, cxmom, cymom, czmom, cdetJ, cellSizeInv, cmf);
+    });
+
+    Real t_pencil = time_kernel(ntimes, [&] () {
+        AdvectionSrcForScalarsWENO_N<InterpType,false,false>(
+            bx, ncomp, icomp, anew, cprim, cxmom, cymom, czmom, cdetJ, cellSizeInv, cmf);
+    });
+
+    ERFScratchArena scratch;
+    Real t_arena = time_kernel(ntimes, [&] () {
+        AdvectionSrcForScalarsWENO_N<InterpType,false,false>(
+            bx, ncomp, icomp, anew, cprim, cxmom, cymom, czmom, cdetJ, cellSizeInv, cmf, &scratch);
+    });
+
+    Real maxdiff = 0.0;
+    amrex::LoopOnCpu(bx, ncomp, [&] (int i, int j, int k, int n)
+    {
+        maxdiff = amrex::max(maxdiff, std::abs(aref(i,j,k,icomp+n) - anew(i,j,k,icomp+n)));
+    });
+
+    const Real ncell = static_cast<Real>(bx.numPts());
+    amrex::Print() << name << ":\n"
+                   << "  pointwise structs       " << t_point  << " s/call, "
+                   << 1.e9*t_point /ncell << " ns/cell\n"
+                   << "  pencil kernel           " << t_pencil << " s/call, "
+                   << 1.e9*t_pencil/ncell << " ns/cell\n"
+                   << "  pencil kernel + arena   " << t_arena  << " s/call, "
+                   << 1.e9*t_arena /ncell << " ns/cell\n"
+                   << "  speedup " << t_point/t_arena
+                   << ", max difference " << maxdiff << "\n";
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int ncomp  = 4;
+        int ntimes = 20;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("ncomp" , ncomp);
+            pp.query("ntimes", ntimes);
+        }
+
+        const Box bx(IntVect(0), IntVect(n_cell-1));
+        amrex::Print() << "Box " << bx << ", " << ncomp << " scalars, "
+                       << ntimes << " calls per kernel\n";
+
+        run<WENO3    >("WENO3"    , bx, ncomp, ntimes);
+        run<WENO_Z3  >("WENO_Z3"  , bx, ncomp, ntimes);
+        run<WENO_MZQ3>("WENO_MZQ3", bx, ncomp, ntimes);
+        run<WENO5    >("WENO5"    , bx, ncomp, ntimes);
+        run<WENO_Z5  >("WENO_Z5"  , bx, ncomp, ntimes);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,250 @@
+#include <limits>
+
+#include <AMReX.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <DataStruct.H>
+#include <IndexDefines.H>
+#include <TI_headers.H>
+#include <Advection.H>
+#include <Diffusion.H>
+
+using namespace amrex;
+
+/**
+ * Standalone timing of the cell-centered slow RHS of (rho) and (rho theta)
+ *
+ * The fused kernel (erf_fused_slow_rhs_cc_N) and the unfused sequence of kernels of
+ * erf_slow_rhs_pre are timed on a fixed box with the solver choices read from the
+ * inputs file (the erf.* parameters of a run).  The bandwidth of the STREAM triad is
+ * measured with the same threading, and the time per cell of each path is converted
+ * into the bytes per cell it would move at that bandwidth.  This is the traffic of the
+ * path if it is bound by memory bandwidth, and an upper bound on it otherwise.
+ */
+
+namespace {
+
+template<typename F>
+Real
+time_kernel (int ntimes, F&& f)
+{
+    f(); // warm up
+    Gpu::streamSynchronize();
+    Real t0 = amrex::second();
+    for (int it = 0; it < ntimes; ++it) {
+        f();
+    }
+    Gpu::streamSynchronize();
+    return (amrex::second() - t0) / ntimes;
+}
+
+/**
+ * Bandwidth [bytes/s] of the STREAM triad a = b + s*c on arrays of n elements, counted
+ * as STREAM does (two reads and one write per element), best of ntimes calls
+ */
+Real
+stream_triad_bandwidth (Long n, int ntimes)
+{
+    Gpu::DeviceVector<Real> a(n, 0.0);
+    Gpu::DeviceVector<Real> b(n, 1.0);
+    Gpu::DeviceVector<Real> c(n, 2.0);
+    Real*       pa = a.data();
+    const Real* pb = b.data();
+    const Real* pc = c.data();
+    const Real scalar = 3.0;
+
+    auto triad = [=] ()
+    {
+        amrex::ParallelFor(n, [=] AMREX_GPU_DEVICE (Long i) noexcept
+        {
+            pa[i] = pb[i] + scalar * pc[i];
+        });
+    };
+
+    Real t_best = std::numeric_limits<Real>::max();
+    for (int it = 0; it < ntimes; ++it) {
+        t_best = amrex::min(t_best, time_kernel(1, triad));
+    }
+    return 3.0 * sizeof(Real) * static_cast<Real>(n) / t_best;
+}
+
+void
+time_slow_rhs_cc (const SolverChoice& solverChoice,
+                  const BCRec* bc_ptr_h, const BCRec* bc_ptr_d,
+                  int n_cell, int ntimes, Long stream_n)
+{
+    const Box bx(IntVect(0), IntVect(n_cell-1));
+    const Box& domain = bx;
+    const GpuArray<Real, AMREX_SPACEDIM> cellSizeInv = {1.0, 1.0, 1.0};
+
+    const bool l_turb     = (solverChoice.les_type == LESType::Smagorinsky);
+    const bool l_use_diff = ( (solverChoice.molec_diff_type != MolecDiffType::None) || l_turb );
+    const bool l_rayleigh = (solverChoice.use_rayleigh_damping && solverChoice.rayleigh_damp_T);
+
+    // Smooth fields on the box and its ghost cells
+    FArrayBox cons_fab(amrex::grow(bx,2), NVAR);
+    FArrayBox prim_fab(amrex::grow(bx,2), NVAR-1);
+    FArrayBox xmom_fab(amrex::grow(amrex::surroundingNodes(bx,0),1), 1);
+    FArrayBox ymom_fab(amrex::grow(amrex::surroundingNodes(bx,1),1), 1);
+    FArrayBox zmom_fab(amrex::grow(amrex::surroundingNodes(bx,2),1), 1);
+    FArrayBox mu_fab  (amrex::grow(bx,1), EddyDiff::NumDiffs);
+    FArrayBox src_fab (bx, NVAR);
+    FArrayBox rhs_fab (bx, NVAR);
+    FArrayBox avgx_fab(amrex::surroundingNodes(bx,0), 1);
+    FArrayBox avgy_fab(amrex::surroundingNodes(bx,1), 1);
+    FArrayBox avgz_fab(amrex::surroundingNodes(bx,2), 1);
+    FArrayBox dfx_fab (amrex::surroundingNodes(bx,0), NVAR);
+    FArrayBox dfy_fab (amrex::surroundingNodes(bx,1), NVAR);
+    FArrayBox dfz_fab (amrex::surroundingNodes(bx,2), NVAR);
+    FArrayBox mf_fab  (amrex::grow(amrex::makeSlab(bx,2,0),3), 1);
+    FArrayBox mfu_fab (amrex::grow(amrex::makeSlab(amrex::surroundingNodes(bx,0),2,0),3), 1);
+    FArrayBox mfv_fab (amrex::grow(amrex::makeSlab(amrex::surroundingNodes(bx,1),2,0),3), 1);
+
+    const Array4<Real> cons = cons_fab.array();
+    const Array4<Real> prim = prim_fab.array();
+    amrex::ParallelFor(cons_fab.box(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        Real rho   = 1.0 + 0.1 * std::sin(0.1*i + 0.2*j + 0.3*k);
+        Real theta = 300.0 + std::cos(0.3*i + 0.2*j + 0.1*k);
+        for (int n = 0; n < NVAR; ++n) {
+            cons(i,j,k,n) = (n == Rho_comp) ? rho : rho * theta;
+        }
+        for (int n = 0; n < NVAR-1; ++n) {
+            prim(i,j,k,n) = theta;
+        }
+    });
+    const Array4<Real> xmom = xmom_fab.array();
+    const Array4<Real> ymom = ymom_fab.array();
+    const Array4<Real> zmom = zmom_fab.array();
+    amrex::ParallelFor(xmom_fab.box(), ymom_fab.box(), zmom_fab.box(),
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept { xmom(i,j,k) = 10.0 * std::cos(0.1*j + 0.2*k); },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept { ymom(i,j,k) =  5.0 * std::cos(0.1*k + 0.2*i); },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept { zmom(i,j,k) =  0.5 * std::cos(0.1*i + 0.2*j); });
+    mu_fab.setVal<RunOn::Device>(1.0);
+    src_fab.setVal<RunOn::Device>(1.e-3);
+    mf_fab.setVal<RunOn::Device>(1.0);
+    mfu_fab.setVal<RunOn::Device>(1.0);
+    mfv_fab.setVal<RunOn::Device>(1.0);
+
+    Gpu::DeviceVector<Real> rayleigh_tau(n_cell, 1.e-3);
+    Gpu::DeviceVector<Real> rayleigh_thetabar(n_cell, 300.0);
+    const Real* dptr_tau      = l_rayleigh ? rayleigh_tau.data()      : nullptr;
+    const Real* dptr_thetabar = l_rayleigh ? rayleigh_thetabar.data() : nullptr;
+
+    const Array4<Real> cell_rhs = rhs_fab.array();
+    const Array4<const Real> cell_data = cons_fab.const_array();
+    const Array4<const Real> cell_prim = prim_fab.const_array();
+    const Array4<const Real> rho_u = xmom_fab.const_array();
+    const Array4<const Real> rho_v = ymom_fab.const_array();
+    const Array4<const Real> omega = zmom_fab.const_array();
+    const Array4<Real> avg_xmom = avgx_fab.array();
+    const Array4<Real> avg_ymom = avgy_fab.array();
+    const Array4<Real> avg_zmom = avgz_fab.array();
+    const Array4<const Real> mf_m = mf_fab.const_array();
+    const Array4<const Real> mf_u = mfu_fab.const_array();
+    const Array4<const Real> mf_v = mfv_fab.const_array();
+    const Array4<const Real> mu_turb = mu_fab.const_array();
+    const Array4<const Real> src_arr = src_fab.const_array();
+
+    auto fused = [&] ()
+    {
+        erf_fused_slow_rhs_cc_N(bx, bx, domain, cell_rhs, cell_data, cell_prim,
+                                rho_u, rho_v, omega, avg_xmom, avg_ymom, avg_zmom,
+                                mf_m, mf_u, mf_v, mu_turb, src_arr, cellSizeInv,
+                                solverChoice, bc_ptr_h, dptr_tau, dptr_thetabar);
+    };
+
+    // The same sequence of kernels as the unfused branch of erf_slow_rhs_pre
+    auto unfused = [&] ()
+    {
+        AdvectionSrcForRhoAndTheta(bx, bx, cell_rhs, rho_u, rho_v, omega, 1.0,
+                                   avg_xmom, avg_ymom, avg_zmom, cell_prim,
+                                   Array4<const Real>{}, Array4<const Real>{},
+                                   cellSizeInv, mf_m, mf_u, mf_v,
+                                   solverChoice.dycore_horiz_adv_type,
+                                   solverChoice.dycore_vert_adv_type, 0, false);
+        if (l_use_diff) {
+            Array4<Real> hfx_z, diss;
+            const GpuArray<Real,AMREX_SPACEDIM> grav_gpu = {0.0, 0.0, -CONST_GRAV};
+            DiffusionSrcForState_N(bx, domain, RhoTheta_comp, 1,
+                                   rho_u, rho_v, cell_data, cell_prim, cell_rhs,
+                                   dfx_fab.array(), dfy_fab.array(), dfz_fab.array(),
+                                   cellSizeInv, Array4<const Real>{}, mf_m, mf_u, mf_v,
+                                   hfx_z, diss, mu_turb, solverChoice,
+                                   Array4<const Real>{}, grav_gpu, bc_ptr_d);
+        }
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            cell_rhs(i,j,k,RhoTheta_comp) += src_arr(i,j,k,RhoTheta_comp);
+        });
+        if (l_rayleigh) {
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                Real theta = cell_prim(i,j,k,PrimTheta_comp);
+                cell_rhs(i,j,k,RhoTheta_comp) -= dptr_tau[k] * (theta - dptr_thetabar[k])
+                                                             * cell_data(i,j,k,Rho_comp);
+            });
+        }
+    };
+
+    const Real t_fused   = time_kernel(ntimes, fused);
+    const Real t_unfused = time_kernel(ntimes, unfused);
+    const Real bandwidth = stream_triad_bandwidth(stream_n, ntimes);
+
+    const Real ncell = static_cast<Real>(bx.numPts());
+    amrex::Print() << "Cell-centered slow RHS on a " << n_cell << "^3 box, " << ntimes << " calls per path:\n"
+                   << "  fused    " << 1.e9 * t_fused   / ncell << " ns/cell\n"
+                   << "  unfused  " << 1.e9 * t_unfused / ncell << " ns/cell\n"
+                   << "STREAM triad bandwidth on " << stream_n << " elements: "
+                   << 1.e-9 * bandwidth << " GB/s\n"
+                   << "Bytes per cell at that bandwidth (the traffic if memory bound, an upper bound otherwise):\n"
+                   << "  fused    " << bandwidth * t_fused   / ncell << "\n"
+                   << "  unfused  " << bandwidth * t_unfused / ncell << std::endl;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int ntimes = 10;
+        Long stream_n = Long(1) << 25;
+        int ext_dir_z = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell"   , n_cell);
+            pp.query("ntimes"   , ntimes);
+            pp.query("stream_n" , stream_n);
+            pp.query("ext_dir_z", ext_dir_z);
+        }
+
+        // The erf.* solver choices, as in a run
+        SolverChoice solverChoice;
+        solverChoice.init_params();
+
+        if (!use_fused_slow_rhs_cc(solverChoice)) {
+            amrex::Abort("SlowRhsTiming: the fused slow RHS does not support these solver choices");
+        }
+
+        // Boundary conditions of all the variables: first order extrapolation, or
+        //    Dirichlet at the bottom and top with ext_dir_z = 1
+        Vector<BCRec> bcs(BCVars::NumTypes);
+        for (auto& bc : bcs) {
+            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                const int bctype = (dir == 2 && ext_dir_z) ? ERFBCType::ext_dir : ERFBCType::foextrap;
+                bc.setLo(dir, bctype);
+                bc.setHi(dir, bctype);
+            }
+        }
+        Gpu::DeviceVector<BCRec> bcs_d(bcs.size());
+        Gpu::copy(Gpu::hostToDevice, bcs.begin(), bcs.end(), bcs_d.begin());
+
+        time_slow_rhs_cc(solverChoice, bcs.data(), bcs_d.data(), n_cell, ntimes, stream_n);
+    }
+    amrex::Finalize();
+}
@@ -5,9 +5,8 @@ using namespace amrex;
 
 /**
  * Function for computing the advective tendency for the momentum equations
- * This routine has explicit expressions for all cases (terrain or not) when
- * the horizontal and vertial spatial orders are <= 2, and calls more specialized
- * functions when either (or both) spatial order(s) is greater than 2.
+ * This routine calls the kernel specialized for the spatial discretizations, terrain
+ * and map factors (see AdvectionDispatch.H).
  *
  * @param[in] bxx box over which the x-momentum is updated
  * @param[in] bxy box over which the y-momentum is updated
@@ -30,6 +29,7 @@ using namespace amrex;
  * @param[in] horiz_adv_type sets the spatial order to be used for lateral derivatives
  * @param[in] vert_adv_type  sets the spatial order to be used for vertical derivatives
  * @param[in] use_terrain if true, use the terrain-aware derivatives (with metric terms)
+ * @param[in] use_mf if false, the map factors are all 1 and are not read
  * @param[in] domhi_z maximum k value in the domain
  */
 void
@@ -52,256 +52,48 @@ AdvectionSrcForMom (const Box& bxx, const Box& bxy, const Box& bxz,
                     const AdvType horiz_adv_type,
                     const AdvType vert_adv_type,
                     const int use_terrain,
+                    const bool use_mf,
                     const int domhi_z)
 {
     BL_PROFILE_VAR("AdvectionSrcForMom", AdvectionSrcForMom);
 
-    auto dxInv = cellSizeInv[0], dyInv = cellSizeInv[1], dzInv = cellSizeInv[2];
-
     AMREX_ALWAYS_ASSERT(bxz.smallEnd(2) > 0);
 
+    // Each combination of schemes, terrain and map factors has its own kernel
     if (!use_terrain) {
-        // Inline with 2nd order for efficiency
-        if (horiz_adv_type == AdvType::Centered_2nd && vert_adv_type == AdvType::Centered_2nd)
+        DispatchAdvTypes(horiz_adv_type, vert_adv_type, use_mf, [&] (auto htag, auto vtag, auto mftag)
         {
-            ParallelFor(bxx, bxy, bxz,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                Real mf_u_inv_hi = 1. / mf_u(i+1,j  ,0); Real mf_u_inv_mid = 1. / mf_u(i  ,j  ,0);
-                Real mf_u_inv_lo = 1. / mf_u(i-1,j  ,0);
-                Real mf_v_inv_1  = 1. / mf_v(i  ,j+1,0); Real mf_v_inv_2   = 1. / mf_v(i-1,j+1,0);
-                Real mf_v_inv_3  = 1. / mf_v(i  ,j  ,0); Real mf_v_inv_4   = 1. / mf_v(i-1,j  ,0);
-
-                Real xflux_hi = 0.25 * (rho_u(i, j  , k) * mf_u_inv_mid + rho_u(i+1, j  , k) * mf_u_inv_hi) * (u(i+1,j,k) + u(i,j,k));
-                Real xflux_lo = 0.25 * (rho_u(i, j  , k) * mf_u_inv_mid + rho_u(i-1, j  , k) * mf_u_inv_lo) * (u(i-1,j,k) + u(i,j,k));
-
-                Real yflux_hi = 0.25 * (rho_v(i, j+1, k) * mf_v_inv_1 + rho_v(i-1, j+1, k) * mf_v_inv_2) * (u(i,j+1,k) + u(i,j,k));
-                Real yflux_lo = 0.25 * (rho_v(i, j  , k) * mf_v_inv_3 + rho_v(i-1, j  , k) * mf_v_inv_4) * (u(i,j-1,k) + u(i,j,k));
-
-                Real zflux_hi = 0.25 * (Omega(i, j, k+1) + Omega(i-1, j, k+1)) * (u(i,j,k+1) + u(i,j,k));
-                Real zflux_lo = 0.25 * (Omega(i, j, k  ) + Omega(i-1, j, k  )) * (u(i,j,k-1) + u(i,j,k));
-
-                Real mfsq = mf_u(i,j,0) * mf_u(i,j,0);
-
-                Real advectionSrc = (xflux_hi - xflux_lo) * dxInv * mfsq
-                                  + (yflux_hi - yflux_lo) * dyInv * mfsq
-                                  + (zflux_hi - zflux_lo) * dzInv;
-                rho_u_rhs(i, j, k) = -advectionSrc;
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                Real mf_v_inv_hi = 1. / mf_v(i  ,j+1,0); Real mf_v_inv_mid = 1. / mf_v(i  ,j  ,0);
-                Real mf_v_inv_lo = 1. / mf_v(i  ,j-1,0);
-                Real mf_u_inv_1  = 1. / mf_u(i+1,j  ,0); Real mf_u_inv_2   = 1. / mf_u(i+1,j-1,0);
-                Real mf_u_inv_3  = 1. / mf_u(i  ,j  ,0); Real mf_u_inv_4   = 1. / mf_u(i  ,j-1,0);
-
-                Real xflux_hi = 0.25 * (rho_u(i+1, j, k) * mf_u_inv_1 + rho_u(i+1, j-1, k) * mf_u_inv_2) * (v(i+1,j,k) + v(i,j,k));
-                Real xflux_lo = 0.25 * (rho_u(i  , j, k) * mf_u_inv_3 + rho_u(i  , j-1, k) * mf_u_inv_4) * (v(i-1,j,k) + v(i,j,k));
-
-                Real yflux_hi = 0.25 * (rho_v(i  ,j+1,k) * mf_v_inv_hi  + rho_v(i  ,j  ,k) * mf_v_inv_mid) * (v(i,j+1,k) + v(i,j,k));
-                Real yflux_lo = 0.25 * (rho_v(i  ,j  ,k) * mf_v_inv_mid + rho_v(i  ,j-1,k) * mf_v_inv_lo ) * (v(i,j-1,k) + v(i,j,k));
-
-                Real zflux_hi = 0.25 * (Omega(i, j, k+1) + Omega(i, j-1, k+1)) * (v(i,j,k+1) + v(i,j,k));
-                Real zflux_lo = 0.25 * (Omega(i, j, k  ) + Omega(i, j-1, k  )) * (v(i,j,k-1) + v(i,j,k));
-
-                Real mfsq = mf_v(i,j,0) * mf_v(i,j,0);
-
-                Real advectionSrc = (xflux_hi - xflux_lo) * dxInv * mfsq
-                                  + (yflux_hi - yflux_lo) * dyInv * mfsq
-                                  + (zflux_hi - zflux_lo) * dzInv;
-                rho_v_rhs(i, j, k) = -advectionSrc;
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                Real mf_u_inv_hi = 1. / mf_u(i+1,j  ,0); Real mf_u_inv_lo = 1. / mf_u(i  ,j  ,0);
-                Real mf_v_inv_hi = 1. / mf_v(i  ,j+1,0); Real mf_v_inv_lo = 1. / mf_v(i  ,j  ,0);
-
-                Real xflux_hi = 0.25*(rho_u(i+1,j  ,k) + rho_u(i+1, j, k-1)) * mf_u_inv_hi * (w(i+1,j,k) + w(i,j,k));
-                Real xflux_lo = 0.25*(rho_u(i  ,j  ,k) + rho_u(i  , j, k-1)) * mf_u_inv_lo * (w(i-1,j,k) + w(i,j,k));
-
-                Real yflux_hi = 0.25*(rho_v(i  ,j+1,k) + rho_v(i, j+1, k-1)) * mf_v_inv_hi * (w(i,j+1,k) + w(i,j,k));
-                Real yflux_lo = 0.25*(rho_v(i  ,j  ,k) + rho_v(i, j  , k-1)) * mf_v_inv_lo * (w(i,j-1,k) + w(i,j,k));
-
-                Real zflux_lo = 0.25 * (Omega(i,j,k) + Omega(i,j,k-1)) * (w(i,j,k) + w(i,j,k-1));
-
-                Real zflux_hi = (k == domhi_z+1) ? Omega(i,j,k) * w(i,j,k) :
-                    0.25 * (Omega(i,j,k) + Omega(i,j,k+1)) * (w(i,j,k) + w(i,j,k+1));
-
-                Real mfsq = mf_m(i,j,0) * mf_m(i,j,0);
-
-                Real advectionSrc = (xflux_hi - xflux_lo) * dxInv * mfsq
-                                  + (yflux_hi - yflux_lo) * dyInv * mfsq
-                                  + (zflux_hi - zflux_lo) * dzInv;
-                rho_w_rhs(i, j, k) = -advectionSrc;
-            });
-        // Template higher order methods
-        } else {
-            if (horiz_adv_type == AdvType::Centered_2nd) {
-                AdvectionSrcForMomVert_N<CENTERED2>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else if (horiz_adv_type == AdvType::Upwind_3rd) {
-                AdvectionSrcForMomVert_N<UPWIND3>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else if (horiz_adv_type == AdvType::Centered_4th) {
-                AdvectionSrcForMomVert_N<CENTERED4>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else if (horiz_adv_type == AdvType::Upwind_5th) {
-                AdvectionSrcForMomVert_N<UPWIND5>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else if (horiz_adv_type == AdvType::Centered_6th) {
-                AdvectionSrcForMomVert_N<CENTERED6>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else {
-                AMREX_ASSERT_WITH_MESSAGE(false, "Unknown advection scheme!");
-            }
-        }
-    } // end of use_terrain == false
-    else
-    { // now do use_terrain == true
-        // Inline with 2nd order for efficiency
-        if (horiz_adv_type == AdvType::Centered_2nd && vert_adv_type == AdvType::Centered_2nd)
+            AdvectionSrcForMomWrapper_N<typename decltype(htag)::type,
+                                        typename decltype(vtag)::type, UPWINDALL,
+                                        decltype(vtag)::adv_type,
+                                        decltype(mftag)::value>(bxx, bxy, bxz,
+                                                                rho_u_rhs, rho_v_rhs, rho_w_rhs,
+                                                                rho_u, rho_v, Omega, u, v, w,
+                                                                cellSizeInv, mf_m, mf_u, mf_v,
+                                                                domhi_z);
+        });
+    } else if (horiz_adv_type == AdvType::Centered_2nd && vert_adv_type == AdvType::Centered_2nd) {
+        // The metric terms are applied in a different order than in the general kernel,
+        //     so this keeps its own kernel
+        DispatchBool(use_mf, [&] (auto mftag)
         {
-            ParallelFor(bxx, bxy, bxz,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                Real mf_u_inv_hi  = 1. / mf_u(i+1,j  ,0);
-                Real mf_u_inv_mid = 1. / mf_u(i  ,j  ,0);
-                Real mf_u_inv_lo  = 1. / mf_u(i-1,j  ,0);
-                Real mf_v_inv_1   = 1. / mf_v(i  ,j+1,0); Real mf_v_inv_2  = 1. / mf_v(i-1,j+1,0);
-                Real mf_v_inv_3   = 1. / mf_v(i  ,j  ,0); Real mf_v_inv_4  = 1. / mf_v(i-1,j  ,0);
-
-                Real met_h_zeta_xhi = Compute_h_zeta_AtCellCenter(i  ,j  ,k  ,cellSizeInv,z_nd);
-                Real xflux_hi = 0.25 * (rho_u(i, j  , k) * mf_u_inv_mid + rho_u(i+1, j  , k) * mf_u_inv_hi) * (u(i+1,j,k) + u(i,j,k)) * met_h_zeta_xhi;
-
-                Real met_h_zeta_xlo = Compute_h_zeta_AtCellCenter(i-1,j  ,k  ,cellSizeInv,z_nd);
-                Real xflux_lo = 0.25 * (rho_u(i, j  , k) * mf_u_inv_mid + rho_u(i-1, j  , k) * mf_u_inv_lo) * (u(i-1,j,k) + u(i,j,k)) * met_h_zeta_xlo;
-
-                Real met_h_zeta_yhi = Compute_h_zeta_AtEdgeCenterK(i  ,j+1,k  ,cellSizeInv,z_nd);
-                Real yflux_hi = 0.25 * (rho_v(i, j+1, k) * mf_v_inv_1 + rho_v(i-1, j+1, k) * mf_v_inv_2) * (u(i,j+1,k) + u(i,j,k)) * met_h_zeta_yhi;
-
-                Real met_h_zeta_ylo = Compute_h_zeta_AtEdgeCenterK(i  ,j  ,k  ,cellSizeInv,z_nd);
-                Real yflux_lo = 0.25 * (rho_v(i, j  , k) * mf_v_inv_3 + rho_v(i-1, j  , k) * mf_v_inv_4) * (u(i,j-1,k) + u(i,j,k)) * met_h_zeta_ylo;
-
-                Real zflux_hi = 0.25 * (Omega(i, j, k+1) + Omega(i-1, j, k+1)) * (u(i,j,k+1) + u(i,j,k));
-                Real zflux_lo = 0.25 * (Omega(i, j, k  ) + Omega(i-1, j, k  )) * (u(i,j,k-1) + u(i,j,k));
-
-                Real mfsq = mf_u(i,j,0) * mf_u(i,j,0);
-
-                Real advectionSrc = (xflux_hi - xflux_lo) * dxInv * mfsq
-                                  + (yflux_hi - yflux_lo) * dyInv * mfsq
-                                  + (zflux_hi - zflux_lo) * dzInv;
-
-                rho_u_rhs(i, j, k) = -advectionSrc / (0.5 * (detJ(i,j,k) + detJ(i-1,j,k)));
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                Real mf_v_inv_hi = 1. / mf_v(i  ,j+1,0); Real mf_v_inv_mid = 1. / mf_v(i  ,j  ,0); Real mf_v_inv_lo = 1. / mf_v(i  ,j-1,0);
-                Real mf_u_inv_1  = 1. / mf_u(i+1,j  ,0); Real mf_u_inv_2   = 1. / mf_u(i+1,j-1,0); Real mf_u_inv_3  = 1. / mf_u(i  ,j  ,0); Real mf_u_inv_4 = 1. / mf_u(i-1,j  ,0);
-
-                Real met_h_zeta_xhi = Compute_h_zeta_AtEdgeCenterK(i+1,j  ,k  ,cellSizeInv,z_nd);
-                Real xflux_hi = 0.25 * (rho_u(i+1,j  ,k) * mf_u_inv_1 + rho_u(i+1,j-1, k) * mf_u_inv_2) * (v(i+1,j,k) + v(i,j,k)) * met_h_zeta_xhi;
-
-                Real met_h_zeta_xlo = Compute_h_zeta_AtEdgeCenterK(i  ,j  ,k  ,cellSizeInv,z_nd);
-                Real xflux_lo = 0.25 * (rho_u(i, j  , k) * mf_u_inv_3 + rho_u(i  ,j-1, k) * mf_u_inv_4) * (v(i-1,j,k) + v(i,j,k)) * met_h_zeta_xlo;
-
-                Real met_h_zeta_yhi = Compute_h_zeta_AtCellCenter(i  ,j  ,k  ,cellSizeInv,z_nd);
-                Real yflux_hi = 0.25 * (rho_v(i  ,j+1, k) * mf_v_inv_hi + rho_v(i  ,j  ,k) * mf_v_inv_mid) * (v(i,j+1,k) + v(i,j,k)) * met_h_zeta_yhi;
-
-                Real met_h_zeta_ylo = Compute_h_zeta_AtCellCenter(i  ,j-1,k  ,cellSizeInv,z_nd);
-                Real yflux_lo = 0.25 * (rho_v(i  ,j  ,k) * mf_v_inv_mid + rho_v(i  , j-1, k) * mf_v_inv_lo) * (v(i,j-1,k) + v(i,j,k)) * met_h_zeta_ylo;
-
-                Real zflux_hi = 0.25 * (Omega(i, j, k+1) + Omega(i, j-1, k+1)) * (v(i,j,k+1) + v(i,j,k));
-                Real zflux_lo = 0.25 * (Omega(i, j, k  ) + Omega(i, j-1, k  )) * (v(i,j,k-1) + v(i,j,k));
-
-                Real mfsq = mf_v(i,j,0) * mf_v(i,j,0);
-
-                Real advectionSrc = (xflux_hi - xflux_lo) * dxInv * mfsq
-                                  + (yflux_hi - yflux_lo) * dyInv * mfsq
-                                  + (zflux_hi - zflux_lo) * dzInv;
-
-                rho_v_rhs(i, j, k) = -advectionSrc / (0.5 * (detJ(i,j,k) + detJ(i,j-1,k)));
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                Real mf_u_inv_hi = 1. / mf_u(i+1,j  ,0); Real mf_u_inv_lo = 1. / mf_u(i  ,j  ,0);
-                Real mf_v_inv_hi = 1. / mf_v(i  ,j+1,0); Real mf_v_inv_lo = 1. / mf_v(i  ,j  ,0);
-
-                Real met_h_zeta_xhi = Compute_h_zeta_AtEdgeCenterJ(i+1,j  ,k  ,cellSizeInv,z_nd);
-                Real xflux_hi = 0.25*(rho_u(i+1,j  ,k) + rho_u(i+1, j, k-1)) * mf_u_inv_hi * (w(i+1,j,k) + w(i,j,k)) * met_h_zeta_xhi;
-
-                Real met_h_zeta_xlo = Compute_h_zeta_AtEdgeCenterJ(i  ,j  ,k  ,cellSizeInv,z_nd);
-                Real xflux_lo = 0.25*(rho_u(i  ,j  ,k) + rho_u(i  , j, k-1)) * mf_u_inv_lo * (w(i-1,j,k) + w(i,j,k)) * met_h_zeta_xlo;
-
-                Real met_h_zeta_yhi = Compute_h_zeta_AtEdgeCenterI(i  ,j+1,k  ,cellSizeInv,z_nd);
-                Real yflux_hi = 0.25*(rho_v(i  ,j+1,k) + rho_v(i, j+1, k-1)) * mf_v_inv_hi * (w(i,j+1,k) + w(i,j,k)) * met_h_zeta_yhi;
-
-                Real met_h_zeta_ylo = Compute_h_zeta_AtEdgeCenterI(i  ,j  ,k  ,cellSizeInv,z_nd);
-                Real yflux_lo = 0.25*(rho_v(i  ,j  ,k) + rho_v(i, j  , k-1)) * mf_v_inv_lo * (w(i,j-1,k) + w(i,j,k)) * met_h_zeta_ylo;
-
-                Real zflux_lo = 0.25 * (Omega(i,j,k) + Omega(i,j,k-1)) * (w(i,j,k) + w(i,j,k-1));
-
-                Real zflux_hi = (k == domhi_z+1) ? Omega(i,j,k) * w(i,j,k) :
-                    0.25 * (Omega(i,j,k) + Omega(i,j,k+1)) * (w(i,j,k) + w(i,j,k+1));
-
-                Real mfsq = mf_m(i,j,0) * mf_m(i,j,0);
-
-                Real advectionSrc = (xflux_hi - xflux_lo) * dxInv * mfsq
-                                  + (yflux_hi - yflux_lo) * dyInv * mfsq
-                                  + (zflux_hi - zflux_lo) * dzInv;
-
-                rho_w_rhs(i, j, k) = -advectionSrc / (0.5*(detJ(i,j,k) + detJ(i,j,k-1)));
-            });
-        // Template higher order methods
-        } else {
-            if (horiz_adv_type == AdvType::Centered_2nd) {
-                AdvectionSrcForMomVert_T<CENTERED2>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w, z_nd, detJ,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else if (horiz_adv_type == AdvType::Upwind_3rd) {
-                AdvectionSrcForMomVert_T<UPWIND3>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w, z_nd, detJ,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else if (horiz_adv_type == AdvType::Centered_4th) {
-                AdvectionSrcForMomVert_T<CENTERED4>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w, z_nd, detJ,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else if (horiz_adv_type == AdvType::Upwind_5th) {
-                AdvectionSrcForMomVert_T<UPWIND5>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w, z_nd, detJ,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else if (horiz_adv_type == AdvType::Centered_6th) {
-                AdvectionSrcForMomVert_T<CENTERED6>(bxx, bxy, bxz,
-                                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
-                                                  rho_u, rho_v, Omega, u, v, w, z_nd, detJ,
-                                                  cellSizeInv, mf_m, mf_u, mf_v,
-                                                  vert_adv_type, domhi_z);
-            } else {
-                AMREX_ASSERT_WITH_MESSAGE(false, "Unknown advection scheme!");
-            }
-        }
+            AdvectionSrcForMomC2_T<decltype(mftag)::value>(bxx, bxy, bxz,
+                                                           rho_u_rhs, rho_v_rhs, rho_w_rhs,
+                                                           rho_u, rho_v, Omega, u, v, w, z_nd, detJ,
+                                                           cellSizeInv, mf_m, mf_u, mf_v,
+                                                           domhi_z);
+        });
+    } else {
+        DispatchAdvTypes(horiz_adv_type, vert_adv_type, use_mf, [&] (auto htag, auto vtag, auto mftag)
+        {
+            AdvectionSrcForMomWrapper_T<typename decltype(htag)::type,
+                                        typename decltype(vtag)::type, UPWINDALL,
+                                        decltype(vtag)::adv_type,
+                                        decltype(mftag)::value>(bxx, bxy, bxz,
+                                                                rho_u_rhs, rho_v_rhs, rho_w_rhs,
+                                                                rho_u, rho_v, Omega, u, v, w, z_nd, detJ,
+                                                                cellSizeInv, mf_m, mf_u, mf_v,
+                                                                domhi_z);
+        });
     }
 }
-
@@ -11,7 +11,8 @@ using namespace amrex;
  */
 void ABLMost::update_fluxes(int lev, int max_iters)
 {
-    // Compute plane averages for all vars
+    // Compute plane averages for all vars (every box of a column gets the averages
+    //    of the box at the surface, so the fluxes below are the same up the column)
     m_ma.compute_averages(lev);
 
     // Pointers to the computed averages
@@ -160,6 +161,9 @@ ABLMost::impose_most_bcs(const int lev,
     const int icomp = 0;
     for (MFIter mfi(*mfs[0]); mfi.isValid(); ++mfi)
     {
+        // Only the boxes at the surface have ghost cells below it
+        if (mfi.validbox().smallEnd(2) != m_geom[lev].Domain().smallEnd(2)) continue;
+
         // Get field arrays
         const auto cons_arr = mfs[Vars::cons]->array(mfi);
         const auto velx_arr = mfs[Vars::xvel]->array(mfi);
@@ -347,3 +351,24 @@ ABLMost::impose_most_bcs(const int lev,
         } // var_idx
     } // mf
 }
+
+
+/**
+ * Function to move the fluxes and the averages of a level onto a new distribution
+ * mapping of the same grids.  Everything is moved with its values, so that the time
+ * averaging of the MOST averages carries on as if nothing happened.
+ *
+ * @param[in] lev Current level
+ * @param[in] dm New distribution mapping of the grids at lev
+ */
+void
+ABLMost::redistribute(int lev, const DistributionMapping& dm)
+{
+    for (auto* mf : {u_star[lev], t_star[lev], olen[lev], t_surf[lev]}) {
+        MultiFab tmp(mf->boxArray(), dm, mf->nComp(), mf->nGrowVect());
+        tmp.Redistribute(*mf, 0, 0, mf->nComp(), mf->nGrowVect());
+        std::swap(*mf, tmp);
+    }
+
+    m_ma.redistribute(lev, dm);
+}
@@ -16,6 +16,9 @@ ERF::fill_from_wrfbdy (const Vector<MultiFab*>& mfs, const Real time)
 {
     int lev = 0;
 
+    // Load the time levels needed at this time if this rank does not hold them yet
+    wrfbdy_provider.ensure_time(time);
+
     // Time interpolation
     Real dT = bdy_time_interval;
     Real time_since_start = (time - start_bdy_time) / 1.e10;
@@ -45,8 +48,8 @@ ERF::fill_from_wrfbdy (const Vector<MultiFab*>& mfs, const Real time)
     ind_map.push_back( {WRFBdyVars::V} ); // yvel
     ind_map.push_back( {0} );             // zvel
 
-    // Nvars to loop over
-    Vector<int> comp_var = {NVAR, 1, 1, 1};
+    // Nvars to loop over (the cons MultiFab may only hold the fast variables)
+    Vector<int> comp_var = {std::min(NVAR, mfs[Vars::cons]->nComp()), 1, 1, 1};
 
     // Loop over all variable types
     for (int var_idx = Vars::cons; var_idx < Vars::NumTypes; ++var_idx)
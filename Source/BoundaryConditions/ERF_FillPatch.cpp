@@ -3,6 +3,7 @@
 #include <IndexDefines.H>
 #include <TimeInterpolatedData.H>
 #include <ERF_FillPatcher.H>
+#include <Utils.H>
 
 using namespace amrex;
 
@@ -23,7 +24,33 @@ ERF::FillPatch (int lev, Real time, const Vector<MultiFab*>& mfs)
     int bccomp;
     amrex::Interpolater* mapper = nullptr;
 
-    for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx) {
+    // At level 0 the data is usually filled in place (the MultiFabs are the old or new
+    //     state at its own time) so only the ghost cells shared with other grids need
+    //     filling; in that case we exchange all the variables together
+    bool exchange_together = (lev == 0 && aggregate_halo_exchange);
+    if (exchange_together) {
+        const Real teps = (t_new[lev] - t_old[lev]) * 1.e-3;
+        for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx) {
+            bool in_place = (mfs[var_idx] == &vars_new[lev][var_idx] &&
+                             time >= t_new[lev]-teps && time <= t_new[lev]+teps) ||
+                            (mfs[var_idx] == &vars_old[lev][var_idx] &&
+                             time >= t_old[lev]-teps && time <= t_old[lev]+teps);
+            exchange_together = exchange_together && in_place;
+        }
+    }
+
+    if (exchange_together) {
+        Vector<int>     scomp(Vars::NumTypes, 0);
+        Vector<int>     ncomp(Vars::NumTypes);
+        Vector<IntVect> nghost(Vars::NumTypes);
+        for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx) {
+            ncomp[var_idx]  = mfs[var_idx]->nComp();
+            nghost[var_idx] = mfs[var_idx]->nGrowVect();
+        }
+        FillBoundaryMulti(mfs, scomp, ncomp, nghost, geom[lev].periodicity());
+    }
+
+    for (int var_idx = 0; var_idx < Vars::NumTypes && !exchange_together; ++var_idx) {
         MultiFab& mf = *mfs[var_idx];
         const int icomp = 0;
         const int ncomp = mf.nComp();
@@ -151,6 +178,8 @@ ERF::FillPatchMoistVars (int lev, MultiFab& mf)
  * @param[in]  ncomp_cons     number of components for conserved variables
  * @param[in]  eddyDiffs      diffusion coefficients for LES turbulence models
  * @param[in]  allow_most_bcs if true then use MOST bcs at the low boundary
+ * @param[in]  ghosts_exchanged if true then the ghost cells shared with other grids at
+ *                              level 0 have already been filled (FillBoundary is skipped)
  */
 
 void
@@ -159,7 +188,8 @@ ERF::FillIntermediatePatch (int lev, Real time,
                             int ng_cons, int ng_vel, bool cons_only,
                             int icomp_cons, int ncomp_cons,
                             MultiFab* eddyDiffs,
-                            bool allow_most_bcs)
+                            bool allow_most_bcs,
+                            bool ghosts_exchanged)
 {
     BL_PROFILE_VAR("FillIntermediatePatch()",FillIntermediatePatch);
     int bccomp;
@@ -168,6 +198,12 @@ ERF::FillIntermediatePatch (int lev, Real time,
     // We should always pass cons, xvel, yvel, and zvel (in that order) in the mfs vector
     AMREX_ALWAYS_ASSERT(mfs.size() == Vars::NumTypes);
 
+    // Ghost cells shared with other grids at level 0, exchanged together when
+    //     aggregate_halo_exchange is set
+    Vector<MultiFab*> fb_mfs;
+    Vector<int>       fb_scomp, fb_ncomp;
+    Vector<IntVect>   fb_nghost;
+
     for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx)
     {
         if (cons_only && var_idx != Vars::cons) continue;
@@ -211,7 +247,16 @@ ERF::FillIntermediatePatch (int lev, Real time,
 
         if (lev == 0)
         {
-            mf.FillBoundary(icomp,ncomp,ngvect,geom[lev].periodicity());
+            if (ghosts_exchanged) {
+                // Nothing to do here
+            } else if (aggregate_halo_exchange) {
+                fb_mfs.push_back(&mf);
+                fb_scomp.push_back(icomp);
+                fb_ncomp.push_back(ncomp);
+                fb_nghost.push_back(ngvect);
+            } else {
+                mf.FillBoundary(icomp,ncomp,ngvect,geom[lev].periodicity());
+            }
         }
         else
         {
@@ -226,6 +271,10 @@ ERF::FillIntermediatePatch (int lev, Real time,
         } // lev > 0
     } // var_idx
 
+    if (!fb_mfs.empty()) {
+        FillBoundaryMulti(fb_mfs, fb_scomp, fb_ncomp, fb_nghost, geom[lev].periodicity());
+    }
+
     // Coarse-Fine set region
     if (lev>0 && coupling_type=="OneWay" && cf_set_width>0) {
         FPr_c[lev-1].fill(*mfs[Vars::cons], time, null_bc, domain_bcs_type, true);
@@ -1,6 +1,8 @@
 #include <MOSTAverage.H>
+#include <type_traits>
 #include <utility>
 #include <TileNoZ.H>
+#include <AMReX_ParallelReduce.H>
 
 using namespace amrex;
 
@@ -120,9 +122,14 @@ MOSTAverage::MOSTAverage (Vector<Geometry>  geom,
         } else {
             m_k_indx[lev] = new iMultiFab(ba2d,dm,incomp,ng);
         }
+        if (m_k_indx[lev]) m_k_indx[lev]->setVal(0);
       }
     } // lev
 
+    // Boxes above the surface get their averages from the surface boxes below them
+    //--------------------------------------------------------
+    set_column_copy();
+
     // Setup auxiliary data for spatial configuration & policy
     //--------------------------------------------------------
     if (m_z_phys_nd[0] && m_norm_vec && m_interp) { // Terrain w/ norm & w/ interpolation
@@ -186,6 +193,138 @@ MOSTAverage::update_field_ptrs(int lev,
 }
 
 
+/**
+ * Function to move the 2D averages, positions and indices of a level onto a new
+ * distribution mapping of the same grids.  The averages are moved with their values,
+ * so the time filtered means and the flag of their initialization are kept.
+ *
+ * @param[in] lev Current level
+ * @param[in] dm New distribution mapping of the grids at lev
+ */
+void
+MOSTAverage::redistribute(int lev, const DistributionMapping& dm)
+{
+    auto redistribute_mf = [&dm] (auto* mf)
+    {
+        if (!mf) return;
+        typename std::remove_pointer<decltype(mf)>::type tmp(mf->boxArray(), dm, mf->nComp(), mf->nGrowVect());
+        tmp.Redistribute(*mf, 0, 0, mf->nComp(), mf->nGrowVect());
+        std::swap(*mf, tmp);
+    };
+
+    for (int iavg(0); iavg < m_navg; ++iavg) redistribute_mf(m_averages[lev][iavg]);
+
+    redistribute_mf(m_x_pos[lev]);
+    redistribute_mf(m_y_pos[lev]);
+    redistribute_mf(m_z_pos[lev]);
+
+    redistribute_mf(m_i_indx[lev]);
+    redistribute_mf(m_j_indx[lev]);
+    redistribute_mf(m_k_indx[lev]);
+
+    // The gather of the surface boxes follows the new mapping
+    set_column_copy();
+}
+
+
+/**
+ * Function to set up the copy of the averages from the boxes at the surface to the
+ * boxes above them, for levels whose boxes do not span the whole vertical domain.
+ * The averages are only computed on the surface boxes; they are gathered on a 2D
+ * MultiFab holding just those boxes and copied from there to every box of the column.
+ */
+void
+MOSTAverage::set_column_copy()
+{
+    m_full_columns.resize(m_maxlev);
+    m_surface_boxes.resize(m_maxlev);
+    m_surface_averages.resize(m_maxlev);
+
+    for (int lev(0); lev < m_maxlev; lev++) {
+        const Box& domain = m_geom[lev].Domain();
+        const BoxArray& ba = m_fields[lev][2]->boxArray();
+        const DistributionMapping& dm = m_fields[lev][2]->DistributionMap();
+
+        m_full_columns[lev] = 1;
+        m_surface_boxes[lev].clear();
+        for (int n(0); n < ba.size(); ++n) {
+            if (ba[n].smallEnd(2) != domain.smallEnd(2) || ba[n].bigEnd(2) != domain.bigEnd(2)) {
+                m_full_columns[lev] = 0;
+            }
+            if (ba[n].smallEnd(2) == domain.smallEnd(2)) m_surface_boxes[lev].push_back(n);
+        }
+
+        m_surface_averages[lev].resize(m_navg);
+        if (m_full_columns[lev] || m_surface_boxes[lev].empty()) {
+            for (int iavg(0); iavg < m_navg; ++iavg) m_surface_averages[lev][iavg].reset();
+            continue;
+        }
+
+        // The surface boxes stay on the ranks that own them, so the gather is local
+        Vector<int> pmap(m_surface_boxes[lev].size());
+        for (int n(0); n < pmap.size(); ++n) pmap[n] = dm[m_surface_boxes[lev][n]];
+        DistributionMapping surf_dm(std::move(pmap));
+
+        for (int iavg(0); iavg < m_navg; ++iavg) {
+            const BoxArray& ba2d = m_averages[lev][iavg]->boxArray();
+            BoxList surf_bl(ba2d.ixType());
+            for (int n : m_surface_boxes[lev]) surf_bl.push_back(ba2d[n]);
+            m_surface_averages[lev][iavg] = std::make_unique<MultiFab>(BoxArray(std::move(surf_bl)), surf_dm, 1, 0);
+        }
+    }
+}
+
+
+/**
+ * Function to copy the averages of the surface boxes to the boxes above them.
+ *
+ * @param[in] lev Current level
+ * @param[in] iavg Index of the average
+ */
+void
+MOSTAverage::copy_up_columns(int lev, int iavg)
+{
+    if (!m_surface_averages[lev][iavg]) return;
+
+    MultiFab& avg  = *m_averages[lev][iavg];
+    MultiFab& surf = *m_surface_averages[lev][iavg];
+    const auto& surface_boxes = m_surface_boxes[lev];
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(surf); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        surf[mfi].copy<RunOn::Device>(avg[surface_boxes[mfi.index()]], bx, 0, bx, 0, 1);
+    }
+
+    avg.ParallelCopy(surf, 0, 0, 1);
+}
+
+
+/**
+ * Function to check that the cells used by the averages (the k index plus the radius)
+ * are held by the surface boxes, including their ghost cells.
+ *
+ * @param[in] lev Current level
+ */
+void
+MOSTAverage::check_k_indices(int lev)
+{
+    if (m_full_columns[lev]) return;
+
+    int ngz = m_fields[lev][0]->nGrow(2);
+    for (int imf(1); imf < m_nvar; ++imf) ngz = std::min(ngz, m_fields[lev][imf]->nGrow(2));
+
+    const BoxArray& ba = m_fields[lev][2]->boxArray();
+    int ktop = m_geom[lev].Domain().bigEnd(2) + ngz;
+    for (int n : m_surface_boxes[lev]) ktop = std::min(ktop, ba[n].bigEnd(2) + ngz);
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_k_indx[lev]->max(0) + m_radius <= ktop,
+                                     "MOST reference height must lie in the boxes at the surface!");
+}
+
+
 /**
  * Function to compute normalization for plane average.
  *
@@ -256,6 +395,7 @@ MOSTAverage::set_k_indices_N()
             AMREX_ALWAYS_ASSERT(lk >= m_radius);
 
             m_k_indx[lev]->setVal(lk);
+            check_k_indices(lev);
         }
     // Specified k_indx & compute z_ref
     } else if (read_k) {
@@ -263,6 +403,7 @@ MOSTAverage::set_k_indices_N()
             AMREX_ASSERT_WITH_MESSAGE(m_k_in[lev] >= m_radius,
                                       "K index must be larger than averaging radius!");
             m_k_indx[lev]->setVal(m_k_in[lev]);
+            check_k_indices(lev);
         }
 
         // TODO: check that z_ref is constant across levels
@@ -291,11 +432,15 @@ MOSTAverage::set_k_indices_T()
     // Specify z_ref & compute k_indx (z_ref takes precedence)
     if (read_z) {
         for (int lev(0); lev < m_maxlev; lev++) {
-            int kmax = m_geom[lev].Domain().bigEnd(2);
             for (MFIter mfi(*m_k_indx[lev], TileNoZ()); mfi.isValid(); ++mfi) {
+                if (!at_surface(lev, mfi.index())) continue;
+
                 Box npbx  = mfi.tilebox(); npbx.convert({1,1,0});
                 const auto z_phys_arr = m_z_phys_nd[lev]->const_array(mfi);
                 auto k_arr = m_k_indx[lev]->array(mfi);
+
+                // Search no higher than the top of the box (the domain with full columns)
+                int kmax = std::min(m_geom[lev].Domain().bigEnd(2), ubound(z_phys_arr).z - 1);
                 ParallelFor(npbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
                 {
                     Real z_target = d_zref + z_phys_arr(i,j,k);
@@ -313,6 +458,7 @@ MOSTAverage::set_k_indices_T()
                     }
                 });
             }
+            check_k_indices(lev);
         }
     // Specified k_indx & compute z_ref
     } else if (read_k) {
@@ -336,13 +482,17 @@ MOSTAverage::set_norm_indices_T()
     Real d_radius = m_radius;
 
     for (int lev(0); lev < m_maxlev; lev++) {
-        int kmax = m_geom[lev].Domain().bigEnd(2);
         const auto dxInv  = m_geom[lev].InvCellSizeArray();
         IntVect ng = m_k_indx[lev]->nGrowVect(); ng[2]=0;
         for (MFIter mfi(*m_k_indx[lev], TileNoZ()); mfi.isValid(); ++mfi) {
+            if (!at_surface(lev, mfi.index())) continue;
+
             Box npbx  = mfi.tilebox(); npbx.convert({1,1,0});
             Box gpbx  = mfi.growntilebox(ng);
             const auto z_phys_arr = m_z_phys_nd[lev]->const_array(mfi);
+
+            // Search no higher than the top of the box (the domain with full columns)
+            int kmax = std::min(m_geom[lev].Domain().bigEnd(2), ubound(z_phys_arr).z - 1);
             auto i_arr = m_i_indx[lev]->array(mfi);
             auto j_arr = m_j_indx[lev]->array(mfi);
             auto k_arr = m_k_indx[lev]->array(mfi);
@@ -386,6 +536,7 @@ MOSTAverage::set_norm_indices_T()
                                           "Query index outside of proc domain!");
             });
         }
+        check_k_indices(lev);
     }
 }
 
@@ -408,6 +559,8 @@ MOSTAverage::set_z_positions_T()
         const auto dx = m_geom[lev].CellSizeArray();
         IntVect ng = m_x_pos[lev]->nGrowVect(); ng[2]=0;
         for (MFIter mfi(*m_x_pos[lev], TileNoZ()); mfi.isValid(); ++mfi) {
+            if (!at_surface(lev, mfi.index())) continue;
+
             Box npbx  = mfi.tilebox(); npbx.convert({1,1,0});
             Box gpbx  = mfi.growntilebox(ng);
             RealBox grb{gpbx,dx.data(),base.dataPtr()};
@@ -452,6 +605,8 @@ MOSTAverage::set_norm_positions_T()
         const auto dxInv  = m_geom[lev].InvCellSizeArray();
         IntVect ng = m_x_pos[lev]->nGrowVect(); ng[2]=0;
         for (MFIter mfi(*m_x_pos[lev], TileNoZ()); mfi.isValid(); ++mfi) {
+            if (!at_surface(lev, mfi.index())) continue;
+
             Box npbx  = mfi.tilebox(); npbx.convert({1,1,0});
             Box gpbx  = mfi.growntilebox(ng);
             RealBox grb{gpbx,dx.data(),base.dataPtr()};
@@ -575,6 +730,9 @@ MOSTAverage::compute_plane_averages(int lev)
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
         for (MFIter mfi(*fields[imf], TileNoZ()); mfi.isValid(); ++mfi) {
+            // Each column is counted once, by the box at the surface
+            if (!at_surface(lev, mfi.index())) continue;
+
             Box vbx = mfi.validbox(); // This is the grid (not tile)
             Box pbx = mfi.tilebox();  // This is the tile (not grid)
             pbx.setSmall(2,0); pbx.setBig(2,0);
@@ -643,6 +801,8 @@ MOSTAverage::compute_plane_averages(int lev)
 #endif
         for (MFIter mfi(*averages[iavg], TileNoZ()); mfi.isValid(); ++mfi)
         {
+            if (!at_surface(lev, mfi.index())) continue;
+
             Box pbx = mfi.tilebox();
             pbx.setSmall(2,0); pbx.setBig(2,0);
 
@@ -690,7 +850,7 @@ MOSTAverage::compute_plane_averages(int lev)
 
     // Copy to host and sum across procs
     Gpu::copy(Gpu::deviceToHost, pavg.begin(), pavg.end(), plane_average.begin());
-    ParallelDescriptor::ReduceRealSum(plane_average.data(), plane_average.size());
+    ParallelAllReduce::Sum(plane_average.data(), plane_average.size(), ParallelContext::CommunicatorSub());
 
     // No spatial variation with plane averages
     for (int iavg(0); iavg < m_navg; ++iavg){
@@ -746,6 +906,8 @@ MOSTAverage::compute_region_averages(int lev)
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
         for (MFIter mfi(*fields[imf], TileNoZ()); mfi.isValid(); ++mfi) {
+            if (!at_surface(lev, mfi.index())) continue;
+
             Box pbx = mfi.tilebox(); pbx.setSmall(2,0); pbx.setBig(2,0);
 
             auto mf_arr = fields[imf]->const_array(mfi);
@@ -801,8 +963,10 @@ MOSTAverage::compute_region_averages(int lev)
             }
         }
 
-        // Fill interior ghost cells and any ghost cells outside a periodic domain
+        // Copy to the boxes above the surface, then fill interior ghost cells and
+        //    any ghost cells outside a periodic domain
         //***********************************************************************************
+        copy_up_columns(lev, imf);
         averages[imf]->FillBoundary(geom.periodicity());
     }
 
@@ -816,6 +980,8 @@ MOSTAverage::compute_region_averages(int lev)
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
         for (MFIter mfi(*averages[iavg], TileNoZ()); mfi.isValid(); ++mfi) {
+            if (!at_surface(lev, mfi.index())) continue;
+
             Box pbx = mfi.tilebox(); pbx.setSmall(2,0); pbx.setBig(2,0);
 
             auto u_mf_arr = fields[imf]->const_array(mfi);
@@ -876,11 +1042,13 @@ MOSTAverage::compute_region_averages(int lev)
                     }
                 });
             }
-
-            // Fill interior ghost cells and any ghost cells outside a periodic domain
-            //***********************************************************************************
-            averages[iavg]->FillBoundary(geom.periodicity());
         }
+
+        // Copy to the boxes above the surface, then fill interior ghost cells and
+        //    any ghost cells outside a periodic domain
+        //***********************************************************************************
+        copy_up_columns(lev, iavg);
+        averages[iavg]->FillBoundary(geom.periodicity());
     }
 
 
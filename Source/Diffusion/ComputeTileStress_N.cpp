@@ -0,0 +1,117 @@
+#include <Diffusion.H>
+
+using namespace amrex;
+
+/**
+ * Function for computing the strain rates without terrain over one tile into tile-local FABs.
+ * The FABs are resized here to the tile grown by one cell in x and y, which holds everything
+ * needed by the stress divergence (and SmnSmn) on the faces and cells of the tile; the caller
+ * keeps them alive (Elixir) for as long as they are read.
+ *
+ * @param[in]  bx cell center tile box, intersected with the valid box
+ * @param[in]  u x-direction velocity
+ * @param[in]  v y-direction velocity
+ * @param[in]  w z-direction velocity
+ * @param[out] S11 11 strain
+ * @param[out] S22 22 strain
+ * @param[out] S33 33 strain
+ * @param[out] S12 12 strain
+ * @param[out] S13 13 strain
+ * @param[out] S23 23 strain
+ * @param[in]  bc_ptr container with boundary condition types
+ * @param[in]  dxInv inverse cell size array
+ * @param[in]  mf_m map factor at cell center
+ * @param[in]  mf_u map factor at x-face
+ * @param[in]  mf_v map factor at y-face
+ */
+void
+ComputeTileStrain_N (const Box& bx,
+                     const Array4<const Real>& u, const Array4<const Real>& v, const Array4<const Real>& w,
+                     FArrayBox& S11, FArrayBox& S22, FArrayBox& S33,
+                     FArrayBox& S12, FArrayBox& S13, FArrayBox& S23,
+                     const BCRec* bc_ptr, const GpuArray<Real, AMREX_SPACEDIM>& dxInv,
+                     const Array4<const Real>& mf_m, const Array4<const Real>& mf_u, const Array4<const Real>& mf_v)
+{
+    // The nodal boxes hold the high side nodes of the tile as well, so no neighboring
+    //     tile is needed to close the fluxes
+    Box bxcc  = amrex::grow(bx, IntVect(1,1,0));
+    Box tbxxy = amrex::grow(amrex::convert(bx, IntVect(1,1,0)), IntVect(1,1,0));
+    Box tbxxz = amrex::grow(amrex::convert(bx, IntVect(1,0,1)), IntVect(1,1,0));
+    Box tbxyz = amrex::grow(amrex::convert(bx, IntVect(0,1,1)), IntVect(1,1,0));
+
+    S11.resize(bxcc,1);  S22.resize(bxcc,1);  S33.resize(bxcc,1);
+    S12.resize(tbxxy,1); S13.resize(tbxxz,1); S23.resize(tbxyz,1);
+    Array4<Real> s11 = S11.array();  Array4<Real> s22 = S22.array();  Array4<Real> s33 = S33.array();
+    Array4<Real> s12 = S12.array();  Array4<Real> s13 = S13.array();  Array4<Real> s23 = S23.array();
+
+    ComputeStrain_N(bxcc, tbxxy, tbxxz, tbxyz,
+                    u, v, w,
+                    s11, s22, s33,
+                    s12, s13, s23,
+                    bc_ptr, dxInv,
+                    mf_m, mf_u, mf_v);
+}
+
+/**
+ * Function for turning the strain rates of one tile (from ComputeTileStrain_N) into the
+ * stress without terrain, in place.  tau_ii is computed on the tile grown by one cell in
+ * x and y, and the off-diagonal terms on the nodes surrounding the tile, which is what
+ * DiffusionSrcForMom_N reads for the faces of the tile.
+ *
+ * @param[in]     bx cell center tile box, intersected with the valid box
+ * @param[in]     mu_eff constant molecular viscosity
+ * @param[in]     mu_turb variable turbulent viscosity (empty for constant viscosity)
+ * @param[in]     u x-direction velocity
+ * @param[in]     v y-direction velocity
+ * @param[in]     w z-direction velocity
+ * @param[in,out] S11 11 strain -> stress
+ * @param[in,out] S22 22 strain -> stress
+ * @param[in,out] S33 33 strain -> stress
+ * @param[in,out] S12 12 strain -> stress
+ * @param[in,out] S13 13 strain -> stress
+ * @param[in,out] S23 23 strain -> stress
+ * @param[in]     dxInv inverse cell size array
+ * @param[in]     mf_m map factor at cell center
+ * @param[in]     mf_u map factor at x-face
+ * @param[in]     mf_v map factor at y-face
+ */
+void
+ComputeTileStress_N (const Box& bx, Real mu_eff,
+                     const Array4<const Real>& mu_turb,
+                     const Array4<const Real>& u, const Array4<const Real>& v, const Array4<const Real>& w,
+                     FArrayBox& S11, FArrayBox& S22, FArrayBox& S33,
+                     FArrayBox& S12, FArrayBox& S13, FArrayBox& S23,
+                     const GpuArray<Real, AMREX_SPACEDIM>& dxInv,
+                     const Array4<const Real>& mf_m, const Array4<const Real>& mf_u, const Array4<const Real>& mf_v)
+{
+    Box bxcc  = amrex::grow(bx, IntVect(1,1,0));
+    Box tbxxy = amrex::convert(bx, IntVect(1,1,0));
+    Box tbxxz = amrex::convert(bx, IntVect(1,0,1));
+    Box tbxyz = amrex::convert(bx, IntVect(0,1,1));
+
+    // Expansion rate
+    FArrayBox ER(bxcc,1);
+    Elixir er_eli = ER.elixir();
+    Array4<Real> er_arr = ER.array();
+    amrex::ParallelFor(bxcc, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+        Real mfsq = mf_m(i,j,0)*mf_m(i,j,0);
+        er_arr(i,j,k) = (u(i+1, j  , k  )/mf_u(i+1,j,0) - u(i, j, k)/mf_u(i,j,0))*dxInv[0]*mfsq +
+                        (v(i  , j+1, k  )/mf_v(i,j+1,0) - v(i, j, k)/mf_v(i,j,0))*dxInv[1]*mfsq +
+                        (w(i  , j  , k+1) - w(i, j, k))*dxInv[2];
+    });
+
+    Array4<Real> s11 = S11.array();  Array4<Real> s22 = S22.array();  Array4<Real> s33 = S33.array();
+    Array4<Real> s12 = S12.array();  Array4<Real> s13 = S13.array();  Array4<Real> s23 = S23.array();
+
+    if (mu_turb) {
+        ComputeStressVarVisc_N(bxcc, tbxxy, tbxxz, tbxyz, mu_eff, mu_turb,
+                               s11, s22, s33,
+                               s12, s13, s23,
+                               er_arr);
+    } else {
+        ComputeStressConsVisc_N(bxcc, tbxxy, tbxxz, tbxyz, mu_eff,
+                                s11, s22, s33,
+                                s12, s13, s23,
+                                er_arr);
+    }
+}
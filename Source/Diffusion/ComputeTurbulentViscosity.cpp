@@ -15,12 +15,16 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
                               const amrex::Geometry& geom,
                               const SolverChoice& solverChoice,
                               std::unique_ptr<ABLMost>& most,
+                              PBLColumnSum& pbl_columns,
                               bool /*vert_only*/);
 
 /**
  * Function for computing the turbulent viscosity with LES.
  *
- * @param[in]  Tau11 11 strain
+ * @param[in]  xvel velocity in x-dir
+ * @param[in]  yvel velocity in y-dir
+ * @param[in]  zvel velocity in z-dir
+ * @param[in]  Tau11 11 strain (null if the strain is not stored)
  * @param[in]  Tau22 22 strain
  * @param[in]  Tau33 33 strain
  * @param[in]  Tau12 12 strain
@@ -28,21 +32,25 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
  * @param[in]  Tau23 23 strain
  * @param[in]  cons_in cell center conserved quantities
  * @param[out] eddyViscosity turbulent viscosity
- * @param[in]  Hfx1 heat flux in x-dir
- * @param[in]  Hfx2 heat flux in y-dir
+ * @param[in]  Hfx1 heat flux in x-dir (may be null)
+ * @param[in]  Hfx2 heat flux in y-dir (may be null)
  * @param[in]  Hfx3 heat flux in z-dir
  * @param[in]  Diss dissipation of turbulent kinetic energy
  * @param[in]  geom problem geometry
+ * @param[in]  mapfac_m map factor at cell center
  * @param[in]  mapfac_u map factor at x-face
  * @param[in]  mapfac_v map factor at y-face
+ * @param[in]  bc_ptr_h container with boundary condition types
  * @param[in]  solverChoice container with solver parameters
  */
-void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::MultiFab& Tau22, const amrex::MultiFab& Tau33,
-                                   const amrex::MultiFab& Tau12, const amrex::MultiFab& Tau13, const amrex::MultiFab& Tau23,
+void ComputeTurbulentViscosityLES (const amrex::MultiFab& xvel, const amrex::MultiFab& yvel, const amrex::MultiFab& zvel,
+                                   const amrex::MultiFab* Tau11, const amrex::MultiFab* Tau22, const amrex::MultiFab* Tau33,
+                                   const amrex::MultiFab* Tau12, const amrex::MultiFab* Tau13, const amrex::MultiFab* Tau23,
                                    const amrex::MultiFab& cons_in, amrex::MultiFab& eddyViscosity,
-                                   amrex::MultiFab& Hfx1, amrex::MultiFab& Hfx2, amrex::MultiFab& Hfx3, amrex::MultiFab& Diss,
+                                   amrex::MultiFab* Hfx1, amrex::MultiFab* Hfx2, amrex::MultiFab* Hfx3, amrex::MultiFab* Diss,
                                    const amrex::Geometry& geom,
-                                   const amrex::MultiFab& mapfac_u, const amrex::MultiFab& mapfac_v,
+                                   const amrex::MultiFab& mapfac_m, const amrex::MultiFab& mapfac_u, const amrex::MultiFab& mapfac_v,
+                                   const amrex::BCRec* bc_ptr_h,
                                    const SolverChoice& solverChoice)
 {
     const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dxInv = geom.InvCellSizeArray();
@@ -64,16 +72,26 @@ void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::Mu
         const Array4<Real>& mu_turb = eddyViscosity.array(mfi);
         const amrex::Array4<amrex::Real const > &cell_data = cons_in.array(mfi);
 
-        Array4<Real const> tau11 = Tau11.array(mfi);
-        Array4<Real const> tau22 = Tau22.array(mfi);
-        Array4<Real const> tau33 = Tau33.array(mfi);
-        Array4<Real const> tau12 = Tau12.array(mfi);
-        Array4<Real const> tau13 = Tau13.array(mfi);
-        Array4<Real const> tau23 = Tau23.array(mfi);
-
         Array4<Real const> mf_u = mapfac_u.array(mfi);
         Array4<Real const> mf_v = mapfac_v.array(mfi);
 
+        // Without the stored strain (use_fused_stress), compute it on this tile
+        FArrayBox S11,S22,S33,S12,S13,S23;
+        if (!Tau11) {
+            ComputeTileStrain_N(bxcc, xvel.const_array(mfi), yvel.const_array(mfi), zvel.const_array(mfi),
+                                S11, S22, S33, S12, S13, S23,
+                                bc_ptr_h, dxInv, mapfac_m.const_array(mfi), mf_u, mf_v);
+        }
+        Elixir S11_eli = S11.elixir(); Elixir S22_eli = S22.elixir(); Elixir S33_eli = S33.elixir();
+        Elixir S12_eli = S12.elixir(); Elixir S13_eli = S13.elixir(); Elixir S23_eli = S23.elixir();
+
+        Array4<Real const> tau11 = Tau11 ? Tau11->const_array(mfi) : S11.const_array();
+        Array4<Real const> tau22 = Tau22 ? Tau22->const_array(mfi) : S22.const_array();
+        Array4<Real const> tau33 = Tau33 ? Tau33->const_array(mfi) : S33.const_array();
+        Array4<Real const> tau12 = Tau12 ? Tau12->const_array(mfi) : S12.const_array();
+        Array4<Real const> tau13 = Tau13 ? Tau13->const_array(mfi) : S13.const_array();
+        Array4<Real const> tau23 = Tau23 ? Tau23->const_array(mfi) : S23.const_array();
+
         ParallelFor(bxcc, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             Real SmnSmn = ComputeSmnSmn(i,j,k,tau11,tau22,tau33,tau12,tau13,tau23);
@@ -105,10 +123,10 @@ void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::Mu
           Box bxcc  = mfi.tilebox();
 
         const Array4<Real>& mu_turb = eddyViscosity.array(mfi);
-        const Array4<Real>& hfx_x   = Hfx1.array(mfi);
-        const Array4<Real>& hfx_y   = Hfx2.array(mfi);
-        const Array4<Real>& hfx_z   = Hfx3.array(mfi);
-        const Array4<Real>& diss    = Diss.array(mfi);
+        const Array4<Real>& hfx_x   = Hfx1 ? Hfx1->array(mfi) : Array4<Real>{};
+        const Array4<Real>& hfx_y   = Hfx2 ? Hfx2->array(mfi) : Array4<Real>{};
+        const Array4<Real>& hfx_z   = Hfx3->array(mfi);
+        const Array4<Real>& diss    = Diss->array(mfi);
 
         const amrex::Array4<amrex::Real const > &cell_data = cons_in.array(mfi);
 
@@ -153,8 +171,8 @@ void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::Mu
               Ce = 1.9*l_C_k + Ce_lcoeff*length / DeltaMsf;
           diss(i,j,k) = cell_data(i,j,k,Rho_comp) * Ce * std::pow(E,1.5) / length;
           // - heat flux
-          hfx_x(i,j,k) = 0.0;
-          hfx_y(i,j,k) = 0.0;
+          if (hfx_x) hfx_x(i,j,k) = 0.0;
+          if (hfx_y) hfx_y(i,j,k) = 0.0;
           hfx_z(i,j,k) = -mu_turb(i,j,k,EddyDiff::Theta_v) * dtheta_dz; // (rho*w)' theta' [kg m^-2 s^-1 K]
         });
       }
@@ -342,7 +360,8 @@ void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::Mu
  *
  * @param[in]  xvel velocity in x-dir
  * @param[in]  yvel velocity in y-dir
- * @param[in]  Tau11 11 strain
+ * @param[in]  zvel velocity in z-dir
+ * @param[in]  Tau11 11 strain (null if the strain is not stored)
  * @param[in]  Tau22 22 strain
  * @param[in]  Tau33 33 strain
  * @param[in]  Tau12 12 strain
@@ -350,27 +369,32 @@ void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::Mu
  * @param[in]  Tau23 23 strain
  * @param[in]  cons_in cell center conserved quantities
  * @param[out] eddyViscosity turbulent viscosity
- * @param[in]  Hfx1 heat flux in x-dir
- * @param[in]  Hfx2 heat flux in y-dir
+ * @param[in]  Hfx1 heat flux in x-dir (may be null)
+ * @param[in]  Hfx2 heat flux in y-dir (may be null)
  * @param[in]  Hfx3 heat flux in z-dir
  * @param[in]  Diss dissipation of turbulent kinetic energy
  * @param[in]  geom problem geometry
+ * @param[in]  mapfac_m map factor at cell center
  * @param[in]  mapfac_u map factor at x-face
  * @param[in]  mapfac_v map factor at y-face
+ * @param[in]  bc_ptr_h container with boundary condition types
  * @param[in]  solverChoice container with solver parameters
  * @param[in]  most pointer to Monin-Obukhov class if instantiated
+ * @param[in,out] pbl_columns cached layout of the PBL column integrals
  * @param[in]  vert_only flag for vertical components of eddyViscosity
  */
-void ComputeTurbulentViscosity (const amrex::MultiFab& xvel , const amrex::MultiFab& yvel ,
-                                const amrex::MultiFab& Tau11, const amrex::MultiFab& Tau22, const amrex::MultiFab& Tau33,
-                                const amrex::MultiFab& Tau12, const amrex::MultiFab& Tau13, const amrex::MultiFab& Tau23,
+void ComputeTurbulentViscosity (const amrex::MultiFab& xvel , const amrex::MultiFab& yvel , const amrex::MultiFab& zvel ,
+                                const amrex::MultiFab* Tau11, const amrex::MultiFab* Tau22, const amrex::MultiFab* Tau33,
+                                const amrex::MultiFab* Tau12, const amrex::MultiFab* Tau13, const amrex::MultiFab* Tau23,
                                 const amrex::MultiFab& cons_in,
                                 amrex::MultiFab& eddyViscosity,
-                                amrex::MultiFab& Hfx1, amrex::MultiFab& Hfx2, amrex::MultiFab& Hfx3, amrex::MultiFab& Diss,
+                                amrex::MultiFab* Hfx1, amrex::MultiFab* Hfx2, amrex::MultiFab* Hfx3, amrex::MultiFab* Diss,
                                 const amrex::Geometry& geom,
-                                const amrex::MultiFab& mapfac_u, const amrex::MultiFab& mapfac_v,
+                                const amrex::MultiFab& mapfac_m, const amrex::MultiFab& mapfac_u, const amrex::MultiFab& mapfac_v,
+                                const amrex::BCRec* bc_ptr_h,
                                 const SolverChoice& solverChoice,
                                 std::unique_ptr<ABLMost>& most,
+                                PBLColumnSum& pbl_columns,
                                 bool vert_only)
 {
     BL_PROFILE_VAR("ComputeTurbulentViscosity()",ComputeTurbulentViscosity);
@@ -399,16 +423,17 @@ void ComputeTurbulentViscosity (const amrex::MultiFab& xvel , const amrex::Multi
     }
 
     if (solverChoice.les_type != LESType::None) {
-        ComputeTurbulentViscosityLES(Tau11, Tau22, Tau33,
+        ComputeTurbulentViscosityLES(xvel, yvel, zvel,
+                                     Tau11, Tau22, Tau33,
                                      Tau12, Tau13, Tau23,
                                      cons_in, eddyViscosity,
                                      Hfx1, Hfx2, Hfx3, Diss,
-                                     geom, mapfac_u, mapfac_v,
-                                     solverChoice);
+                                     geom, mapfac_m, mapfac_u, mapfac_v,
+                                     bc_ptr_h, solverChoice);
     }
 
     if (solverChoice.pbl_type != PBLType::None) {
         ComputeTurbulentViscosityPBL(xvel, yvel, cons_in, eddyViscosity,
-                                     geom, solverChoice, most, vert_only);
+                                     geom, solverChoice, most, pbl_columns, vert_only);
     }
 }
@@ -1,6 +1,130 @@
 #include "ABLMost.H"
 #include "DirectionSelector.H"
 #include "Diffusion.H"
+#include "PBLColumnSum.H"
+#include "TileNoZ.H"
+
+/**
+ * Function to build the 2D layouts for the grids of cons_in, unless they were built for
+ * the same grids already.
+ *
+ * @param[in] cons_in cell center conserved quantities
+ * @param[in] geom problem geometry
+ */
+void
+PBLColumnSum::define (const amrex::MultiFab& cons_in,
+                      const amrex::Geometry& geom)
+{
+    const amrex::BoxArray& ba = cons_in.boxArray();
+    const amrex::DistributionMapping& dm = cons_in.DistributionMap();
+
+    if (!m_ba.empty() && m_ba == ba && m_dm == dm) return;
+
+    BL_PROFILE("PBLColumnSum::define()");
+
+    m_ba = ba;
+    m_dm = dm;
+
+    const amrex::Box& dbx = geom.Domain();
+    m_full_columns = true;
+    for (int n = 0; n < ba.size(); ++n) {
+        if (ba[n].smallEnd(2) != dbx.smallEnd(2) || ba[n].bigEnd(2) != dbx.bigEnd(2)) m_full_columns = false;
+    }
+    if (m_full_columns) {
+        m_qsum.reset();
+        m_col.reset();
+        return;
+    }
+
+    amrex::BoxList bl2d = ba.boxList();
+    amrex::IntVect max_len(1);
+    for (auto& b : bl2d) {
+        max_len = amrex::max(max_len, b.length());
+        b.setSmall(2,0); b.setBig(2,0);
+    }
+    amrex::BoxArray ba2d(std::move(bl2d));
+    m_qsum = std::make_unique<amrex::MultiFab>(ba2d, dm, 2, amrex::IntVect(1,1,0));
+
+    amrex::Box dom2d = dbx;
+    dom2d.setSmall(2,0); dom2d.setBig(2,0);
+    amrex::BoxArray col_ba(dom2d);
+    col_ba.maxSize(max_len);
+    amrex::DistributionMapping col_dm(col_ba);
+    m_col = std::make_unique<amrex::MultiFab>(col_ba, col_dm, 2, 0);
+}
+
+/**
+ * Function to check whether every box of the grids of cons_in spans the whole vertical domain.
+ *
+ * @param[in] cons_in cell center conserved quantities
+ * @param[in] geom problem geometry
+ */
+bool
+PBLColumnSum::full_columns (const amrex::MultiFab& cons_in,
+                            const amrex::Geometry& geom)
+{
+    define(cons_in, geom);
+    return m_full_columns;
+}
+
+/**
+ * Function to compute, for boxes that do not span the whole vertical domain, the
+ * column integrals of z*q and q used by the MYNN length scale.
+ *
+ * @param[in] cons_in cell center conserved quantities
+ * @param[in] geom problem geometry
+ * @return z-flattened MultiFab on the boxes of cons_in (one ghost column in x and y)
+ *         holding the integrals of z*q (comp 0) and q (comp 1)
+ */
+const amrex::MultiFab&
+PBLColumnSum::sum (const amrex::MultiFab& cons_in,
+                   const amrex::Geometry& geom)
+{
+    BL_PROFILE("PBLColumnSum::sum()");
+
+    define(cons_in, geom);
+    AMREX_ALWAYS_ASSERT(!m_full_columns);
+
+    amrex::MultiFab& qsum = *m_qsum;
+    amrex::MultiFab& col  = *m_col;
+    qsum.setVal(0.0);
+
+    const amrex::GeometryData gdata = geom.data();
+
+    // Partial sums over the cells of each box
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( amrex::MFIter mfi(qsum,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const amrex::Box& xybx = mfi.tilebox();
+        const amrex::Box& vbx  = cons_in.box(mfi.index());
+        const int klo = vbx.smallEnd(2);
+        const int khi = vbx.bigEnd(2);
+        const amrex::Array4<amrex::Real const>& cell_data = cons_in.const_array(mfi);
+        const amrex::Array4<amrex::Real>& qint = qsum.array(mfi);
+        amrex::ParallelFor(xybx, [=] AMREX_GPU_DEVICE (int i, int j, int) noexcept
+        {
+            amrex::Real qint_zq = 0.0;
+            amrex::Real qint_q  = 0.0;
+            for (int k = klo; k <= khi; ++k) {
+                const amrex::Real Zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
+                const amrex::Real qvel = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp));
+                qint_zq += Zval*qvel;
+                qint_q  += qvel;
+            }
+            qint(i,j,0,0) = qint_zq;
+            qint(i,j,0,1) = qint_q;
+        });
+    }
+
+    // Add up the boxes of each column on the footprint of the domain and send the totals
+    //    back, including the ghost columns (periodic ones come from the other side)
+    col.setVal(0.0);
+    col.ParallelAdd(qsum, 0, 0, 2);
+    qsum.ParallelCopy(col, 0, 0, 2, amrex::IntVect(0), amrex::IntVect(1,1,0), geom.periodicity());
+
+    return qsum;
+}
 
 /**
  * Function to compute turbulent viscosity with PBL.
@@ -12,6 +136,7 @@
  * @param[in] geom problem geometry
  * @param[in] solverChoice container with solver parameters
  * @param[in] most pointer to Monin-Obukhov class if instantiated
+ * @param[in,out] pbl_columns cached layout of the column integrals
  */
 void
 ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
@@ -21,6 +146,7 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
                               const amrex::Geometry& geom,
                               const SolverChoice& solverChoice,
                               std::unique_ptr<ABLMost>& most,
+                              PBLColumnSum& pbl_columns,
                               bool /*vert_only*/)
 {
   // MYNN Level 2.5 PBL Model
@@ -36,10 +162,34 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
     //const amrex::Real C4 = solverChoice.pbl_C4;
     const amrex::Real C5 = solverChoice.pbl_C5;
 
+    const amrex::Box& dbx = geom.Domain();
+    const amrex::GeometryData gdata = geom.data();
+    const auto dlo = amrex::lbound(dbx);
+    const auto dhi = amrex::ubound(dbx);
+    const auto is_per = geom.isPeriodicArray();
+
+    amrex::Real dz_inv = geom.InvCellSize(2);
+    int izmin = dbx.smallEnd(2);
+    int izmax = dbx.bigEnd(2);
+
+    // The column integrals are done by the column loop itself when every box spans the
+    //    whole vertical domain; otherwise the partial integrals of the boxes are summed first
+    const amrex::MultiFab* qsum = pbl_columns.full_columns(cons_in, geom) ? nullptr
+                                                                          : &pbl_columns.sum(cons_in, geom);
+
+    // Spatially varying MOST
+    amrex::Real eps       = 1.0e-16;
+    amrex::Real d_kappa   = most->kappa;
+    amrex::Real d_gravity = most->gravity;
+
+    const auto& t_mean_mf = most->get_mac_avg(0,2); // TODO: IS THIS ACTUALLY RHOTHETA
+    const auto& u_star_mf = most->get_u_star(0);    // Use coarsest level
+    const auto& t_star_mf = most->get_t_star(0);    // Use coarsest level
+
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-    for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    for ( amrex::MFIter mfi(eddyViscosity,TileNoZ()); mfi.isValid(); ++mfi) {
 
       const amrex::Box &bx = mfi.growntilebox(1);
       const amrex::Array4<amrex::Real const > &cell_data = cons_in.array(mfi);
@@ -47,78 +197,41 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
       const amrex::Array4<amrex::Real const> &uvel = xvel.array(mfi);
       const amrex::Array4<amrex::Real const> &vvel = yvel.array(mfi);
 
-      // Compute some quantities that are constant in each column
-      // Sbox is shrunk to only include the interior of the domain in the vertical direction to compute integrals
-      // NOTE: Here we requite that sbx covers the entire vertical domain
-      const amrex::Box &dbx = geom.Domain();
-      amrex::Box sbx(bx.smallEnd(), bx.bigEnd());
-      sbx.grow(2,-1);
-      AMREX_ALWAYS_ASSERT(sbx.smallEnd(2) == dbx.smallEnd(2) && sbx.bigEnd(2) == dbx.bigEnd(2));
-
-      const amrex::GeometryData gdata = geom.data();
-
-      const amrex::Box xybx = PerpendicularBox<ZDir>(bx, amrex::IntVect{0,0,0});
-      amrex::FArrayBox qintegral(xybx,2);
-      qintegral.setVal<amrex::RunOn::Device>(0.0);
-      amrex::FArrayBox qturb(bx,1);
-      const amrex::Array4<amrex::Real> qint = qintegral.array();
-      const amrex::Array4<amrex::Real> qvel= qturb.array();
-
-      amrex::ParallelFor(amrex::Gpu::KernelInfo().setReduction(true), bx,
-                         [=] AMREX_GPU_DEVICE (int i, int j, int k, amrex::Gpu::Handler const& handler) noexcept
-      {
-          const amrex::Real Zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
-          const amrex::Real rho = cell_data(i,j,k,Rho_comp);
-          qvel(i,j,k) = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / rho);
-          // We will divide by qvel later
-          AMREX_ASSERT_WITH_MESSAGE(qvel(i,j,k) > 0.0, "QKE must have a positive value");
-          if (sbx.contains(i,j,k)) {
-              amrex::Gpu::deviceReduceSum(&qint(i,j,0,0), Zval*qvel(i,j,k), handler);
-              amrex::Gpu::deviceReduceSum(&qint(i,j,0,1), qvel(i,j,k), handler);
-          }
-      });
-
-      amrex::Real dz_inv = geom.InvCellSize(2);
-      int izmin = geom.Domain().smallEnd(2);
-      int izmax = geom.Domain().bigEnd(2);
-
-      // Spatially varying MOST
-      amrex::Real eps       = 1.0e-16;
-      amrex::Real d_kappa   = most->kappa;
-      amrex::Real d_gravity = most->gravity;
-
-      const auto& t_mean_mf = most->get_mac_avg(0,2); // TODO: IS THIS ACTUALLY RHOTHETA
-      const auto& u_star_mf = most->get_u_star(0);    // Use coarsest level
-      const auto& t_star_mf = most->get_t_star(0);    // Use coarsest level
-
       const auto& tm_arr     = t_mean_mf->array(mfi); // TODO: IS THIS ACTUALLY RHOTHETA
       const auto& u_star_arr = u_star_mf->array(mfi);
       const auto& t_star_arr = t_star_mf->array(mfi);
 
-      amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+      const amrex::Array4<amrex::Real const> qsum_arr = qsum ? qsum->const_array(mfi)
+                                                             : amrex::Array4<amrex::Real const>{};
+
+      // One column per thread: the integrals, the column constants and the
+      //     length scales are all kept in registers
+      const amrex::Box xybx = PerpendicularBox<ZDir>(bx, amrex::IntVect{0,0,0});
+      const int klo = bx.smallEnd(2);
+      const int khi = bx.bigEnd(2);
+
+      amrex::ParallelFor(xybx, [=] AMREX_GPU_DEVICE (int i, int j, int) noexcept
       {
-          // Compute some partial derivatives that we will need (1st order at domain boundary)
-          // U and V derivatives are interpolated to account for staggered grid
-          amrex::Real dthetadz, dudz, dvdz;
-          if (k == izmax) {
-              dthetadz = (cell_data(i,j,k,RhoTheta_comp)/cell_data(i,j,k,Rho_comp) -
-                          cell_data(i,j,k-1,RhoTheta_comp)/cell_data(i,j,k-1,Rho_comp))*dz_inv;
-              dudz = 0.5*(uvel(i,j,k) - uvel(i,j,k-1) + uvel(i+1,j,k) - uvel(i+1,j,k-1))*dz_inv;
-              dvdz = 0.5*(vvel(i,j,k) - vvel(i,j,k-1) + vvel(i,j+1,k) - vvel(i,j+1,k-1))*dz_inv;
-          } else if (k == izmin){
-              dthetadz = (cell_data(i,j,k+1,RhoTheta_comp)/cell_data(i,j,k+1,Rho_comp) -
-                          cell_data(i,j,k,RhoTheta_comp)/cell_data(i,j,k,Rho_comp))*dz_inv;
-              dudz = 0.5*(uvel(i,j,k+1) - uvel(i,j,k) + uvel(i+1,j,k+1) - uvel(i+1,j,k))*dz_inv;
-              dvdz = 0.5*(vvel(i,j,k+1) - vvel(i,j,k) + vvel(i,j+1,k+1) - vvel(i,j+1,k))*dz_inv;
+          // Column integrals of Zval*qvel and qvel over the interior of the domain
+          amrex::Real qint_zq = 0.0;
+          amrex::Real qint_q  = 0.0;
+          if (qsum_arr) {
+              // Ghost columns outside a non-periodic domain use the adjacent interior column
+              const int ii = is_per[0] ? i : amrex::max(dlo.x, amrex::min(i, dhi.x));
+              const int jj = is_per[1] ? j : amrex::max(dlo.y, amrex::min(j, dhi.y));
+              qint_zq = qsum_arr(ii,jj,0,0);
+              qint_q  = qsum_arr(ii,jj,0,1);
           } else {
-              dthetadz = 0.5*(cell_data(i,j,k+1,RhoTheta_comp)/cell_data(i,j,k+1,Rho_comp) -
-                              cell_data(i,j,k-1,RhoTheta_comp)/cell_data(i,j,k-1,Rho_comp))*dz_inv;
-              dudz = 0.25*(uvel(i,j,k+1) - uvel(i,j,k-1) + uvel(i+1,j,k+1) - uvel(i+1,j,k-1))*dz_inv;
-              dvdz = 0.25*(vvel(i,j,k+1) - vvel(i,j,k-1) + vvel(i,j+1,k+1) - vvel(i,j+1,k-1))*dz_inv;
+              for (int k = izmin; k <= izmax; ++k) {
+                  const amrex::Real Zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
+                  const amrex::Real qvel = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp));
+                  qint_zq += Zval*qvel;
+                  qint_q  += qvel;
+              }
           }
 
           // Spatially varying MOST
-          amrex::Real surface_heat_flux = u_star_arr(i,k,0) * t_star_arr(i,j,0);
+          amrex::Real surface_heat_flux = u_star_arr(i,j,0) * t_star_arr(i,j,0);
           amrex::Real theta0            = tm_arr(i,j,0); // TODO: IS THIS ACTUALLY RHOTHETA
           amrex::Real l_obukhov;
           if (std::abs(surface_heat_flux) > eps) {
@@ -127,68 +240,94 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
           } else {
               l_obukhov = std::numeric_limits<amrex::Real>::max();
           }
-
-          // First Length Scale
           AMREX_ASSERT(l_obukhov != 0);
-          const amrex::Real zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
-          const amrex::Real zeta = zval/l_obukhov;
-          amrex::Real l_S;
-          if (zeta >= 1.0) {
-              l_S = KAPPA*zval/3.7;
-          } else if (zeta >= 0) {
-              l_S = KAPPA*zval/(1+2.7*zeta);
-          } else {
-              l_S = KAPPA*zval*std::pow(1.0 - 100.0 * zeta, 0.2);
-          }
 
           // Second Length Scale
           amrex::Real l_T;
-          if (qint(i,j,0,1) > 0.0) {
-              l_T = 0.23*qint(i,j,0,0)/qint(i,j,0,1);
+          if (qint_q > 0.0) {
+              l_T = 0.23*qint_zq/qint_q;
           } else {
               l_T = std::numeric_limits<amrex::Real>::max();
           }
 
-          // Third Length Scale
-          amrex::Real l_B;
-          if (dthetadz > 0) {
-              amrex::Real N_brunt_vaisala = CONST_GRAV/theta0 * std::sqrt(dthetadz);
-              if (zeta < 0) {
-                  amrex::Real qc = CONST_GRAV/theta0 * surface_heat_flux * l_T;
-                  qc = std::pow(qc,1.0/3.0);
-                  l_B = (1.0 + 5.0*std::sqrt(qc/(N_brunt_vaisala * l_T))) * qvel(i,j,k)/N_brunt_vaisala;
+          for (int k = klo; k <= khi; ++k) {
+              const amrex::Real rho  = cell_data(i,j,k,Rho_comp);
+              const amrex::Real qvel = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / rho);
+              // We will divide by qvel later
+              AMREX_ASSERT_WITH_MESSAGE(qvel > 0.0, "QKE must have a positive value");
+
+              // Compute some partial derivatives that we will need (1st order at domain boundary)
+              // U and V derivatives are interpolated to account for staggered grid
+              amrex::Real dthetadz, dudz, dvdz;
+              if (k == izmax) {
+                  dthetadz = (cell_data(i,j,k,RhoTheta_comp)/cell_data(i,j,k,Rho_comp) -
+                              cell_data(i,j,k-1,RhoTheta_comp)/cell_data(i,j,k-1,Rho_comp))*dz_inv;
+                  dudz = 0.5*(uvel(i,j,k) - uvel(i,j,k-1) + uvel(i+1,j,k) - uvel(i+1,j,k-1))*dz_inv;
+                  dvdz = 0.5*(vvel(i,j,k) - vvel(i,j,k-1) + vvel(i,j+1,k) - vvel(i,j+1,k-1))*dz_inv;
+              } else if (k == izmin){
+                  dthetadz = (cell_data(i,j,k+1,RhoTheta_comp)/cell_data(i,j,k+1,Rho_comp) -
+                              cell_data(i,j,k,RhoTheta_comp)/cell_data(i,j,k,Rho_comp))*dz_inv;
+                  dudz = 0.5*(uvel(i,j,k+1) - uvel(i,j,k) + uvel(i+1,j,k+1) - uvel(i+1,j,k))*dz_inv;
+                  dvdz = 0.5*(vvel(i,j,k+1) - vvel(i,j,k) + vvel(i,j+1,k+1) - vvel(i,j+1,k))*dz_inv;
               } else {
-                  l_B = qvel(i,j,k) / N_brunt_vaisala;
+                  dthetadz = 0.5*(cell_data(i,j,k+1,RhoTheta_comp)/cell_data(i,j,k+1,Rho_comp) -
+                                  cell_data(i,j,k-1,RhoTheta_comp)/cell_data(i,j,k-1,Rho_comp))*dz_inv;
+                  dudz = 0.25*(uvel(i,j,k+1) - uvel(i,j,k-1) + uvel(i+1,j,k+1) - uvel(i+1,j,k-1))*dz_inv;
+                  dvdz = 0.25*(vvel(i,j,k+1) - vvel(i,j,k-1) + vvel(i,j+1,k+1) - vvel(i,j+1,k-1))*dz_inv;
+              }
+
+              // First Length Scale
+              const amrex::Real zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
+              const amrex::Real zeta = zval/l_obukhov;
+              amrex::Real l_S;
+              if (zeta >= 1.0) {
+                  l_S = KAPPA*zval/3.7;
+              } else if (zeta >= 0) {
+                  l_S = KAPPA*zval/(1+2.7*zeta);
+              } else {
+                  l_S = KAPPA*zval*std::pow(1.0 - 100.0 * zeta, 0.2);
+              }
+
+              // Third Length Scale
+              amrex::Real l_B;
+              if (dthetadz > 0) {
+                  amrex::Real N_brunt_vaisala = CONST_GRAV/theta0 * std::sqrt(dthetadz);
+                  if (zeta < 0) {
+                      amrex::Real qc = CONST_GRAV/theta0 * surface_heat_flux * l_T;
+                      qc = std::pow(qc,1.0/3.0);
+                      l_B = (1.0 + 5.0*std::sqrt(qc/(N_brunt_vaisala * l_T))) * qvel/N_brunt_vaisala;
+                  } else {
+                      l_B = qvel / N_brunt_vaisala;
+                  }
+              } else {
+                  l_B = std::numeric_limits<amrex::Real>::max();
               }
-          } else {
-              l_B = std::numeric_limits<amrex::Real>::max();
-          }
 
-          // Overall Length Scale
-          amrex::Real l_comb = 1.0 / (1.0/l_S + 1.0/l_T + 1.0/l_B);
-
-          // Compute non-dimensional parameters
-          amrex::Real l2_over_q2 = l_comb*l_comb/(qvel(i,j,k)*qvel(i,j,k));
-          amrex::Real GM = l2_over_q2 * (dudz*dudz + dvdz*dvdz);
-          amrex::Real GH = -l2_over_q2 / theta0 * dthetadz;
-          amrex::Real E1 = 1.0 + 6.0*A1*A1*GM - 9.0*A1*A2*(1.0-C2)*GH;
-          amrex::Real E2 = -3.0*A1*(4.0*A1 + 3.0*A2*(1.0-C5))*(1.0-C2)*GH;
-          amrex::Real E3 = 6.0*A2*A1*GM;
-          amrex::Real E4 = 1.0 - 12.0*A2*A1*(1.0-C2)*GH -3.0*A2*B2*(1.0-C3)*GH;
-          amrex::Real R1 = A1*(1.0-3.0*C1);
-
-          amrex::Real SM = (A2*E2 - R1*E4)/(E2*E3 - E1*E4);
-          amrex::Real SH = (R1*E3 - A2*E1)/(E2*E3 - E1*E4);
-          amrex::Real SQ = 3.0 * SM;
-
-          // Finally, compute the eddy viscosity/diffusivities
-          const amrex::Real rho = cell_data(i,j,k,Rho_comp);
-          K_turb(i,j,k,EddyDiff::Mom_v)   = rho * l_comb * qvel(i,j,k) * SM * 0.5;
-          K_turb(i,j,k,EddyDiff::Theta_v) = rho * l_comb * qvel(i,j,k) * SH;
-          K_turb(i,j,k,EddyDiff::QKE_v)   = rho * l_comb * qvel(i,j,k) * 3.0 * SQ;
-
-          K_turb(i,j,k,EddyDiff::PBL_lengthscale) = l_comb;
-          // TODO: How should this be done for other components (scalars, moisture)
+              // Overall Length Scale
+              amrex::Real l_comb = 1.0 / (1.0/l_S + 1.0/l_T + 1.0/l_B);
+
+              // Compute non-dimensional parameters
+              amrex::Real l2_over_q2 = l_comb*l_comb/(qvel*qvel);
+              amrex::Real GM = l2_over_q2 * (dudz*dudz + dvdz*dvdz);
+              amrex::Real GH = -l2_over_q2 / theta0 * dthetadz;
+              amrex::Real E1 = 1.0 + 6.0*A1*A1*GM - 9.0*A1*A2*(1.0-C2)*GH;
+              amrex::Real E2 = -3.0*A1*(4.0*A1 + 3.0*A2*(1.0-C5))*(1.0-C2)*GH;
+              amrex::Real E3 = 6.0*A2*A1*GM;
+              amrex::Real E4 = 1.0 - 12.0*A2*A1*(1.0-C2)*GH -3.0*A2*B2*(1.0-C3)*GH;
+              amrex::Real R1 = A1*(1.0-3.0*C1);
+
+              amrex::Real SM = (A2*E2 - R1*E4)/(E2*E3 - E1*E4);
+              amrex::Real SH = (R1*E3 - A2*E1)/(E2*E3 - E1*E4);
+              amrex::Real SQ = 3.0 * SM;
+
+              // Finally, compute the eddy viscosity/diffusivities
+              K_turb(i,j,k,EddyDiff::Mom_v)   = rho * l_comb * qvel * SM * 0.5;
+              K_turb(i,j,k,EddyDiff::Theta_v) = rho * l_comb * qvel * SH;
+              K_turb(i,j,k,EddyDiff::QKE_v)   = rho * l_comb * qvel * 3.0 * SQ;
+
+              K_turb(i,j,k,EddyDiff::PBL_lengthscale) = l_comb;
+              // TODO: How should this be done for other components (scalars, moisture)
+          }
       });
     }
   }
@@ -0,0 +1,89 @@
+#include <EOS.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+using namespace amrex;
+
+bool erf_eos_strict = false;
+
+void
+CheckEOSPow ()
+{
+    BL_PROFILE("CheckEOSPow()");
+
+    // Logarithmically spaced bases in [1e-3,1e7]: the arguments of the EOS are near 1,
+    //    but p^(1/Gamma) and p_0^(R_d/Cp_d) are taken of pressures up to ~1e7
+    const int npts = 1 << 20;
+    Vector<Real> x(npts), y_fast(npts), y_std(npts), y_eos(npts);
+    for (int n = 0; n < npts; ++n) {
+        x[n] = std::pow(Real(10.0), Real(-3.0) + Real(10.0) * Real(n) / Real(npts-1));
+    }
+
+    const Real rdOcp = R_d / Cp_d;
+    const Real exponents[] = {Gamma, iGamma, rdOcp, Gamma * rdOcp, Gamma - 1.0};
+
+    Real max_rel_err = 0.0;
+    bool bitwise_equal = true;
+    bool eos_bitwise_equal = true;
+    double time_fast = 0.0;
+    double time_std  = 0.0;
+
+    for (const Real a : exponents) {
+        // The polynomial path, whatever erf.eos_strict says
+        double t0 = amrex::second();
+        for (int n = 0; n < npts; ++n) {
+#ifdef ERF_EOS_POW_IS_FAST
+            y_fast[n] = erf_fast_eos_pow(x[n], a);
+#else
+            y_fast[n] = erf_eos_pow(x[n], a);
+#endif
+        }
+        double t1 = amrex::second();
+        for (int n = 0; n < npts; ++n) {
+            y_std[n] = std::pow(x[n], a);
+        }
+        double t2 = amrex::second();
+        time_fast += t1 - t0;
+        time_std  += t2 - t1;
+
+        // The path the equation of state takes in this run
+        for (int n = 0; n < npts; ++n) {
+            y_eos[n] = erf_eos_pow(x[n], a);
+        }
+
+        for (int n = 0; n < npts; ++n) {
+            bitwise_equal     = bitwise_equal     && (y_fast[n] == y_std[n]);
+            eos_bitwise_equal = eos_bitwise_equal && (y_eos[n]  == y_std[n]);
+            max_rel_err = amrex::max(max_rel_err, std::abs(y_fast[n] - y_std[n]) / y_std[n]);
+        }
+    }
+
+    const Real ncalls = Real(npts) * Real(sizeof(exponents) / sizeof(exponents[0]));
+    amrex::Print() << "EOS powers ("
+#ifdef ERF_EOS_POW_IS_FAST
+#ifdef ERF_FAST_EOS_LOW
+                   << "fast, low tier"
+#else
+                   << "fast, high tier"
+#endif
+#else
+                   << "std::pow"
+#endif
+                   << "): max relative error " << max_rel_err
+                   << ((bitwise_equal) ? " (bitwise identical)" : "")
+                   << ", " << 1.e9 * time_fast / ncalls << " ns per call vs "
+                   << 1.e9 * time_std  / ncalls << " ns for std::pow"
+                   << ((erf_eos_strict) ? "; the EOS uses std::pow (erf.eos_strict)" : "")
+                   << std::endl;
+
+#ifdef ERF_EOS_POW_IS_FAST
+    if (erf_eos_strict && !eos_bitwise_equal) {
+        amrex::Abort("CheckEOSPow: the EOS powers differ from std::pow with erf.eos_strict = true");
+    }
+#else
+    if (!bitwise_equal || !eos_bitwise_equal) {
+        amrex::Abort("CheckEOSPow: the EOS powers differ from std::pow in a build without USE_FAST_EOS");
+    }
+#endif
+}
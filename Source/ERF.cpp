@@ -16,6 +16,10 @@
 #include <TerrainMetrics.H>
 #include <memory>
 
+#ifdef ERF_USE_RRTMGP
+#include "Radiation.H"
+#endif
+
 #ifdef ERF_USE_MULTIBLOCK
 #include <MultiBlockContainer.H>
 #endif
@@ -36,6 +40,9 @@ amrex::Real ERF::fixed_fast_dt = -1.0;
 amrex::Real ERF::init_shrink   =  1.0;
 amrex::Real ERF::change_max    =  1.1;
 int         ERF::fixed_mri_dt_ratio = 0;
+int         ERF::overlap_dt_reduction = 0;
+int         ERF::overlap_halo_exchange = 0;
+int         ERF::aggregate_halo_exchange = 0;
 
 
 #ifdef ERF_USE_PARTICLES
@@ -53,6 +60,25 @@ int         ERF::verbose       = 0;
 int         ERF::sum_interval  = -1;
 amrex::Real ERF::sum_per       = -1.0;
 
+// Asynchronous output of the profile and time series logs
+int         ERF::async_output                = 0;
+amrex::Real ERF::async_output_flush_interval = 5.0;
+amrex::Real ERF::async_output_max_mb         = 64.0;
+
+#ifdef ERF_USE_RRTMGP
+// Radiation cadence and column batch size
+int ERF::rad_interval   = 0;
+int ERF::rad_batch_size = 1024;
+
+// Shortwave radiation and the position of the sun
+bool        ERF::rad_do_shortwave = true;
+amrex::Real ERF::rad_latitude     = 0.0;
+amrex::Real ERF::rad_longitude    = 0.0;
+amrex::Real ERF::rad_day_of_year  = 0.0;
+amrex::Real ERF::rad_utc_hour     = 0.0;
+amrex::Real ERF::rad_albedo       = 0.3;
+#endif
+
 // Native AMReX vs NetCDF
 std::string ERF::plotfile_type    = "amrex";
 
@@ -163,6 +189,16 @@ ERF::ERF ()
 
     mri_integrator_mem.resize(nlevs_max);
     physbcs.resize(nlevs_max);
+    scratch_arena.resize(nlevs_max);
+    fast_tridiag.resize(nlevs_max);
+    fast_coeffs_cache.resize(nlevs_max);
+    h_averager.resize(nlevs_max);
+    pbl_columns.resize(nlevs_max);
+
+#if defined(ERF_USE_RRTMGP)
+    rad.resize(nlevs_max);
+    qheating_rates.resize(nlevs_max);
+#endif
 
     flux_registers.resize(nlevs_max);
 
@@ -198,6 +234,9 @@ ERF::ERF ()
     // Theta prim for MOST
     Theta_prim.resize(nlevs_max);
 
+    // Measured box costs for the load balancing
+    box_cost.resize(nlevs_max);
+
     // Initialize tagging criteria for mesh refinement
     refinement_criteria_setup();
 
@@ -232,7 +271,19 @@ ERF::Evolve ()
     {
         amrex::Print() << "\nCoarse STEP " << step+1 << " starts ..." << std::endl;
 
-        ComputeDt();
+        if (overlap_dt_reduction && !input_bndry_planes) {
+            ComputeDtStart();
+
+            // Filling the level 0 ghost cells at the start of the step does not depend on dt,
+            //    so we do it while the reduction is in flight
+            FillPatch(0, cur_time, {&vars_new[0][Vars::cons], &vars_new[0][Vars::xvel],
+                                    &vars_new[0][Vars::yvel], &vars_new[0][Vars::zvel]});
+            lev0_ghosts_filled = true;
+
+            ComputeDtFinish();
+        } else {
+            ComputeDt();
+        }
 
         // Make sure we have read enough of the boundary plane data to make it through this timestep
         if (input_bndry_planes)
@@ -301,6 +352,9 @@ ERF::Evolve ()
         }
     }
 
+    // Make sure all the profile and time series output is on disk
+    log_writer.drain();
+
     BL_PROFILE_VAR_STOP(evolve);
 }
 
@@ -374,6 +428,10 @@ ERF::post_timestep (int nstep, Real time, Real dt_lev0)
         make_zcc(geom[lev],*z_phys_nd[lev],*z_phys_cc[lev]);
       }
     }
+
+    if (load_balance_int > 0 && (nstep+1) % load_balance_int == 0) {
+        LoadBalance();
+    }
 } // post_timestep
 
 // This is called from main.cpp and handles all initialization, whether from start or restart
@@ -409,14 +467,6 @@ ERF::InitData ()
         const Real time = start_time;
         InitFromScratch(time);
 
-#ifdef ERF_USE_MULTIBLOCK
-        // Multiblock: hook to set BL & comms once ba/dm are known
-        if(domain_p[0].bigEnd(0) < 500 ) {
-            m_mbc->SetBoxLists();
-            m_mbc->SetBlockCommMetaData();
-        }
-#endif
-
         if ( (init_type == "ideal" || init_type == "input_sounding") && solverChoice.use_terrain) {
             amrex::Abort("We do not currently support init_type = ideal or input_sounding with terrain");
         }
@@ -458,9 +508,9 @@ ERF::InitData ()
 #ifdef ERF_USE_PARTICLES
         // Initialize tracer particles if required
         if (use_tracer_particles) {
-            tracer_particles = std::make_unique<TerrainFittedPC>(Geom(0), dmap[0], grids[0]);
+            tracer_particles = std::make_unique<TerrainFittedPC>(GetParGDB());
 
-            tracer_particles->InitParticles(*z_phys_nd[0]);
+            tracer_particles->InitParticles(z_phys_nd);
 
             Print() << "Initialized " << tracer_particles->TotalNumberOfParticles() << " tracer particles." << std::endl;
         }
@@ -526,7 +576,8 @@ ERF::InitData ()
         // If not restarting we need to fill qmoist given qt and qp.
         if (restart_chkfile.empty()) {
             micro.Init(vars_new[lev][Vars::cons], qmoist[lev],
-                       grids_to_evolve[lev], Geom(lev), 0.0); // dummy value, not needed just to diagnose
+                       grids_to_evolve[lev], Geom(lev), 0.0, // dummy value, not needed just to diagnose
+                       h_averager[lev], t_new[lev]);
             micro.Update(vars_new[lev][Vars::cons], qmoist[lev]);
         }
     }
@@ -824,6 +875,25 @@ ERF::ReadParameters ()
         pp.query("restart_type", restart_type);
 
         pp.query("regrid_int", regrid_int);
+
+        // Measured-cost load balancing of level 0
+        pp.query("load_balance_int", load_balance_int);
+        pp.query("load_balance_threshold", load_balance_threshold);
+        pp.query("load_balance_method", load_balance_method);
+        if (load_balance_int > 0) {
+            if (load_balance_method != "knapsack" && load_balance_method != "sfc") {
+                amrex::Abort("erf.load_balance_method must be knapsack or sfc");
+            }
+#ifdef ERF_USE_MULTIBLOCK
+            // The multiblock communication patterns are built for fixed distribution mappings
+            amrex::Abort("Load balancing is not supported with multiple blocks");
+#endif
+            if (max_level > 0) {
+                amrex::Print() << "Load balancing is only done for single level runs; "
+                               << "turning off erf.load_balance_int" << std::endl;
+                load_balance_int = -1;
+            }
+        }
         pp.query("check_file", check_file);
         pp.query("check_type", check_type);
 
@@ -839,11 +909,26 @@ ERF::ReadParameters ()
         // Verbosity
         pp.query("v", verbose);
 
+        // Use std::pow in the EOS even with USE_FAST_EOS
+        pp.query("eos_strict", erf_eos_strict);
+
+        // Compare the EOS powers with std::pow (see USE_FAST_EOS)
+        bool check_eos_pow = false;
+        pp.query("check_eos_pow", check_eos_pow);
+        if (check_eos_pow) CheckEOSPow();
+
 
         // Frequency of diagnostic output
         pp.query("sum_interval", sum_interval);
         pp.query("sum_period"  , sum_per);
 
+        pp.query("async_output", async_output);
+        pp.query("async_output_flush_interval", async_output_flush_interval);
+        pp.query("async_output_max_mb", async_output_max_mb);
+        AMREX_ALWAYS_ASSERT(async_output_flush_interval > 0.0 && async_output_max_mb > 0.0);
+        log_writer.define(async_output != 0, async_output_flush_interval,
+                          static_cast<std::size_t>(async_output_max_mb * 1024.0 * 1024.0));
+
         // Time step controls
         pp.query("cfl", cfl);
         pp.query("init_shrink", init_shrink);
@@ -852,6 +937,28 @@ ERF::ReadParameters ()
         pp.query("fixed_dt", fixed_dt);
         pp.query("fixed_fast_dt", fixed_fast_dt);
         pp.query("fixed_mri_dt_ratio", fixed_mri_dt_ratio);
+        pp.query("overlap_dt_reduction", overlap_dt_reduction);
+        pp.query("overlap_halo_exchange", overlap_halo_exchange);
+        AMREX_ALWAYS_ASSERT(overlap_halo_exchange >= 0 && overlap_halo_exchange <= 2);
+        pp.query("aggregate_halo_exchange", aggregate_halo_exchange);
+
+#ifdef ERF_USE_RRTMGP
+        pp.query("rad_interval", rad_interval);
+        pp.query("rad_batch_size", rad_batch_size);
+        AMREX_ALWAYS_ASSERT(rad_batch_size > 0);
+
+        // The shortwave needs the position of the sun, which has no sensible default
+        pp.query("rad_do_shortwave", rad_do_shortwave);
+        if (rad_interval > 0 && rad_do_shortwave) {
+            if (!pp.query("rad_latitude", rad_latitude) || !pp.query("rad_day_of_year", rad_day_of_year)) {
+                amrex::Abort("erf.rad_latitude and erf.rad_day_of_year must be given for the shortwave radiation;"
+                             " set erf.rad_do_shortwave = false to run without it");
+            }
+            pp.query("rad_longitude", rad_longitude);
+            pp.query("rad_utc_hour", rad_utc_hour);
+            pp.query("rad_albedo", rad_albedo);
+        }
+#endif
 
 #ifdef ERF_USE_PARTICLES
         // Tracer particle toggle
@@ -1022,7 +1129,11 @@ ERF::MakeHorizontalAverages ()
         AverageDown();
     }
 
+#if defined(ERF_USE_MOISTURE)
     MultiFab mf(grids[lev], dmap[lev], 5, 0);
+#else
+    MultiFab mf(grids[lev], dmap[lev], 3, 0);
+#endif
 
 #if defined(ERF_USE_MOISTURE)
     MultiFab qv(qmoist[lev], make_alias, 0, 1);
@@ -1051,29 +1162,29 @@ ERF::MakeHorizontalAverages ()
         });
     }
 
-    int zdir = 2;
-    auto domain = geom[0].Domain();
+    // Average all components in one sweep with one reduction
+    Vector<HorizontalAverager::Field> fields;
+    for (int n = 0; n < mf.nComp(); ++n) fields.push_back({&mf, n});
 
-    // Sum in the horizontal plane
-    Gpu::HostVector<Real> h_avg_density     = sumToLine(mf,0,1,domain,zdir);
-    Gpu::HostVector<Real> h_avg_temperature = sumToLine(mf,1,1,domain,zdir);
-    Gpu::HostVector<Real> h_avg_pressure    = sumToLine(mf,2,1,domain,zdir);
-#ifdef ERF_USE_MOISTURE
-    Gpu::HostVector<Real> h_avg_qv          = sumToLine(mf,3,1,domain,zdir);
-    Gpu::HostVector<Real> h_avg_qc          = sumToLine(mf,4,1,domain,zdir);
-#endif
+    const auto& havg = h_averager[lev].average("havg_state", t_new[lev], geom[lev], fields);
 
-    // Divide by the total number of cells we are averaging over
-     int size_z = domain.length(zdir);
-    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-    int klen = static_cast<int>(h_avg_density.size());
-    for (int k = 0; k < klen; ++k) {
-        h_havg_density[k]     /= area_z;
-        h_havg_temperature[k] /= area_z;
-        h_havg_pressure[k]    /= area_z;
+    int size_z = havg.ncell_line;
+    int ncomp  = havg.ncomp;
+
+    h_havg_density.resize(size_z);
+    h_havg_temperature.resize(size_z);
+    h_havg_pressure.resize(size_z);
 #if defined(ERF_USE_MOISTURE)
-        h_havg_qc[k]          /= area_z;
-        h_havg_qv[k]          /= area_z;
+    h_havg_qv.resize(size_z);
+    h_havg_qc.resize(size_z);
+#endif
+    for (int k = 0; k < size_z; ++k) {
+        h_havg_density[k]     = havg.data[ncomp*k + 0];
+        h_havg_temperature[k] = havg.data[ncomp*k + 1];
+        h_havg_pressure[k]    = havg.data[ncomp*k + 2];
+#if defined(ERF_USE_MOISTURE)
+        h_havg_qv[k]          = havg.data[ncomp*k + 3];
+        h_havg_qc[k]          = havg.data[ncomp*k + 4];
 #endif
     }
 
@@ -1357,6 +1468,16 @@ ERF::ERF (const amrex::RealBox& rb, int max_level_in,
 
     mri_integrator_mem.resize(nlevs_max);
     physbcs.resize(nlevs_max);
+    scratch_arena.resize(nlevs_max);
+    fast_tridiag.resize(nlevs_max);
+    fast_coeffs_cache.resize(nlevs_max);
+    h_averager.resize(nlevs_max);
+    pbl_columns.resize(nlevs_max);
+
+#if defined(ERF_USE_RRTMGP)
+    rad.resize(nlevs_max);
+    qheating_rates.resize(nlevs_max);
+#endif
 
     // Multiblock: public domain sizes (need to know which vars are nodal)
     Box nbx;
@@ -1402,6 +1523,9 @@ ERF::ERF (const amrex::RealBox& rb, int max_level_in,
     // Theta prim for MOST
     Theta_prim.resize(nlevs_max);
 
+    // Measured box costs for the load balancing
+    box_cost.resize(nlevs_max);
+
     // Initialize tagging criteria for mesh refinement
     refinement_criteria_setup();
 
@@ -1423,76 +1547,96 @@ ERF::ERF (const amrex::RealBox& rb, int max_level_in,
 void
 ERF::Evolve_MB (int MBstep, int max_block_step)
 {
-    Real cur_time = t_new[0];
-
-    int step;
-
     // Take one coarse timestep by calling timeStep -- which recursively calls timeStep
     // for finer levels (with or without subcycling)
-    for (int Bstep(0); Bstep < max_block_step && cur_time < stop_time; ++Bstep)
+    for (int Bstep(0); Bstep < max_block_step; ++Bstep)
     {
-        step = Bstep + MBstep - 1;
+        int step = Bstep + MBstep - 1;
 
-        amrex::Print() << "\nCoarse STEP " << step+1 << " starts ..." << std::endl;
+        if (!Advance_MB(step)) break;
 
-        ComputeDt();
+        PostStep_MB(step);
 
-        // Make sure we have read enough of the boundary plane data to make it through this timestep
-        if (input_bndry_planes)
-        {
-            m_r2d->read_input_files(cur_time,dt[0],m_bc_extdir_vals);
-        }
+        if (t_new[0] >= stop_time - 1.e-6*dt[0]) break;
+    }
 
-        int lev = 0;
-        int iteration = 1;
-        timeStep(lev, cur_time, iteration);
+    FinishEvolve_MB();
+}
 
-        // DEBUG
-        // Multiblock: hook for erf2 to fill from erf1
-        if(domain_p[0].bigEnd(0) < 500) {
-            for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx)
-                m_mbc->FillPatchBlocks(var_idx,var_idx);
-        }
+// take one coarse time step of a block -- this only communicates within the ranks
+// of the current ParallelContext, so blocks on disjoint sets of ranks may call it at
+// the same time
+bool
+ERF::Advance_MB (int step)
+{
+    Real cur_time = t_new[0];
 
-        cur_time  += dt[0];
+    if (cur_time >= stop_time) return false;
 
-        amrex::Print() << "Coarse STEP " << step+1 << " ends." << " TIME = " << cur_time
-                       << " DT = " << dt[0]  << std::endl;
+    amrex::Print() << "\nCoarse STEP " << step+1 << " starts ..." << std::endl;
 
-        post_timestep(step, cur_time, dt[0]);
+    ComputeDt();
 
-        if (plot_int_1 > 0 && (step+1) % plot_int_1 == 0) {
-            last_plot_file_step_1 = step+1;
-            WritePlotFile(1,plot_var_names_1);
-        }
-        if (plot_int_2 > 0 && (step+1) % plot_int_2 == 0) {
-            last_plot_file_step_2 = step+1;
-            WritePlotFile(2,plot_var_names_2);
-        }
+    // Make sure we have read enough of the boundary plane data to make it through this timestep
+    if (input_bndry_planes)
+    {
+        m_r2d->read_input_files(cur_time,dt[0],m_bc_extdir_vals);
+    }
 
-        if (check_int > 0 && (step+1) % check_int == 0) {
-            last_check_file_step = step+1;
+    int lev = 0;
+    int iteration = 1;
+    timeStep(lev, cur_time, iteration);
+
+    cur_time  += dt[0];
+
+    amrex::Print() << "Coarse STEP " << step+1 << " ends." << " TIME = " << cur_time
+                   << " DT = " << dt[0]  << std::endl;
+
+    return true;
+}
+
+// work done by all ranks after a coarse time step of a block
+void
+ERF::PostStep_MB (int step)
+{
+    Real cur_time = t_new[0];
+
+    post_timestep(step, cur_time, dt[0]);
+
+    if (plot_int_1 > 0 && (step+1) % plot_int_1 == 0) {
+        last_plot_file_step_1 = step+1;
+        WritePlotFile(1,plot_var_names_1);
+    }
+    if (plot_int_2 > 0 && (step+1) % plot_int_2 == 0) {
+        last_plot_file_step_2 = step+1;
+        WritePlotFile(2,plot_var_names_2);
+    }
+
+    if (check_int > 0 && (step+1) % check_int == 0) {
+        last_check_file_step = step+1;
 #ifdef ERF_USE_NETCDF
-            if (check_type == "netcdf") {
-               WriteNCCheckpointFile();
-            }
+        if (check_type == "netcdf") {
+           WriteNCCheckpointFile();
+        }
 #endif
-            if (check_type == "native") {
-               WriteCheckpointFile();
-            }
+        if (check_type == "native") {
+           WriteCheckpointFile();
         }
+    }
 
 #ifdef AMREX_MEM_PROFILING
-        {
-            std::ostringstream ss;
-            ss << "[STEP " << step+1 << "]";
-            MemProfiler::report(ss.str());
-        }
-#endif
-
-        if (cur_time >= stop_time - 1.e-6*dt[0]) break;
+    {
+        std::ostringstream ss;
+        ss << "[STEP " << step+1 << "]";
+        MemProfiler::report(ss.str());
     }
+#endif
+}
 
+// output written at the end of Evolve_MB
+void
+ERF::FinishEvolve_MB ()
+{
     if (plot_int_1 > 0 && istep[0] > last_plot_file_step_1) {
         WritePlotFile(1,plot_var_names_1);
     }
@@ -1510,6 +1654,54 @@ ERF::Evolve_MB (int MBstep, int max_block_step)
            WriteCheckpointFile();
         }
     }
+}
 
+// place the grids of this block on a contiguous range of the global ranks
+void
+ERF::SetBlockRanks (int rank_lo, int nranks)
+{
+    AMREX_ALWAYS_ASSERT(rank_lo >= 0 && rank_lo + nranks <= ParallelDescriptor::NProcs());
+
+    if (nranks < ParallelDescriptor::NProcs()) {
+        // The boundary planes are read with collective I/O over all ranks
+        if (input_bndry_planes) {
+            amrex::Abort("Blocks on a subset of the ranks cannot read boundary planes");
+        }
+        // The grids are only known to the ranks of the block after a regrid
+        if (regrid_int > 0) {
+            amrex::Abort("Blocks on a subset of the ranks cannot regrid");
+        }
+    }
+
+    m_block_rank_lo = rank_lo;
+    m_block_nranks  = nranks;
+}
+
+// after a step taken by the ranks of this block only, bring the other ranks up to date
+void
+ERF::BroadcastBlockTimes (int root)
+{
+    const int nlevs = istep.size();
+    ParallelDescriptor::Bcast(istep.data()       , nlevs, root);
+    ParallelDescriptor::Bcast(t_new.data()       , nlevs, root);
+    ParallelDescriptor::Bcast(t_old.data()       , nlevs, root);
+    ParallelDescriptor::Bcast(dt.data()          , nlevs, root);
+    ParallelDescriptor::Bcast(dt_mri_ratio.data(), nlevs, root);
+}
+
+// distribute the grids over the ranks of this block only
+DistributionMapping
+ERF::MakeDistributionMap (int lev, BoxArray const& ba)
+{
+    if (m_block_nranks <= 0) {
+        return AmrCore::MakeDistributionMap(lev, ba);
+    }
+
+    DistributionMapping dm_block(ba, m_block_nranks);
+    Vector<int> pmap = dm_block.ProcessorMap();
+    for (auto& rank : pmap) {
+        rank += m_block_rank_lo;
+    }
+    return DistributionMapping(std::move(pmap));
 }
 #endif
@@ -0,0 +1,143 @@
+#include <ERF.H>
+
+using namespace amrex;
+
+/**
+ * Redistribute the boxes of level 0 over the ranks using the wall time measured on each
+ * of them since the last call (in the slow RHS, the microphysics and the particle
+ * advection).  A new distribution mapping is built with the knapsack or SFC algorithm
+ * and is only used if its efficiency (mean over max cost per rank) exceeds that of the
+ * current one by the factor load_balance_threshold.  The grids themselves do not change.
+ */
+void
+ERF::LoadBalance ()
+{
+    BL_PROFILE("ERF::LoadBalance()");
+
+    const int lev = 0;
+    if (!box_cost[lev] || finest_level > 0) return;
+
+    // Every rank needs the cost of every box
+    const int nboxes = grids[lev].size();
+    Vector<Real> cost(nboxes, 0.0);
+    for (MFIter mfi(*box_cost[lev], false); mfi.isValid(); ++mfi) {
+        cost[mfi.index()] = (*box_cost[lev])[mfi];
+        (*box_cost[lev])[mfi] = 0.0;
+    }
+    ParallelDescriptor::ReduceRealSum(cost.data(), nboxes);
+
+    // Nothing was measured, e.g. when the interval is shorter than the first step
+    Real total_cost = 0.0;
+    for (const auto& c : cost) total_cost += c;
+    if (total_cost <= 0.0) return;
+
+    Real current_eff = 0.0;
+    DistributionMapping::ComputeDistributionMappingEfficiency(dmap[lev], cost, &current_eff);
+
+    Real new_eff = 0.0;
+    DistributionMapping new_dm = (load_balance_method == "sfc")
+        ? DistributionMapping::makeSFC(cost, grids[lev], new_eff)
+        : DistributionMapping::makeKnapSack(cost, new_eff);
+
+    const bool do_remap = (new_eff > load_balance_threshold * current_eff);
+
+    if (verbose > 0) {
+        amrex::Print() << "Load balance at step " << istep[lev] << ": efficiency "
+                       << current_eff << " -> " << new_eff
+                       << ((do_remap) ? ", redistributing" : ", keeping the current mapping")
+                       << std::endl;
+    }
+
+    if (do_remap) {
+        RedistributeLevel(lev, new_dm);
+    }
+}
+
+/**
+ * Move the data of level lev, valid and ghost cells, onto the distribution mapping dm
+ * of the same grids, and rebuild everything that depends on the mapping.
+ *
+ * @param[in] lev level to redistribute
+ * @param[in] dm  new distribution mapping of grids[lev]
+ */
+void
+ERF::RedistributeLevel (int lev, const DistributionMapping& dm)
+{
+    BL_PROFILE("ERF::RedistributeLevel()");
+
+    auto redistribute = [&dm] (MultiFab& mf)
+    {
+        if (mf.empty()) return;
+        MultiFab tmp(mf.boxArray(), dm, mf.nComp(), mf.nGrowVect());
+        tmp.Redistribute(mf, 0, 0, mf.nComp(), mf.nGrowVect());
+        std::swap(mf, tmp);
+    };
+    auto redistribute_ptr = [&redistribute] (std::unique_ptr<MultiFab>& mf)
+    {
+        if (mf) redistribute(*mf);
+    };
+
+    // State and scratch space of the time integrator
+    for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx) {
+        redistribute(vars_new[lev][var_idx]);
+        redistribute(vars_old[lev][var_idx]);
+    }
+    redistribute(rU_old[lev]); redistribute(rU_new[lev]);
+    redistribute(rV_old[lev]); redistribute(rV_new[lev]);
+    redistribute(rW_old[lev]); redistribute(rW_new[lev]);
+
+#if defined(ERF_USE_MOISTURE)
+    redistribute(qmoist[lev]);
+#endif
+
+    // Stresses and turbulence quantities (kept since they may be written out)
+    for (auto* mf : {&Tau11_lev, &Tau22_lev, &Tau33_lev,
+                     &Tau12_lev, &Tau21_lev, &Tau13_lev, &Tau31_lev, &Tau23_lev, &Tau32_lev,
+                     &SFS_hfx1_lev, &SFS_hfx2_lev, &SFS_hfx3_lev, &SFS_diss_lev,
+                     &eddyDiffs_lev, &SmnSmn_lev}) {
+        redistribute_ptr((*mf)[lev]);
+    }
+
+    // Metric terms, map factors and base state
+    for (auto* mf : {&z_phys_nd, &z_phys_cc, &detJ_cc, &z_phys_nd_src, &detJ_cc_src,
+                     &z_phys_nd_new, &detJ_cc_new, &z_t_rk,
+                     &mapfac_m, &mapfac_u, &mapfac_v, &Theta_prim}) {
+        redistribute_ptr((*mf)[lev]);
+    }
+    redistribute(base_state[lev]);
+    redistribute(base_state_new[lev]);
+
+    SetDistributionMap(lev, dm);
+
+#ifdef ERF_USE_NETCDF
+    // The faces of the domain that need wrfbdy data on this rank follow its boxes;
+    //    load them now, since the ghost cells may be filled before the next step
+    if (lev == 0 && init_type == "real") {
+        wrfbdy_provider.update(t_new[0], t_new[0],
+                               {&vars_new[0][Vars::cons], &vars_new[0][Vars::xvel],
+                                &vars_new[0][Vars::yvel], &vars_new[0][Vars::zvel]});
+    }
+#endif
+
+    box_cost[lev] = std::make_unique<LayoutData<Real>>(grids[lev], dm);
+    for (MFIter mfi(*box_cost[lev], false); mfi.isValid(); ++mfi) {
+        (*box_cost[lev])[mfi] = 0.0;
+    }
+
+    // The integrator memory, the physical boundary conditions and the scratch
+    //    space are rebuilt on the new mapping
+    initialize_integrator(lev, vars_new[lev][Vars::cons], vars_new[lev][Vars::xvel]);
+
+    // The MOST averages and fluxes are moved with their values, so that their time
+    //    averages are not restarted
+    if (lev == 0 && m_most) {
+        m_most->redistribute(lev, dm);
+    }
+
+#ifdef ERF_USE_PARTICLES
+    // Move the tracer particles to the ranks now holding their boxes
+    if (use_tracer_particles) {
+        tracer_particles->Redistribute();
+    }
+#endif
+}
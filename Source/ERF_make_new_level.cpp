@@ -10,6 +10,10 @@
 #include <EOS.H>
 #include <ERF.H>
 
+#ifdef ERF_USE_RRTMGP
+#include "Radiation.H"
+#endif
+
 #include <AMReX_buildInfo.H>
 
 #include <Utils.H>
@@ -360,12 +364,28 @@ ERF::update_arrays (int lev, const BoxArray& ba, const DistributionMapping& dm)
     bool l_use_kturb   = ( (solverChoice.les_type != LESType::None)   ||
                            (solverChoice.pbl_type != PBLType::None) );
     bool l_use_ddorf   = (solverChoice.les_type == LESType::Deardorff);
+    bool l_use_fused   = solverChoice.use_fused_stress;
 
     BoxArray ba12 = convert(ba, IntVect(1,1,0));
     BoxArray ba13 = convert(ba, IntVect(1,0,1));
     BoxArray ba23 = convert(ba, IntVect(0,1,1));
 
-    if (l_use_diff) {
+    // With use_fused_stress the stress only lives in tile-local FABs, and the SFS heat
+    //    flux and dissipation are only needed by (and only computed for) Deardorff
+    if (l_use_diff && l_use_fused) {
+      Tau11_lev[lev] = nullptr; Tau22_lev[lev] = nullptr; Tau33_lev[lev] = nullptr;
+      Tau12_lev[lev] = nullptr; Tau21_lev[lev] = nullptr;
+      Tau13_lev[lev] = nullptr; Tau31_lev[lev] = nullptr;
+      Tau23_lev[lev] = nullptr; Tau32_lev[lev] = nullptr;
+      SFS_hfx1_lev[lev] = nullptr; SFS_hfx2_lev[lev] = nullptr;
+      if (l_use_ddorf) {
+          SFS_hfx3_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
+          SFS_diss_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
+      } else {
+          SFS_hfx3_lev[lev] = nullptr;
+          SFS_diss_lev[lev] = nullptr;
+      }
+    } else if (l_use_diff) {
         Tau11_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
         Tau22_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
         Tau33_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
@@ -405,6 +425,18 @@ ERF::update_arrays (int lev, const BoxArray& ba, const DistributionMapping& dm)
       eddyDiffs_lev[lev] = nullptr;
       SmnSmn_lev[lev]    = nullptr;
     }
+
+    // ********************************************************************************************
+    // Measured box costs, which start over whenever the grids change
+    // ********************************************************************************************
+    if (load_balance_int > 0) {
+        box_cost[lev] = std::make_unique<LayoutData<Real>>(ba, dm);
+        for (MFIter mfi(*box_cost[lev], false); mfi.isValid(); ++mfi) {
+            (*box_cost[lev])[mfi] = 0.0;
+        }
+    } else {
+        box_cost[lev] = nullptr;
+    }
 }
 
 void
@@ -456,6 +488,22 @@ ERF::initialize_integrator(int lev, MultiFab& cons_mf, MultiFab& vel_mf)
     mri_integrator_mem[lev]->setIncompressible(solverChoice.incompressible);
     mri_integrator_mem[lev]->setForceFirstStageSingleSubstep(solverChoice.force_stage1_single_substep);
 
+    // Any scratch space was built on the old grids
+    scratch_arena[lev].clear();
+    fast_tridiag[lev].clear();
+    fast_coeffs_cache[lev].invalidate();
+    h_averager[lev].clear();
+    pbl_columns[lev].clear();
+
+#if defined(ERF_USE_RRTMGP)
+    // Regather the radiation columns and reallocate its buffers for the new grids;
+    //    the heating rates are recomputed at the next step
+    if (rad[lev]) {
+        rad[lev]->define_columns(cons_mf, rad_batch_size);
+    }
+    qheating_rates[lev].reset();
+#endif
+
     physbcs[lev] = std::make_unique<ERFPhysBCFunct> (lev, geom[lev], domain_bcs_type, domain_bcs_type_d,
                                                      solverChoice.terrain_type, m_bc_extdir_vals, m_bc_neumann_vals,
                                                      z_phys_nd[lev], detJ_cc[lev]);
@@ -482,6 +530,15 @@ ERF::ClearLevel (int lev)
     // Clears the integrator memory
     mri_integrator_mem[lev].reset();
     physbcs[lev].reset();
+    scratch_arena[lev].clear();
+    fast_tridiag[lev].clear();
+    fast_coeffs_cache[lev].invalidate();
+    h_averager[lev].clear();
+    pbl_columns[lev].clear();
+
+#if defined(ERF_USE_RRTMGP)
+    qheating_rates[lev].reset();
+#endif
 
     grids_to_evolve[lev].clear();
 }
@@ -176,12 +176,12 @@ ERF::WriteCheckpointFile () const
 #endif
 
 #ifdef ERF_USE_NETCDF
-   // Write bdy_data files
+   // Write the bdy_data header; the data itself is read again from the wrfbdy file on restart
    if (ParallelDescriptor::IOProcessor() && (init_type == "real")) {
 
      // Vector dimensions
      int num_time = bdy_data_xlo.size();
-     int num_var  = bdy_data_xlo[0].size();
+     int num_var  = WRFBdyVars::NumTypes;
 
      // Open header file and write to it
      std::ofstream bdy_h_file(amrex::MultiFabFileFullPrefix(0, checkpointname, "Level_", "bdy_H"));
@@ -191,23 +191,6 @@ ERF::WriteCheckpointFile () const
      bdy_h_file << start_bdy_time << "\n";
      bdy_h_file << bdy_time_interval << "\n";
      bdy_h_file << wrfbdy_width << "\n";
-     for (int ivar(0); ivar<num_var; ++ivar) {
-       bdy_h_file << bdy_data_xlo[0][ivar].box() << "\n";
-       bdy_h_file << bdy_data_xhi[0][ivar].box() << "\n";
-       bdy_h_file << bdy_data_ylo[0][ivar].box() << "\n";
-       bdy_h_file << bdy_data_yhi[0][ivar].box() << "\n";
-     }
-
-     // Open data file and write to it
-     std::ofstream bdy_d_file(amrex::MultiFabFileFullPrefix(0, checkpointname, "Level_", "bdy_D"));
-     for (int itime(0); itime<num_time; ++itime) {
-       for (int ivar(0); ivar<num_var; ++ivar) {
-         bdy_data_xlo[itime][ivar].writeOn(bdy_d_file,0,1);
-         bdy_data_xhi[itime][ivar].writeOn(bdy_d_file,0,1);
-         bdy_data_ylo[itime][ivar].writeOn(bdy_d_file,0,1);
-         bdy_data_yhi[itime][ivar].writeOn(bdy_d_file,0,1);
-       }
-     }
    }
 #endif
 
@@ -374,19 +357,19 @@ ERF::ReadCheckpointFile ()
 
 #ifdef ERF_USE_PARTICLES
    if (use_tracer_particles) {
-       tracer_particles = std::make_unique<TerrainFittedPC>(Geom(0), dmap[0], grids[0]);
+       tracer_particles = std::make_unique<TerrainFittedPC>(GetParGDB());
        std::string tracer_file("tracers");
        tracer_particles->Restart(restart_chkfile, tracer_file);
    }
 #endif
 
 #ifdef ERF_USE_NETCDF
-    // Read bdy_data files
+    // Read the bdy_data header (checkpoints written before the data was read lazily also hold
+    //    the boundary data, which is not needed since it is read again from the wrfbdy file)
     if (init_type == "real") {
         int ioproc = ParallelDescriptor::IOProcessorNumber();  // I/O rank
         int num_time;
         int num_var;
-        Vector<Box> bx_v;
         if (ParallelDescriptor::IOProcessor()) {
             // Open header file and read from it
             std::ifstream bdy_h_file(amrex::MultiFabFileFullPrefix(0, restart_chkfile, "Level_", "bdy_H"));
@@ -395,42 +378,6 @@ ERF::ReadCheckpointFile ()
             bdy_h_file >> start_bdy_time;
             bdy_h_file >> bdy_time_interval;
             bdy_h_file >> wrfbdy_width;
-            bx_v.resize(4*num_var);
-            for (int ivar(0); ivar<num_var; ++ivar) {
-                bdy_h_file >> bx_v[4*ivar  ];
-                bdy_h_file >> bx_v[4*ivar+1];
-                bdy_h_file >> bx_v[4*ivar+2];
-                bdy_h_file >> bx_v[4*ivar+3];
-            }
-
-            // IO size the FABs
-            bdy_data_xlo.resize(num_time);
-            bdy_data_xhi.resize(num_time);
-            bdy_data_ylo.resize(num_time);
-            bdy_data_yhi.resize(num_time);
-            for (int itime(0); itime<num_time; ++itime) {
-                bdy_data_xlo[itime].resize(num_var);
-                bdy_data_xhi[itime].resize(num_var);
-                bdy_data_ylo[itime].resize(num_var);
-                bdy_data_yhi[itime].resize(num_var);
-                for (int ivar(0); ivar<num_var; ++ivar) {
-                    bdy_data_xlo[itime][ivar].resize(bx_v[4*ivar  ]);
-                    bdy_data_xhi[itime][ivar].resize(bx_v[4*ivar+1]);
-                    bdy_data_ylo[itime][ivar].resize(bx_v[4*ivar+2]);
-                    bdy_data_yhi[itime][ivar].resize(bx_v[4*ivar+3]);
-                }
-            }
-
-            // Open data file and read from it
-            std::ifstream bdy_d_file(amrex::MultiFabFileFullPrefix(0, restart_chkfile, "Level_", "bdy_D"));
-            for (int itime(0); itime<num_time; ++itime) {
-                for (int ivar(0); ivar<num_var; ++ivar) {
-                    bdy_data_xlo[itime][ivar].readFrom(bdy_d_file);
-                    bdy_data_xhi[itime][ivar].readFrom(bdy_d_file);
-                    bdy_data_ylo[itime][ivar].readFrom(bdy_d_file);
-                    bdy_data_yhi[itime][ivar].readFrom(bdy_d_file);
-                }
-            }
         } // IO
 
         // Broadcast the data
@@ -441,39 +388,23 @@ ERF::ReadCheckpointFile ()
         ParallelDescriptor::Bcast(&num_time,1,ioproc);
         ParallelDescriptor::Bcast(&num_var,1,ioproc);
 
-        // Everyone size their boxes
-        bx_v.resize(4*num_var);
-
-        ParallelDescriptor::Bcast(bx_v.dataPtr(),bx_v.size(),ioproc);
-
-        // Everyone but IO size their FABs
-        if (!ParallelDescriptor::IOProcessor()) {
-          bdy_data_xlo.resize(num_time);
-          bdy_data_xhi.resize(num_time);
-          bdy_data_ylo.resize(num_time);
-          bdy_data_yhi.resize(num_time);
-          for (int itime(0); itime<num_time; ++itime) {
-            bdy_data_xlo[itime].resize(num_var);
-            bdy_data_xhi[itime].resize(num_var);
-            bdy_data_ylo[itime].resize(num_var);
-            bdy_data_yhi[itime].resize(num_var);
-            for (int ivar(0); ivar<num_var; ++ivar) {
-              bdy_data_xlo[itime][ivar].resize(bx_v[4*ivar  ]);
-              bdy_data_xhi[itime][ivar].resize(bx_v[4*ivar+1]);
-              bdy_data_ylo[itime][ivar].resize(bx_v[4*ivar+2]);
-              bdy_data_yhi[itime][ivar].resize(bx_v[4*ivar+3]);
-            }
-          }
-        }
-
-        for (int itime(0); itime<num_time; ++itime) {
-            for (int ivar(0); ivar<num_var; ++ivar) {
-                ParallelDescriptor::Bcast(bdy_data_xlo[itime][ivar].dataPtr(),bdy_data_xlo[itime][ivar].box().numPts(),ioproc);
-                ParallelDescriptor::Bcast(bdy_data_xhi[itime][ivar].dataPtr(),bdy_data_xhi[itime][ivar].box().numPts(),ioproc);
-                ParallelDescriptor::Bcast(bdy_data_ylo[itime][ivar].dataPtr(),bdy_data_ylo[itime][ivar].box().numPts(),ioproc);
-                ParallelDescriptor::Bcast(bdy_data_yhi[itime][ivar].dataPtr(),bdy_data_yhi[itime][ivar].box().numPts(),ioproc);
-            }
-        }
+        // Each rank reads the time levels it needs (on the faces it needs) as the run advances
+        if (nc_bdy_file.empty())
+            amrex::Error("NetCDF boundary file name must be provided via input");
+        if (nc_init_file.empty() || nc_init_file[0].empty() || nc_init_file[0][0].empty())
+            amrex::Error("Restarting a real case needs the level 0 NetCDF init file to convert the boundary data");
+        wrfbdy_provider.define(nc_bdy_file, nc_init_file[0][0], geom[0].Domain(),
+                               bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi);
+        AMREX_ALWAYS_ASSERT(wrfbdy_provider.numTimes() == num_time);
+
+        // Read (and convert) the time levels needed at the restart time on the
+        //     faces of the domain this rank's grids need
+        wrfbdy_provider.update(t_new[0], t_new[0],
+                               {&vars_new[0][Vars::cons], &vars_new[0][Vars::xvel],
+                                &vars_new[0][Vars::yvel], &vars_new[0][Vars::zvel]});
+
+        // The rest of the initialization may write NetCDF files
+        wrfbdy_provider.wait();
     } // init real
 #endif
 }
@@ -0,0 +1,277 @@
+#include "ERF_WRFBdyProvider.H"
+#include "NCWpsFile.H"
+
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+#ifdef ERF_USE_NETCDF
+
+Real
+read_times_from_wrfbdy(const std::string& nc_bdy_file,
+                       int& ntimes, int& width, Real& start_bdy_time);
+
+void
+wrfbdy_plane_boxes(int which, const Box& domain, int width, Vector<Box>& bxs);
+
+void
+read_level_from_wrfbdy(const std::string& nc_bdy_file, int nt,
+                       const Array<int,4>& read_side,
+                       Array<Vector<std::vector<float>>,4>& raw);
+
+void
+fill_wrfbdy_fabs(int which, const Box& domain, int width,
+                 const Vector<std::vector<float>>& raw,
+                 Vector<FArrayBox>& bdy_data);
+
+void
+convert_wrfbdy_data(int which, const Box& domain, int nt,
+                    Vector<FArrayBox>& bdy_data,
+                    const FArrayBox& NC_MUB_fab,
+                    const FArrayBox& NC_MSFU_fab,
+                    const FArrayBox& NC_MSFV_fab,
+                    const FArrayBox& NC_MSFM_fab,
+                    const FArrayBox& NC_PH_fab,
+                    const FArrayBox& NC_PHB_fab,
+                    const FArrayBox& NC_C1H_fab,
+                    const FArrayBox& NC_C2H_fab,
+                    const FArrayBox& NC_RDNW_fab,
+                    const FArrayBox& NC_xvel_fab,
+                    const FArrayBox& NC_yvel_fab,
+                    const FArrayBox& NC_rho_fab,
+                    const FArrayBox& NC_rhoth_fab);
+
+void
+read_from_wrfinput(int lev, const Box& domain, const BoxList& regions, const std::string& fname,
+                   FArrayBox& NC_xvel_fab, FArrayBox& NC_yvel_fab,
+                   FArrayBox& NC_zvel_fab, FArrayBox& NC_rho_fab,
+                   FArrayBox& NC_rhop_fab, FArrayBox& NC_rhotheta_fab,
+                   FArrayBox& NC_MUB_fab ,
+                   FArrayBox& NC_MSFU_fab, FArrayBox& NC_MSFV_fab,
+                   FArrayBox& NC_MSFM_fab, FArrayBox& NC_SST_fab,
+                   FArrayBox& NC_C1H_fab , FArrayBox& NC_C2H_fab,
+                   FArrayBox& NC_RDNW_fab,
+#if defined(ERF_USE_MOISTURE)
+                   FArrayBox& NC_QVAPOR_fab,
+                   FArrayBox& NC_QCLOUD_fab,
+                   FArrayBox& NC_QRAIN_fab,
+#elif defined(ERF_USE_WARM_NO_PRECIP)
+#endif
+                   FArrayBox& NC_PH_fab  , FArrayBox& NC_PHB_fab,
+                   FArrayBox& NC_ALB_fab , FArrayBox& NC_PB_fab);
+
+void
+WRFBdyProvider::define (const std::string& bdy_file, const std::string& init_file,
+                        const Box& domain,
+                        BdyData& bdy_data_xlo, BdyData& bdy_data_xhi,
+                        BdyData& bdy_data_ylo, BdyData& bdy_data_yhi)
+{
+    wait();
+
+    m_bdy_file  = bdy_file;
+    m_init_file = init_file;
+    m_domain    = domain;
+
+    m_time_interval = read_times_from_wrfbdy(m_bdy_file, m_ntimes, m_width, m_start_time);
+
+    // Every time level has a slot, but nothing is allocated until it is needed
+    m_bdy_data = {{&bdy_data_xlo, &bdy_data_xhi, &bdy_data_ylo, &bdy_data_yhi}};
+    for (int which = 0; which < 4; which++) {
+        BdyData& bdy_data = *m_bdy_data[which];
+        bdy_data.clear();
+        bdy_data.resize(m_ntimes);
+        for (int nt = 0; nt < m_ntimes; nt++) {
+            bdy_data[nt].resize(WRFBdyVars::NumTypes);
+        }
+        m_need[which] = 0;
+        m_strip[which] = InitStrip{};
+        m_raw[which].clear();
+        m_raw_sides[which] = 0;
+    }
+    m_raw_nt = -1;
+
+    amrex::Print() << "Boundary data has " << m_ntimes << " time levels " << m_time_interval
+                   << " seconds apart; only the levels bracketing the current time are held" << std::endl;
+}
+
+int
+WRFBdyProvider::time_index (Real time) const
+{
+    Real time_since_start = (time - m_start_time) / 1.e10;
+    int n_time = static_cast<int>( time_since_start / m_time_interval);
+    return std::max(0, std::min(n_time, m_ntimes-2));
+}
+
+void
+WRFBdyProvider::set_needed_sides (const Vector<const MultiFab*>& mfs)
+{
+    // The boundary data is read up to width cells from the boundary (plus one for
+    //     the staggered velocities); anything beyond that never touches it
+    const int margin = m_width + 1;
+    const Dim3 dom_lo = lbound(m_domain);
+    const Dim3 dom_hi = ubound(m_domain);
+
+    m_need = {{0, 0, 0, 0}};
+    for (const auto* mf : mfs) {
+        if (mf == nullptr) continue;
+        for (MFIter mfi(*mf); mfi.isValid(); ++mfi) {
+            Box bx = amrex::convert(mfi.fabbox(), IntVect::TheZeroVector());
+            if (bx.smallEnd(0) <= dom_lo.x + margin) m_need[WRFBdyTypes::x_lo] = 1;
+            if (bx.bigEnd(0)   >= dom_hi.x - margin) m_need[WRFBdyTypes::x_hi] = 1;
+            if (bx.smallEnd(1) <= dom_lo.y + margin) m_need[WRFBdyTypes::y_lo] = 1;
+            if (bx.bigEnd(1)   >= dom_hi.y - margin) m_need[WRFBdyTypes::y_hi] = 1;
+        }
+    }
+}
+
+void
+WRFBdyProvider::read_init_strip (int which)
+{
+    // The conversion needs the initial data along the lateral boundaries only, so we
+    //     read just the strip of the file under the boundary planes of this face
+    Vector<Box> bxs;
+    wrfbdy_plane_boxes(which, m_domain, m_width, bxs);
+    Box strip = bxs[WRFBdyVars::T];
+    strip.minBox(amrex::convert(bxs[WRFBdyVars::U], IntVect::TheZeroVector()));
+    strip.minBox(amrex::convert(bxs[WRFBdyVars::V], IntVect::TheZeroVector()));
+    strip.grow(0,1).grow(1,1);
+
+    InitStrip& s = m_strip[which];
+    FArrayBox zvel, rhop, SST, ALB, PB;
+#if defined(ERF_USE_MOISTURE)
+    FArrayBox QVAPOR, QCLOUD, QRAIN;
+#endif
+    read_from_wrfinput(0, m_domain, BoxList(strip), m_init_file,
+                       s.xvel, s.yvel, zvel, s.rho,
+                       rhop, s.rhoth, s.MUB,
+                       s.MSFU, s.MSFV, s.MSFM,
+                       SST, s.C1H, s.C2H, s.RDNW,
+#if defined(ERF_USE_MOISTURE)
+                       QVAPOR, QCLOUD, QRAIN,
+#elif defined(ERF_USE_WARM_NO_PRECIP)
+#endif
+                       s.PH, s.PHB, ALB, PB);
+    s.is_read = true;
+}
+
+void
+WRFBdyProvider::ensure (int nt)
+{
+    if (nt < 0 || nt >= m_ntimes) return;
+
+    Array<int,4> missing{{0, 0, 0, 0}};
+    bool any_missing = false;
+    for (int which = 0; which < 4; which++) {
+        missing[which] = m_need[which] && !(*m_bdy_data[which])[nt][WRFBdyVars::U].isAllocated();
+        any_missing = any_missing || missing[which];
+    }
+    if (!any_missing) return;
+
+    BL_PROFILE("WRFBdyProvider::ensure()");
+
+    // Use what was read in the background and read the rest now
+    wait();
+    if (m_raw_nt != nt) {
+        for (int which = 0; which < 4; which++) {
+            m_raw[which].clear();
+            m_raw_sides[which] = 0;
+        }
+        m_raw_nt = nt;
+    }
+
+    Array<int,4> to_read{{0, 0, 0, 0}};
+    bool any_to_read = false;
+    for (int which = 0; which < 4; which++) {
+        to_read[which] = missing[which] && !m_raw_sides[which];
+        any_to_read = any_to_read || to_read[which];
+    }
+    if (any_to_read) {
+        Array<Vector<std::vector<float>>,4> raw;
+        read_level_from_wrfbdy(m_bdy_file, nt, to_read, raw);
+        for (int which = 0; which < 4; which++) {
+            if (to_read[which]) {
+                m_raw[which] = std::move(raw[which]);
+                m_raw_sides[which] = 1;
+            }
+        }
+    }
+
+    for (int which = 0; which < 4; which++)
+    {
+        if (!missing[which]) continue;
+
+        if (!m_strip[which].is_read) read_init_strip(which);
+
+        Vector<FArrayBox>& bdy_data = (*m_bdy_data[which])[nt];
+        fill_wrfbdy_fabs(which, m_domain, m_width, m_raw[which], bdy_data);
+
+        const InitStrip& s = m_strip[which];
+        convert_wrfbdy_data(which, m_domain, nt, bdy_data,
+                            s.MUB, s.MSFU, s.MSFV, s.MSFM,
+                            s.PH , s.PHB,
+                            s.C1H, s.C2H, s.RDNW,
+                            s.xvel, s.yvel, s.rho, s.rhoth);
+    }
+
+    // The raw data is not needed once it has been converted
+    for (int which = 0; which < 4; which++) {
+        m_raw[which].clear();
+        m_raw_sides[which] = 0;
+    }
+    m_raw_nt = -1;
+}
+
+void
+WRFBdyProvider::ensure_time (Real time)
+{
+    if (!isDefined()) return;
+    const int n_time = time_index(time);
+    ensure(n_time);
+    ensure(n_time+1);
+}
+
+void
+WRFBdyProvider::update (Real time_lo, Real time_hi, const Vector<const MultiFab*>& mfs)
+{
+    if (!isDefined()) return;
+
+    BL_PROFILE("WRFBdyProvider::update()");
+
+    set_needed_sides(mfs);
+
+    const int n_lo = time_index(time_lo);
+    const int n_hi = std::min(time_index(time_hi) + 1, m_ntimes - 1);
+
+    for (int nt = n_lo; nt <= n_hi; nt++) {
+        ensure(nt);
+    }
+
+    // Free the levels we are done with (kernels of the last step may still read them)
+    bool synced = false;
+    for (int which = 0; which < 4; which++) {
+        BdyData& bdy_data = *m_bdy_data[which];
+        for (int nt = 0; nt < m_ntimes; nt++) {
+            if (nt >= n_lo && nt <= n_hi) continue;
+            for (auto& fab : bdy_data[nt]) {
+                if (!fab.isAllocated()) continue;
+                if (!synced) {
+                    Gpu::streamSynchronize();
+                    synced = true;
+                }
+                fab.clear();
+            }
+        }
+    }
+
+    // Read the next level while the step runs
+    const int n_next = n_hi + 1;
+    if (n_next < m_ntimes && m_raw_nt != n_next) {
+        wait();
+        m_raw_nt    = n_next;
+        m_raw_sides = m_need;
+        m_prefetch  = std::async(std::launch::async, [this, n_next] () {
+            read_level_from_wrfbdy(m_bdy_file, n_next, m_raw_sides, m_raw);
+        });
+    }
+}
+#endif
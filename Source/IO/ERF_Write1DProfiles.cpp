@@ -2,6 +2,8 @@
 
 #include "ERF.H"
 #include "EOS.H"
+#include "Diffusion.H"
+#include "TileNoZ.H"
 
 using namespace amrex;
 
@@ -55,63 +57,77 @@ ERF::write_1D_profiles(Real time)
 
         auto const& dx = geom[0].CellSizeArray();
         if (amrex::ParallelDescriptor::IOProcessor()) {
+            // The formatters below capture a copy of the profiles so that the formatting
+            //    and the writes may be done by log_writer in the background
             if (NumDataLogs() > 1) {
                 std::ostream& data_log1 = DataLog(1);
                 if (data_log1.good()) {
-                  // Write the quantities at this time
-                  for (int k = 0; k < hu_size; k++) {
-                      Real z = (k + 0.5)* dx[2];
-                      data_log1 << std::setw(datwidth) << std::setprecision(timeprecision) << time << " "
-                                << std::setw(datwidth) << std::setprecision(datprecision) << z << " "
-                                << h_avg_u[k]  << " " << h_avg_v[k] << " " << h_avg_w[k] << " "
-                                << h_avg_rho[k] << " " << h_avg_th[k] << " " << h_avg_ksgs[k]
-                                << std::endl;
-                  } // loop over z
+                  std::size_t nbytes = 6 * hu_size * sizeof(Real);
+                  log_writer.submit(data_log1, nbytes, [=] (std::ostream& os)
+                  {
+                    // Write the quantities at this time
+                    for (int k = 0; k < hu_size; k++) {
+                        Real z = (k + 0.5)* dx[2];
+                        os << std::setw(datwidth) << std::setprecision(timeprecision) << time << " "
+                           << std::setw(datwidth) << std::setprecision(datprecision) << z << " "
+                           << h_avg_u[k]  << " " << h_avg_v[k] << " " << h_avg_w[k] << " "
+                           << h_avg_rho[k] << " " << h_avg_th[k] << " " << h_avg_ksgs[k]
+                           << '\n';
+                    } // loop over z
+                  });
                 } // if good
             } // NumDataLogs
 
             if (NumDataLogs() > 2) {
                 std::ostream& data_log2 = DataLog(2);
                 if (data_log2.good()) {
-                  // Write the perturbational quantities at this time
-                  for (int k = 0; k < hu_size; k++) {
-                      Real z = (k + 0.5)* dx[2];
-                      data_log2 << std::setw(datwidth) << std::setprecision(timeprecision) << time << " "
-                                << std::setw(datwidth) << std::setprecision(datprecision) << z << " "
-                                << h_avg_uu[k]   - h_avg_u[k]*h_avg_u[k]  << " "
-                                << h_avg_uv[k]   - h_avg_u[k]*h_avg_v[k]  << " "
-                                << h_avg_uw[k]   - h_avg_u[k]*h_avg_w[k]  << " "
-                                << h_avg_vv[k]   - h_avg_v[k]*h_avg_v[k]  << " "
-                                << h_avg_vw[k]   - h_avg_v[k]*h_avg_w[k]  << " "
-                                << h_avg_ww[k]   - h_avg_w[k]*h_avg_w[k]  << " "
-                                << h_avg_uth[k]  - h_avg_u[k]*h_avg_th[k] << " "
-                                << h_avg_vth[k]  - h_avg_v[k]*h_avg_th[k] << " "
-                                << h_avg_wth[k]  - h_avg_w[k]*h_avg_th[k] << " "
-                                << h_avg_thth[k] - h_avg_th[k]*h_avg_th[k] << " "
-                                << h_avg_ku[k]   - h_avg_k[k]*h_avg_u[k] << " "
-                                << h_avg_kv[k]   - h_avg_k[k]*h_avg_v[k] << " "
-                                << h_avg_kw[k]   - h_avg_k[k]*h_avg_w[k] << " "
-                                << h_avg_pu[k]   - h_avg_p[k]*h_avg_u[k] << " "
-                                << h_avg_pv[k]   - h_avg_p[k]*h_avg_v[k] << " "
-                                << h_avg_pw[k]   - h_avg_p[k]*h_avg_w[k]
-                                << std::endl;
-                  } // loop over z
+                  std::size_t nbytes = 22 * hu_size * sizeof(Real);
+                  log_writer.submit(data_log2, nbytes, [=] (std::ostream& os)
+                  {
+                    // Write the perturbational quantities at this time
+                    for (int k = 0; k < hu_size; k++) {
+                        Real z = (k + 0.5)* dx[2];
+                        os << std::setw(datwidth) << std::setprecision(timeprecision) << time << " "
+                           << std::setw(datwidth) << std::setprecision(datprecision) << z << " "
+                           << h_avg_uu[k]   - h_avg_u[k]*h_avg_u[k]  << " "
+                           << h_avg_uv[k]   - h_avg_u[k]*h_avg_v[k]  << " "
+                           << h_avg_uw[k]   - h_avg_u[k]*h_avg_w[k]  << " "
+                           << h_avg_vv[k]   - h_avg_v[k]*h_avg_v[k]  << " "
+                           << h_avg_vw[k]   - h_avg_v[k]*h_avg_w[k]  << " "
+                           << h_avg_ww[k]   - h_avg_w[k]*h_avg_w[k]  << " "
+                           << h_avg_uth[k]  - h_avg_u[k]*h_avg_th[k] << " "
+                           << h_avg_vth[k]  - h_avg_v[k]*h_avg_th[k] << " "
+                           << h_avg_wth[k]  - h_avg_w[k]*h_avg_th[k] << " "
+                           << h_avg_thth[k] - h_avg_th[k]*h_avg_th[k] << " "
+                           << h_avg_ku[k]   - h_avg_k[k]*h_avg_u[k] << " "
+                           << h_avg_kv[k]   - h_avg_k[k]*h_avg_v[k] << " "
+                           << h_avg_kw[k]   - h_avg_k[k]*h_avg_w[k] << " "
+                           << h_avg_pu[k]   - h_avg_p[k]*h_avg_u[k] << " "
+                           << h_avg_pv[k]   - h_avg_p[k]*h_avg_v[k] << " "
+                           << h_avg_pw[k]   - h_avg_p[k]*h_avg_w[k]
+                           << '\n';
+                    } // loop over z
+                  });
                 } // if good
             } // NumDataLogs
 
             if (NumDataLogs() > 3) {
                 std::ostream& data_log3 = DataLog(3);
                 if (data_log3.good()) {
-                  // Write the average stresses
-                  for (int k = 0; k < hu_size; k++) {
-                      Real z = (k + 0.5)* dx[2];
-                      data_log3 << std::setw(datwidth) << std::setprecision(timeprecision) << time << " "
-                                << std::setw(datwidth) << std::setprecision(datprecision) << z << " "
-                                << h_avg_tau11[k] << " " << h_avg_tau12[k] << " " << h_avg_tau13[k] << " "
-                                << h_avg_tau22[k] << " " << h_avg_tau23[k] << " " << h_avg_tau33[k] << " "
-                                << h_avg_sgshfx[k] << " " << h_avg_sgsdiss[k]
-                                << std::endl;
-                  } // loop over z
+                  std::size_t nbytes = 8 * hu_size * sizeof(Real);
+                  log_writer.submit(data_log3, nbytes, [=] (std::ostream& os)
+                  {
+                    // Write the average stresses
+                    for (int k = 0; k < hu_size; k++) {
+                        Real z = (k + 0.5)* dx[2];
+                        os << std::setw(datwidth) << std::setprecision(timeprecision) << time << " "
+                           << std::setw(datwidth) << std::setprecision(datprecision) << z << " "
+                           << h_avg_tau11[k] << " " << h_avg_tau12[k] << " " << h_avg_tau13[k] << " "
+                           << h_avg_tau22[k] << " " << h_avg_tau23[k] << " " << h_avg_tau33[k] << " "
+                           << h_avg_sgshfx[k] << " " << h_avg_sgsdiss[k]
+                           << '\n';
+                    } // loop over z
+                  });
                 } // if good
             } // NumDataLogs
         } // if IOProcessor
@@ -173,22 +189,6 @@ ERF::derive_diag_profiles(Gpu::HostVector<Real>& h_avg_u   , Gpu::HostVector<Rea
     average_face_to_cellcenter(mf_vels,0,
             Array<const MultiFab*,3>{&vars_new[lev][Vars::xvel],&vars_new[lev][Vars::yvel],&vars_new[lev][Vars::zvel]});
 
-    int zdir = 2;
-    auto domain = geom[0].Domain();
-
-    // Sum in the horizontal plane
-    h_avg_u  = sumToLine(mf_vels ,0,1,domain,zdir);
-    h_avg_v  = sumToLine(mf_vels ,1,1,domain,zdir);
-    h_avg_w  = sumToLine(mf_vels ,2,1,domain,zdir);
-
-    int hu_size =  h_avg_u.size();
-
-    // Divide by the total number of cells we are averaging over
-    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-    for (int k = 0; k < hu_size; ++k) {
-        h_avg_u[k] /= area_z; h_avg_v[k] /= area_z; h_avg_w[k] /= area_z;
-    }
-
     int nvars = vars_new[lev][Vars::cons].nComp();
     MultiFab mf_cons(vars_new[lev][Vars::cons], make_alias, 0, nvars);
 
@@ -250,42 +250,126 @@ ERF::derive_diag_profiles(Gpu::HostVector<Real>& h_avg_u   , Gpu::HostVector<Rea
         });
     }
 
-    h_avg_rho  = sumToLine(mf_out, 0,1,domain,zdir);
-    h_avg_th   = sumToLine(mf_out, 1,1,domain,zdir);
-    h_avg_ksgs = sumToLine(mf_out, 2,1,domain,zdir);
-    h_avg_uu   = sumToLine(mf_out, 3,1,domain,zdir);
-    h_avg_uv   = sumToLine(mf_out, 4,1,domain,zdir);
-    h_avg_uw   = sumToLine(mf_out, 5,1,domain,zdir);
-    h_avg_vv   = sumToLine(mf_out, 6,1,domain,zdir);
-    h_avg_vw   = sumToLine(mf_out, 7,1,domain,zdir);
-    h_avg_ww   = sumToLine(mf_out, 8,1,domain,zdir);
-    h_avg_uth  = sumToLine(mf_out, 9,1,domain,zdir);
-    h_avg_vth  = sumToLine(mf_out,10,1,domain,zdir);
-    h_avg_wth  = sumToLine(mf_out,11,1,domain,zdir);
-    h_avg_thth = sumToLine(mf_out,12,1,domain,zdir);
-    h_avg_k    = sumToLine(mf_out,13,1,domain,zdir);
-    h_avg_ku   = sumToLine(mf_out,14,1,domain,zdir);
-    h_avg_kv   = sumToLine(mf_out,15,1,domain,zdir);
-    h_avg_kw   = sumToLine(mf_out,16,1,domain,zdir);
-    h_avg_p    = sumToLine(mf_out,17,1,domain,zdir);
-    h_avg_pu   = sumToLine(mf_out,18,1,domain,zdir);
-    h_avg_pv   = sumToLine(mf_out,19,1,domain,zdir);
-    h_avg_pw   = sumToLine(mf_out,20,1,domain,zdir);
-
-    // Divide by the total number of cells we are averaging over
-    int h_avg_u_size = static_cast<int>(h_avg_u.size());
-    for (int k = 0; k < h_avg_u_size; ++k) {
-        h_avg_rho[k] /= area_z;  h_avg_ksgs[k] /= area_z;
-        h_avg_th[k]  /= area_z;  h_avg_thth[k] /= area_z;
-        h_avg_uu[k]  /= area_z;  h_avg_uv[k]   /= area_z;  h_avg_uw[k]  /= area_z;
-        h_avg_vv[k]  /= area_z;  h_avg_vw[k]   /= area_z;  h_avg_ww[k]  /= area_z;
-        h_avg_uth[k] /= area_z;  h_avg_vth[k]  /= area_z;  h_avg_wth[k] /= area_z;
-        h_avg_k[k]   /= area_z;
-        h_avg_ku[k]  /= area_z;  h_avg_kv[k]   /= area_z;  h_avg_kw[k]  /= area_z;
-        h_avg_p[k]   /= area_z;
-        h_avg_pu[k]  /= area_z;  h_avg_pv[k]   /= area_z;  h_avg_pw[k]  /= area_z;
+    // Average the velocities and all 21 derived quantities in one sweep with one reduction
+    Vector<HorizontalAverager::Field> fields;
+    for (int n = 0; n < AMREX_SPACEDIM; ++n) fields.push_back({&mf_vels, n});
+    for (int n = 0; n < mf_out.nComp(); ++n) fields.push_back({&mf_out, n});
+
+    const auto& havg = h_averager[lev].average("diag_profiles", t_new[lev], geom[lev], fields);
+
+    Vector<Gpu::HostVector<Real>*> h_avgs = {&h_avg_u, &h_avg_v, &h_avg_w,
+                                             &h_avg_rho, &h_avg_th, &h_avg_ksgs,
+                                             &h_avg_uu, &h_avg_uv, &h_avg_uw, &h_avg_vv, &h_avg_vw, &h_avg_ww,
+                                             &h_avg_uth, &h_avg_vth, &h_avg_wth, &h_avg_thth,
+                                             &h_avg_k, &h_avg_ku, &h_avg_kv, &h_avg_kw,
+                                             &h_avg_p, &h_avg_pu, &h_avg_pv, &h_avg_pw};
+    AMREX_ALWAYS_ASSERT(h_avgs.size() == fields.size());
+    for (int n = 0; n < static_cast<int>(h_avgs.size()); ++n) {
+        havg.line_average(n, *h_avgs[n]);
     }
 }
+/**
+ * Returns the stress components 11, 12, 13, 22, 23 and 33 on a level for output.  These
+ * are the stored Tau MultiFabs (from the last RK stage) unless use_fused_stress is set, in
+ * which case the stress only ever lives in tile-local FABs and is computed here from the
+ * current velocity, only when output is written.
+ *
+ * @param[in]  lev     level of refinement
+ * @param[out] tau_tmp storage for the stress when it is computed here
+ */
+Vector<const MultiFab*>
+ERF::stress_for_output (int lev, Vector<MultiFab>& tau_tmp)
+{
+    if (Tau11_lev[lev]) {
+        return {Tau11_lev[lev].get(), Tau12_lev[lev].get(), Tau13_lev[lev].get(),
+                Tau22_lev[lev].get(), Tau23_lev[lev].get(), Tau33_lev[lev].get()};
+    }
+
+    const BoxArray& ba = grids[lev];
+    const DistributionMapping& dm = dmap[lev];
+    tau_tmp.clear();
+    tau_tmp.emplace_back(ba                        , dm, 1, 0); // 11
+    tau_tmp.emplace_back(convert(ba,IntVect(1,1,0)), dm, 1, 0); // 12
+    tau_tmp.emplace_back(convert(ba,IntVect(1,0,1)), dm, 1, 0); // 13
+    tau_tmp.emplace_back(ba                        , dm, 1, 0); // 22
+    tau_tmp.emplace_back(convert(ba,IntVect(0,1,1)), dm, 1, 0); // 23
+    tau_tmp.emplace_back(ba                        , dm, 1, 0); // 33
+
+    Vector<const MultiFab*> tau;
+    for (auto& mf : tau_tmp) tau.push_back(&mf);
+
+    // No diffusion at all
+    if (!solverChoice.use_fused_stress) {
+        for (auto& mf : tau_tmp) mf.setVal(0.0);
+        return tau;
+    }
+
+    const bool l_use_turb = ( solverChoice.les_type == LESType::Smagorinsky ||
+                              solverChoice.les_type == LESType::Deardorff   ||
+                              solverChoice.pbl_type == PBLType::MYNN25 );
+    const Real mu_eff = 2.0 * solverChoice.dynamicViscosity;
+    const BCRec* bc_ptr_h = domain_bcs_type.data();
+    const GpuArray<Real, AMREX_SPACEDIM> dxInv = geom[lev].InvCellSizeArray();
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( MFIter mfi(tau_tmp[0],TileNoZ()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+
+        const Array4<const Real>& u = vars_new[lev][Vars::xvel].const_array(mfi);
+        const Array4<const Real>& v = vars_new[lev][Vars::yvel].const_array(mfi);
+        const Array4<const Real>& w = vars_new[lev][Vars::zvel].const_array(mfi);
+
+        const Array4<const Real>& mf_m = mapfac_m[lev]->const_array(mfi);
+        const Array4<const Real>& mf_u = mapfac_u[lev]->const_array(mfi);
+        const Array4<const Real>& mf_v = mapfac_v[lev]->const_array(mfi);
+
+        const Array4<const Real>& mu_turb = l_use_turb ? eddyDiffs_lev[lev]->const_array(mfi) : Array4<const Real>{};
+
+        FArrayBox S11,S22,S33,S12,S13,S23;
+        ComputeTileStrain_N(bx, u, v, w,
+                            S11, S22, S33, S12, S13, S23,
+                            bc_ptr_h, dxInv, mf_m, mf_u, mf_v);
+        Elixir S11_eli = S11.elixir(); Elixir S22_eli = S22.elixir(); Elixir S33_eli = S33.elixir();
+        Elixir S12_eli = S12.elixir(); Elixir S13_eli = S13.elixir(); Elixir S23_eli = S23.elixir();
+        ComputeTileStress_N(bx, mu_eff, mu_turb, u, v, w,
+                            S11, S22, S33, S12, S13, S23,
+                            dxInv, mf_m, mf_u, mf_v);
+
+        const Array4<const Real> s11 = S11.const_array(); const Array4<const Real> s22 = S22.const_array();
+        const Array4<const Real> s33 = S33.const_array(); const Array4<const Real> s12 = S12.const_array();
+        const Array4<const Real> s13 = S13.const_array(); const Array4<const Real> s23 = S23.const_array();
+
+        const Array4<Real>& tau11 = tau_tmp[0].array(mfi);
+        const Array4<Real>& tau12 = tau_tmp[1].array(mfi);
+        const Array4<Real>& tau13 = tau_tmp[2].array(mfi);
+        const Array4<Real>& tau22 = tau_tmp[3].array(mfi);
+        const Array4<Real>& tau23 = tau_tmp[4].array(mfi);
+        const Array4<Real>& tau33 = tau_tmp[5].array(mfi);
+
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            tau11(i,j,k) = s11(i,j,k);
+            tau22(i,j,k) = s22(i,j,k);
+            tau33(i,j,k) = s33(i,j,k);
+        });
+        ParallelFor(mfi.tilebox(IntVect(1,1,0)), mfi.tilebox(IntVect(1,0,1)), mfi.tilebox(IntVect(0,1,1)),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+            tau12(i,j,k) = s12(i,j,k);
+        },
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+            tau13(i,j,k) = s13(i,j,k);
+        },
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+            tau23(i,j,k) = s23(i,j,k);
+        });
+    }
+
+    return tau;
+}
+
 void
 ERF::derive_stress_profiles(Gpu::HostVector<Real>& h_avg_tau11, Gpu::HostVector<Real>& h_avg_tau12,
                             Gpu::HostVector<Real>& h_avg_tau13, Gpu::HostVector<Real>& h_avg_tau22,
@@ -297,25 +381,29 @@ ERF::derive_stress_profiles(Gpu::HostVector<Real>& h_avg_tau11, Gpu::HostVector<
     // This will hold the stress tensor components
     MultiFab mf_out(grids[lev], dmap[lev], 8, 0);
 
+    Vector<MultiFab> tau_tmp;
+    const Vector<const MultiFab*> tau = stress_for_output(lev, tau_tmp);
+
     for ( MFIter mfi(mf_out,TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
         const Box& bx = mfi.tilebox();
         const Array4<Real>& fab_arr = mf_out.array(mfi);
 
-        // NOTE: These are from the last RK stage...
-        const Array4<const Real>& tau11_arr = Tau11_lev[lev]->const_array(mfi);
-        const Array4<const Real>& tau12_arr = Tau12_lev[lev]->const_array(mfi);
-        const Array4<const Real>& tau13_arr = Tau13_lev[lev]->const_array(mfi);
-        const Array4<const Real>& tau22_arr = Tau22_lev[lev]->const_array(mfi);
-        const Array4<const Real>& tau23_arr = Tau23_lev[lev]->const_array(mfi);
-        const Array4<const Real>& tau33_arr = Tau33_lev[lev]->const_array(mfi);
+        // NOTE: These are from the last RK stage (or from the current velocity with use_fused_stress)
+        const Array4<const Real>& tau11_arr = tau[0]->const_array(mfi);
+        const Array4<const Real>& tau12_arr = tau[1]->const_array(mfi);
+        const Array4<const Real>& tau13_arr = tau[2]->const_array(mfi);
+        const Array4<const Real>& tau22_arr = tau[3]->const_array(mfi);
+        const Array4<const Real>& tau23_arr = tau[4]->const_array(mfi);
+        const Array4<const Real>& tau33_arr = tau[5]->const_array(mfi);
 
         // These should be re-calculated during ERF_slow_rhs_post
         // -- just vertical SFS kinematic heat flux for now
         //const Array4<const Real>& hfx1_arr = SFS_hfx1_lev[lev]->const_array(mfi);
         //const Array4<const Real>& hfx2_arr = SFS_hfx2_lev[lev]->const_array(mfi);
-        const Array4<const Real>& hfx3_arr = SFS_hfx3_lev[lev]->const_array(mfi);
-        const Array4<const Real>& diss_arr = SFS_diss_lev[lev]->const_array(mfi);
+        // -- only allocated for Deardorff with use_fused_stress, zero otherwise
+        const Array4<const Real>& hfx3_arr = SFS_hfx3_lev[lev] ? SFS_hfx3_lev[lev]->const_array(mfi) : Array4<const Real>{};
+        const Array4<const Real>& diss_arr = SFS_diss_lev[lev] ? SFS_diss_lev[lev]->const_array(mfi) : Array4<const Real>{};
 
         ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
         {
@@ -325,31 +413,22 @@ ERF::derive_stress_profiles(Gpu::HostVector<Real>& h_avg_tau11, Gpu::HostVector<
             fab_arr(i, j, k, 3) = tau22_arr(i,j,k);
             fab_arr(i, j, k, 4) = tau23_arr(i,j,k);
             fab_arr(i, j, k, 5) = tau33_arr(i,j,k);
-            fab_arr(i, j, k, 6) =  hfx3_arr(i,j,k);
-            fab_arr(i, j, k, 7) =  diss_arr(i,j,k);
+            fab_arr(i, j, k, 6) = (hfx3_arr) ? hfx3_arr(i,j,k) : 0.0;
+            fab_arr(i, j, k, 7) = (diss_arr) ? diss_arr(i,j,k) : 0.0;
         });
     }
 
-    int zdir = 2;
-    auto domain = geom[0].Domain();
-
-    h_avg_tau11 = sumToLine(mf_out,0,1,domain,zdir);
-    h_avg_tau12 = sumToLine(mf_out,1,1,domain,zdir);
-    h_avg_tau13 = sumToLine(mf_out,2,1,domain,zdir);
-    h_avg_tau22 = sumToLine(mf_out,3,1,domain,zdir);
-    h_avg_tau23 = sumToLine(mf_out,4,1,domain,zdir);
-    h_avg_tau33 = sumToLine(mf_out,5,1,domain,zdir);
-    h_avg_hfx3  = sumToLine(mf_out,6,1,domain,zdir);
-    h_avg_diss  = sumToLine(mf_out,7,1,domain,zdir);
-
-    int ht_size =  h_avg_tau11.size();
-
-    // Divide by the total number of cells we are averaging over
-    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-    for (int k = 0; k < ht_size; ++k) {
-        h_avg_tau11[k] /= area_z; h_avg_tau12[k] /= area_z; h_avg_tau13[k] /= area_z;
-        h_avg_tau22[k] /= area_z; h_avg_tau23[k] /= area_z; h_avg_tau33[k] /= area_z;
-        h_avg_hfx3[k] /= area_z;
-        h_avg_diss[k] /= area_z;
-    }
+    Vector<HorizontalAverager::Field> fields;
+    for (int n = 0; n < mf_out.nComp(); ++n) fields.push_back({&mf_out, n});
+
+    const auto& havg = h_averager[lev].average("stress_profiles", t_new[lev], geom[lev], fields);
+
+    havg.line_average(0, h_avg_tau11);
+    havg.line_average(1, h_avg_tau12);
+    havg.line_average(2, h_avg_tau13);
+    havg.line_average(3, h_avg_tau22);
+    havg.line_average(4, h_avg_tau23);
+    havg.line_average(5, h_avg_tau33);
+    havg.line_average(6, h_avg_hfx3);
+    havg.line_average(7, h_avg_diss);
 }
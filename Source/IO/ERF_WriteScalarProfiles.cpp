@@ -35,17 +35,14 @@ ERF::sum_integrated_quantities(Real time)
         Gpu::HostVector<Real> h_avg_tstar; h_avg_tstar.resize(1);
         Gpu::HostVector<Real> h_avg_olen; h_avg_olen.resize(1);
         if ((m_most != nullptr) && (NumDataLogs() > 0)) {
-            Box domain = geom[0].Domain();
-            int zdir = 2;
-            h_avg_ustar = sumToLine(*m_most->get_u_star(0),0,1,domain,zdir);
-            h_avg_tstar = sumToLine(*m_most->get_t_star(0),0,1,domain,zdir);
-            h_avg_olen  = sumToLine(*m_most->get_olen(0),0,1,domain,zdir);
-
-            // Divide by the total number of cells we are averaging over
-            Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-            h_avg_ustar[0] /= area_z;
-            h_avg_tstar[0] /= area_z;
-            h_avg_olen[0]  /= area_z;
+            // The surface fields live in the k = 0 plane only
+            const auto& havg = h_averager[0].average("most_surface", time, geom[0],
+                                                     {{m_most->get_u_star(0), 0},
+                                                      {m_most->get_t_star(0), 0},
+                                                      {m_most->get_olen(0)  , 0}});
+            h_avg_ustar[0] = havg.data[0];
+            h_avg_tstar[0] = havg.data[1];
+            h_avg_olen[0]  = havg.data[2];
 
         } else {
             h_avg_ustar[0] = 0.;
@@ -76,23 +73,26 @@ ERF::sum_integrated_quantities(Real time)
                 int nd = 0;
                 std::ostream& data_log1 = DataLog(nd);
                 if (data_log1.good()) {
+                  const Real ustar = h_avg_ustar[0];
+                  const Real tstar = h_avg_tstar[0];
+                  const Real olen  = h_avg_olen[0];
+                  log_writer.submit(data_log1, 3 * sizeof(Real), [=] (std::ostream& os)
+                  {
                     if (time == 0.0) {
-                        data_log1 << std::setw(datwidth) << "          time";
-                        data_log1 << std::setw(datwidth) << "          u_star";
-                        data_log1 << std::setw(datwidth) << "          t_star";
-                        data_log1 << std::setw(datwidth) << "          olen";
-                        data_log1 << std::endl;
+                        os << std::setw(datwidth) << "          time";
+                        os << std::setw(datwidth) << "          u_star";
+                        os << std::setw(datwidth) << "          t_star";
+                        os << std::setw(datwidth) << "          olen";
+                        os << '\n';
                     } // time = 0
 
-                  // Write the quantities at this time
-                  data_log1 << std::setw(datwidth) << time;
-                  data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                            << h_avg_ustar[0];
-                  data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                            << h_avg_tstar[0];
-                  data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                            << h_avg_olen[0];
-                  data_log1 << std::endl;
+                    // Write the quantities at this time
+                    os << std::setw(datwidth) << time;
+                    os << std::setw(datwidth) << std::setprecision(datprecision) << ustar;
+                    os << std::setw(datwidth) << std::setprecision(datprecision) << tstar;
+                    os << std::setw(datwidth) << std::setprecision(datprecision) << olen;
+                    os << '\n';
+                  });
                 } // if good
             } // loop over i
           } // if IOProcessor
@@ -144,12 +144,15 @@ ERF::sample_points(int lev, Real time, IntVect cell, MultiFab& mf)
 
         std::ostream& sample_log = SamplePointLog(ifile);
         if (sample_log.good()) {
-          sample_log << std::setw(datwidth) << time;
-          for (int i = 0; i < ncomp; ++i)
+          log_writer.submit(sample_log, ncomp * sizeof(Real), [=] (std::ostream& os)
           {
-              sample_log << std::setw(datwidth) << my_point[i];
-          }
-          sample_log << std::endl;
+            os << std::setw(datwidth) << time;
+            for (int i = 0; i < ncomp; ++i)
+            {
+                os << std::setw(datwidth) << my_point[i];
+            }
+            os << '\n';
+          });
         } // if good
     } // only write from processor that holds the cell
 }
@@ -185,12 +188,14 @@ ERF::sample_lines(int lev, Real time, IntVect cell, MultiFab& mf)
     int dir = 2;
     MultiFab my_line       = get_line_data(mf,              dir, cell);
     MultiFab my_line_vels  = get_line_data(mf_vels,         dir, cell);
-    MultiFab my_line_tau11 = get_line_data(*Tau11_lev[lev], dir, cell);
-    MultiFab my_line_tau12 = get_line_data(*Tau12_lev[lev], dir, cell);
-    MultiFab my_line_tau13 = get_line_data(*Tau13_lev[lev], dir, cell);
-    MultiFab my_line_tau22 = get_line_data(*Tau22_lev[lev], dir, cell);
-    MultiFab my_line_tau23 = get_line_data(*Tau23_lev[lev], dir, cell);
-    MultiFab my_line_tau33 = get_line_data(*Tau33_lev[lev], dir, cell);
+    Vector<MultiFab> tau_tmp;
+    const Vector<const MultiFab*> tau = stress_for_output(lev, tau_tmp);
+    MultiFab my_line_tau11 = get_line_data(*tau[0], dir, cell);
+    MultiFab my_line_tau12 = get_line_data(*tau[1], dir, cell);
+    MultiFab my_line_tau13 = get_line_data(*tau[2], dir, cell);
+    MultiFab my_line_tau22 = get_line_data(*tau[3], dir, cell);
+    MultiFab my_line_tau23 = get_line_data(*tau[4], dir, cell);
+    MultiFab my_line_tau33 = get_line_data(*tau[5], dir, cell);
 
     for (MFIter mfi(my_line, false); mfi.isValid(); ++mfi)
     {
@@ -198,7 +203,6 @@ ERF::sample_lines(int lev, Real time, IntVect cell, MultiFab& mf)
 
         std::ostream& sample_log = SampleLineLog(ifile);
         if (sample_log.good()) {
-          sample_log << std::setw(datwidth) << std::setprecision(datprecision) << time;
           const auto& my_line_arr = my_line[0].const_array();
           const auto& my_line_vels_arr = my_line_vels[0].const_array();
           const auto& my_line_tau11_arr = my_line_tau11[0].const_array();
@@ -212,35 +216,36 @@ ERF::sample_lines(int lev, Real time, IntVect cell, MultiFab& mf)
           const int khi = my_box.bigEnd(2);
           int i = cell[0];
           int j = cell[1];
+
+          // Snapshot the line in the order it is written so that the lines may be
+          //    reused before log_writer formats them
+          Vector<Real> my_vals;
+          my_vals.reserve((ncomp + AMREX_SPACEDIM + 6) * (khi - klo + 1));
           for (int n = 0; n < ncomp; n++) {
               for (int k = klo; k <= khi; k++) {
-                  sample_log << std::setw(datwidth) << std::setprecision(datprecision) << my_line_arr(i,j,k,n);
+                  my_vals.push_back(my_line_arr(i,j,k,n));
               }
           }
           for (int n = 0; n < AMREX_SPACEDIM; n++) {
               for (int k = klo; k <= khi; k++) {
-                  sample_log << std::setw(datwidth) << std::setprecision(datprecision) << my_line_vels_arr(i,j,k,n);
+                  my_vals.push_back(my_line_vels_arr(i,j,k,n));
               }
           }
-          for (int k = klo; k <= khi; k++) {
-              sample_log << std::setw(datwidth) << std::setprecision(datprecision) << my_line_tau11_arr(i,j,k);
-          }
-          for (int k = klo; k <= khi; k++) {
-              sample_log << std::setw(datwidth) << std::setprecision(datprecision) << my_line_tau12_arr(i,j,k);
-          }
-          for (int k = klo; k <= khi; k++) {
-              sample_log << std::setw(datwidth) << std::setprecision(datprecision) << my_line_tau13_arr(i,j,k);
-          }
-          for (int k = klo; k <= khi; k++) {
-              sample_log << std::setw(datwidth) << std::setprecision(datprecision) << my_line_tau22_arr(i,j,k);
-          }
-          for (int k = klo; k <= khi; k++) {
-              sample_log << std::setw(datwidth) << std::setprecision(datprecision) << my_line_tau23_arr(i,j,k);
-          }
-          for (int k = klo; k <= khi; k++) {
-              sample_log << std::setw(datwidth) << std::setprecision(datprecision) << my_line_tau33_arr(i,j,k);
+          for (const auto& tau_arr : {my_line_tau11_arr, my_line_tau12_arr, my_line_tau13_arr,
+                                      my_line_tau22_arr, my_line_tau23_arr, my_line_tau33_arr}) {
+              for (int k = klo; k <= khi; k++) {
+                  my_vals.push_back(tau_arr(i,j,k));
+              }
           }
-          sample_log << std::endl;
+
+          log_writer.submit(sample_log, my_vals.size() * sizeof(Real), [=] (std::ostream& os)
+          {
+            os << std::setw(datwidth) << std::setprecision(datprecision) << time;
+            for (const auto& val : my_vals) {
+                os << std::setw(datwidth) << std::setprecision(datprecision) << val;
+            }
+            os << '\n';
+          });
         } // if good
     } // mfi
 }
@@ -12,17 +12,48 @@
 
 using namespace amrex;
 
-using RARRAY = NDArray<float>;
-
-void
-fill_fab_from_arrays(int iv, Vector<RARRAY>& nc_arrays,
-                     const std::string& var_name,
-                     NC_Data_Dims_Type& NC_dim_type,
-                     FArrayBox& temp);
+/**
+ * Helper function returning the (zero-based) index space of a NetCDF variable
+ * for the first time in the file
+ *
+ * @param shape Shape of the variable in the NetCDF file
+ * @param NC_dim_type NetCDF data dimension type
+ */
+Box
+file_box_of_var (const std::vector<size_t>& shape,
+                 NC_Data_Dims_Type NC_dim_type)
+{
+    int ns1, ns2, ns3;
+    if (NC_dim_type == NC_Data_Dims_Type::Time_BT) {
+        ns1 = static_cast<int>(shape[1]);
+        ns2 = 1;
+        ns3 = 1;
+    } else if (NC_dim_type == NC_Data_Dims_Type::Time_SN_WE) {
+        ns1 = 1;
+        ns2 = static_cast<int>(shape[1]);
+        ns3 = static_cast<int>(shape[2]);
+    } else if (NC_dim_type == NC_Data_Dims_Type::Time_BT_SN_WE) {
+        ns1 = static_cast<int>(shape[1]);
+        ns2 = static_cast<int>(shape[2]);
+        ns3 = static_cast<int>(shape[3]);
+    } else {
+        amrex::Abort("Dont know this NC_Data_Dims_Type");
+    }
+    return Box(IntVect(0,0,0), IntVect(ns3-1,ns2-1,ns1-1));
+}
 
 /**
  * Function to read NetCDF variables and fill the corresponding Array4's
  *
+ * Each rank reads one hyperslab of every variable per box of the given regions, so no
+ * rank holds (or receives) the whole domain, nor the gaps between boxes that are not
+ * contiguous.  The regions restrict the horizontal extent only; the columns are always
+ * read whole.  Each FAB spans the bounding box of the hyperslabs read into it; the cells
+ * of that box that are not read are set to one so that the map factor divisions and the
+ * inversion of rho done by the callers on the whole FAB stay finite.
+ *
+ * @param domain Box of the level covered by the file (file index 0 maps to its lower corner)
+ * @param regions Parts of the level (in the index space of the level) needed on this rank
  * @param fname Name of the NetCDF file to be read
  * @param nc_var_names Variable names in the NetCDF file
  * @param NC_dim_types NetCDF data dimension types
@@ -30,123 +61,168 @@ fill_fab_from_arrays(int iv, Vector<RARRAY>& nc_arrays,
  */
 void
 BuildFABsFromNetCDFFile(const Box& domain,
+                        const BoxList& regions,
                         const std::string &fname,
                         Vector<std::string> nc_var_names,
                         Vector<enum NC_Data_Dims_Type> NC_dim_types,
                         Vector<amrex::FArrayBox*> fab_vars)
 {
-    int ioproc = ParallelDescriptor::IOProcessorNumber();  // I/O rank
-
-    amrex::Vector<RARRAY> nc_arrays(nc_var_names.size());
-
-    if (amrex::ParallelDescriptor::IOProcessor())
-    {
-        ReadNetCDFFile(fname, nc_var_names, nc_arrays);
+    BL_PROFILE("BuildFABsFromNetCDFFile()");
+
+    const Dim3 dom_lb = lbound(domain);
+    const IntVect shift(dom_lb.x,dom_lb.y,dom_lb.z);
+
+    // The regions in the index space of the file, grown by one so that variables
+    //     staggered in the file get the faces on both sides of every cell
+    BoxList file_regions;
+    for (Box bx : regions) {
+        if (!bx.ok()) continue;
+        bx.shift(-shift);
+        bx.grow(0,1).grow(1,1);
+        file_regions.push_back(bx);
     }
+    file_regions = DisjointBoxes(file_regions);
+
+    auto ncf = ncutils::NCFile::open(fname, NC_NOWRITE);
 
     for (int iv = 0; iv < nc_var_names.size(); iv++)
     {
-        amrex::FArrayBox tmp;
-        if (amrex::ParallelDescriptor::IOProcessor()) {
-            fill_fab_from_arrays(iv, nc_arrays, nc_var_names[iv], NC_dim_types[iv], tmp);
+        auto ncvar = ncf.var(nc_var_names[iv]);
+        const Box file_box = file_box_of_var(ncvar.shape(), NC_dim_types[iv]);
+
+        Vector<Box> read_boxes;
+        if (NC_dim_types[iv] == NC_Data_Dims_Type::Time_BT) {
+            read_boxes.push_back(file_box);
+        } else {
+            for (const Box& fr : file_regions) {
+                Box read_box = file_box;
+                for (int dir = 0; dir < 2; dir++) {
+                    read_box.setSmall(dir, std::max(file_box.smallEnd(dir), fr.smallEnd(dir)));
+                    read_box.setBig  (dir, std::min(file_box.bigEnd(dir)  , fr.bigEnd(dir)));
+                }
+                if (read_box.ok()) read_boxes.push_back(read_box);
+            }
+            // A rank that has no data in this file still reads a single column so that
+            //     the FABs it hands back are well defined
+            if (read_boxes.empty()) {
+                Box read_box = file_box;
+                read_box.setRange(0, file_box.smallEnd(0));
+                read_box.setRange(1, file_box.smallEnd(1));
+                read_boxes.push_back(read_box);
+            }
         }
 
-        Box box = tmp.box();
-        int ncomp = tmp.nComp();
-        ParallelDescriptor::Bcast(&box, 1, ioproc);
-        ParallelDescriptor::Bcast(&ncomp, 1, ioproc);
+        Box my_box = read_boxes[0];
+        for (const Box& rb : read_boxes) my_box.minBox(rb);
 
-        if (!amrex::ParallelDescriptor::IOProcessor()) {
+        const std::string& var_name = nc_var_names[iv];
+        if (var_name == "U" || var_name == "UU" ||
+            var_name == "MACFAC_U" || var_name == "MAPFAC_UY") my_box.setType(amrex::IndexType(IntVect(1,0,0)));
+        if (var_name == "V" || var_name == "VV" ||
+            var_name == "MACFAC_V" || var_name == "MAPFAC_VY") my_box.setType(amrex::IndexType(IntVect(0,1,0)));
+        if (var_name == "W" || var_name == "WW") my_box.setType(amrex::IndexType(IntVect(0,0,1)));
+
+        // Shift box by the domain lower corner
+        my_box.shift(shift);
+
+        amrex::FArrayBox tmp;
 #ifdef AMREX_USE_GPU
-            tmp.resize(box,ncomp, The_Pinned_Arena());
+        // Make sure tmp lives on CPU since buf lives on CPU only
+        tmp.resize(my_box,1,The_Pinned_Arena());
 #else
-            tmp.resize(box,ncomp);
+        tmp.resize(my_box,1);
 #endif
+        if (read_boxes.size() > 1) tmp.setVal<RunOn::Host>(1.0);
+        const Array4<Real> tmp_arr = tmp.array();
+
+        std::vector<float> buf;
+        for (const Box& read_box : read_boxes)
+        {
+            const int nx = read_box.length(0);
+            const int ny = read_box.length(1);
+            const int nz = read_box.length(2);
+
+            std::vector<size_t> start, count;
+            if (NC_dim_types[iv] == NC_Data_Dims_Type::Time_BT) {
+                start = {0, 0};
+                count = {1, static_cast<size_t>(nz)};
+            } else if (NC_dim_types[iv] == NC_Data_Dims_Type::Time_SN_WE) {
+                start = {0, static_cast<size_t>(read_box.smallEnd(1)), static_cast<size_t>(read_box.smallEnd(0))};
+                count = {1, static_cast<size_t>(ny), static_cast<size_t>(nx)};
+            } else {
+                start = {0, 0, static_cast<size_t>(read_box.smallEnd(1)), static_cast<size_t>(read_box.smallEnd(0))};
+                count = {1, static_cast<size_t>(nz), static_cast<size_t>(ny), static_cast<size_t>(nx)};
+            }
+
+            buf.resize(read_box.numPts());
+            ncvar.get(buf.data(), start, count);
+
+            const Dim3 lo = lbound(read_box);
+            for (int k = 0; k < nz; ++k) {
+                for (int j = 0; j < ny; ++j) {
+                    for (int i = 0; i < nx; ++i) {
+                        tmp_arr(lo.x+shift[0]+i,lo.y+shift[1]+j,lo.z+shift[2]+k) =
+                            static_cast<Real>(buf[(static_cast<Long>(k)*ny + j)*nx + i]);
+                    }
+                }
+            }
         }
 
-        ParallelDescriptor::Bcast(tmp.dataPtr(), tmp.size(), ioproc);
-
-        // Shift box by the domain lower corner
-        Box  fab_bx = tmp.box();
-        Dim3 dom_lb = lbound(domain);
-        fab_bx += IntVect(dom_lb.x,dom_lb.y,dom_lb.z);
         // fab_vars points to data on device
-        fab_vars[iv]->resize(fab_bx,1);
+        fab_vars[iv]->resize(my_box,1);
 #ifdef AMREX_USE_GPU
         Gpu::copy(Gpu::hostToDevice, tmp.dataPtr(), tmp.dataPtr() + tmp.size(), fab_vars[iv]->dataPtr());
 #else
         // Provided by BaseFab inheritance through FArrayBox
-        fab_vars[iv]->copy(tmp,tmp.box(),0,fab_bx,0,1);
+        fab_vars[iv]->copy(tmp,my_box,0,my_box,0,1);
 #endif
     }
+    ncf.close();
 }
 
 /**
- * Helper function for reading data from NetCDF file into a
- * provided FAB.
+ * Helper function returning boxes that cover the same cells as the given ones without
+ * overlapping, with contiguous boxes merged where they line up
  *
- * @param iv Index for which variable we are going to fill
- * @param nc_arrays Arrays of data from NetCDF file
- * @param var_name Variable name
- * @param NC_dim_type Dimension type for the variable as stored in the NetCDF file
- * @param temp FAB where we store the variable data from the NetCDF Arrays
+ * @param bl Boxes (possibly overlapping) to cover
  */
-void
-fill_fab_from_arrays(int iv, Vector<RARRAY>& nc_arrays,
-                     const std::string& var_name,
-                     NC_Data_Dims_Type& NC_dim_type,
-                     FArrayBox& temp)
+BoxList
+DisjointBoxes (const BoxList& bl)
 {
-    int ns1, ns2, ns3;
-    if (NC_dim_type == NC_Data_Dims_Type::Time_BT) {
-        ns1 = nc_arrays[iv].get_vshape()[1];
-        ns2 = 1;
-        ns3 = 1;
-        // amrex::Print() << "TYPE BT " << ns1 << std::endl;
-    } else if (NC_dim_type == NC_Data_Dims_Type::Time_SN_WE) {
-        ns1 = 1;
-        ns2 = nc_arrays[iv].get_vshape()[1];
-        ns3 = nc_arrays[iv].get_vshape()[2];
-        // amrex::Print() << "TYPE SN WE " << ns2 << " " << ns3 << std::endl;
-    } else if (NC_dim_type == NC_Data_Dims_Type::Time_BT_SN_WE) {
-        ns1 = nc_arrays[iv].get_vshape()[1];
-        ns2 = nc_arrays[iv].get_vshape()[2];
-        ns3 = nc_arrays[iv].get_vshape()[3];
-        // amrex::Print() << "TYPE BT SN WE " << ns1 << " " << ns2 << " " << ns3 << std::endl;
-    } else {
-        amrex::Abort("Dont know this NC_Data_Dims_Type");
+    BoxList disjoint;
+    for (const Box& bx : bl) {
+        BoxList pieces(bx);
+        for (const Box& done : disjoint) {
+            BoxList rest;
+            for (const Box& p : pieces) {
+                rest.join(amrex::boxDiff(p, done));
+            }
+            pieces = rest;
+        }
+        disjoint.join(pieces);
     }
+    disjoint.simplify();
+    return disjoint;
+}
 
-    // TODO:  The box will only start at (0,0,0) at level 0 -- we need to generalize this
-    Box my_box(IntVect(0,0,0), IntVect(ns3-1,ns2-1,ns1-1));
-    // amrex::Print() <<" MY BOX " << my_box << std::endl;
-
-    if (var_name == "U" || var_name == "UU" ||
-        var_name == "MACFAC_U" || var_name == "MAPFAC_UY") my_box.setType(amrex::IndexType(IntVect(1,0,0)));
-    if (var_name == "V" || var_name == "VV" ||
-        var_name == "MACFAC_V" || var_name == "MAPFAC_VY") my_box.setType(amrex::IndexType(IntVect(0,1,0)));
-    if (var_name == "W" || var_name == "WW") my_box.setType(amrex::IndexType(IntVect(0,0,1)));
-
-#ifdef AMREX_USE_GPU
-    // Make sure temp lives on CPU since nc_arrays lives on CPU only
-    temp.resize(my_box,1,The_Pinned_Arena());
-#else
-    temp.resize(my_box,1);
-#endif
-    Array4<Real> fab_arr = temp.array();
-
-    int ioff = temp.box().smallEnd()[0];
-    int joff = temp.box().smallEnd()[1];
-
-    auto num_pts = my_box.numPts();
-
-    // amrex::Print() <<" ns1 * ns2 * ns3 " << ns1 * ns2 * ns3 << std::endl;
-    // amrex::Print() <<" NUMPTS " << num_pts << std::endl;
-
-    for (int n(0); n < num_pts; ++n) {
-        int k  = n / (ns2*ns3);
-        int j  = (n - k*(ns2*ns3)) / ns3 + joff;
-        int i  = n - k*(ns2*ns3) - (j-joff) * ns3 + ioff;
-        fab_arr(i,j,k,0) = static_cast<Real>(*(nc_arrays[iv].get_data()+n));
+/**
+ * Helper function returning the cell-centered boxes of every FAB (including ghost cells)
+ * of the given MultiFabs owned by this rank; overlapping boxes are cut apart and
+ * contiguous ones merged, so each cell is covered once and no cell outside them is
+ *
+ * @param mfs MultiFabs whose local FABs the boxes must cover
+ * @param nextra Number of cells by which each FAB box is grown
+ */
+BoxList
+LocalBoxes (const Vector<const MultiFab*>& mfs, int nextra)
+{
+    BoxList bl;
+    for (const auto* mf : mfs) {
+        if (mf == nullptr) continue;
+        for (MFIter mfi(*mf); mfi.isValid(); ++mfi) {
+            Box bx = amrex::convert(mfi.fabbox(), IntVect::TheZeroVector());
+            bl.push_back(bx.grow(nextra));
+        }
     }
+    return DisjointBoxes(bl);
 }
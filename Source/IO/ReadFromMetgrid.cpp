@@ -7,6 +7,7 @@ using namespace amrex;
 void
 read_from_metgrid(int lev,
                   const Box& domain,
+                  const BoxList& regions,
                   const std::string& fname,
                   FArrayBox& NC_xvel_fab, FArrayBox& NC_yvel_fab,
                   FArrayBox& NC_temp_fab, FArrayBox& NC_rhum_fab,
@@ -35,7 +36,7 @@ read_from_metgrid(int lev,
 
     // Read the netcdf file and fill these FABs
     amrex::Print() << "Building initial FABS from file " << fname << std::endl;
-    BuildFABsFromNetCDFFile(domain, fname, NC_names, NC_dim_types, NC_fabs);
+    BuildFABsFromNetCDFFile(domain, regions, fname, NC_names, NC_dim_types, NC_fabs);
 
 
     // TODO: FIND OUT IF WE NEED TO DIVIDE VELS BY MAPFAC
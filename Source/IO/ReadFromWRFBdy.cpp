@@ -18,15 +18,6 @@ using namespace amrex;
 
 #ifdef ERF_USE_NETCDF
 
-namespace WRFBdyTypes {
-    enum {
-        x_lo,
-        x_hi,
-        y_lo,
-        y_hi
-    };
-}
-
 // Converts UTC time string to a time_t value.
 std::time_t getEpochTime(const std::string& dateTime, const std::string& dateTimeFormat)
 {
@@ -50,25 +41,26 @@ std::time_t getEpochTime(const std::string& dateTime, const std::string& dateTim
     return epoch;
 }
 
+/**
+ * Function to read the time stamps and the width of the boundary zone of a wrfbdy file
+ *
+ * Only the I/O rank opens the file; the results are broadcast to every rank.
+ *
+ * @param[in]  nc_bdy_file    name of the wrfbdy file
+ * @param[out] ntimes         number of time levels in the file
+ * @param[out] width          number of cells in the boundary zone
+ * @param[out] start_bdy_time epoch time of the first time level
+ * @return     number of seconds between the time levels
+ */
 Real
-read_from_wrfbdy(const std::string& nc_bdy_file, const Box& domain,
-                 Vector<Vector<FArrayBox>>& bdy_data_xlo,
-                 Vector<Vector<FArrayBox>>& bdy_data_xhi,
-                 Vector<Vector<FArrayBox>>& bdy_data_ylo,
-                 Vector<Vector<FArrayBox>>& bdy_data_yhi,
-                 int& width, Real& start_bdy_time)
+read_times_from_wrfbdy(const std::string& nc_bdy_file,
+                       int& ntimes, int& width, Real& start_bdy_time)
 {
-    amrex::Print() << "Loading boundary data from NetCDF file " << std::endl;
+    amrex::Print() << "Loading boundary time stamps from NetCDF file " << std::endl;
 
     int ioproc = ParallelDescriptor::IOProcessorNumber();  // I/O rank
 
-    const auto& lo = domain.loVect();
-    const auto& hi = domain.hiVect();
-
-    // *******************************************************************************
-
-    int ntimes;
-    Real timeInterval;
+    Real timeInterval = 0.;
     const std::string dateTimeFormat ="%Y-%m-%d_%H:%M:%S";
 
     if (ParallelDescriptor::IOProcessor())
@@ -102,452 +94,245 @@ read_from_wrfbdy(const std::string& nc_bdy_file, const Box& domain,
                 AMREX_ALWAYS_ASSERT(epochTimes[nt] - epochTimes[nt-1] == timeInterval);
         }
         start_bdy_time = epochTimes[0];
+
+        // Width of the boundary region (only the shape of the data is needed here)
+        auto ncf = ncutils::NCFile::open(nc_bdy_file, NC_NOWRITE);
+        std::vector<size_t> shape = ncf.var("U_BXS").shape();
+        ncf.close();
+
+        // Assert that the data has the same number of time snapshots
+        AMREX_ALWAYS_ASSERT(static_cast<int>(shape[0]) == ntimes);
+
+        width = static_cast<int>(shape[1]);
+        AMREX_ALWAYS_ASSERT(1 <= width && width <= 5);
     }
 
     ParallelDescriptor::Bcast(&start_bdy_time,1,ioproc);
     ParallelDescriptor::Bcast(&ntimes,1,ioproc);
     ParallelDescriptor::Bcast(&timeInterval,1,ioproc);
+    ParallelDescriptor::Bcast(&width,1,ioproc);
 
-    // Even though we may not read in all the variables, we need to make the arrays big enough for them (for now)
-    int nvars = WRFBdyVars::NumTypes*4;
+    // Return the number of seconds between the boundary plane data
+    return timeInterval;
+}
 
-    // Our outermost loop is time
-    bdy_data_xlo.resize(ntimes);
-    bdy_data_xhi.resize(ntimes);
-    bdy_data_ylo.resize(ntimes);
-    bdy_data_yhi.resize(ntimes);
+/**
+ * Function returning the boxes of the boundary data on one lateral face,
+ * in the order of the WRFBdyVars enum
+ *
+ * @param[in]  which face (0: lo x, 1: hi x, 2: lo y, 3: hi y)
+ * @param[in]  domain level 0 domain
+ * @param[in]  width number of cells in the boundary zone
+ * @param[out] bxs boxes of U, V, R, T, QV, MU, PC
+ */
+void
+wrfbdy_plane_boxes(int which, const Box& domain, int width, Vector<Box>& bxs)
+{
+    const auto& lo = domain.loVect();
+    const auto& hi = domain.hiVect();
 
     amrex::IntVect plo(lo);
     amrex::IntVect phi(hi);
 
-    // ******************************************************************
-    // Read the netcdf file and fill these FABs
+    Box plane_no_stag, plane_x_stag, plane_y_stag, line;
+
+    if (which == WRFBdyTypes::x_lo) {
+        plo[0] = lo[0]        ; plo[1] = lo[1]; plo[2] = lo[2];
+        phi[0] = lo[0]+width-1; phi[1] = hi[1]; phi[2] = hi[2];
+        plane_no_stag = Box(plo, phi);
+        plane_x_stag  = plane_no_stag; plane_x_stag.shiftHalf(0,-1);
+        plane_y_stag  = convert(plane_no_stag, {0, 1, 0});
+        line = Box(IntVect(lo[0], lo[1], 0), IntVect(lo[0]+width-1, hi[1], 0));
+    } else if (which == WRFBdyTypes::x_hi) {
+        plo[0] = hi[0]-width+1; plo[1] = lo[1]; plo[2] = lo[2];
+        phi[0] = hi[0]        ; phi[1] = hi[1]; phi[2] = hi[2];
+        plane_no_stag = Box(plo, phi);
+        plane_x_stag  = plane_no_stag; plane_x_stag.shiftHalf(0,1);
+        plane_y_stag  = convert(plane_no_stag, {0, 1, 0});
+        line = Box(IntVect(hi[0]-width+1, lo[1], 0), IntVect(hi[0], hi[1], 0));
+    } else if (which == WRFBdyTypes::y_lo) {
+        plo[1] = lo[1]        ; plo[0] = lo[0]; plo[2] = lo[2];
+        phi[1] = lo[1]+width-1; phi[0] = hi[0]; phi[2] = hi[2];
+        plane_no_stag = Box(plo, phi);
+        plane_x_stag  = convert(plane_no_stag, {1, 0, 0});
+        plane_y_stag  = plane_no_stag; plane_y_stag.shiftHalf(1,-1);
+        line = Box(IntVect(lo[0], lo[1], 0), IntVect(hi[0], lo[1]+width-1, 0));
+    } else {
+        plo[1] = hi[1]-width+1; plo[0] = lo[0]; plo[2] = lo[2];
+        phi[1] = hi[1]        ; phi[0] = hi[0]; phi[2] = hi[2];
+        plane_no_stag = Box(plo, phi);
+        plane_x_stag  = convert(plane_no_stag, {1, 0, 0});
+        plane_y_stag  = plane_no_stag; plane_y_stag.shiftHalf(1,1);
+        line = Box(IntVect(lo[0], hi[1]-width+1, 0), IntVect(hi[0], hi[1], 0));
+    }
+
+    bxs.resize(WRFBdyVars::NumTypes);
+    bxs[WRFBdyVars::U ] = plane_x_stag;
+    bxs[WRFBdyVars::V ] = plane_y_stag;
+    bxs[WRFBdyVars::R ] = plane_no_stag;
+    bxs[WRFBdyVars::T ] = plane_no_stag;
+    bxs[WRFBdyVars::QV] = plane_no_stag;
+    bxs[WRFBdyVars::MU] = line;
+    bxs[WRFBdyVars::PC] = line;
+}
+
+/**
+ * Function to read a single time level of the boundary data on the requested faces
+ *
+ * Every variable is read as the hyperslab [nt, 0:width, 0:nz, 0:n] of the file, so the
+ * cost is proportional to the perimeter of the domain rather than to the number of time
+ * levels.  This makes no MPI calls and touches no device memory, so it may be called
+ * from a thread other than the main one (as long as no other thread uses NetCDF).
+ *
+ * @param[in]  nc_bdy_file name of the wrfbdy file
+ * @param[in]  nt time level to read
+ * @param[in]  read_side which of the four faces to read
+ * @param[out] raw raw[which][ivar] holds the data of variable ivar on face which
+ */
+void
+read_level_from_wrfbdy(const std::string& nc_bdy_file, int nt,
+                       const Array<int,4>& read_side,
+                       Array<Vector<std::vector<float>>,4>& raw)
+{
+    BL_PROFILE("read_level_from_wrfbdy()");
+
     // NOTE: the order and number of these must match the WRFBdyVars enum!
     // WRFBdyVars:  U, V, R, T, QV, MU, PC
-    // ******************************************************************
-    Vector<std::string> nc_var_names;
+    // R is not in the file -- it is computed from MU and PH in convert_wrfbdy_data
     Vector<std::string> nc_var_prefix = {"U","V","R","T","QVAPOR","MU","PC"};
+    Vector<std::string> nc_var_suffix = {"_BXS","_BXE","_BYS","_BYE"};
 
-    for (int ip = 0; ip < nc_var_prefix.size(); ++ip)
-    {
-       nc_var_names.push_back(nc_var_prefix[ip] + "_BXS");
-       nc_var_names.push_back(nc_var_prefix[ip] + "_BXE");
-       nc_var_names.push_back(nc_var_prefix[ip] + "_BYS");
-       nc_var_names.push_back(nc_var_prefix[ip] + "_BYE");
-    }
+    auto ncf = ncutils::NCFile::open(nc_bdy_file, NC_NOWRITE);
 
-    using RARRAY = NDArray<float>;
-    amrex::Vector<RARRAY> arrays(nc_var_names.size());
-
-    if (ParallelDescriptor::IOProcessor())
+    for (int which = 0; which < 4; which++)
     {
-        ReadNetCDFFile(nc_bdy_file, nc_var_names, arrays);
+        raw[which].clear();
+        if (!read_side[which]) continue;
 
-        // Assert that the data has the same number of time snapshots
-        int itimes = static_cast<int>(arrays[0].get_vshape()[0]);
-        AMREX_ALWAYS_ASSERT(itimes == ntimes);
+        raw[which].resize(WRFBdyVars::NumTypes);
+        for (int ivar = 0; ivar < WRFBdyVars::NumTypes; ivar++)
+        {
+            if (ivar == WRFBdyVars::R) continue;
 
-        // Width of the boundary region
-        width = arrays[0].get_vshape()[1];
+            auto ncvar = ncf.var(nc_var_prefix[ivar] + nc_var_suffix[which]);
+            std::vector<size_t> count = ncvar.shape();
+            std::vector<size_t> start(count.size(), 0);
+            start[0] = static_cast<size_t>(nt);
+            count[0] = 1;
 
-        AMREX_ALWAYS_ASSERT(1 <= width && width <= 5);
-    }
-    ParallelDescriptor::Bcast(&width,1,ioproc);
-
-    // This loops over every variable on every face, so nvars should be 4 * number of "ivartype" below
-    for (int iv = 0; iv < nvars; iv++)
-    {
-        amrex::Print() << "Building FAB for the NetCDF variable : " << nc_var_names[iv] << std::endl;
-
-        int bdyVarType;
-
-        std::string first1 = nc_var_names[iv].substr(0,1);
-        std::string first2 = nc_var_names[iv].substr(0,2);
-
-        if        (first1 == "U") {
-            bdyVarType = WRFBdyVars::U;
-        } else if (first1 == "V") {
-            bdyVarType = WRFBdyVars::V;
-        } else if (first1 == "R") {
-            bdyVarType = WRFBdyVars::R;
-        } else if (first1 == "T") {
-            bdyVarType = WRFBdyVars::T;
-        } else if (first2 == "QV") {
-            bdyVarType = WRFBdyVars::QV;
-        } else if (first2 == "MU") {
-            bdyVarType = WRFBdyVars::MU;
-        } else if (first2 == "PC") {
-            bdyVarType = WRFBdyVars::PC;
-        } else {
-            amrex::Print() << "Trying to read " << first1 << " or " << first2 << std::endl;
-            amrex::Abort("dont know this variable");
-        }
+            size_t npts = 1;
+            for (const auto& n : count) npts *= n;
 
-        std::string  last3 = nc_var_names[iv].substr(nc_var_names[iv].size()-3, 3);
-        int bdyType;
-
-        if        (last3 == "BXS") {
-            bdyType = WRFBdyTypes::x_lo;
-        } else if (last3 == "BXE") {
-            bdyType = WRFBdyTypes::x_hi;
-        } else if (last3 == "BYS") {
-            bdyType = WRFBdyTypes::y_lo;
-        } else if (last3 == "BYE") {
-            bdyType = WRFBdyTypes::y_hi;
+            raw[which][ivar].resize(npts);
+            ncvar.get(raw[which][ivar].data(), start, count);
         }
+    }
+    ncf.close();
+}
 
-        Box y_line_no_stag(IntVect(lo[0], 0, 0), IntVect(hi[0], 0, 0));
-
-        if (bdyType == WRFBdyTypes::x_lo) {
-
-                // *******************************************************************************
-                // xlo bdy
-                // *******************************************************************************
-                plo[0] = lo[0]        ; plo[1] = lo[1]; plo[2] = lo[2];
-                phi[0] = lo[0]+width-1; phi[1] = hi[1]; phi[2] = hi[2];
-                const Box pbx_xlo(plo, phi);
-
-                Box xlo_plane_no_stag(pbx_xlo);
-                Box xlo_plane_x_stag = pbx_xlo; xlo_plane_x_stag.shiftHalf(0,-1);
-                Box xlo_plane_y_stag = convert(pbx_xlo, {0, 1, 0});
-
-                Box xlo_line(IntVect(lo[0], lo[1], 0), IntVect(lo[0]+width-1, hi[1], 0));
-
-                if        (bdyVarType == WRFBdyVars::U) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xlo[nt].push_back(FArrayBox(xlo_plane_x_stag, 1)); // U
-                    }
-                } else if (bdyVarType == WRFBdyVars::V) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xlo[nt].push_back(FArrayBox(xlo_plane_y_stag , 1)); // V
-                    }
-                } else if (bdyVarType == WRFBdyVars::R) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xlo[nt].push_back(FArrayBox(xlo_plane_no_stag, 1)); // R
-                    }
-                } else if (bdyVarType == WRFBdyVars::T) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xlo[nt].push_back(FArrayBox(xlo_plane_no_stag, 1)); // T
-                    }
-                } else if (bdyVarType == WRFBdyVars::QV) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xlo[nt].push_back(FArrayBox(xlo_plane_no_stag, 1)); // QV
-                    }
-                } else if (bdyVarType == WRFBdyVars::MU ||
-                           bdyVarType == WRFBdyVars::PC) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xlo[nt].push_back(FArrayBox(xlo_line, 1));
-                    }
-                }
+/**
+ * Function to allocate the boundary data of one face at one time level and fill it
+ * with the data read by read_level_from_wrfbdy
+ *
+ * The data on the hi faces is stored in the file starting from the boundary,
+ * so the first index runs backwards from the end of the domain.
+ *
+ * @param[in]  which face (0: lo x, 1: hi x, 2: lo y, 3: hi y)
+ * @param[in]  domain level 0 domain
+ * @param[in]  width number of cells in the boundary zone
+ * @param[in]  raw data of this face, indexed by WRFBdyVars
+ * @param[out] bdy_data FABs of this face, indexed by WRFBdyVars
+ */
+void
+fill_wrfbdy_fabs(int which, const Box& domain, int width,
+                 const Vector<std::vector<float>>& raw,
+                 Vector<FArrayBox>& bdy_data)
+{
+    Vector<Box> bxs;
+    wrfbdy_plane_boxes(which, domain, width, bxs);
 
-            } else if (bdyType == WRFBdyTypes::x_hi) {
-
-                // *******************************************************************************
-                // xhi bdy
-                // *******************************************************************************
-                plo[0] = hi[0]-width+1; plo[1] = lo[1]; plo[2] = lo[2];
-                phi[0] = hi[0]        ; phi[1] = hi[1]; phi[2] = hi[2];
-                const Box pbx_xhi(plo, phi);
-
-                Box xhi_plane_no_stag(pbx_xhi);
-                Box xhi_plane_x_stag = pbx_xhi; xhi_plane_x_stag.shiftHalf(0,1);
-                Box xhi_plane_y_stag = convert(pbx_xhi, {0, 1, 0});
-
-                Box xhi_line(IntVect(hi[0]-width+1, lo[1], 0), IntVect(hi[0], hi[1], 0));
-
-                //amrex::Print() << "HI XBX NO STAG " << pbx_xhi << std::endl;
-                //amrex::Print() << "HI XBX  X STAG " << xhi_plane_x_stag << std::endl;
-                //amrex::Print() << "HI XBX  Y STAG " << xhi_plane_y_stag << std::endl;
-
-                if        (bdyVarType == WRFBdyVars::U) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xhi[nt].push_back(FArrayBox(xhi_plane_x_stag, 1)); // U
-                    }
-                } else if (bdyVarType == WRFBdyVars::V) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xhi[nt].push_back(FArrayBox(xhi_plane_y_stag , 1)); // V
-                    }
-                } else if (bdyVarType == WRFBdyVars::R) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xhi[nt].push_back(FArrayBox(xhi_plane_no_stag, 1)); // R
-                    }
-                } else if (bdyVarType == WRFBdyVars::T) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xhi[nt].push_back(FArrayBox(xhi_plane_no_stag, 1)); // T
-                    }
-                } else if (bdyVarType == WRFBdyVars::QV) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xhi[nt].push_back(FArrayBox(xhi_plane_no_stag, 1)); // QV
-                    }
-                } else if (bdyVarType == WRFBdyVars::MU ||
-                           bdyVarType == WRFBdyVars::PC) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_xhi[nt].push_back(FArrayBox(xhi_line, 1)); // MU
-                    }
-                }
+    bdy_data.resize(WRFBdyVars::NumTypes);
 
-            } else if (bdyType == WRFBdyTypes::y_lo) {
-
-                // *******************************************************************************
-                // ylo bdy
-                // *******************************************************************************
-                plo[1] = lo[1]        ; plo[0] = lo[0]; plo[2] = lo[2];
-                phi[1] = lo[1]+width-1; phi[0] = hi[0]; phi[2] = hi[2];
-                const Box pbx_ylo(plo, phi);
-
-                Box ylo_plane_no_stag(pbx_ylo);
-                Box ylo_plane_x_stag = convert(pbx_ylo, {1, 0, 0});
-                Box ylo_plane_y_stag = pbx_ylo; ylo_plane_y_stag.shiftHalf(1,-1);
-
-                Box ylo_line(IntVect(lo[0], lo[1], 0), IntVect(hi[0], lo[1]+width-1, 0));
-
-                if        (bdyVarType == WRFBdyVars::U) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_ylo[nt].push_back(FArrayBox(ylo_plane_x_stag , 1)); // U
-                    }
-                } else if (bdyVarType == WRFBdyVars::V) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_ylo[nt].push_back(FArrayBox(ylo_plane_y_stag, 1)); // V
-                    }
-                } else if (bdyVarType == WRFBdyVars::R) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_ylo[nt].push_back(FArrayBox(ylo_plane_no_stag, 1)); // R
-                    }
-                } else if (bdyVarType == WRFBdyVars::T) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_ylo[nt].push_back(FArrayBox(ylo_plane_no_stag, 1)); // T
-                    }
-                } else if (bdyVarType == WRFBdyVars::QV) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_ylo[nt].push_back(FArrayBox(ylo_plane_no_stag, 1)); // QV
-                    }
-                } else if (bdyVarType == WRFBdyVars::MU ||
-                           bdyVarType == WRFBdyVars::PC) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_ylo[nt].push_back(FArrayBox(ylo_line, 1)); // PC
-                    }
-                }
+    for (int ivar = 0; ivar < WRFBdyVars::NumTypes; ivar++)
+    {
+        const Box& bx = bxs[ivar];
+        bdy_data[ivar].resize(bx, 1);
 
-            } else if (bdyType == WRFBdyTypes::y_hi) {
-
-                // *******************************************************************************
-                // yhi bdy
-                // *******************************************************************************
-                plo[1] = hi[1]-width+1; plo[0] = lo[0]; plo[2] = lo[2];
-                phi[1] = hi[1]        ; phi[0] = hi[0]; phi[2] = hi[2];
-                const Box pbx_yhi(plo, phi);
-
-                Box yhi_plane_no_stag(pbx_yhi);
-                Box yhi_plane_x_stag = convert(pbx_yhi, {1, 0, 0});
-                Box yhi_plane_y_stag = pbx_yhi; yhi_plane_y_stag.shiftHalf(1,1);
-
-                Box yhi_line(IntVect(lo[0], hi[1]-width+1, 0), IntVect(hi[0], hi[1], 0));
-
-                //amrex::Print() << "HI YBX NO STAG " << pbx_yhi << std::endl;
-                //amrex::Print() << "HI YBX  X STAG " << yhi_plane_x_stag << std::endl;
-                //amrex::Print() << "HI YBX  Y STAG " << yhi_plane_y_stag << std::endl;
-
-                if        (bdyVarType == WRFBdyVars::U) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_yhi[nt].push_back(FArrayBox(yhi_plane_x_stag , 1)); // U
-                    }
-                } else if (bdyVarType == WRFBdyVars::V) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_yhi[nt].push_back(FArrayBox(yhi_plane_y_stag, 1)); // V
-                    }
-                } else if (bdyVarType == WRFBdyVars::R) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_yhi[nt].push_back(FArrayBox(yhi_plane_no_stag, 1)); // R
-                    }
-                } else if (bdyVarType == WRFBdyVars::T) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_yhi[nt].push_back(FArrayBox(yhi_plane_no_stag, 1)); // T
-                    }
-                } else if (bdyVarType == WRFBdyVars::QV) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_yhi[nt].push_back(FArrayBox(yhi_plane_no_stag, 1)); // QV
-                    }
-                } else if (bdyVarType == WRFBdyVars::MU ||
-                           bdyVarType == WRFBdyVars::PC) {
-                    for (int nt(0); nt < ntimes; ++nt) {
-                        bdy_data_yhi[nt].push_back(FArrayBox(yhi_line, 1)); // PC
-                    }
-                }
-        }
+        // R is computed from the other variables when the data is converted
+        if (ivar == WRFBdyVars::R) continue;
 
-        long num_pts;
+        AMREX_ALWAYS_ASSERT(raw[ivar].size() == static_cast<size_t>(bx.numPts()));
 
-        // Now fill the data
-        if (ParallelDescriptor::IOProcessor())
+        FArrayBox tmp;
+#ifdef AMREX_USE_GPU
+        // Make sure tmp lives on CPU since raw lives on CPU only
+        tmp.resize(bx,1,The_Pinned_Arena());
+#else
+        tmp.resize(bx,1);
+#endif
+        const Array4<Real> fab_arr = tmp.array();
+        const float* data = raw[ivar].data();
+
+        // The first index of the data in the file is the distance from the boundary
+        const bool is_x  = (which == WRFBdyTypes::x_lo || which == WRFBdyTypes::x_hi);
+        const bool is_hi = (which == WRFBdyTypes::x_hi || which == WRFBdyTypes::y_hi);
+        const int  dir   = is_x ? 0 : 1;
+        const int  off   = is_hi ? bx.bigEnd(dir) : bx.smallEnd(dir);
+        const int  sgn   = is_hi ? -1 : 1;
+
+        const Long num_pts = bx.numPts();
+        if (ivar == WRFBdyVars::MU || ivar == WRFBdyVars::PC)
         {
-            // amrex::Print() << "SHAPE0 " << arrays[iv].get_vshape()[0] << std::endl;
-            // amrex::Print() << "SHAPE1 " << arrays[iv].get_vshape()[1] << std::endl;
-            // amrex::Print() << "SHAPE2 " << arrays[iv].get_vshape()[2] << std::endl;
-            // amrex::Print() << "SHAPE3 " << arrays[iv].get_vshape()[3] << std::endl;
-
-            Array4<Real> fab_arr;
-            if (bdyVarType == WRFBdyVars::U || bdyVarType == WRFBdyVars::V ||
-                bdyVarType == WRFBdyVars::R || bdyVarType == WRFBdyVars::T ||
-                bdyVarType == WRFBdyVars::QV)
-            {
-                int ns2 = arrays[iv].get_vshape()[2];
-                int ns3 = arrays[iv].get_vshape()[3];
-
-                if (bdyType == WRFBdyTypes::x_lo) {
-                    num_pts  = bdy_data_xlo[0][bdyVarType].box().numPts();
-                    int ioff = bdy_data_xlo[0][bdyVarType].smallEnd()[0];
-                    for (int nt(0); nt < ntimes; ++nt)
-                    {
-                        fab_arr  = bdy_data_xlo[nt][bdyVarType].array();
-                        int n_off = nt * num_pts;
-                        for (int n(0); n < num_pts; ++n) {
-                            int i = n / (ns2 * ns3);
-                            int k = (n - i * (ns2 * ns3)) / ns3;
-                            int j =  n - i * (ns2 * ns3) - k * ns3;
-                            fab_arr(ioff+i, j, k, 0) = static_cast<Real>(*(arrays[iv].get_data() + n + n_off));
-                        }
-                    }
-                } else if (bdyType == WRFBdyTypes::x_hi) {
-                    num_pts  = bdy_data_xhi[0][bdyVarType].box().numPts();
-                    int ioff = bdy_data_xhi[0][bdyVarType].bigEnd()[0];
-                    for (int nt(0); nt < ntimes; ++nt)
-                    {
-                        fab_arr  = bdy_data_xhi[nt][bdyVarType].array();
-                        int n_off = nt * num_pts;
-                        for (int n(0); n < num_pts; ++n) {
-                            int i = n / (ns2 * ns3);
-                            int k = (n - i * (ns2 * ns3)) / ns3;
-                            int j =  n - i * (ns2 * ns3) - k * ns3;
-                            fab_arr(ioff-i, j, k, 0) = static_cast<Real>(*(arrays[iv].get_data() + n + n_off));
-                        }
-                    }
-                } else if (bdyType == WRFBdyTypes::y_lo) {
-                    num_pts  = bdy_data_ylo[0][bdyVarType].box().numPts();
-                    int joff = bdy_data_ylo[0][bdyVarType].smallEnd()[1];
-                    for (int nt(0); nt < ntimes; ++nt)
-                    {
-                        fab_arr  = bdy_data_ylo[nt][bdyVarType].array();
-                        int n_off = nt * num_pts;
-                        for (int n(0); n < num_pts; ++n) {
-                            int j = n / (ns2 * ns3);
-                            int k = (n - j * (ns2 * ns3)) / ns3;
-                            int i =  n - j * (ns2 * ns3) - k * ns3;
-                            fab_arr(i, joff+j, k, 0) = static_cast<Real>(*(arrays[iv].get_data() + n + n_off));
-                        }
-                    }
-                } else if (bdyType == WRFBdyTypes::y_hi) {
-                    num_pts  = bdy_data_yhi[0][bdyVarType].box().numPts();
-                    int joff = bdy_data_yhi[0][bdyVarType].bigEnd()[1];
-                    for (int nt(0); nt < ntimes; ++nt)
-                    {
-                        fab_arr  = bdy_data_yhi[nt][bdyVarType].array();
-                        int n_off = nt * num_pts;
-                        for (int n(0); n < num_pts; ++n) {
-                            int j = n / (ns2 * ns3);
-                            int k = (n - j * (ns2 * ns3)) / ns3;
-                            int i =  n - j * (ns2 * ns3) - k * ns3;
-                            fab_arr(i, joff-j, k, 0) = static_cast<Real>(*(arrays[iv].get_data() + n + n_off));
-                        }
-                    }
-                } // bdyType
-
-            } else if (bdyVarType == WRFBdyVars::MU || bdyVarType == WRFBdyVars::PC) {
-
-                if (bdyType == WRFBdyTypes::x_lo) {
-                    num_pts  = bdy_data_xlo[0][bdyVarType].box().numPts();
-                    int ioff = bdy_data_xlo[0][bdyVarType].smallEnd()[0];
-                    int ns2 = arrays[iv].get_vshape()[2];
-                    for (int nt(0); nt < ntimes; ++nt)
-                    {
-                        fab_arr  = bdy_data_xlo[nt][bdyVarType].array();
-
-                        int n_off = nt * num_pts;
-                        for (int n(0); n < num_pts; ++n) {
-                            int i = n / ns2;
-                            int j = n - i * ns2;
-                            fab_arr(ioff+i, j, 0, 0) = static_cast<Real>(*(arrays[iv].get_data() + n + n_off));
-                        }
-                    }
-                } else if (bdyType == WRFBdyTypes::x_hi) {
-                    num_pts  = bdy_data_xhi[0][bdyVarType].box().numPts();
-                    int ioff = bdy_data_xhi[0][bdyVarType].bigEnd()[0];
-                    int ns2 = arrays[iv].get_vshape()[2];
-                    for (int nt(0); nt < ntimes; ++nt)
-                    {
-                        fab_arr  = bdy_data_xhi[nt][bdyVarType].array();
-
-                        int n_off = nt * num_pts;
-                        for (int n(0); n < num_pts; ++n) {
-                            int i = n / ns2;
-                            int j = n - i * ns2;
-                            fab_arr(ioff-i, j, 0, 0) = static_cast<Real>(*(arrays[iv].get_data() + n + n_off));
-                        }
-                    }
-                } else if (bdyType == WRFBdyTypes::y_lo) {
-                    num_pts  = bdy_data_ylo[0][bdyVarType].box().numPts();
-                    int joff = bdy_data_ylo[0][bdyVarType].smallEnd()[1];
-                    int ns2 = arrays[iv].get_vshape()[2];
-                    for (int nt(0); nt < ntimes; ++nt)
-                    {
-                        fab_arr  = bdy_data_ylo[nt][bdyVarType].array();
-
-                        int n_off = nt * num_pts;
-                        for (int n(0); n < num_pts; ++n) {
-                            int j = n / ns2;
-                            int i = n - j * ns2;
-                            fab_arr(i, joff+j, 0, 0) = static_cast<Real>(*(arrays[iv].get_data() + n + n_off));
-                        }
-                    }
-                } else if (bdyType == WRFBdyTypes::y_hi) {
-                    num_pts  = bdy_data_yhi[0][bdyVarType].box().numPts();
-                    int joff = bdy_data_yhi[0][bdyVarType].bigEnd()[1];
-                    int ns2 = arrays[iv].get_vshape()[2];
-                    for (int nt(0); nt < ntimes; ++nt)
-                    {
-                        fab_arr  = bdy_data_yhi[nt][bdyVarType].array();
-
-                        int n_off = nt * num_pts;
-                        for (int n(0); n < num_pts; ++n) {
-                            int j = n / ns2;
-                            int i = n - j * ns2;
-                            fab_arr(i, joff-j, 0, 0) = static_cast<Real>(*(arrays[iv].get_data() + n + n_off));
-                        }
-                    }
+            // Lines: (width, n)
+            const int ns2 = bx.length(1-dir);
+            for (Long n(0); n < num_pts; ++n) {
+                int b = static_cast<int>(n / ns2);
+                int t = static_cast<int>(n - b * ns2) + bx.smallEnd(1-dir);
+                if (is_x) {
+                    fab_arr(off+sgn*b, t, 0, 0) = static_cast<Real>(data[n]);
+                } else {
+                    fab_arr(t, off+sgn*b, 0, 0) = static_cast<Real>(data[n]);
                 }
-            } // bdyVarType
-        } // if ParalleDescriptor::IOProcessor()
-    } // nc_var_names
-
-    // We put a barrier here so the rest of the processors wait to do anything until they have the data
-    amrex::ParallelDescriptor::Barrier();
-
-    // When an FArrayBox is built, space is allocated on every rank.  However, we only
-    //    filled the data in these FABs on the IOProcessor.  So here we broadcast
-    //    the data to every rank.
-    int n_per_time = nc_var_prefix.size();
-    for (int nt = 0; nt < ntimes; nt++)
-    {
-        for (int i = 0; i < n_per_time; i++)
+            }
+        }
+        else
         {
-            ParallelDescriptor::Bcast(bdy_data_xlo[nt][i].dataPtr(),bdy_data_xlo[nt][i].box().numPts(),ioproc);
-            ParallelDescriptor::Bcast(bdy_data_xhi[nt][i].dataPtr(),bdy_data_xhi[nt][i].box().numPts(),ioproc);
-            ParallelDescriptor::Bcast(bdy_data_ylo[nt][i].dataPtr(),bdy_data_ylo[nt][i].box().numPts(),ioproc);
-            ParallelDescriptor::Bcast(bdy_data_yhi[nt][i].dataPtr(),bdy_data_yhi[nt][i].box().numPts(),ioproc);
+            // Planes: (width, nz, n)
+            const int ns2 = bx.length(2);
+            const int ns3 = bx.length(1-dir);
+            for (Long n(0); n < num_pts; ++n) {
+                int b = static_cast<int>(n / (ns2 * ns3));
+                int k = static_cast<int>((n - b * (ns2 * ns3)) / ns3);
+                int t = static_cast<int>(n - b * (ns2 * ns3) - k * ns3) + bx.smallEnd(1-dir);
+                k += bx.smallEnd(2);
+                if (is_x) {
+                    fab_arr(off+sgn*b, t, k, 0) = static_cast<Real>(data[n]);
+                } else {
+                    fab_arr(t, off+sgn*b, k, 0) = static_cast<Real>(data[n]);
+                }
+            }
         }
-    }
-
-    // Make sure all processors know how timeInterval
-    ParallelDescriptor::Bcast(&timeInterval,1,ioproc);
 
-    // Make sure all processors know how many times are stored
-    ParallelDescriptor::Bcast(&ntimes,1,ioproc);
-
-    // Return the number of seconds between the boundary plane data
-    return timeInterval;
+#ifdef AMREX_USE_GPU
+        Gpu::copy(Gpu::hostToDevice, tmp.dataPtr(), tmp.dataPtr() + tmp.size(), bdy_data[ivar].dataPtr());
+#else
+        bdy_data[ivar].copy(tmp,bx,0,bx,0,1);
+#endif
+    }
 }
 
+/**
+ * Function to convert the boundary data of one face at one time level from the
+ * mass-coupled WRF variables to the ERF state, using the initial data read from
+ * wrfinput along that face
+ *
+ * @param[in]    which face (0: lo x, 1: hi x, 2: lo y, 3: hi y)
+ * @param[in]    domain level 0 domain
+ * @param[in]    nt time level of the data (the first one is compared with the initial data)
+ * @param[inout] bdy_data FABs of this face at this time level, indexed by WRFBdyVars
+ */
 void
-convert_wrfbdy_data(int which, const Box& domain, Vector<Vector<FArrayBox>>& bdy_data,
+convert_wrfbdy_data(int which, const Box& domain, int nt, Vector<FArrayBox>& bdy_data,
                     const FArrayBox& NC_MUB_fab,
                     const FArrayBox& NC_MSFU_fab, const FArrayBox& NC_MSFV_fab,
                     const FArrayBox& NC_MSFM_fab,
@@ -573,162 +358,158 @@ convert_wrfbdy_data(int which, const Box& domain, Vector<Vector<FArrayBox>>& bdy
     Array4<Real const> r_arr   = NC_rho_fab.const_array();
     Array4<Real const> rth_arr = NC_rhotheta_fab.const_array();
 
-    int ntimes = bdy_data.size();
-    for (int nt = 0; nt < ntimes; nt++)
-    {
-        Array4<Real> bdy_u_arr  = bdy_data[nt][WRFBdyVars::U].array();  // This is face-centered
-        Array4<Real> bdy_v_arr  = bdy_data[nt][WRFBdyVars::V].array();
-        Array4<Real> bdy_r_arr  = bdy_data[nt][WRFBdyVars::R].array();
-        Array4<Real> bdy_t_arr  = bdy_data[nt][WRFBdyVars::T].array();
-        Array4<Real> bdy_qv_arr = bdy_data[nt][WRFBdyVars::QV].array();
-        Array4<Real> mu_arr     = bdy_data[nt][WRFBdyVars::MU].array(); // This is cell-centered
-
-        int ilo  = domain.smallEnd()[0];
-        int ihi  = domain.bigEnd()[0];
-        int jlo  = domain.smallEnd()[1];
-        int jhi  = domain.bigEnd()[1];
-
-        const auto & bx_u  = bdy_data[0][WRFBdyVars::U].box();
-        amrex::ParallelFor(bx_u, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
-            Real xmu;
-            if (i == ilo) {
-                xmu  = mu_arr(i,j,0) + mub_arr(i,j,0);
-            } else if (i > ihi) {
-                xmu  = mu_arr(i-1,j,0) + mub_arr(i-1,j,0);
-            } else {
-                xmu = ( mu_arr(i,j,0) +  mu_arr(i-1,j,0)
-                      +mub_arr(i,j,0) + mub_arr(i-1,j,0)) * 0.5;
-            }
-            Real xmu_mult = c1h_arr(0,0,k) * xmu + c2h_arr(0,0,k);
-            Real new_bdy = bdy_u_arr(i,j,k) / xmu_mult;
-            bdy_u_arr(i,j,k) = new_bdy;
-        });
+    Array4<Real> bdy_u_arr  = bdy_data[WRFBdyVars::U].array();  // This is face-centered
+    Array4<Real> bdy_v_arr  = bdy_data[WRFBdyVars::V].array();
+    Array4<Real> bdy_r_arr  = bdy_data[WRFBdyVars::R].array();
+    Array4<Real> bdy_t_arr  = bdy_data[WRFBdyVars::T].array();
+    Array4<Real> bdy_qv_arr = bdy_data[WRFBdyVars::QV].array();
+    Array4<Real> mu_arr     = bdy_data[WRFBdyVars::MU].array(); // This is cell-centered
+
+    int ilo  = domain.smallEnd()[0];
+    int ihi  = domain.bigEnd()[0];
+    int jlo  = domain.smallEnd()[1];
+    int jhi  = domain.bigEnd()[1];
+
+    const auto & bx_u  = bdy_data[WRFBdyVars::U].box();
+    amrex::ParallelFor(bx_u, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+        Real xmu;
+        if (i == ilo) {
+            xmu  = mu_arr(i,j,0) + mub_arr(i,j,0);
+        } else if (i > ihi) {
+            xmu  = mu_arr(i-1,j,0) + mub_arr(i-1,j,0);
+        } else {
+            xmu = ( mu_arr(i,j,0) +  mu_arr(i-1,j,0)
+                  +mub_arr(i,j,0) + mub_arr(i-1,j,0)) * 0.5;
+        }
+        Real xmu_mult = c1h_arr(0,0,k) * xmu + c2h_arr(0,0,k);
+        Real new_bdy = bdy_u_arr(i,j,k) / xmu_mult;
+        bdy_u_arr(i,j,k) = new_bdy;
+    });
 
 #ifndef AMREX_USE_GPU
-        if (nt == 0) {
-            FArrayBox diff(bx_u,1);
-            diff.template copy<RunOn::Device>(bdy_data[0][WRFBdyVars::U]);
-            diff.template minus<RunOn::Device>(NC_xvel_fab);
-            if (which == 0)
-                amrex::Print() << "Max norm of diff between initial U and bdy U on lo x face: " << diff.norm(0) << std::endl;
-            if (which == 1)
-                amrex::Print() << "Max norm of diff between initial U and bdy U on hi x face: " << diff.norm(0) << std::endl;
-            if (which == 2)
-                amrex::Print() << "Max norm of diff between initial U and bdy U on lo y face: " << diff.norm(0) << std::endl;
-            if (which == 3)
-                amrex::Print() << "Max norm of diff between initial U and bdy U on hi y face: " << diff.norm(0) << std::endl;
-        }
+    if (nt == 0) {
+        FArrayBox diff(bx_u,1);
+        diff.template copy<RunOn::Device>(bdy_data[WRFBdyVars::U]);
+        diff.template minus<RunOn::Device>(NC_xvel_fab);
+        if (which == 0)
+            amrex::Print() << "Max norm of diff between initial U and bdy U on lo x face: " << diff.norm(0) << std::endl;
+        if (which == 1)
+            amrex::Print() << "Max norm of diff between initial U and bdy U on hi x face: " << diff.norm(0) << std::endl;
+        if (which == 2)
+            amrex::Print() << "Max norm of diff between initial U and bdy U on lo y face: " << diff.norm(0) << std::endl;
+        if (which == 3)
+            amrex::Print() << "Max norm of diff between initial U and bdy U on hi y face: " << diff.norm(0) << std::endl;
+    }
 #endif
 
-        const auto & bx_v  = bdy_data[0][WRFBdyVars::V].box();
-        amrex::ParallelFor(bx_v, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
-            Real xmu;
-            if (j == jlo) {
-                xmu  = mu_arr(i,j,0) + mub_arr(i,j,0);
-            } else if (j > jhi) {
-                xmu  = mu_arr(i,j-1,0) + mub_arr(i,j-1,0);
-            } else {
-                xmu =  ( mu_arr(i,j,0) +  mu_arr(i,j-1,0)
-                       +mub_arr(i,j,0) + mub_arr(i,j-1,0) ) * 0.5;
-            }
-            Real xmu_mult = c1h_arr(0,0,k) * xmu + c2h_arr(0,0,k);
-            Real new_bdy = bdy_v_arr(i,j,k) / xmu_mult;
-            bdy_v_arr(i,j,k) = new_bdy;
-        });
+    const auto & bx_v  = bdy_data[WRFBdyVars::V].box();
+    amrex::ParallelFor(bx_v, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+        Real xmu;
+        if (j == jlo) {
+            xmu  = mu_arr(i,j,0) + mub_arr(i,j,0);
+        } else if (j > jhi) {
+            xmu  = mu_arr(i,j-1,0) + mub_arr(i,j-1,0);
+        } else {
+            xmu =  ( mu_arr(i,j,0) +  mu_arr(i,j-1,0)
+                   +mub_arr(i,j,0) + mub_arr(i,j-1,0) ) * 0.5;
+        }
+        Real xmu_mult = c1h_arr(0,0,k) * xmu + c2h_arr(0,0,k);
+        Real new_bdy = bdy_v_arr(i,j,k) / xmu_mult;
+        bdy_v_arr(i,j,k) = new_bdy;
+    });
 
 #ifndef AMREX_USE_GPU
-        if (nt == 0) {
-            FArrayBox diff(bx_v,1);
-            diff.template copy<RunOn::Device>(bdy_data[0][WRFBdyVars::V]);
-            diff.template minus<RunOn::Device>(NC_yvel_fab);
-            if (which == 0)
-                amrex::Print() << "Max norm of diff between initial V and bdy V on lo x face: " << diff.norm(0) << std::endl;
-            if (which == 1)
-                amrex::Print() << "Max norm of diff between initial V and bdy V on hi x face: " << diff.norm(0) << std::endl;
-            if (which == 2)
-                amrex::Print() << "Max norm of diff between initial V and bdy V on lo y face: " << diff.norm(0) << std::endl;
-            if (which == 3)
-                amrex::Print() << "Max norm of diff between initial V and bdy V on hi y face: " << diff.norm(0) << std::endl;
-        }
+    if (nt == 0) {
+        FArrayBox diff(bx_v,1);
+        diff.template copy<RunOn::Device>(bdy_data[WRFBdyVars::V]);
+        diff.template minus<RunOn::Device>(NC_yvel_fab);
+        if (which == 0)
+            amrex::Print() << "Max norm of diff between initial V and bdy V on lo x face: " << diff.norm(0) << std::endl;
+        if (which == 1)
+            amrex::Print() << "Max norm of diff between initial V and bdy V on hi x face: " << diff.norm(0) << std::endl;
+        if (which == 2)
+            amrex::Print() << "Max norm of diff between initial V and bdy V on lo y face: " << diff.norm(0) << std::endl;
+        if (which == 3)
+            amrex::Print() << "Max norm of diff between initial V and bdy V on hi y face: " << diff.norm(0) << std::endl;
+    }
 #endif
 
-        const auto & bx_t = bdy_data[0][WRFBdyVars::T].box(); // Note this is currently "THM" aka the perturbational moist pot. temp.
+    const auto & bx_t = bdy_data[WRFBdyVars::T].box(); // Note this is currently "THM" aka the perturbational moist pot. temp.
 
-        // Define density
-        amrex::ParallelFor(bx_t, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+    // Define density
+    amrex::ParallelFor(bx_t, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
 
-            Real xmu = c1h_arr(0,0,k) * (mu_arr(i,j,0) + mub_arr(i,j,0)) + c2h_arr(0,0,k);
+        Real xmu = c1h_arr(0,0,k) * (mu_arr(i,j,0) + mub_arr(i,j,0)) + c2h_arr(0,0,k);
 
-            Real dpht =  (ph_arr(i,j,k+1) + phb_arr(i,j,k+1)) - (ph_arr(i,j,k) + phb_arr(i,j,k));
+        Real dpht =  (ph_arr(i,j,k+1) + phb_arr(i,j,k+1)) - (ph_arr(i,j,k) + phb_arr(i,j,k));
 
-            bdy_r_arr(i,j,k) = -xmu / ( dpht * rdnw_arr(0,0,k) );
+        bdy_r_arr(i,j,k) = -xmu / ( dpht * rdnw_arr(0,0,k) );
 
-            //if (nt == 0 and std::abs(r_arr(i,j,k) - bdy_r_arr(i,j,k)) > 0.) {
-            //    amrex::Print() << "INIT VS BDY DEN " << IntVect(i,j,k) << " " << r_arr(i,j,k) << " " << bdy_r_arr(i,j,k) <<
-            //                    " " << std::abs(r_arr(i,j,k) - bdy_r_arr(i,j,k)) << std::endl;
-            //}
-        });
+        //if (nt == 0 and std::abs(r_arr(i,j,k) - bdy_r_arr(i,j,k)) > 0.) {
+        //    amrex::Print() << "INIT VS BDY DEN " << IntVect(i,j,k) << " " << r_arr(i,j,k) << " " << bdy_r_arr(i,j,k) <<
+        //                    " " << std::abs(r_arr(i,j,k) - bdy_r_arr(i,j,k)) << std::endl;
+        //}
+    });
 
-        // Define theta
-        amrex::Real theta_ref = 300.;
-        amrex::ParallelFor(bx_t, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+    // Define theta
+    amrex::Real theta_ref = 300.;
+    amrex::ParallelFor(bx_t, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
 
-            Real xmu  = (mu_arr(i,j,0) + mub_arr(i,j,0));
-            Real xmu_mult = c1h_arr(0,0,k) * xmu + c2h_arr(0,0,k);
+        Real xmu  = (mu_arr(i,j,0) + mub_arr(i,j,0));
+        Real xmu_mult = c1h_arr(0,0,k) * xmu + c2h_arr(0,0,k);
 
-            Real new_bdy_Th = bdy_t_arr(i,j,k) / xmu_mult + theta_ref;
+        Real new_bdy_Th = bdy_t_arr(i,j,k) / xmu_mult + theta_ref;
 
-            Real qv_fac = (1. + bdy_qv_arr(i,j,k) / 0.622 / xmu_mult);
+        Real qv_fac = (1. + bdy_qv_arr(i,j,k) / 0.622 / xmu_mult);
 
-            new_bdy_Th /= qv_fac;
+        new_bdy_Th /= qv_fac;
 
-            bdy_t_arr(i,j,k) = new_bdy_Th * bdy_r_arr(i,j,k);
+        bdy_t_arr(i,j,k) = new_bdy_Th * bdy_r_arr(i,j,k);
 
-            //if (nt == 0 and std::abs(rth_arr(i,j,k) - bdy_t_arr(i,j,k)) > 0.) {
-            //    amrex::Print() << "INIT VS BDY TH " << IntVect(i,j,k) << " " << rth_arr(i,j,k) << " " << bdy_t_arr(i,j,k) <<
-            //                    " " << std::abs(th_arr(i,j,k) - bdy_t_arr(i,j,k)) << std::endl;
-            //}
-        });
+        //if (nt == 0 and std::abs(rth_arr(i,j,k) - bdy_t_arr(i,j,k)) > 0.) {
+        //    amrex::Print() << "INIT VS BDY TH " << IntVect(i,j,k) << " " << rth_arr(i,j,k) << " " << bdy_t_arr(i,j,k) <<
+        //                    " " << std::abs(th_arr(i,j,k) - bdy_t_arr(i,j,k)) << std::endl;
+        //}
+    });
 
 #ifndef AMREX_USE_GPU
-        if (nt == 0) {
-            FArrayBox diff(bx_t,1);
-            diff.template copy<RunOn::Device>(bdy_data[0][WRFBdyVars::R]);
-            //diff.template mult<RunOn::Device>(NC_rho_fab);
-            diff.template minus<RunOn::Device>(NC_rho_fab);
-            if (which == 0)
-                amrex::Print() << "Max norm of diff between initial r and bdy r on lo x face: " << diff.norm(0) << std::endl;
-            if (which == 1)
-                amrex::Print() << "Max norm of diff between initial r and bdy r on hi x face: " << diff.norm(0) << std::endl;
-            if (which == 2)
-                amrex::Print() << "Max norm of diff between initial r and bdy r on lo y face: " << diff.norm(0) << std::endl;
-            if (which == 3)
-                amrex::Print() << "Max norm of diff between initial r and bdy r on hi y face: " << diff.norm(0) << std::endl;
-
-            diff.template copy<RunOn::Device>(bdy_data[0][WRFBdyVars::T]);
-            diff.template minus<RunOn::Device>(NC_rhotheta_fab);
-            if (which == 0)
-                amrex::Print() << "Max norm of diff between initial rTh and bdy rTh on lo x face: " << diff.norm(0) << std::endl;
-            if (which == 1)
-                amrex::Print() << "Max norm of diff between initial rTh and bdy rTh on hi x face: " << diff.norm(0) << std::endl;
-            if (which == 2)
-                amrex::Print() << "Max norm of diff between initial rTh and bdy rTh on lo y face: " << diff.norm(0) << std::endl;
-            if (which == 3)
-                amrex::Print() << "Max norm of diff between initial rTh and bdy rTh on hi y face: " << diff.norm(0) << std::endl;
-        }
+    if (nt == 0) {
+        FArrayBox diff(bx_t,1);
+        diff.template copy<RunOn::Device>(bdy_data[WRFBdyVars::R]);
+        //diff.template mult<RunOn::Device>(NC_rho_fab);
+        diff.template minus<RunOn::Device>(NC_rho_fab);
+        if (which == 0)
+            amrex::Print() << "Max norm of diff between initial r and bdy r on lo x face: " << diff.norm(0) << std::endl;
+        if (which == 1)
+            amrex::Print() << "Max norm of diff between initial r and bdy r on hi x face: " << diff.norm(0) << std::endl;
+        if (which == 2)
+            amrex::Print() << "Max norm of diff between initial r and bdy r on lo y face: " << diff.norm(0) << std::endl;
+        if (which == 3)
+            amrex::Print() << "Max norm of diff between initial r and bdy r on hi y face: " << diff.norm(0) << std::endl;
+
+        diff.template copy<RunOn::Device>(bdy_data[WRFBdyVars::T]);
+        diff.template minus<RunOn::Device>(NC_rhotheta_fab);
+        if (which == 0)
+            amrex::Print() << "Max norm of diff between initial rTh and bdy rTh on lo x face: " << diff.norm(0) << std::endl;
+        if (which == 1)
+            amrex::Print() << "Max norm of diff between initial rTh and bdy rTh on hi x face: " << diff.norm(0) << std::endl;
+        if (which == 2)
+            amrex::Print() << "Max norm of diff between initial rTh and bdy rTh on lo y face: " << diff.norm(0) << std::endl;
+        if (which == 3)
+            amrex::Print() << "Max norm of diff between initial rTh and bdy rTh on hi y face: " << diff.norm(0) << std::endl;
+    }
 #endif
 
-        // Define Qv
-        const auto & bx_qv = bdy_data[0][WRFBdyVars::QV].box();
-        amrex::ParallelFor(bx_qv, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+    // Define Qv
+    const auto & bx_qv = bdy_data[WRFBdyVars::QV].box();
+    amrex::ParallelFor(bx_qv, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
 
-            Real xmu  = (mu_arr(i,j,0) + mub_arr(i,j,0));
-            Real xmu_mult = c1h_arr(0,0,k) * xmu + c2h_arr(0,0,k);
+        Real xmu  = (mu_arr(i,j,0) + mub_arr(i,j,0));
+        Real xmu_mult = c1h_arr(0,0,k) * xmu + c2h_arr(0,0,k);
 
-            Real new_bdy_QV = bdy_qv_arr(i,j,k) / xmu_mult;
+        Real new_bdy_QV = bdy_qv_arr(i,j,k) / xmu_mult;
 
-            bdy_qv_arr(i,j,k) = new_bdy_QV * bdy_r_arr(i,j,k);
-        });
-    } // ntimes
+        bdy_qv_arr(i,j,k) = new_bdy_QV * bdy_r_arr(i,j,k);
+    });
 }
 #endif // ERF_USE_NETCDF
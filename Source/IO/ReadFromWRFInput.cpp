@@ -7,6 +7,7 @@ using namespace amrex;
 void
 read_from_wrfinput(int lev,
                    const Box& domain,
+                   const BoxList& regions,
                    const std::string& fname,
                    FArrayBox& NC_xvel_fab, FArrayBox& NC_yvel_fab,
                    FArrayBox& NC_zvel_fab, FArrayBox& NC_rho_fab,
@@ -60,7 +61,7 @@ read_from_wrfinput(int lev,
 
     // Read the netcdf file and fill these FABs
     amrex::Print() << "Building initial FABS from file " << fname << std::endl;
-    BuildFABsFromNetCDFFile(domain, fname, NC_names, NC_dim_types, NC_fabs);
+    BuildFABsFromNetCDFFile(domain, regions, fname, NC_names, NC_dim_types, NC_fabs);
 
     //
     // Convert the velocities using the map factors
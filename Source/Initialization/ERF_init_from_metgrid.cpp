@@ -11,7 +11,7 @@
 using namespace amrex;
 
 void
-read_from_metgrid(int lev, const Box& domain, const std::string& fname,
+read_from_metgrid(int lev, const Box& domain, const BoxList& regions, const std::string& fname,
                   FArrayBox& NC_xvel_fab, FArrayBox& NC_yvel_fab,
                   FArrayBox& NC_temp_fab, FArrayBox& NC_rhum_fab,
                   FArrayBox& NC_pres_fab, FArrayBox& NC_hgt_fab,
@@ -78,19 +78,26 @@ ERF::init_from_metgrid(int lev)
     if (nc_init_file[lev].empty())
         amrex::Error("NetCDF initialization file name must be provided via input");
 
+    auto& lev_new = vars_new[lev];
+
+    std::unique_ptr<MultiFab>& z_phys = z_phys_nd[lev];
+
+    // Each rank only reads the parts of the file(s) covering its own grids (including ghost cells),
+    //     one hyperslab per group of contiguous boxes;
+    //     the extra cell is needed by the stencil that puts the terrain height on nodes
+    const BoxList local_regions = LocalBoxes({&lev_new[Vars::cons], mapfac_u[lev].get(),
+                                              mapfac_v[lev].get(), mapfac_m[lev].get(),
+                                              z_phys.get()}, 1);
+
     for (int idx = 0; idx < nboxes; idx++)
     {
-        read_from_metgrid(lev, boxes_at_level[lev][idx], nc_init_file[lev][idx],
+        read_from_metgrid(lev, boxes_at_level[lev][idx], local_regions, nc_init_file[lev][idx],
                           NC_xvel_fab[idx], NC_yvel_fab[idx],
                           NC_temp_fab[idx], NC_rhum_fab[idx],
                           NC_pres_fab[idx], NC_hgt_fab[idx],
                           NC_MSFU_fab[idx], NC_MSFV_fab[idx], NC_MSFM_fab[idx] );
     }
 
-    auto& lev_new = vars_new[lev];
-
-    std::unique_ptr<MultiFab>& z_phys = z_phys_nd[lev];
-
     AMREX_ALWAYS_ASSERT(solverChoice.use_terrain);
 
     z_phys->setVal(0.);
@@ -363,7 +370,7 @@ init_msfs_from_metgrid(int lev, FArrayBox& msfu_fab,
     {
         //
         // FArrayBox to FArrayBox copy does "copy on intersection"
-        // This only works here because we have broadcast the FArrayBox of data from the netcdf file to all ranks
+        // This only works here because each rank has read the part of the netcdf file covering its grids
         //
         // This copies mapfac_u
         msfu_fab.template copy<RunOn::Device>(NC_MSFU_fab[idx]);
@@ -400,7 +407,7 @@ init_base_state_from_metgrid(int lev, const Box& valid_bx, const Real l_rdOcp,
     {
         //
         // FArrayBox to FArrayBox copy does "copy on intersection"
-        // This only works here because we have broadcast the FArrayBox of data from the netcdf file to all ranks
+        // This only works here because each rank has read the part of the netcdf file covering its grids
         //
         const Array4<Real      >&  p_hse_arr =  p_hse.array();
         const Array4<Real      >& pi_hse_arr = pi_hse.array();
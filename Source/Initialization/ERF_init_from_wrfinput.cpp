@@ -13,7 +13,7 @@ using namespace amrex;
 #ifdef ERF_USE_NETCDF
 
 void
-read_from_wrfinput(int lev, const Box& domain, const std::string& fname,
+read_from_wrfinput(int lev, const Box& domain, const BoxList& regions, const std::string& fname,
                    FArrayBox& NC_xvel_fab, FArrayBox& NC_yvel_fab,
                    FArrayBox& NC_zvel_fab, FArrayBox& NC_rho_fab,
                    FArrayBox& NC_rhop_fab, FArrayBox& NC_rhotheta_fab,
@@ -31,31 +31,6 @@ read_from_wrfinput(int lev, const Box& domain, const std::string& fname,
                    FArrayBox& NC_PH_fab  , FArrayBox& NC_PHB_fab,
                    FArrayBox& NC_ALB_fab , FArrayBox& NC_PB_fab);
 
-Real
-read_from_wrfbdy(const std::string& nc_bdy_file, const Box& domain,
-                 Vector<Vector<FArrayBox>>& bdy_data_xlo,
-                 Vector<Vector<FArrayBox>>& bdy_data_xhi,
-                 Vector<Vector<FArrayBox>>& bdy_data_ylo,
-                 Vector<Vector<FArrayBox>>& bdy_data_yhi,
-                 int& width, amrex::Real& start_bdy_time);
-
-void
-convert_wrfbdy_data(int which, const Box& domain,
-                    Vector<Vector<FArrayBox>>& bdy_data,
-                    const FArrayBox& NC_MUB_fab,
-                    const FArrayBox& NC_MSFU_fab,
-                    const FArrayBox& NC_MSFV_fab,
-                    const FArrayBox& NC_MSFM_fab,
-                    const FArrayBox& NC_PH_fab,
-                    const FArrayBox& NC_PHB_fab,
-                    const FArrayBox& NC_C1H_fab,
-                    const FArrayBox& NC_C2H_fab,
-                    const FArrayBox& NC_RDNW_fab,
-                    const FArrayBox& NC_xvel_fab,
-                    const FArrayBox& NC_yvel_fab,
-                    const FArrayBox& NC_rho_fab,
-                    const FArrayBox& NC_rhoth_fab);
-
 void
 init_state_from_wrfinput(int lev, FArrayBox& state_fab,
                          FArrayBox& x_vel_fab, FArrayBox& y_vel_fab,
@@ -128,9 +103,17 @@ ERF::init_from_wrfinput(int lev)
     if (nc_init_file.empty())
         amrex::Error("NetCDF initialization file name must be provided via input");
 
+    // Each rank only reads the parts of the file(s) covering its own grids (including ghost cells),
+    //     one hyperslab per group of contiguous boxes;
+    //     the extra cell is needed by the stencil that puts the terrain height on nodes
+    auto& lev_new = vars_new[lev];
+    const BoxList local_regions = LocalBoxes({&lev_new[Vars::cons], mapfac_u[lev].get(),
+                                              mapfac_v[lev].get(), mapfac_m[lev].get(),
+                                              z_phys_nd[lev].get()}, 1);
+
     for (int idx = 0; idx < num_boxes_at_level[lev]; idx++)
     {
-        read_from_wrfinput(lev, boxes_at_level[lev][idx], nc_init_file[lev][idx],
+        read_from_wrfinput(lev, boxes_at_level[lev][idx], local_regions, nc_init_file[lev][idx],
                            NC_xvel_fab[idx], NC_yvel_fab[idx],  NC_zvel_fab[idx], NC_rho_fab[idx],
                            NC_rhop_fab[idx], NC_rhoth_fab[idx], NC_MUB_fab[idx],
                            NC_MSFU_fab[idx], NC_MSFV_fab[idx],  NC_MSFM_fab[idx],
@@ -142,8 +125,6 @@ ERF::init_from_wrfinput(int lev)
                            NC_PH_fab[idx],NC_PHB_fab[idx],NC_ALB_fab[idx],NC_PB_fab[idx]);
     }
 
-    auto& lev_new = vars_new[lev];
-
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
@@ -220,9 +201,11 @@ ERF::init_from_wrfinput(int lev)
     if (init_type == "real" && (lev == 0)) {
         if (nc_bdy_file.empty())
             amrex::Error("NetCDF boundary file name must be provided via input");
-        bdy_time_interval = read_from_wrfbdy(nc_bdy_file,geom[0].Domain(),
-                                             bdy_data_xlo,bdy_data_xhi,bdy_data_ylo,bdy_data_yhi,
-                                             wrfbdy_width, start_bdy_time);
+        wrfbdy_provider.define(nc_bdy_file, nc_init_file[lev][0], geom[0].Domain(),
+                               bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi);
+        bdy_time_interval = wrfbdy_provider.timeInterval();
+        start_bdy_time    = wrfbdy_provider.startTime();
+        wrfbdy_width      = wrfbdy_provider.width();
 
         if (wrfbdy_width-1 <= wrfbdy_set_width) wrfbdy_set_width = wrfbdy_width;
         amrex::Print() << "Read in boundary data with width "  << wrfbdy_width << std::endl;
@@ -233,26 +216,14 @@ ERF::init_from_wrfinput(int lev)
         //       Without relaxation zones, we must augment this value by 1.
         if (wrfbdy_width == wrfbdy_set_width) wrfbdy_width += 1;
 
-        convert_wrfbdy_data(0,domain,bdy_data_xlo,
-                            NC_MUB_fab[0], NC_MSFU_fab[0], NC_MSFV_fab[0], NC_MSFM_fab[0],
-                            NC_PH_fab[0] , NC_PHB_fab[0],
-                            NC_C1H_fab[0], NC_C2H_fab[0], NC_RDNW_fab[0],
-                            NC_xvel_fab[0],NC_yvel_fab[0],NC_rho_fab[0],NC_rhoth_fab[0]);
-        convert_wrfbdy_data(1,domain,bdy_data_xhi,
-                            NC_MUB_fab[0], NC_MSFU_fab[0], NC_MSFV_fab[0], NC_MSFM_fab[0],
-                            NC_PH_fab[0] , NC_PHB_fab[0],
-                            NC_C1H_fab[0], NC_C2H_fab[0], NC_RDNW_fab[0],
-                            NC_xvel_fab[0],NC_yvel_fab[0],NC_rho_fab[0],NC_rhoth_fab[0]);
-        convert_wrfbdy_data(2,domain,bdy_data_ylo,
-                            NC_MUB_fab[0], NC_MSFU_fab[0], NC_MSFV_fab[0], NC_MSFM_fab[0],
-                            NC_PH_fab[0] , NC_PHB_fab[0],
-                            NC_C1H_fab[0], NC_C2H_fab[0], NC_RDNW_fab[0],
-                            NC_xvel_fab[0],NC_yvel_fab[0],NC_rho_fab[0],NC_rhoth_fab[0]);
-        convert_wrfbdy_data(3,domain,bdy_data_yhi,
-                            NC_MUB_fab[0], NC_MSFU_fab[0], NC_MSFV_fab[0], NC_MSFM_fab[0],
-                            NC_PH_fab[0] , NC_PHB_fab[0],
-                            NC_C1H_fab[0], NC_C2H_fab[0], NC_RDNW_fab[0],
-                            NC_xvel_fab[0],NC_yvel_fab[0],NC_rho_fab[0],NC_rhoth_fab[0]);
+        // Read (and convert) the time levels needed at the start of the run on the
+        //     faces of the domain this rank's grids need
+        wrfbdy_provider.update(t_new[0], t_new[0],
+                               {&lev_new[Vars::cons], &lev_new[Vars::xvel],
+                                &lev_new[Vars::yvel], &lev_new[Vars::zvel]});
+
+        // The rest of the initialization may write NetCDF files
+        wrfbdy_provider.wait();
     }
 }
 
@@ -293,7 +264,7 @@ init_state_from_wrfinput(int lev,
     {
         //
         // FArrayBox to FArrayBox copy does "copy on intersection"
-        // This only works here because we have broadcast the FArrayBox of data from the netcdf file to all ranks
+        // This only works here because each rank has read the part of the netcdf file covering its grids
         //
         // This copies x-vel
         x_vel_fab.template copy<RunOn::Device>(NC_xvel_fab[idx]);
@@ -348,7 +319,7 @@ init_msfs_from_wrfinput(int lev, FArrayBox& msfu_fab,
     {
         //
         // FArrayBox to FArrayBox copy does "copy on intersection"
-        // This only works here because we have broadcast the FArrayBox of data from the netcdf file to all ranks
+        // This only works here because each rank has read the part of the netcdf file covering its grids
         //
         // This copies mapfac_u
         msfu_fab.template copy<RunOn::Device>(NC_MSFU_fab[idx]);
@@ -384,7 +355,7 @@ init_base_state_from_wrfinput(int lev, const Box& valid_bx, const Real l_rdOcp,
     {
         //
         // FArrayBox to FArrayBox copy does "copy on intersection"
-        // This only works here because we have broadcast the FArrayBox of data from the netcdf file to all ranks
+        // This only works here because each rank has read the part of the netcdf file covering its grids
         //
         const Array4<Real      >&  p_hse_arr =  p_hse.array();
         const Array4<Real      >& pi_hse_arr = pi_hse.array(); const Array4<Real      >&  r_hse_arr =  r_hse.array();
@@ -16,6 +16,7 @@ void Microphysics::Cloud() {
   constexpr Real bp   = tprmin*ap;
 
   auto pres1d_t = pres1d.table();
+  auto sat      = m_sat_table.view();
 
   auto qt    = mic_fab_vars[MicVar::qt];
   auto qp    = mic_fab_vars[MicVar::qp];
@@ -48,18 +49,18 @@ void Microphysics::Cloud() {
         // Warm cloud:
         if(tabs1 > tbgmax) {
            tabs1 = tabs_array(i,j,k)+fac_cond*qp_array(i,j,k);
-           erf_qsatw(tabs1, pres1d_t(k), qsatt);
+           sat.qsatw(tabs1, pres1d_t(k), qsatt);
         }
         // Ice cloud:
         else if(tabs1 <= tbgmin) {
           tabs1 = tabs_array(i,j,k)+fac_sub*qp_array(i,j,k);
-          erf_qsati(tabs1, pres1d_t(k), qsatt);
+          sat.qsati(tabs1, pres1d_t(k), qsatt);
         }
         // Mixed-phase cloud:
         else {
           om = an*tabs1-bn;
-          erf_qsatw(tabs1, pres1d_t(k), qsatt1);
-          erf_qsati(tabs1, pres1d_t(k), qsatt2);
+          sat.qsatw(tabs1, pres1d_t(k), qsatt1);
+          sat.qsati(tabs1, pres1d_t(k), qsatt2);
           qsatt = om*qsatt1 + (1.-om)*qsatt2;
        }
 //if(i==2 && j==2)
@@ -77,26 +78,26 @@ void Microphysics::Cloud() {
               om=1.0;
               lstarn  = fac_cond;
               dlstarn = 0.0;
-              erf_qsatw(tabs1, pres1d_t(k), qsatt);
-              erf_dtqsatw(tabs1, pres1d_t(k), dqsat);
+              sat.qsatw(tabs1, pres1d_t(k), qsatt);
+              sat.dtqsatw(tabs1, pres1d_t(k), dqsat);
             }
             else if(tabs1 <= tbgmin) {
               om      = 0.0;
               lstarn  = fac_sub;
               dlstarn = 0.0;
-              erf_qsati(tabs1, pres1d_t(k), qsatt);
-              erf_dtqsati(tabs1, pres1d_t(k), dqsat);
+              sat.qsati(tabs1, pres1d_t(k), qsatt);
+              sat.dtqsati(tabs1, pres1d_t(k), dqsat);
            }
            else {
               om=an*tabs1-bn;
               lstarn  = fac_cond+(1.0-om)*fac_fus;
               dlstarn = an*fac_fus;
-              erf_qsatw(tabs1, pres1d_t(k), qsatt1);
-              erf_qsati(tabs1, pres1d_t(k), qsatt2);
+              sat.qsatw(tabs1, pres1d_t(k), qsatt1);
+              sat.qsati(tabs1, pres1d_t(k), qsatt2);
 
               qsatt = om*qsatt1+(1.-om)*qsatt2;
-              erf_dtqsatw(tabs1, pres1d_t(k), qsatt1);
-              erf_dtqsati(tabs1, pres1d_t(k), qsatt2);
+              sat.dtqsatw(tabs1, pres1d_t(k), qsatt1);
+              sat.dtqsati(tabs1, pres1d_t(k), qsatt2);
               dqsat = om*qsatt1+(1.-om)*qsatt2;
           }
 
@@ -0,0 +1,628 @@
+#include "ERF_Constants.H"
+#include "Microphysics.H"
+#include "IndexDefines.H"
+#include "EOS.H"
+#include "TileNoZ.H"
+#include "BoxCost.H"
+
+using namespace amrex;
+
+namespace {
+
+// Work arrays of one column
+namespace MicCol {
+   enum {
+      qt = 0,
+      qp,
+      qn,
+      tabs,
+      theta,
+      fz,     // ice or precipitation flux
+      wp,     // precipitation velocity
+      www,    // anti-diffusive flux
+      lfac,   // latent heat factor
+      mx,
+      mn,
+      tmp_qp,
+      NumVars
+  };
+}
+
+/**
+ * Work arrays of one column: variable n at level k is p[(n*nzp + k-zlo)*stride].
+ * Each variable has one more level than the column so that the flux above the top
+ * cell can be stored.
+ */
+struct MicColumn
+{
+    Real* p;
+    int   zlo;
+    int   nzp;
+    Long  stride;
+
+    AMREX_GPU_DEVICE
+    AMREX_FORCE_INLINE
+    Real& operator() (int k, int n) const noexcept
+    {
+        return p[(static_cast<Long>(n)*nzp + (k-zlo))*stride];
+    }
+};
+
+/**
+ * Constants and vertical tables shared by all the columns
+ */
+struct MicColumnParams
+{
+    int  nz, zlo, zhi;
+    Real dt, dz;
+    Real fac_cond, fac_sub, fac_fus;
+    Real vrain, vsnow, vgrau;
+
+    Table1D<Real> rho1d, pres1d;
+    Table1D<Real> accrrc, accrsc, accrsi, accrgc, accrgi, coefice;
+    Table1D<Real> evapr1, evapr2, evaps1, evaps2, evapg1, evapg2;
+    Table1D<Real> qifall, tlatqi, qpsrc, qpevp;
+
+    SatVapTableView sat;
+};
+
+/**
+ * Advance one column through Cloud, Diagnose, IceFall, Precip, PrecipFall and Update.
+ * Each stage is the per-cell code of the corresponding Microphysics function, applied
+ * to the column's work arrays instead of the 3D microphysics variables.  The ice fall
+ * range and the number of sedimentation sub-steps are those of this column.  The
+ * vertical budgets are shared by all the columns (and CPU threads), so they are summed
+ * with host and device atomics.
+ *
+ * @param[in]     i,j    index of the column
+ * @param[in]     cbx    box on which the saturation adjustment is done
+ * @param[in]     prm    constants and vertical tables
+ * @param[in,out] state  conserved variables
+ * @param[out]    qm     qv, qc, qi, qr, qs, qg
+ * @param[in]     c      work arrays of this column
+ */
+AMREX_GPU_DEVICE
+void
+MicrophysicsColumn (int i, int j, const Box& cbx,
+                    const MicColumnParams& prm,
+                    const Array4<Real>& state,
+                    const Array4<Real>& qm,
+                    const MicColumn& c)
+{
+  constexpr Real an   = 1.0/(tbgmax-tbgmin);
+  constexpr Real bn   = tbgmin*an;
+  constexpr Real ap   = 1.0/(tprmax-tprmin);
+  constexpr Real bp   = tprmin*ap;
+
+  Real constexpr eps = 1.e-10;
+
+  const int  nz  = prm.nz;
+  const int  zlo = prm.zlo;
+  const int  zhi = prm.zhi;
+  const Real dtn = prm.dt;
+  const Real dz  = prm.dz;
+
+  const Real fac_cond = prm.fac_cond;
+  const Real fac_sub  = prm.fac_sub;
+  const Real fac_fus  = prm.fac_fus;
+
+  const auto& pres1d_t = prm.pres1d;
+  const auto& rho1d_t  = prm.rho1d;
+
+  // Get theta, qt, qp and the temperature from the state
+  for (int k = zlo; k <= zhi; ++k) {
+    c(k,MicCol::theta) = state(i,j,k,RhoTheta_comp)/state(i,j,k,Rho_comp);
+    c(k,MicCol::qt)    = state(i,j,k,RhoQt_comp)/state(i,j,k,Rho_comp);
+    c(k,MicCol::qp)    = state(i,j,k,RhoQp_comp)/state(i,j,k,Rho_comp);
+    c(k,MicCol::qn)    = 0.0; // Init reads qc+qi after resetting qmoist
+    c(k,MicCol::tabs)  = getTgivenRandRTh(state(i,j,k,Rho_comp),state(i,j,k,RhoTheta_comp));
+  }
+
+  // Cloud
+  for (int k = zlo; k <= zhi; ++k) {
+    if (!cbx.contains(IntVect(i,j,k))) continue;
+
+    Real& qt_k   = c(k,MicCol::qt);
+    Real& qp_k   = c(k,MicCol::qp);
+    Real& qn_k   = c(k,MicCol::qn);
+    Real& tabs_k = c(k,MicCol::tabs);
+
+    qt_k = std::max(0.0,qt_k);
+    // Initial guess for temperature assuming no cloud water/ice:
+    Real tabs1 = tabs_k;
+
+    Real qsatt;
+    Real om;
+    Real qsatt1;
+    Real qsatt2;
+
+    // Warm cloud:
+    if(tabs1 > tbgmax) {
+      tabs1 = tabs_k+fac_cond*qp_k;
+      prm.sat.qsatw(tabs1, pres1d_t(k), qsatt);
+    }
+    // Ice cloud:
+    else if(tabs1 <= tbgmin) {
+      tabs1 = tabs_k+fac_sub*qp_k;
+      prm.sat.qsati(tabs1, pres1d_t(k), qsatt);
+    }
+    // Mixed-phase cloud:
+    else {
+      om = an*tabs1-bn;
+      prm.sat.qsatw(tabs1, pres1d_t(k), qsatt1);
+      prm.sat.qsati(tabs1, pres1d_t(k), qsatt2);
+      qsatt = om*qsatt1 + (1.-om)*qsatt2;
+    }
+
+    int niter;
+    Real dtabs, lstarn, dlstarn, omp, lstarp, dlstarp, fff, dfff, dqsat;
+    //  Test if condensation is possible:
+    if(qt_k > qsatt) {
+      niter = 0;
+      dtabs = 1;
+      do {
+        if(tabs1 >= tbgmax) {
+          om=1.0;
+          lstarn  = fac_cond;
+          dlstarn = 0.0;
+          prm.sat.qsatw(tabs1, pres1d_t(k), qsatt);
+          prm.sat.dtqsatw(tabs1, pres1d_t(k), dqsat);
+        }
+        else if(tabs1 <= tbgmin) {
+          om      = 0.0;
+          lstarn  = fac_sub;
+          dlstarn = 0.0;
+          prm.sat.qsati(tabs1, pres1d_t(k), qsatt);
+          prm.sat.dtqsati(tabs1, pres1d_t(k), dqsat);
+        }
+        else {
+          om=an*tabs1-bn;
+          lstarn  = fac_cond+(1.0-om)*fac_fus;
+          dlstarn = an*fac_fus;
+          prm.sat.qsatw(tabs1, pres1d_t(k), qsatt1);
+          prm.sat.qsati(tabs1, pres1d_t(k), qsatt2);
+
+          qsatt = om*qsatt1+(1.-om)*qsatt2;
+          prm.sat.dtqsatw(tabs1, pres1d_t(k), qsatt1);
+          prm.sat.dtqsati(tabs1, pres1d_t(k), qsatt2);
+          dqsat = om*qsatt1+(1.-om)*qsatt2;
+        }
+
+        if(tabs1 >= tprmax) {
+          omp = 1.0;
+          lstarp  = fac_cond;
+          dlstarp = 0.0;
+        }
+        else if(tabs1 <= tprmin) {
+          omp     = 0.0;
+          lstarp  = fac_sub;
+          dlstarp = 0.0;
+        }
+        else {
+          omp=ap*tabs1-bp;
+          lstarp  = fac_cond+(1.0-omp)*fac_fus;
+          dlstarp = ap*fac_fus;
+        }
+        fff   = tabs_k-tabs1+lstarn*(qt_k-qsatt)+lstarp*qp_k;
+        dfff  = dlstarn*(qt_k-qsatt)+dlstarp*qp_k-lstarn*dqsat-1.0;
+        dtabs = -fff/dfff;
+        niter = niter+1;
+        tabs1 = tabs1+dtabs;
+      } while(std::abs(dtabs) > 0.01 && niter < 10);
+      qsatt = qsatt + dqsat*dtabs;
+      qn_k = std::max(0.0, qt_k-qsatt);
+    }
+    else {
+      qn_k = 0.0;
+    }
+    tabs_k = tabs1;
+    qp_k   = std::max(0.0, qp_k); // just in case
+  }
+
+  // Diagnose (straight into qmoist: qv, qcl, qci, qpl, qpi)
+  for (int k = zlo; k <= zhi; ++k) {
+    qm(i,j,k,0) = c(k,MicCol::qt) - c(k,MicCol::qn);
+    Real omn    = std::max(0.0, std::min(1.0,(c(k,MicCol::tabs)-tbgmin)*a_bg));
+    qm(i,j,k,1) = c(k,MicCol::qn)*omn;
+    qm(i,j,k,2) = c(k,MicCol::qn)*(1.0-omn);
+    Real omp    = std::max(0.0, std::min(1.0,(c(k,MicCol::tabs)-tprmin)*a_pr));
+    qm(i,j,k,3) = c(k,MicCol::qp)*omp;
+    qm(i,j,k,4) = c(k,MicCol::qp)*(1.0-omp);
+  }
+
+  // IceFall, over the ice fall range of this column
+  {
+    int kmin = nz-1;
+    int kmax = 0;
+    for (int k = zlo; k <= zhi; ++k) {
+      if (qm(i,j,k,1)+qm(i,j,k,2) > 0.0 && c(k,MicCol::tabs) < 273.15) {
+        kmin = std::min(kmin, k);
+        kmax = std::max(kmax, k);
+      }
+    }
+
+    for (int k = zlo; k <= zhi+1; ++k) {
+      c(k,MicCol::fz) = 0.0;
+    }
+
+    const Real coef = dtn/dz;
+    const int  kbot = std::max(0,kmin-1);
+
+    for (int k = kbot; k <= kmax; ++k) {
+      int kc = std::min(k+1, nz-1);
+      int kb = std::max(k-1, 0);
+
+      // Cloud ice density in this cell (c) and the ones above (u, upwind) and below (d)
+      Real qiu = rho1d_t(kc)*qm(i,j,kc,2);
+      Real qic = rho1d_t(k )*qm(i,j,k ,2);
+      Real qid = rho1d_t(kb)*qm(i,j,kb,2);
+
+      // Ice sedimentation velocity, Heymsfield (JAS, 2003, p.2607)
+      Real vt_ice = min( 0.4 , 8.66 * pow( (max(0.,qic)+1.e-10) , 0.24) );
+
+      // MC flux limiter
+      Real tmp_phi;
+      if ( std::abs(qic-qid) < 1.0e-25 ) {
+        tmp_phi = 0.;
+      } else {
+        Real tmp_theta = (qiu-qic)/(qic-qid+1.0e-20);
+        tmp_phi = max(0., min(0.5*(1.+tmp_theta), min(2., 2.*tmp_theta)));
+      }
+
+      c(k,MicCol::fz) = -vt_ice*(qic - 0.5*(1.-coef*vt_ice)*tmp_phi*(qic-qid));
+    }
+
+    for (int k = kbot; k <= kmax; ++k) {
+      // The cloud ice increment is the difference of the fluxes.
+      Real dqi = coef*(c(k,MicCol::fz)-c(k+1,MicCol::fz));
+      c(k,MicCol::qt) += dqi;
+      amrex::HostDevice::Atomic::Add(&prm.qifall(k), dqi);
+
+      // Latent heat of sublimation
+      Real lat_heat = (fac_cond+fac_fus)*dqi;
+      c(k,MicCol::theta) -= lat_heat;
+      amrex::HostDevice::Atomic::Add(&prm.tlatqi(k), -lat_heat);
+    }
+  }
+
+  // Precip
+  {
+    Real powr1 = (3.0 + b_rain) / 4.0;
+    Real powr2 = (5.0 + b_rain) / 8.0;
+    Real pows1 = (3.0 + b_snow) / 4.0;
+    Real pows2 = (5.0 + b_snow) / 8.0;
+    Real powg1 = (3.0 + b_grau) / 4.0;
+    Real powg2 = (5.0 + b_grau) / 8.0;
+
+    for (int k = zlo; k <= zhi; ++k) {
+      Real& qt_k   = c(k,MicCol::qt);
+      Real& qp_k   = c(k,MicCol::qp);
+      Real& qn_k   = c(k,MicCol::qn);
+      Real  tabs_k = c(k,MicCol::tabs);
+
+      //------- Autoconversion/accretion
+      Real omn, omp, omg, qcc, qii, autor, autos, accrr, qrr, accrcs, accris,
+           qss, accrcg, accrig, tmp, qgg, dq, qsatt, qsat;
+
+      if (qn_k+qp_k > 0.0) {
+        omn = std::max(0.0,std::min(1.0,(tabs_k-tbgmin)*a_bg));
+        omp = std::max(0.0,std::min(1.0,(tabs_k-tprmin)*a_pr));
+        omg = std::max(0.0,std::min(1.0,(tabs_k-tgrmin)*a_gr));
+
+        if (qn_k > 0.0) {
+          qcc = qn_k * omn;
+          qii = qn_k * (1.0-omn);
+
+          if (qcc > qcw0) {
+            autor = alphaelq;
+          } else {
+            autor = 0.0;
+          }
+
+          if (qii > qci0) {
+            autos = betaelq*prm.coefice(k);
+          } else {
+            autos = 0.0;
+          }
+
+          accrr = 0.0;
+          if (omp > 0.001) {
+            qrr = qp_k * omp;
+            accrr = prm.accrrc(k) * std::pow(qrr, powr1);
+          }
+
+          accrcs = 0.0;
+          accris = 0.0;
+
+          if (omp < 0.999 && omg < 0.999) {
+            qss = qp_k * (1.0-omp)*(1.0-omg);
+            tmp = pow(qss, pows1);
+            accrcs = prm.accrsc(k) * tmp;
+            accris = prm.accrsi(k) * tmp;
+          }
+          accrcg = 0.0;
+          accrig = 0.0;
+          if (omp < 0.999 && omg > 0.001) {
+            qgg = qp_k * (1.0-omp)*omg;
+            tmp = pow(qgg, powg1);
+            accrcg = prm.accrgc(k) * tmp;
+            accrig = prm.accrgi(k) * tmp;
+          }
+          qcc = (qcc+dtn*autor*qcw0)/(1.0+dtn*(accrr+accrcs+accrcg+autor));
+          qii = (qii+dtn*autos*qci0)/(1.0+dtn*(accris+accrig+autos));
+          dq = dtn *(accrr*qcc + autor*(qcc-qcw0)+(accris+accrig)*qii + (accrcs+accrcg)*qcc + autos*(qii-qci0));
+          dq = std::min(dq,qn_k);
+          qt_k = qt_k - dq;
+          qp_k = qp_k + dq;
+          qn_k = qn_k - dq;
+          amrex::HostDevice::Atomic::Add(&prm.qpsrc(k), dq);
+
+        } else if(qp_k > qp_threshold && qn_k == 0.0) {
+
+          qsatt = 0.0;
+          if(omn > 0.001) {
+            prm.sat.qsatw(tabs_k,pres1d_t(k),qsat);
+            qsatt = qsatt + omn*qsat;
+          }
+          if(omn < 0.999) {
+            prm.sat.qsati(tabs_k,pres1d_t(k),qsat);
+            qsatt = qsatt + (1.-omn)*qsat;
+          }
+          dq = 0.0;
+          if(omp > 0.001) {
+            qrr = qp_k * omp;
+            dq = dq + prm.evapr1(k)*sqrt(qrr) + prm.evapr2(k)*pow(qrr,powr2);
+          }
+          if(omp < 0.999 && omg < 0.999) {
+            qss = qp_k * (1.0-omp)*(1.0-omg);
+            dq = dq + prm.evaps1(k)*sqrt(qss) + prm.evaps2(k)*pow(qss,pows2);
+          }
+          if(omp < 0.999 && omg > 0.001) {
+            qgg = qp_k * (1.0-omp)*omg;
+            dq = dq + prm.evapg1(k)*sqrt(qgg) + prm.evapg2(k)*pow(qgg,powg2);
+          }
+          dq = dq * dtn * (qt_k / qsatt-1.0);
+          dq = std::max(-0.5*qp_k,dq);
+          qt_k = qt_k - dq;
+          qp_k = qp_k + dq;
+          amrex::HostDevice::Atomic::Add(&prm.qpevp(k), dq);
+
+        } else {
+          qt_k = qt_k + qp_k;
+          amrex::HostDevice::Atomic::Add(&prm.qpevp(k), -qp_k);
+          qp_k = 0.0;
+        }
+      }
+      dq = qp_k;
+      qp_k = max(0.0,qp_k);
+      qt_k = qt_k + (dq-qp_k);
+    }
+  }
+
+  // PrecipFall (hydro_type 2), with the number of sub-steps set by the CFL of this column
+  {
+    const Real wmax  = dz/dtn; // Velocity equivalent to a cfl of 1.0.
+    const Real iwmax = 1.0/wmax;
+
+    Real prec_cfl = 0.0;
+    for (int k = zlo; k <= zhi; ++k) {
+      Real omega = std::max(0.0,std::min(1.0,(c(k,MicCol::tabs)-tprmin)*a_pr));
+      c(k,MicCol::lfac) = fac_cond + (1.0-omega)*fac_fus;
+      Real tmp = term_vel_qp(i,j,k,c(k,MicCol::qp),
+                             prm.vrain, prm.vsnow, prm.vgrau, rho1d_t(k),
+                             c(k,MicCol::tabs));
+      Real wp = std::sqrt(1.29/rho1d_t(k))*tmp;
+      prec_cfl = std::max(prec_cfl, wp*iwmax);
+      c(k,MicCol::wp) = -wp*rho1d_t(k)*dtn/dz;
+    }
+
+    // If the CFL due to precipitation velocity is greater than 0.9,
+    // take more than one advection step to maintain stability.
+    int nprec = 1;
+    if (prec_cfl > 0.9) {
+      nprec = static_cast<int>(std::ceil(prec_cfl/0.9));
+      for (int k = zlo; k <= zhi; ++k) {
+        c(k,MicCol::wp) = c(k,MicCol::wp)/Real(nprec);
+      }
+    }
+
+#ifdef ERF_FIXED_SUBCYCLE
+    nprec = 4;
+#endif
+
+    for (int iprec = 1; iprec <= nprec; iprec++) {
+      for (int k = zlo; k <= zhi; ++k) {
+        int kc = min(nz-1,k+1);
+        int kb = max(0,k-1);
+        c(k,MicCol::mx) = max(c(kb,MicCol::qp), max(c(kc,MicCol::qp), c(k,MicCol::qp)));
+        c(k,MicCol::mn) = min(c(kb,MicCol::qp), min(c(kc,MicCol::qp), c(k,MicCol::qp)));
+        // Define upwind precipitation flux
+        c(k,MicCol::fz) = c(k,MicCol::qp)*c(k,MicCol::wp);
+      }
+
+      for (int k = zlo; k <= zhi; ++k) {
+        int kc = min(k+1, nz-1);
+        c(k,MicCol::tmp_qp) = c(k,MicCol::qp) - (c(kc,MicCol::fz)-c(k,MicCol::fz))*(1.0/rho1d_t(k));
+      }
+
+      // Anti-diffusive correction to the upwind flux, reformulated for the
+      // cell-centered precipitation velocity
+      for (int k = zlo; k <= zhi; ++k) {
+        int kb = max(0,k-1);
+        c(k,MicCol::www) = 0.5*(1.0+c(k,MicCol::wp)*(1.0/rho1d_t(k)))*(c(kb,MicCol::tmp_qp)*c(kb,MicCol::wp) -
+                                                                       c(k ,MicCol::tmp_qp)*c(k ,MicCol::wp));
+      }
+
+      for (int k = zlo; k <= zhi; ++k) {
+        int kc = min(nz-1,k+1);
+        int kb = max(0,k-1);
+        Real tq = c(k,MicCol::tmp_qp);
+        Real mx = max(c(kb,MicCol::tmp_qp),max(c(kc,MicCol::tmp_qp), max(tq, c(k,MicCol::mx))));
+        Real mn = min(c(kb,MicCol::tmp_qp),min(c(kc,MicCol::tmp_qp), min(tq, c(k,MicCol::mn))));
+        c(k,MicCol::mx) = rho1d_t(k)*(mx-tq)/(pn(c(kc,MicCol::www)) + pp(c(k,MicCol::www))+eps);
+        c(k,MicCol::mn) = rho1d_t(k)*(tq-mn)/(pp(c(kc,MicCol::www)) + pn(c(k,MicCol::www))+eps);
+      }
+
+      for (int k = zlo; k <= zhi; ++k) {
+        int kb = max(0,k-1);
+        Real www = c(k,MicCol::www);
+        c(k,MicCol::fz) += pp(www)*std::min(1.0,std::min(c(k ,MicCol::mx), c(kb,MicCol::mn))) -
+                           pn(www)*std::min(1.0,std::min(c(kb,MicCol::mx), c(k ,MicCol::mn)));
+      }
+
+      // Update precipitation mass fraction and liquid-ice static energy
+      for (int k = zlo; k <= zhi; ++k) {
+        int kc = min(k+1, nz-1);
+        Real irho = 1.0/rho1d_t(k);
+        c(k,MicCol::qp) = c(k,MicCol::qp) - (c(kc,MicCol::fz) - c(k,MicCol::fz))*irho;
+        Real lat_heat = -(c(kc,MicCol::lfac)*c(kc,MicCol::fz)-c(k,MicCol::lfac)*c(k,MicCol::fz))*irho;
+        c(k,MicCol::theta) -= lat_heat;
+      }
+
+      if (iprec < nprec) {
+        // Re-compute precipitation velocity using new value of qp.
+        for (int k = zlo; k <= zhi; ++k) {
+          Real tmp = term_vel_qp(i,j,k,c(k,MicCol::qp),
+                                 prm.vrain, prm.vsnow, prm.vgrau, rho1d_t(k),
+                                 c(k,MicCol::tabs));
+          Real wp = std::sqrt(1.29/rho1d_t(k))*tmp;
+          c(k,MicCol::wp) = -wp*rho1d_t(k)*dtn/dz/nprec;
+        }
+      }
+    }
+  }
+
+  // Update
+  for (int k = zlo; k <= zhi; ++k) {
+    Real rho = state(i,j,k,Rho_comp);
+    state(i,j,k,RhoTheta_comp) = rho*c(k,MicCol::theta);
+    state(i,j,k,RhoQt_comp)    = rho*c(k,MicCol::qt);
+    state(i,j,k,RhoQp_comp)    = rho*c(k,MicCol::qp);
+
+    // Graupel == precip total - rain - snow (but must be >= 0)
+    qm(i,j,k,5) = std::max(0.0, c(k,MicCol::qp)-qm(i,j,k,3)-qm(i,j,k,4));
+  }
+}
+
+} // namespace
+
+/**
+ * Advances the microphysics one column at a time.  Each column goes through all of the
+ * stages (Cloud, Diagnose, IceFall, Precip, PrecipFall and Update) while its work arrays
+ * are in cache, and the temperature is computed from the state rather than stored, so
+ * none of the 3D microphysics variables are allocated.  InitTables must be called first.
+ *
+ * @param[in,out] cons   Conserved variables
+ * @param[out]    qmoist qv, qc, qi, qr, qs, qg
+ * @param[in,out] cost   measured wall time of each box (not measured if null)
+ */
+void Microphysics::AdvanceColumns(MultiFab& cons,
+                                  MultiFab& qmoist,
+                                  LayoutData<Real>* cost)
+{
+  BL_PROFILE("Microphysics::AdvanceColumns()");
+
+  Real gamr3 = erf_gammafff(4.0+b_rain      );
+  Real gams3 = erf_gammafff(4.0+b_snow      );
+  Real gamg3 = erf_gammafff(4.0+b_grau      );
+
+  MicColumnParams prm;
+  prm.nz       = nlev;
+  prm.zlo      = zlo;
+  prm.zhi      = zhi;
+  prm.dt       = dt;
+  prm.dz       = m_geom.CellSize(2);
+  prm.fac_cond = m_fac_cond;
+  prm.fac_sub  = m_fac_sub;
+  prm.fac_fus  = m_fac_fus;
+  prm.vrain    = a_rain*gamr3/6.0/pow((PI*rhor*nzeror),crain);
+  prm.vsnow    = a_snow*gams3/6.0/pow((PI*rhos*nzeros),csnow);
+  prm.vgrau    = a_grau*gamg3/6.0/pow((PI*rhog*nzerog),cgrau);
+
+  prm.rho1d    = rho1d.table();
+  prm.pres1d   = pres1d.table();
+  prm.accrrc   = accrrc.table();
+  prm.accrsc   = accrsc.table();
+  prm.accrsi   = accrsi.table();
+  prm.accrgc   = accrgc.table();
+  prm.accrgi   = accrgi.table();
+  prm.coefice  = coefice.table();
+  prm.evapr1   = evapr1.table();
+  prm.evapr2   = evapr2.table();
+  prm.evaps1   = evaps1.table();
+  prm.evaps2   = evaps2.table();
+  prm.evapg1   = evapg1.table();
+  prm.evapg2   = evapg2.table();
+  prm.qifall   = qifall.table();
+  prm.tlatqi   = tlatqi.table();
+  prm.qpsrc    = qpsrc.table();
+  prm.qpevp    = qpevp.table();
+  prm.sat      = m_sat_table.view();
+
+  auto qifall_t = prm.qifall;
+  auto tlatqi_t = prm.tlatqi;
+  auto qpsrc_t  = prm.qpsrc;
+  auto qpevp_t  = prm.qpevp;
+  ParallelFor(nlev, [=] AMREX_GPU_DEVICE (int k) noexcept {
+    qifall_t(k) = 0.0;
+    tlatqi_t(k) = 0.0;
+    qpsrc_t(k)  = 0.0;
+    qpevp_t(k)  = 0.0;
+  });
+
+  // The stages only fill the valid cells
+  qmoist.setVal(0.);
+
+  const int nzp = nlev+1;
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  {
+#ifndef AMREX_USE_GPU
+    // Work arrays of the column being advanced by this thread
+    Vector<Real> col_buf(MicCol::NumVars*nzp);
+#endif
+
+    for ( MFIter mfi(cons, TileNoZ()); mfi.isValid(); ++mfi) {
+      BoxCostTimer box_timer(cost, mfi);
+
+      const Box& box3d = mfi.tilebox();
+      const Box  cbx   = box3d & m_gtoe[mfi.index()];
+
+      AMREX_ALWAYS_ASSERT_WITH_MESSAGE(box3d.smallEnd(2) == zlo && box3d.bigEnd(2) == zhi,
+                                       "AdvanceColumns: every box must span the vertical domain");
+
+      const Array4<Real>& state_arr  = cons.array(mfi);
+      const Array4<Real>& qmoist_arr = qmoist.array(mfi);
+
+      const Box box2d = makeSlab(box3d, 2, zlo);
+
+#ifdef AMREX_USE_GPU
+      // One thread per column; the work arrays of neighboring columns are adjacent
+      FArrayBox col_fab(box2d, MicCol::NumVars*nzp);
+      Elixir col_eli = col_fab.elixir();
+      const Array4<Real>& col_arr = col_fab.array();
+
+      ParallelFor(box2d, [=] AMREX_GPU_DEVICE (int i, int j, int) noexcept
+      {
+        MicColumn col{col_arr.ptr(i,j,zlo,0), zlo, nzp, col_arr.nstride};
+        MicrophysicsColumn(i, j, cbx, prm, state_arr, qmoist_arr, col);
+      });
+#else
+      MicColumn col{col_buf.data(), zlo, nzp, 1};
+      const auto lo = lbound(box2d);
+      const auto hi = ubound(box2d);
+      for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+          MicrophysicsColumn(i, j, cbx, prm, state_arr, qmoist_arr, col);
+        }
+      }
+#endif
+    }
+  }
+
+  // Fill interior ghost cells and periodic boundaries
+  cons.FillBoundary(m_geom.periodicity());
+  qmoist.FillBoundary(m_geom.periodicity());
+}
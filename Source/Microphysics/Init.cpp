@@ -2,7 +2,7 @@
 #include <AMReX_GpuContainers.H>
 #include "Microphysics.H"
 #include "IndexDefines.H"
-#include "PlaneAverage.H"
+#include "HorizontalAverager.H"
 #include "EOS.H"
 #include "TileNoZ.H"
 
@@ -12,25 +12,21 @@ using namespace amrex;
  * Initializes the Microphysics module.
  *
  * @param[in] cons_in Conserved variables input
- * @param[in] qc_in Cloud variables input
- * @param[in,out] qv_in Vapor variables input
- * @param[in] qi_in Ice variables input
+ * @param[in,out] qmoist Moisture variables, reset to zero before the diagnosis
  * @param[in] grids_to_evolve The boxes on which we will evolve the solution
  * @param[in] geom Geometry associated with these MultiFabs and grids
  * @param[in] dt_advance Timestep for the advance
+ * @param[in] h_averager Engine (and cache) for the horizontal averages
+ * @param[in] time Time of the data in cons_in, used as the cache key for the averages
  */
 void Microphysics::Init(const MultiFab& cons_in, MultiFab& qmoist,
                         const BoxArray& grids_to_evolve,
                         const Geometry& geom,
-                        const Real& dt_advance)
- {
-  m_geom = geom;
-  m_gtoe = grids_to_evolve;
-
-  auto dz   = m_geom.CellSize(2);
-  auto lowz = m_geom.ProbLo(2);
-
-  dt = dt_advance;
+                        const Real& dt_advance,
+                        HorizontalAverager& h_averager,
+                        const Real& time)
+{
+  InitTables(cons_in, grids_to_evolve, geom, dt_advance, h_averager, time);
 
   // initialize microphysics variables
   for (auto ivar = 0; ivar < MicVar::NumVars; ++ivar) {
@@ -42,6 +38,68 @@ void Microphysics::Init(const MultiFab& cons_in, MultiFab& qmoist,
   // The ghost cells of these arrays aren't filled in the boundary condition calls for the state
   qmoist.setVal(0.);
 
+  amrex::MultiFab qc(qmoist, amrex::make_alias, 1, 1);
+  amrex::MultiFab qi(qmoist, amrex::make_alias, 2, 1);
+
+  // Get the temperature, density, theta, qt and qp from input
+  for ( MFIter mfi(cons_in, false); mfi.isValid(); ++mfi) {
+     auto states_array = cons_in.array(mfi);
+     auto qc_array  = qc.array(mfi);
+     auto qi_array  = qi.array(mfi);
+
+     auto qt_array     = mic_fab_vars[MicVar::qt]->array(mfi);
+     auto qp_array     = mic_fab_vars[MicVar::qp]->array(mfi);
+     auto qn_array     = mic_fab_vars[MicVar::qn]->array(mfi);
+     auto rho_array    = mic_fab_vars[MicVar::rho]->array(mfi);
+     auto theta_array  = mic_fab_vars[MicVar::theta]->array(mfi);
+     auto temp_array   = mic_fab_vars[MicVar::tabs]->array(mfi);
+     auto pres_array   = mic_fab_vars[MicVar::pres]->array(mfi);
+
+     const auto& box3d = mfi.tilebox();
+
+     // Get pressure, theta, temperature, density, and qt, qp
+     amrex::ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+       rho_array(i,j,k)   = states_array(i,j,k,Rho_comp);
+       theta_array(i,j,k) = states_array(i,j,k,RhoTheta_comp)/states_array(i,j,k,Rho_comp);
+       qt_array(i,j,k)    = states_array(i,j,k,RhoQt_comp)/states_array(i,j,k,Rho_comp);
+       qp_array(i,j,k)    = states_array(i,j,k,RhoQp_comp)/states_array(i,j,k,Rho_comp);
+       qn_array(i,j,k)    = qc_array(i,j,k) + qi_array(i,j,k);
+       temp_array(i,j,k)  = getTgivenRandRTh(states_array(i,j,k,Rho_comp),states_array(i,j,k,RhoTheta_comp));
+       pres_array(i,j,k)  = getPgivenRTh(states_array(i,j,k,RhoTheta_comp))/100.;
+     });
+  }
+
+  // This fills qv
+  Diagnose();
+}
+
+/**
+ * Sets the vertical extent, the plane averages and the coefficient tables for one
+ * advance.  These are all the data needed by AdvanceColumns; Init also fills the
+ * 3D microphysics variables.
+ *
+ * @param[in] cons_in Conserved variables input
+ * @param[in] grids_to_evolve The boxes on which we will evolve the solution
+ * @param[in] geom Geometry associated with these MultiFabs and grids
+ * @param[in] dt_advance Timestep for the advance
+ * @param[in] h_averager Engine (and cache) for the horizontal averages
+ * @param[in] time Time of the data in cons_in, used as the cache key for the averages
+ */
+void Microphysics::InitTables(const MultiFab& cons_in,
+                              const BoxArray& grids_to_evolve,
+                              const Geometry& geom,
+                              const Real& dt_advance,
+                              HorizontalAverager& h_averager,
+                              const Real& time)
+ {
+  m_geom = geom;
+  m_gtoe = grids_to_evolve;
+
+  auto dz   = m_geom.CellSize(2);
+  auto lowz = m_geom.ProbLo(2);
+
+  dt = dt_advance;
+
   for ( MFIter mfi(cons_in, TileNoZ()); mfi.isValid(); ++mfi) {
 
      const auto& box3d = mfi.tilebox();
@@ -98,6 +156,7 @@ void Microphysics::Init(const MultiFab& cons_in, MultiFab& qmoist,
   auto rho1d_t  = rho1d.table();
   auto pres1d_t = pres1d.table();
   auto tabs1d_t = tabs1d.table();
+  auto sat      = m_sat_table.view();
   auto qpsrc_t  = qpsrc.table();
   auto qpevp_t  = qpevp.table();
 
@@ -115,48 +174,16 @@ void Microphysics::Init(const MultiFab& cons_in, MultiFab& qmoist,
   Real gamg2 = erf_gammafff((5.0+b_grau)/2.0);
   // Real gamg3 = erf_gammafff(4.0+b_grau      );
 
-  amrex::MultiFab qv(qmoist, amrex::make_alias, 0, 1);
-  amrex::MultiFab qc(qmoist, amrex::make_alias, 1, 1);
-  amrex::MultiFab qi(qmoist, amrex::make_alias, 2, 1);
-
-  // Get the temperature, density, theta, qt and qp from input
-  for ( MFIter mfi(cons_in, false); mfi.isValid(); ++mfi) {
-     auto states_array = cons_in.array(mfi);
-     auto qc_array  = qc.array(mfi);
-     auto qi_array  = qi.array(mfi);
-
-     auto qt_array     = mic_fab_vars[MicVar::qt]->array(mfi);
-     auto qp_array     = mic_fab_vars[MicVar::qp]->array(mfi);
-     auto qn_array     = mic_fab_vars[MicVar::qn]->array(mfi);
-     auto rho_array    = mic_fab_vars[MicVar::rho]->array(mfi);
-     auto theta_array  = mic_fab_vars[MicVar::theta]->array(mfi);
-     auto temp_array   = mic_fab_vars[MicVar::tabs]->array(mfi);
-     auto pres_array   = mic_fab_vars[MicVar::pres]->array(mfi);
-
-     const auto& box3d = mfi.tilebox();
-
-     // Get pressure, theta, temperature, density, and qt, qp
-     amrex::ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-       rho_array(i,j,k)   = states_array(i,j,k,Rho_comp);
-       theta_array(i,j,k) = states_array(i,j,k,RhoTheta_comp)/states_array(i,j,k,Rho_comp);
-       qt_array(i,j,k)    = states_array(i,j,k,RhoQt_comp)/states_array(i,j,k,Rho_comp);
-       qp_array(i,j,k)    = states_array(i,j,k,RhoQp_comp)/states_array(i,j,k,Rho_comp);
-       qn_array(i,j,k)    = qc_array(i,j,k) + qi_array(i,j,k);
-       temp_array(i,j,k)  = getTgivenRandRTh(states_array(i,j,k,Rho_comp),states_array(i,j,k,RhoTheta_comp));
-       pres_array(i,j,k)  = getPgivenRTh(states_array(i,j,k,RhoTheta_comp))/100.;
-     });
-  }
-
   // calculate the plane average variables
-  PlaneAverage cons_ave(&cons_in, m_geom, m_axis);
-  cons_ave.compute_averages(ZDir(), cons_ave.field());
+  const auto& havg = h_averager.average("microphysics", time, m_geom,
+                                        {{&cons_in, Rho_comp}, {&cons_in, RhoTheta_comp}});
 
   // get host variable rho, and rhotheta
-  int ncell = cons_ave.ncell_line();
+  int ncell = havg.ncell_line;
 
   Gpu::HostVector<Real> rho_h(ncell), rhotheta_h(ncell);
-  cons_ave.line_average(Rho_comp, rho_h);
-  cons_ave.line_average(RhoTheta_comp, rhotheta_h);
+  havg.line_average(0, rho_h);
+  havg.line_average(1, rhotheta_h);
 
   // copy data to device
   Gpu::DeviceVector<Real> rho_d(ncell), rhotheta_d(ncell);
@@ -178,9 +205,6 @@ void Microphysics::Init(const MultiFab& cons_in, MultiFab& qmoist,
     gamaz_t(k)  = gOcp*zmid_t(k);
   });
 
-  // This fills qv
-  Diagnose();
-
 #if 0
   amrex::ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int k, int j, int i) {
     fluxbmk(l,j,i) = 0.0;
@@ -210,8 +234,8 @@ void Microphysics::Init(const MultiFab& cons_in, MultiFab& qmoist,
     Real pratio = sqrt(1.29 / rho1d_t(k));
     Real rrr1=393.0/(tabs1d_t(k)+120.0)*std::pow((tabs1d_t(k)/273.0),1.5);
     Real rrr2=std::pow((tabs1d_t(k)/273.0),1.94)*(1000.0/pres1d_t(k));
-    Real estw = 100.0*erf_esatw(tabs1d_t(k));
-    Real esti = 100.0*erf_esati(tabs1d_t(k));
+    Real estw = 100.0*sat.esatw(tabs1d_t(k));
+    Real esti = 100.0*sat.esati(tabs1d_t(k));
 
     // accretion by snow:
     Real coef1 = 0.25 * PI * nzeros * a_snow * gams1 * pratio/pow((PI * rhos * nzeros/rho1d_t(k) ) , ((3.0+b_snow)/4.0));
@@ -32,6 +32,7 @@ void Microphysics::Precip() {
   auto qpsrc_t   = qpsrc.table();
   auto qpevp_t   = qpevp.table();
   auto pres1d_t  = pres1d.table();
+  auto sat       = m_sat_table.view();
 
   auto qt   = mic_fab_vars[MicVar::qt];
   auto qp   = mic_fab_vars[MicVar::qp];
@@ -116,11 +117,11 @@ void Microphysics::Precip() {
 
            qsatt = 0.0;
            if(omn > 0.001) {
-             erf_qsatw(tabs_array(i,j,k),pres1d_t(k),qsat);
+             sat.qsatw(tabs_array(i,j,k),pres1d_t(k),qsat);
              qsatt = qsatt + omn*qsat;
            }
            if(omn < 0.999) {
-             erf_qsati(tabs_array(i,j,k),pres1d_t(k),qsat);
+             sat.qsati(tabs_array(i,j,k),pres1d_t(k),qsat);
              qsatt = qsatt + (1.-omn)*qsat;
            }
            dq = 0.0;
@@ -0,0 +1,131 @@
+#include <AMReX_Print.H>
+#include <AMReX_Reduce.H>
+
+#include "SatVapTable.H"
+
+using namespace amrex;
+
+constexpr Real SatVapTable::tmin;
+constexpr Real SatVapTable::tmax;
+constexpr Real SatVapTable::dT;
+
+namespace {
+
+/**
+ * Fill the coefficients of each cell of tab from the values of f at the four Chebyshev
+ * points of the cell.  The cubic through them is kept as is for order 3, and reduced
+ * to its values at the ends of the cell for order 1, so that the linear interpolant
+ * is continuous except at the breaks of f.
+ */
+template<typename F>
+void
+FillSatVapTable (TableData<Real,2>& tab, int ncell, int order, F f)
+{
+    const Real tmin = SatVapTable::tmin;
+    const Real dT   = SatVapTable::dT;
+    auto tab_t = tab.table();
+
+    ParallelFor(ncell, [=] AMREX_GPU_DEVICE (int i) noexcept
+    {
+        Real s[4], d[4];
+        for (int m = 0; m < 4; ++m) {
+            s[m] = 0.5 - 0.5*std::cos(PI*(2*m+1)/8.0);
+            d[m] = f(tmin + (Real(i) + s[m])*dT);
+        }
+
+        // Newton divided differences, then expansion into powers of the position in the cell
+        for (int l = 1; l < 4; ++l) {
+            for (int m = 3; m >= l; --m) {
+                d[m] = (d[m] - d[m-1]) / (s[m] - s[m-l]);
+            }
+        }
+        Real c[4] = {d[3], 0.0, 0.0, 0.0};
+        for (int l = 2; l >= 0; --l) {
+            for (int m = 3; m > 0; --m) {
+                c[m] = c[m-1] - s[l]*c[m];
+            }
+            c[0] = d[l] - s[l]*c[0];
+        }
+
+        if (order == 1) {
+            tab_t(0,i) = c[0];
+            tab_t(1,i) = c[1] + c[2] + c[3];
+            tab_t(2,i) = 0.0;
+            tab_t(3,i) = 0.0;
+        } else {
+            for (int m = 0; m < 4; ++m) tab_t(m,i) = c[m];
+        }
+    });
+}
+
+}
+
+void
+SatVapTable::define (int order)
+{
+    if (order == m_order) return;
+
+    AMREX_ALWAYS_ASSERT(order == 0 || order == 1 || order == 3);
+    m_order = order;
+    if (m_order == 0) {
+        m_ncell = 0;
+        return;
+    }
+
+    BL_PROFILE("SatVapTable::define()");
+
+    m_ncell = static_cast<int>(std::round((tmax - tmin) / dT));
+    for (auto* tab : {&m_esatw, &m_esati, &m_dtesatw, &m_dtesati}) {
+        tab->resize({0,0}, {3,m_ncell-1});
+    }
+
+    FillSatVapTable(m_esatw  , m_ncell, m_order, [] AMREX_GPU_DEVICE (Real t) { return erf_esatw(t); });
+    FillSatVapTable(m_esati  , m_ncell, m_order, [] AMREX_GPU_DEVICE (Real t) { return erf_esati(t); });
+    FillSatVapTable(m_dtesatw, m_ncell, m_order, [] AMREX_GPU_DEVICE (Real t) { return erf_dtesatw(t); });
+    FillSatVapTable(m_dtesati, m_ncell, m_order, [] AMREX_GPU_DEVICE (Real t) { return erf_dtesati(t); });
+
+    // Largest relative error against the analytic functions, sampled off the table nodes
+    const int  nsub = 16;
+    const Real tlo  = tmin;
+    const Real dt   = dT / Real(nsub);
+    const SatVapTableView sat = view();
+
+    ReduceOps<ReduceOpMax, ReduceOpMax, ReduceOpMax, ReduceOpMax> reduce_op;
+    ReduceData<Real, Real, Real, Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+
+    reduce_op.eval(m_ncell*nsub, reduce_data,
+    [=] AMREX_GPU_DEVICE (int n) -> ReduceTuple
+    {
+        Real t = tlo + (Real(n) + 0.37) * dt;
+        return { std::abs(sat.esatw(t)   - erf_esatw(t))   / std::abs(erf_esatw(t)),
+                 std::abs(sat.esati(t)   - erf_esati(t))   / std::abs(erf_esati(t)),
+                 std::abs(sat.dtesatw(t) - erf_dtesatw(t)) / std::abs(erf_dtesatw(t)),
+                 std::abs(sat.dtesati(t) - erf_dtesati(t)) / std::abs(erf_dtesati(t)) };
+    });
+
+    ReduceTuple hv = reduce_data.value();
+    Real err[4] = {amrex::get<0>(hv), amrex::get<1>(hv), amrex::get<2>(hv), amrex::get<3>(hv)};
+
+    amrex::Print() << "Saturation vapor pressure table (" << ((m_order == 1) ? "linear" : "cubic")
+                   << ", " << m_ncell << " cells of " << dT << " K from " << tmin << " to " << tmax
+                   << " K): max relative error esatw " << err[0] << ", esati " << err[1]
+                   << ", dtesatw " << err[2] << ", dtesati " << err[3] << std::endl;
+}
+
+SatVapTableView
+SatVapTable::view () const
+{
+    SatVapTableView sat;
+    if (m_order == 0) return sat;
+
+    sat.order     = m_order;
+    sat.ncell     = m_ncell;
+    sat.tmin      = tmin;
+    sat.dtinv     = 1.0 / dT;
+    sat.esatw_t   = m_esatw.const_table();
+    sat.esati_t   = m_esati.const_table();
+    sat.dtesatw_t = m_dtesatw.const_table();
+    sat.dtesati_t = m_dtesati.const_table();
+    return sat;
+}
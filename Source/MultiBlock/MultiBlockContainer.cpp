@@ -2,10 +2,33 @@
 #include <AMReX_NonLocalBC.H>
 #include <ERF.H>
 
+namespace {
+    /**
+     * Append the copy tags of one communication pattern to another
+     *
+     * The tags going to (and coming from) each rank are appended in the same order on
+     * both sides, so the merged pattern is again consistent between the ranks.
+     */
+    void append_tags (amrex::FabArrayBase::CommMetaData& to,
+                      const amrex::FabArrayBase::CommMetaData& from)
+    {
+        to.m_LocTags->insert(to.m_LocTags->end(), from.m_LocTags->begin(), from.m_LocTags->end());
+        for (const auto& kv : *from.m_SndTags) {
+            auto& tags = (*to.m_SndTags)[kv.first];
+            tags.insert(tags.end(), kv.second.begin(), kv.second.end());
+        }
+        for (const auto& kv : *from.m_RcvTags) {
+            auto& tags = (*to.m_RcvTags)[kv.first];
+            tags.insert(tags.end(), kv.second.begin(), kv.second.end());
+        }
+    }
+}
+
 /**
  * Constructor for the MultiBlockContainer class capable of taking a vector of boxes as input.
  *
- * Inputs that are vectors are used to define the two ERF instances in the MultiBlock class.
+ * Inputs that are vectors are used to define the ERF instances in the MultiBlock class,
+ * one per entry.  Block 0 is the outer block; the other blocks get their ghost cells from it.
  *
  * @param[in] rb_v Vector of RealBoxes to define this MultiBlock
  * @param[in] max_level_in_v Maximum level vector
@@ -24,28 +47,37 @@ MultiBlockContainer::MultiBlockContainer(const std::vector<amrex::RealBox>& rb_v
                                          const std::vector<amrex::Array<int,AMREX_SPACEDIM>>& is_per_v,
                                          std::vector<std::string> prefix_v,
                                          int max_step)
-: m_max_step(max_step),
-  erf1(rb_v[0],max_level_in_v[0],n_cell_in_v[0],coord_v[0],ref_ratios_v[0],is_per_v[0],prefix_v[0]),
-  erf2(rb_v[1],max_level_in_v[1],n_cell_in_v[1],coord_v[1],ref_ratios_v[1],is_per_v[1],prefix_v[1])
+: m_max_step(max_step)
 {
-    // Store ptr to container to call member functions
-    erf1.SetMultiBlockPointer(this);
-    erf2.SetMultiBlockPointer(this);
+    const int nblocks = rb_v.size();
+    AMREX_ALWAYS_ASSERT(nblocks >= 2);
+
+    for (int b = 0; b < nblocks; ++b) {
+        erf_blocks.push_back(std::make_unique<ERF>(rb_v[b],max_level_in_v[b],n_cell_in_v[b],coord_v[b],
+                                                   ref_ratios_v[b],is_per_v[b],prefix_v[b]));
 
-    // Set the permutation/sign of dtos
-    dtos.permutation = amrex::IntVect{AMREX_D_DECL(   0,   1,   2)};
-    dtos.sign        = amrex::IntVect{AMREX_D_DECL(   1,   1,   1)};
+        // Store ptr to container to call member functions
+        erf_blocks[b]->SetMultiBlockPointer(this);
+    }
 
-    // Set offset of dtos (NOTE: i_dst =  i_src - i_off -> [0] - [1])
+    // Set the permutation/sign/offset of dtos for every block but the first
+    dtos.resize(nblocks);
     amrex::Real dx = ( rb_v[0].hi(0) - rb_v[0].lo(0) ) / n_cell_in_v[0][0];
     amrex::Real dy = ( rb_v[0].hi(1) - rb_v[0].lo(1) ) / n_cell_in_v[0][1];
     amrex::Real dz = ( rb_v[0].hi(2) - rb_v[0].lo(2) ) / n_cell_in_v[0][2];
-    int offx = amrex::Math::floor(( rb_v[0].lo(0) - rb_v[1].lo(0) ) / dx);
-    int offy = amrex::Math::floor(( rb_v[0].lo(1) - rb_v[1].lo(1) ) / dy);
-    int offz = amrex::Math::floor(( rb_v[0].lo(2) - rb_v[1].lo(2) ) / dz);
-    // DEBUG
-    //offx=0; offy=0; offz=0;
-    dtos.offset = amrex::IntVect{AMREX_D_DECL(offx, offy, offz)};
+    for (int b = 1; b < nblocks; ++b) {
+        dtos[b].permutation = amrex::IntVect{AMREX_D_DECL(   0,   1,   2)};
+        dtos[b].sign        = amrex::IntVect{AMREX_D_DECL(   1,   1,   1)};
+
+        // Set offset of dtos (NOTE: i_dst =  i_src - i_off -> [0] - [b])
+        int offx = amrex::Math::floor(( rb_v[0].lo(0) - rb_v[b].lo(0) ) / dx);
+        int offy = amrex::Math::floor(( rb_v[0].lo(1) - rb_v[b].lo(1) ) / dy);
+        int offz = amrex::Math::floor(( rb_v[0].lo(2) - rb_v[b].lo(2) ) / dz);
+        dtos[b].offset = amrex::IntVect{AMREX_D_DECL(offx, offy, offz)};
+    }
+
+    // This must be done before the grids are made in InitializeBlocks
+    SplitRanks(n_cell_in_v);
 }
 
 /**
@@ -53,6 +85,78 @@ MultiBlockContainer::MultiBlockContainer(const std::vector<amrex::RealBox>& rb_v
  */
 MultiBlockContainer::~MultiBlockContainer()
 {
+#ifdef AMREX_USE_MPI
+    if (m_block_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&m_block_comm);
+    }
+#endif
+}
+
+/**
+ * Split the ranks into disjoint contiguous sets, one per block, with sizes in proportion
+ * to the number of cells of each block.  Each block only places its grids on its own
+ * ranks so that the blocks can be advanced at the same time.  This is only done if
+ * concurrent_blocks is set and there are at least as many ranks as blocks.
+ *
+ * @param[in] n_cell_in_v Number of cells vector
+ */
+void
+MultiBlockContainer::SplitRanks(const std::vector<amrex::Vector<int>>& n_cell_in_v)
+{
+    amrex::ParmParse pp;
+    pp.query("concurrent_blocks", m_concurrent);
+
+    const int nblocks = erf_blocks.size();
+    const int nprocs  = amrex::ParallelDescriptor::NProcs();
+    if (!m_concurrent) return;
+
+    if (nprocs < nblocks) {
+        amrex::Print() << "Fewer ranks than blocks; the blocks are advanced one after the other" << std::endl;
+        m_concurrent = false;
+        return;
+    }
+
+    amrex::Vector<amrex::Long> ncells(nblocks, 1);
+    amrex::Long ncells_total = 0;
+    for (int b = 0; b < nblocks; ++b) {
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+            ncells[b] *= n_cell_in_v[b][dir];
+        }
+        ncells_total += ncells[b];
+    }
+
+    amrex::Vector<int> nranks(nblocks);
+    int nassigned = 0;
+    for (int b = 0; b < nblocks; ++b) {
+        nranks[b] = std::max(1, static_cast<int>((static_cast<amrex::Long>(nprocs) * ncells[b]) / ncells_total));
+        nassigned += nranks[b];
+    }
+
+    // Give the ranks left over by the rounding to (or take the excess from) the largest sets
+    while (nassigned != nprocs) {
+        int bmax = static_cast<int>(std::max_element(nranks.begin(), nranks.end()) - nranks.begin());
+        if (nassigned < nprocs) {
+            ++nranks[bmax];
+            ++nassigned;
+        } else {
+            --nranks[bmax];
+            --nassigned;
+        }
+    }
+
+    const int myproc = amrex::ParallelDescriptor::MyProc();
+    int rank_lo = 0;
+    for (int b = 0; b < nblocks; ++b) {
+        erf_blocks[b]->SetBlockRanks(rank_lo, nranks[b]);
+        if (myproc >= rank_lo && myproc < rank_lo + nranks[b]) m_my_block = b;
+        amrex::Print() << "Block " << b << " is advanced on ranks " << rank_lo
+                       << " to " << rank_lo + nranks[b] - 1 << std::endl;
+        rank_lo += nranks[b];
+    }
+
+#ifdef AMREX_USE_MPI
+    MPI_Comm_split(amrex::ParallelDescriptor::Communicator(), m_my_block, myproc, &m_block_comm);
+#endif
 }
 
 /**
@@ -61,8 +165,13 @@ MultiBlockContainer::~MultiBlockContainer()
 void
 MultiBlockContainer::InitializeBlocks()
 {
-    erf1.InitData();
-    erf2.InitData();
+    for (auto& erf : erf_blocks) {
+        erf->InitData();
+    }
+
+    // The communication between the blocks needs the grids of level 0 of all blocks
+    SetBoxLists();
+    SetBlockCommMetaData();
 }
 
 /**
@@ -71,50 +180,31 @@ MultiBlockContainer::InitializeBlocks()
 void
 MultiBlockContainer::SetBoxLists()
 {
-    // Hard-coded bounds for now
-    int nvars  = erf2.vars_new[0].size();
-    int ndirs  = AMREX_SPACEDIM;
-
-    for (int i(0); i<nvars; ++i) {
-        // Get ghost cells, domain & grown box
-        amrex::IntVect nghost = erf2.vars_new[0][i].nGrowVect();
-        amrex::Box dom = erf2.domain_p[i];
-        amrex::Box gbx = grow(dom,nghost);
-        // Tmp BoxList
-        amrex::BoxList bl;
-        bl.clear();
-        bl.set(gbx.ixType());
-        for (int j(0); j<ndirs; ++j) {
-            // Local box copies
-            amrex::Box lgbx(gbx);
-            amrex::Box ugbx(gbx);
-            // Get lower & upper bound
-            int se = dom.smallEnd(j) - 1;
-            int be = dom.bigEnd(j)   + 1;
-            // Modify bounds for nodal vars
-            if (gbx.ixType().nodeCentered(j)) {
-                se += 1;
-                be -= 1;
-            }
-            // Populate BoxList
-            bl.push_back( lgbx.setBig(j,se) );
-            bl.push_back( ugbx.setSmall(j,be) );
-        }
-        blv.push_back(bl);
-    }
+    const int nblocks = erf_blocks.size();
 
-    /*
-    // DEBUG BOX LIST
-    for (int i(0); i<nvars; ++i) {
-        amrex::Print() << "DOM: " << erf2.domain_p[i] << "\n";
-        amrex::Print() << "BA: " << erf2.vars_new[0][i].boxArray() << "\n";
-        for (int j(0); j<6; ++j)
-            amrex::Print() << (blv[i].data())[j] << "\n";
+    blv.clear();
+    blv.resize(nblocks);
 
-        amrex::Print() << "\n";
+    for (int b = 1; b < nblocks; ++b) {
+        const ERF& erf_dst = *erf_blocks[b];
+        int nvars = erf_dst.vars_new[0].size();
+
+        for (int i(0); i<nvars; ++i) {
+            // Get ghost cells, domain & grown box
+            amrex::IntVect nghost = erf_dst.vars_new[0][i].nGrowVect();
+            amrex::Box dom = erf_dst.domain_p[i];
+            amrex::Box gbx = grow(dom,nghost);
+
+            // Nodal vars are also filled on the faces of the domain
+            amrex::Box interior(dom);
+            for (int j(0); j<AMREX_SPACEDIM; ++j) {
+                if (gbx.ixType().nodeCentered(j)) interior.grow(j,-1);
+            }
+
+            // Disjoint boxes covering the ghost cells (and boundary faces) of the block
+            blv[b].push_back(amrex::complementIn(gbx, amrex::BoxList(interior)));
+        }
     }
-    exit(0);
-    */
 }
 
 /**
@@ -123,45 +213,92 @@ MultiBlockContainer::SetBoxLists()
 void
 MultiBlockContainer::SetBlockCommMetaData()
 {
-    // Hard-coded bounds for now
-    int nvars  = erf2.vars_new[0].size(); // Destination MF
-    int ndirs  = AMREX_SPACEDIM;
-
-    // Loop over num_vars to set communicator
-    for (int i(0); i<nvars; ++i) {
-        // Make space
-        cmd.push_back(std::vector<amrex::NonLocalBC::MultiBlockCommMetaData*>());
-        // Get ghost cell vector for multifab growth
-        amrex::IntVect nghost = erf2.vars_new[0][i].nGrowVect();
-        for (int j(0); j<2*ndirs; ++j) {
-
-            // Store temp ptr to communicator for i^th variable
-            amrex::NonLocalBC::MultiBlockCommMetaData *cmd_tmp =
-                new amrex::NonLocalBC::MultiBlockCommMetaData(erf2.vars_new[0][i], (blv[i].data())[j],
-                                                              erf1.vars_new[0][i], nghost, dtos);
-            // Populate cmd vector
-            cmd[i].push_back(cmd_tmp);
+    const int nblocks = erf_blocks.size();
+
+    cmd.clear();
+    cmd.resize(nblocks);
+
+    for (int b = 1; b < nblocks; ++b) {
+        ERF& erf_dst = *erf_blocks[b];
+        ERF& erf_src = *erf_blocks[0];
+        int nvars = erf_dst.vars_new[0].size(); // Destination MF
+
+        // Loop over num_vars to set communicator
+        for (int i(0); i<nvars; ++i) {
+            // Get ghost cell vector for multifab growth
+            amrex::IntVect nghost = erf_dst.vars_new[0][i].nGrowVect();
+
+            // One pattern for all the faces, so the copy is posted once per variable
+            std::unique_ptr<amrex::NonLocalBC::MultiBlockCommMetaData> cmd_var;
+            for (const auto& bx : blv[b][i]) {
+                if (!cmd_var) {
+                    cmd_var = std::make_unique<amrex::NonLocalBC::MultiBlockCommMetaData>
+                        (erf_dst.vars_new[0][i], bx, erf_src.vars_new[0][i], nghost, dtos[b]);
+                } else {
+                    amrex::NonLocalBC::MultiBlockCommMetaData cmd_face
+                        (erf_dst.vars_new[0][i], bx, erf_src.vars_new[0][i], nghost, dtos[b]);
+                    append_tags(*cmd_var, cmd_face);
+                }
+            }
+            cmd[b].push_back(std::move(cmd_var));
         }
     }
 }
 
 /**
- * Advance blocks in the MultiBlockContainer by calling each timestep advance sequentially.
+ * Advance blocks in the MultiBlockContainer.  By default each timestep advance is called
+ * sequentially and the ghost cells of the inner blocks are filled from block 0 right after it
+ * advances; with concurrent_blocks the blocks advance at the same time, each on its own ranks,
+ * and the inner blocks are filled after all of them.  The output of every block is written by
+ * all ranks.
  */
 void
 MultiBlockContainer::AdvanceBlocks()
 {
+    const int nblocks = erf_blocks.size();
+
     amrex::Print() << "STARTING MAIN DRIVER FOR: " << m_max_step << " STEPS" << "\n";
     amrex::Print() << "\n";
 
     for (int step(1); step <= m_max_step; ++step) {
         amrex::Print() << "    STARTING ADVANCE DRIVER: " << step << "\n";
         amrex::Print() << "===================================="  << "\n";
-        erf1.Evolve_MB(step,1);
-        amrex::Print() << '\n';
-        amrex::Print() << "        SECOND BLOCK STARTS         "  << "\n";
-        amrex::Print() << "------------------------------------"  << "\n";
-        erf2.Evolve_MB(step,1);
+
+        amrex::Vector<int> advanced(nblocks, 0);
+        if (m_concurrent) {
+            amrex::ParallelContext::push(m_block_comm);
+            advanced[m_my_block] = erf_blocks[m_my_block]->Advance_MB(step-1);
+            amrex::ParallelContext::pop();
+
+            // The other ranks need the times and step counters of each block for the output
+            for (int b = 0; b < nblocks; ++b) {
+                const int root = erf_blocks[b]->m_block_rank_lo;
+                amrex::ParallelDescriptor::Bcast(&advanced[b], 1, root);
+                erf_blocks[b]->BroadcastBlockTimes(root);
+            }
+
+            // Multiblock: the inner blocks advanced with the ghost cells filled at the
+            //    previous step, so they are filled from the outer one only now
+            FillPatchBlocks();
+        } else {
+            for (int b = 0; b < nblocks; ++b) {
+                if (b > 0) {
+                    amrex::Print() << '\n';
+                    amrex::Print() << "        BLOCK " << b << " STARTS         "  << "\n";
+                    amrex::Print() << "------------------------------------"  << "\n";
+                }
+                advanced[b] = erf_blocks[b]->Advance_MB(step-1);
+
+                // Multiblock: fill the inner blocks from the outer one before they advance
+                if (b == 0) FillPatchBlocks();
+            }
+        }
+
+        for (int b = 0; b < nblocks; ++b) {
+            if (advanced[b]) erf_blocks[b]->PostStep_MB(step-1);
+            erf_blocks[b]->FinishEvolve_MB();
+        }
+
         amrex::Print() << "COMPLETE" << "\n";
         amrex::Print() << "\n";
     }
@@ -171,16 +308,20 @@ MultiBlockContainer::AdvanceBlocks()
  * Wrapper for ParallelCopy between classes
  */
 void
-MultiBlockContainer::FillPatchBlocks(int src_ind, int dst_ind)
+MultiBlockContainer::FillPatchBlocks()
 {
-    // Hard-coded bounds for now
-    int ndirs  = AMREX_SPACEDIM;
-
-    // Loop faces of box to perform ParallelCopy
-    // NOTE - cmd built with ERF2 so uses dst_ind
-    for (int j(0); j<2*ndirs; ++j)
-        amrex::NonLocalBC::ParallelCopy(erf2.vars_new[0][dst_ind], erf1.vars_new[0][src_ind],
-                                        *(cmd[dst_ind][j]), 0, 0, 1, dtos);
-}
+    BL_PROFILE("MultiBlockContainer::FillPatchBlocks()");
 
+    const int nblocks = erf_blocks.size();
+    const ERF& erf_src = *erf_blocks[0];
 
+    // NOTE - cmd built with the destination block so uses its index
+    for (int b = 1; b < nblocks; ++b) {
+        ERF& erf_dst = *erf_blocks[b];
+        for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx) {
+            if (!cmd[b][var_idx]) continue;
+            amrex::NonLocalBC::ParallelCopy(erf_dst.vars_new[0][var_idx], erf_src.vars_new[0][var_idx],
+                                            *(cmd[b][var_idx]), 0, 0, 1, dtos[b]);
+        }
+    }
+}
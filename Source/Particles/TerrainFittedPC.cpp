@@ -1,4 +1,5 @@
 #include "TerrainFittedPC.H"
+#include "BoxCost.H"
 
 #include <AMReX_TracerParticle_mod_K.H>
 
@@ -30,11 +31,32 @@ namespace
         u[1] = u_mean + uy_th;
         u[2] = u_mean + uz_th;
     }
+
+    /**
+     * Index k of the cell of column (ii,jj) with z(k) < z <= z(k+1), found by bisection
+     * between k_min and k_max, so that it is right however far the particle has moved
+     */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    int find_vertical_index (const Array4<const Real>& zheight, int ii, int jj,
+                             int k_min, int k_max, ParticleReal z)
+    {
+        int klo = k_min;
+        int khi = k_max;
+        while (klo < khi) {
+            int kmid = (klo + khi + 1) / 2;
+            if (z > zheight(ii, jj, kmid)) {
+                klo = kmid;
+            } else {
+                khi = kmid - 1;
+            }
+        }
+        return klo;
+    }
 }
 
 void
 TerrainFittedPC::
-InitParticles (const MultiFab& a_z_height)
+InitParticles (const Vector<std::unique_ptr<MultiFab>>& a_z_height)
 {
     BL_PROFILE("TerrainFittedPC::InitParticles");
 
@@ -42,11 +64,15 @@ InitParticles (const MultiFab& a_z_height)
     const Real* dx = Geom(lev).CellSize();
     const Real* plo = Geom(lev).ProbLo();
 
+    const MultiFab& z_height = *HeightView(*a_z_height[lev], lev);
+
     for(MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
     {
         const Box& tile_box  = mfi.tilebox();
-        const auto& height = a_z_height[mfi];
+        const auto& height = z_height[mfi];
         Gpu::HostVector<ParticleType> host_particles;
+        std::array<Gpu::HostVector<ParticleReal>, RealIdx::ncomps> host_real;
+        std::array<Gpu::HostVector<int>, IntIdx::ncomps> host_int;
         for (IntVect iv = tile_box.smallEnd(); iv <= tile_box.bigEnd(); tile_box.next(iv)) {
             Real r[3] = {0.5, 0.5, 0.5};  // this means place at cell center
             Real v[3] = {0.0, 0.0, 0.0};  // with 0 initial velocity
@@ -62,13 +88,13 @@ InitParticles (const MultiFab& a_z_height)
             p.pos(1) = y;
             p.pos(2) = z;
 
-            p.rdata(RealIdx::vx) = v[0];
-            p.rdata(RealIdx::vy) = v[1];
-            p.rdata(RealIdx::vz) = v[2];
+            host_particles.push_back(p);
 
-            p.idata(IntIdx::k) = iv[2];  // particles carry their z-index
+            host_real[RealIdx::vx].push_back(v[0]);
+            host_real[RealIdx::vy].push_back(v[1]);
+            host_real[RealIdx::vz].push_back(v[2]);
 
-            host_particles.push_back(p);
+            host_int[IntIdx::k].push_back(iv[2]);  // particles carry their z-index
         }
 
         auto& particles = GetParticles(lev);
@@ -81,14 +107,137 @@ InitParticles (const MultiFab& a_z_height)
                   host_particles.begin(),
                   host_particles.end(),
                   particle_tile.GetArrayOfStructs().begin() + old_size);
+
+        auto& soa = particle_tile.GetStructOfArrays();
+        for (int comp = 0; comp < RealIdx::ncomps; comp++) {
+            Gpu::copy(Gpu::hostToDevice,
+                      host_real[comp].begin(),
+                      host_real[comp].end(),
+                      soa.GetRealData(comp).begin() + old_size);
+        }
+        for (int comp = 0; comp < IntIdx::ncomps; comp++) {
+            Gpu::copy(Gpu::hostToDevice,
+                      host_int[comp].begin(),
+                      host_int[comp].end(),
+                      soa.GetIntData(comp).begin() + old_size);
+        }
+    }
+
+    // Move the particles to the finest level that covers them; the index carried from
+    //     level 0 is then that of the wrong level or grid, so it is found again
+    Redistribute();
+
+    for (int l = 0; l <= finestLevel(); ++l) {
+        SetVerticalIndex(l, *a_z_height[l]);
+    }
+}
+
+/*
+  /brief Sets the vertical index carried by the particles of level lev from their position.
+*/
+void
+TerrainFittedPC::SetVerticalIndex (int lev, const MultiFab& a_z_height)
+{
+    BL_PROFILE("TerrainFittedPC::SetVerticalIndex()");
+
+    const Geometry& geom = m_gdb->Geom(lev);
+    const auto plo = geom.ProbLoArray();
+    const auto dxi = geom.InvCellSizeArray();
+    const auto dom_lo = lbound(geom.Domain());
+
+    const MultiFab& z_height = *HeightView(a_z_height, lev);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (ParIterType pti(*this, lev); pti.isValid(); ++pti)
+    {
+        auto& ptile = ParticlesAt(lev, pti);
+        auto& aos  = ptile.GetArrayOfStructs();
+        auto& soa  = ptile.GetStructOfArrays();
+        const int n = aos.numParticles();
+        const auto *p_pbox = aos().data();
+        int* p_k = soa.GetIntData(IntIdx::k).data();
+
+        const auto zheight = z_height.const_array(pti.index());
+        const Dim3 z_lo = lbound(zheight);
+        const Dim3 z_hi = ubound(zheight);
+
+        amrex::ParallelFor(n, [=] AMREX_GPU_DEVICE (int i)
+        {
+            const ParticleType& p = p_pbox[i];
+            if (p.id() <= 0) { return; }
+            int ii = int(amrex::Math::floor((p.pos(0)-plo[0])*dxi[0])) + dom_lo.x;
+            int jj = int(amrex::Math::floor((p.pos(1)-plo[1])*dxi[1])) + dom_lo.y;
+            ii = amrex::max(z_lo.x, amrex::min(ii, z_hi.x));
+            jj = amrex::max(z_lo.y, amrex::min(jj, z_hi.y));
+            p_k[i] = find_vertical_index(zheight, ii, jj, z_lo.z, z_hi.z - 1, p.pos(2));
+        });
+    }
+}
+
+/*
+  /brief Returns mf if it is on the particle grids of level lev, and otherwise a copy of it
+         on those grids, with the same index type and ghost cells, held in view.  The view
+         is kept from one call to the next and only rebuilt when the grids change.
+*/
+const MultiFab*
+TerrainFittedPC::GridView (const MultiFab& mf, int lev, std::unique_ptr<MultiFab>& view)
+{
+    if (OnSameGrids(lev, mf))
+    {
+        view.reset();
+        return &mf;
+    }
+
+    const BoxArray&            pba = ParticleBoxArray(lev);
+    const DistributionMapping& pdm = ParticleDistributionMap(lev);
+
+    const IntVect ng = mf.nGrowVect();
+    if (!view ||
+        !view->boxArray().CellEqual(pba) ||
+        view->DistributionMap() != pdm ||
+        view->nGrowVect() != ng || view->nComp() != mf.nComp())
+    {
+        view = std::make_unique<MultiFab>(amrex::convert(pba, mf.ixType()),
+                                          pdm, mf.nComp(), ng);
     }
+    view->ParallelCopy(mf,0,0,mf.nComp(),ng,ng);
+    return view.get();
+}
+
+/*
+  /brief Returns the velocity on the particle grids of level lev (see GridView).
+*/
+Array<const MultiFab*,AMREX_SPACEDIM>
+TerrainFittedPC::VelocityView (MultiFab* umac, int lev)
+{
+    if (m_umac_view.size() <= lev) m_umac_view.resize(lev+1);
+
+    Array<const MultiFab*,AMREX_SPACEDIM> umac_pointer;
+    for (int i = 0; i < AMREX_SPACEDIM; i++) {
+        umac_pointer[i] = GridView(umac[i], lev, m_umac_view[lev][i]);
+    }
+    return umac_pointer;
+}
+
+/*
+  /brief Returns the nodal heights on the particle grids of level lev (see GridView).
+*/
+const MultiFab*
+TerrainFittedPC::HeightView (const MultiFab& a_z_height, int lev)
+{
+    if (m_z_height_view.size() <= lev) m_z_height_view.resize(lev+1);
+
+    return GridView(a_z_height, lev, m_z_height_view[lev]);
 }
 
 /*
   /brief Uses midpoint method to advance particles using umac.
 */
 void
-TerrainFittedPC::AdvectWithUmac (MultiFab* umac, int lev, Real dt, const MultiFab& a_z_height)
+TerrainFittedPC::AdvectWithUmac (MultiFab* umac, int lev, Real dt, const MultiFab& a_z_height,
+                                 LayoutData<Real>* cost)
 {
     BL_PROFILE("TerrainFittedPC::AdvectWithUmac()");
     AMREX_ASSERT(OK(lev, lev, umac[0].nGrow()-1));
@@ -107,26 +256,15 @@ TerrainFittedPC::AdvectWithUmac (MultiFab* umac, int lev, Real dt, const MultiFa
     const Box& domain = geom.Domain();
     const auto plo = geom.ProbLoArray();
     const auto dxi = geom.InvCellSizeArray();
+    const auto dom_lo = lbound(domain);
 
-    Vector<std::unique_ptr<MultiFab> > raii_umac(AMREX_SPACEDIM);
-    Vector<MultiFab*> umac_pointer(AMREX_SPACEDIM);
-    if (OnSameGrids(lev, umac[0]))
-    {
-        for (int i = 0; i < AMREX_SPACEDIM; i++) {
-            umac_pointer[i] = &umac[i];
-        }
-    }
-    else
-    {
-        for (int i = 0; i < AMREX_SPACEDIM; i++)
-        {
-            int ng = umac[i].nGrow();
-            raii_umac[i] = std::make_unique<MultiFab>
-                (amrex::convert(m_gdb->ParticleBoxArray(lev), IntVect::TheDimensionVector(i)),
-                 m_gdb->ParticleDistributionMap(lev), umac[i].nComp(), ng);
-            umac_pointer[i] = raii_umac[i].get();
-            umac_pointer[i]->ParallelCopy(umac[i],0,0,umac[i].nComp(),ng,ng);
-        }
+    const auto umac_pointer = VelocityView(umac, lev);
+    const MultiFab& z_height = *HeightView(a_z_height, lev);
+
+    // The cost is indexed by the fluid grids, which may differ from the particle grids
+    if (cost && (cost->boxArray()        != ParticleBoxArray(lev) ||
+                 cost->DistributionMap() != ParticleDistributionMap(lev))) {
+        cost = nullptr;
     }
 
     for (int ipass = 0; ipass < 2; ipass++)
@@ -136,17 +274,33 @@ TerrainFittedPC::AdvectWithUmac (MultiFab* umac, int lev, Real dt, const MultiFa
 #endif
         for (ParIterType pti(*this, lev); pti.isValid(); ++pti)
         {
+            BoxCostTimer box_timer(cost, pti);
+
             int grid    = pti.index();
             auto& ptile = ParticlesAt(lev, pti);
             auto& aos  = ptile.GetArrayOfStructs();
+            auto& soa  = ptile.GetStructOfArrays();
             const int n = aos.numParticles();
             auto *p_pbox = aos().data();
+
+            // These hold the old position after the first pass and the velocity after the second
+            ParticleReal* p_vx = soa.GetRealData(RealIdx::vx).data();
+            ParticleReal* p_vy = soa.GetRealData(RealIdx::vy).data();
+            ParticleReal* p_vz = soa.GetRealData(RealIdx::vz).data();
+            int*          p_k  = soa.GetIntData(IntIdx::k).data();
+
             const FArrayBox* fab[AMREX_SPACEDIM] = { AMREX_D_DECL(&((*umac_pointer[0])[grid]),
                                                                   &((*umac_pointer[1])[grid]),
                                                                   &((*umac_pointer[2])[grid])) };
 
-            const auto& zheight_fab = a_z_height[grid];
-            const auto zheight = zheight_fab.array();
+            const auto zheight = z_height.const_array(grid);
+
+            // Columns covered by the nodal heights and the range of cells in each
+            const Dim3 z_lo = lbound(zheight);
+            const Dim3 z_hi = ubound(zheight);
+            const int k_min = z_lo.z;
+            const int k_max = z_hi.z - 1;
+
             //array of these pointers to pass to the GPU
             amrex::GpuArray<amrex::Array4<const Real>, AMREX_SPACEDIM>
                 const umacarr {{AMREX_D_DECL((*fab[0]).array(),
@@ -162,34 +316,30 @@ TerrainFittedPC::AdvectWithUmac (MultiFab* umac, int lev, Real dt, const MultiFa
                 mac_interpolate(p, plo, dxi, umacarr, v);
                 if (ipass == 0)
                 {
+                    p_vx[i] = p.pos(0);
+                    p_vy[i] = p.pos(1);
+                    p_vz[i] = p.pos(2);
                     for (int dim=0; dim < AMREX_SPACEDIM; dim++)
                     {
-                        p.rdata(dim) = p.pos(dim);
                         p.pos(dim) += static_cast<ParticleReal>(ParticleReal(0.5)*dt*v[dim]);
                     }
                 }
                 else
                 {
-                    for (int dim=0; dim < AMREX_SPACEDIM; dim++)
-                    {
-                        p.pos(dim) = p.rdata(dim) + static_cast<ParticleReal>(dt*v[dim]);
-                        p.rdata(dim) = v[dim];
-                    }
+                    p.pos(0) = p_vx[i] + static_cast<ParticleReal>(dt*v[0]);
+                    p.pos(1) = p_vy[i] + static_cast<ParticleReal>(dt*v[1]);
+                    p.pos(2) = p_vz[i] + static_cast<ParticleReal>(dt*v[2]);
+                    p_vx[i] = v[0];
+                    p_vy[i] = v[1];
+                    p_vz[i] = v[2];
 
-                    // also update z-coordinate here
-                    IntVect iv(
-                        AMREX_D_DECL(int(amrex::Math::floor((p.pos(0)-plo[0])*dxi[0])),
-                                     int(amrex::Math::floor((p.pos(1)-plo[1])*dxi[1])),
-                                     p.idata(0)));
-                    iv[0] += domain.smallEnd()[0];
-                    iv[0] += domain.smallEnd()[1];
-                    auto zlo = zheight(iv[0], iv[1], iv[2]);
-                    auto zhi = zheight(iv[0], iv[1], iv[2]+1);
-                    if (p.pos(2) > zhi) { // need to be careful here
-                        p.idata(0) += 1;
-                    } else if (p.pos(2) <= zlo) {
-                        p.idata(0) -= 1;
-                    }
+                    // also update z-coordinate here: find the cell of the column with
+                    //     z(k) < pos(2) <= z(k+1)
+                    int ii = int(amrex::Math::floor((p.pos(0)-plo[0])*dxi[0])) + dom_lo.x;
+                    int jj = int(amrex::Math::floor((p.pos(1)-plo[1])*dxi[1])) + dom_lo.y;
+                    ii = amrex::max(z_lo.x, amrex::min(ii, z_hi.x));
+                    jj = amrex::max(z_lo.y, amrex::min(jj, z_hi.y));
+                    p_k[i] = find_vertical_index(zheight, ii, jj, k_min, k_max, p.pos(2));
                 }
             });
         }
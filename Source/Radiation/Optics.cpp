@@ -381,7 +381,8 @@ void Optics::sample_cloud_optics_lw(
 }
 
 //----------------------------------------------------------------------------
-void Optics::set_aerosol_optics_sw(int icall, int ncol, int nlev, int nswbands, real dt, int1d& night_indices,
+void Optics::set_aerosol_optics_sw(int icall, int ncol, int nlev, int nswbands, real dt,
+                                   int nnight, int1d& night_indices,
                                    bool is_cmip6_volc,
                                    real3d& tau_out, real3d& ssa_out, real3d& asm_out,
                                    real2d& clear_rh) {
@@ -404,13 +405,9 @@ void Optics::set_aerosol_optics_sw(int icall, int ncol, int nlev, int nswbands,
       yakl::memset(tau_w_g, 0.);
       yakl::memset(tau_w_f, 0.);
 
-      int icount = 0;
-      for (auto i=0; i<ncol; ++i) {
-         if (night_indices(i) > 0) ++icount;
-      }
-
+      // The night columns are the first nnight entries of night_indices
       aero_optics.aer_rad_props_sw(icall, dt,
-           icount, night_indices, is_cmip6_volc,
+           nnight, night_indices, is_cmip6_volc,
            tau, tau_w, tau_w_g, tau_w_f, clear_rh);
 
       // Extract quantities from products
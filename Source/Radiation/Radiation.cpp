@@ -11,11 +11,15 @@
  * The RTE-RRTMGP uses BSD-3-Clause Open Source License, if you want to make changes,
  * and modifications to the code, please refer to BSD-3-Clause Open Source License.
  */
+#include <cmath>
 #include <string>
 #include <vector>
 #include <memory>
 
+#include <AMReX_Scan.H>
+
 #include "Radiation.H"
+#include "EOS.H"
 
 using namespace amrex;
 using yakl::intrinsics::size;
@@ -25,27 +29,50 @@ namespace internal {
     fluxes.flux_up = real2d("flux_up", nz, nlay+1);
     fluxes.flux_dn = real2d("flux_dn", nz, nlay+1);
     fluxes.flux_net = real2d("flux_net", nz, nlay+1);
+    fluxes.flux_dn_dir = real2d("flux_dn_dir", nz, nlay+1);
     fluxes.bnd_flux_up = real3d("flux_up", nz, nlay+1, nbands);
     fluxes.bnd_flux_dn = real3d("flux_dn", nz, nlay+1, nbands);
     fluxes.bnd_flux_net = real3d("flux_net", nz, nlay+1, nbands);
+    fluxes.bnd_flux_dn_dir = real3d("flux_dn_dir", nz, nlay+1, nbands);
+  }
+
+  void reset_fluxes(FluxesByband& fluxes) {
+      yakl::memset(fluxes.flux_up, 0.);
+      yakl::memset(fluxes.flux_dn, 0.);
+      yakl::memset(fluxes.flux_net, 0.);
+      yakl::memset(fluxes.flux_dn_dir, 0.);
+      yakl::memset(fluxes.bnd_flux_up, 0.);
+      yakl::memset(fluxes.bnd_flux_dn, 0.);
+      yakl::memset(fluxes.bnd_flux_net, 0.);
+      yakl::memset(fluxes.bnd_flux_dn_dir, 0.);
+  }
+
+  // Views of the leading nday columns of fluxes allocated for more columns
+  void day_flux_views(FluxesByband& buffers, int nday, int nlay, int nbands, FluxesByband& fluxes) {
+    fluxes.flux_up = real2d("flux_up", buffers.flux_up.data(), nday, nlay+1);
+    fluxes.flux_dn = real2d("flux_dn", buffers.flux_dn.data(), nday, nlay+1);
+    fluxes.flux_net = real2d("flux_net", buffers.flux_net.data(), nday, nlay+1);
+    fluxes.flux_dn_dir = real2d("flux_dn_dir", buffers.flux_dn_dir.data(), nday, nlay+1);
+    fluxes.bnd_flux_up = real3d("flux_up", buffers.bnd_flux_up.data(), nday, nlay+1, nbands);
+    fluxes.bnd_flux_dn = real3d("flux_dn", buffers.bnd_flux_dn.data(), nday, nlay+1, nbands);
+    fluxes.bnd_flux_net = real3d("flux_net", buffers.bnd_flux_net.data(), nday, nlay+1, nbands);
+    fluxes.bnd_flux_dn_dir = real3d("flux_dn_dir", buffers.bnd_flux_dn_dir.data(), nday, nlay+1, nbands);
   }
 
-  void expand_day_fluxes(FluxesByband& daytime_fluxes, FluxesByband& expanded_fluxes, int1d& day_indices) {
+  // Scatter the fluxes of the nday compacted day columns back to their columns;
+  //    the night columns get zero fluxes
+  void expand_day_fluxes(FluxesByband& daytime_fluxes, FluxesByband& expanded_fluxes,
+                         int1d& day_indices, int nday) {
 
-      auto ncol  = size(daytime_fluxes.bnd_flux_up, 1);
       auto nlev  = size(daytime_fluxes.bnd_flux_up, 2);
       auto nbnds = size(daytime_fluxes.bnd_flux_up, 3);
 
-      int1d nday_1d("nday_1d", 1),
-            nday_host("nday_host",1);
-      yakl::c::parallel_for(yakl::c::Bounds<1>(ncol), YAKL_LAMBDA (int icol) {
-         if (day_indices(icol) > 0) nday_1d(0)++;
-      });
+      reset_fluxes(expanded_fluxes);
 
-      nday_1d.deep_copy_to(nday_host);
-      auto nday = nday_host(0);
-      yakl::c::parallel_for(yakl::c::Bounds<3>(nday, nlev, nbnds), YAKL_LAMBDA (int iday, int ilev, int ibnd) {
-        // Map daytime index to proper column index
+      if (nday == 0) return;
+
+      yakl::c::parallel_for(yakl::c::Bounds<2>(nday, nlev), YAKL_LAMBDA (int iday, int ilev) {
+         // Map daytime index to proper column index
          auto icol = day_indices(iday);
 
          // Expand broadband fluxes
@@ -53,13 +80,32 @@ namespace internal {
          expanded_fluxes.flux_dn(icol,ilev) = daytime_fluxes.flux_dn(iday,ilev);
          expanded_fluxes.flux_net(icol,ilev) = daytime_fluxes.flux_net(iday,ilev);
          expanded_fluxes.flux_dn_dir(icol,ilev) = daytime_fluxes.flux_dn_dir(iday,ilev);
+      });
+
+      yakl::c::parallel_for(yakl::c::Bounds<3>(nday, nlev, nbnds), YAKL_LAMBDA (int iday, int ilev, int ibnd) {
+         auto icol = day_indices(iday);
 
          // Expand band-by-band fluxes
          expanded_fluxes.bnd_flux_up(icol,ilev,ibnd) = daytime_fluxes.bnd_flux_up(iday,ilev,ibnd);
          expanded_fluxes.bnd_flux_dn(icol,ilev,ibnd) = daytime_fluxes.bnd_flux_dn(iday,ilev,ibnd);
          expanded_fluxes.bnd_flux_net(icol,ilev,ibnd) = daytime_fluxes.bnd_flux_net(iday,ilev,ibnd);
          expanded_fluxes.bnd_flux_dn_dir(icol,ilev,ibnd) = daytime_fluxes.bnd_flux_dn_dir(iday,ilev,ibnd);
-     });
+      });
+  }
+
+  // Reorder the bands of every (column, layer) of a band-resolved array in place,
+  //    using one thread per (column, layer) instead of temporary arrays
+  void reorder_bands(real3d& array, int1d& new_indexing) {
+      auto ncol  = size(array, 1);
+      auto nlay  = size(array, 2);
+      auto nbnds = size(array, 3);
+      constexpr int max_bands = 16;
+      AMREX_ALWAYS_ASSERT(nbnds <= max_bands);
+      yakl::c::parallel_for(yakl::c::Bounds<2>(ncol, nlay), YAKL_LAMBDA (int icol, int ilay) {
+         real tmp[max_bands];
+         for (int ibnd = 0; ibnd < nbnds; ++ibnd) tmp[ibnd] = array(icol,ilay,ibnd);
+         for (int ibnd = 0; ibnd < nbnds; ++ibnd) array(icol,ilay,ibnd) = tmp[new_indexing(ibnd)];
+      });
   }
 
   // Utility function to reorder an array given a new indexing
@@ -72,23 +118,19 @@ namespace internal {
 }
 
 // init
-void Radiation::initialize(const amrex::MultiFab& cons_in,
-                           const amrex::MultiFab& qc_in,
-                           const amrex::MultiFab& qv_in,
-                           const amrex::MultiFab& qi_in,
-                           const amrex::BoxArray& grids_to_evolve,
-                           const amrex::Geometry& geom,
+void Radiation::initialize(const amrex::Geometry& geom,
                            const amrex::Real& dt_advance,
                            const bool& do_sw_rad,
                            const bool& do_lw_rad,
                            const bool& do_aero_rad,
                            const bool& do_snow_opt,
-                           const bool& is_cmip6_volcano) {
+                           const bool& is_cmip6_volcano,
+                           const amrex::Real& latitude,
+                           const amrex::Real& longitude,
+                           const amrex::Real& day_of_year,
+                           const amrex::Real& utc_hour,
+                           const amrex::Real& albedo) {
    m_geom = geom;
-   m_gtoe = grids_to_evolve;
-
-   auto dz   = m_geom.CellSize(2);
-   auto lowz = m_geom.ProbLo(2);
 
    dt = dt_advance;
 
@@ -98,17 +140,21 @@ void Radiation::initialize(const amrex::MultiFab& cons_in,
    do_snow_optics = do_snow_opt;
    is_cmip6_volc = is_cmip6_volcano;
 
-   for ( MFIter mfi(cons_in, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+   m_latitude    = latitude;
+   m_longitude   = longitude;
+   m_day_of_year = day_of_year;
+   m_utc_hour    = utc_hour;
+   m_albedo      = albedo;
 
-      const auto& box3d = mfi.tilebox();
+   // The columns span the whole domain in the vertical
+   zlo  = m_geom.Domain().smallEnd(2);
+   zhi  = m_geom.Domain().bigEnd(2);
+   nlev = zhi - zlo + 1;
 
-      nlev = box3d.length(2);
-      ncol = box3d.length(0)*box3d.length(1);
-   }
+   ngas = static_cast<int>(active_gases.size());
 
    // initialize cloud, aerosol, and radiation
    optics.initialize();
-   radiation.initialize();
 
    // Setup the RRTMGP interface
    //rrtmgp_initialize(ngas, active_gases, rrtmgp_coefficients_file_sw, rrtmgp_coefficients_file_lw);
@@ -116,10 +162,10 @@ void Radiation::initialize(const amrex::MultiFab& cons_in,
 
    // initialize the radiation data
 
-   auto nswbands = radiation.get_nband_sw();
-   auto nswgpts  = radiation.get_ngpt_sw();
-   auto nlwbands = radiation.get_nband_lw();
-   auto nlwgpts  = radiation.get_ngpt_lw();
+   nswbands = radiation.get_nband_sw();
+   nswgpts  = radiation.get_ngpt_sw();
+   nlwbands = radiation.get_nband_lw();
+   nlwgpts  = radiation.get_ngpt_lw();
 
    rrtmg_to_rrtmgp = int1d("rrtmg_to_rrtmgp",14);
    yakl::c::parallel_for(14, YAKL_LAMBDA (int i) {
@@ -130,6 +176,54 @@ void Radiation::initialize(const amrex::MultiFab& cons_in,
      }
    });
 
+   amrex::Print() << "  LW coefficents file: "                                 //  a/, &
+                  << "  SW coefficents file: "                                 //  a/, &
+                  << "  Frequency (timesteps) of Shortwave Radiation calc:  "  //,i5/, &
+                  << "  Frequency (timesteps) of Longwave Radiation calc:   "  //,i5/, &
+                  << "  SW/LW calc done every timestep for first N steps. N="  //,i5/, &
+                  << "  Use average zenith angle:                           "  //,l5/, &
+                  << "  Output spectrally resolved fluxes:                  "  //,l5/, &
+                  << "  Do aerosol radiative calculations:                  "  //,l5/, &
+                  << "  Fixed solar consant (disabled with -1):             "  //f10.4/, &
+                  << "  Enable temperature warnings:                        "; //,l5/ )
+
+}
+
+// Gather the columns of all the boxes on this rank into batches of batch_size columns
+//    and allocate the buffers for one batch.  Since the buffers are reused for all
+//    batches and all calls, this is the only place where they are allocated.
+void Radiation::define_columns(const amrex::MultiFab& cons_in,
+                               const int& batch_size) {
+   AMREX_ALWAYS_ASSERT(batch_size > 0);
+
+   m_box_col_offset.clear();
+   m_ncol_local = 0;
+   for (MFIter mfi(cons_in); mfi.isValid(); ++mfi) {
+      const Box& vbx = mfi.validbox();
+      if (vbx.length(2) != nlev) {
+         amrex::Abort("Radiation: the grids must span the whole domain in the vertical");
+      }
+      m_box_col_offset.push_back(m_ncol_local);
+      m_ncol_local += vbx.length(0)*vbx.length(1);
+   }
+   m_box_col_offset.push_back(m_ncol_local);
+
+   // Use smaller batches if this rank owns fewer columns than batch_size
+   int new_ncol = std::max(1, std::min(batch_size, m_ncol_local));
+   m_nbatch = (m_ncol_local + new_ncol - 1) / new_ncol;
+
+   if (new_ncol != ncol || !tmid.initialized()) {
+      ncol = new_ncol;
+      alloc_buffers();
+   }
+}
+
+void Radiation::alloc_buffers() {
+   qrs  = real2d("qrs", ncol, nlev);
+   qrl  = real2d("qrl", ncol, nlev);
+   qrsc = real2d("qrsc", ncol, nlev);
+   qrlc = real2d("qrlc", ncol, nlev);
+
    // Temporary variable for heating rate output
    hr = real2d("hr", ncol, nlev);
 
@@ -142,104 +236,246 @@ void Radiation::initialize(const amrex::MultiFab& cons_in,
    albedo_dir = real2d("albedo_dir", nswbands, ncol);
    albedo_dif = real2d("albedo_dif", nswbands, ncol);
 
-   amrex::Print() << "  LW coefficents file: "                                 //  a/, &
-                  << "  SW coefficents file: "                                 //  a/, &
-                  << "  Frequency (timesteps) of Shortwave Radiation calc:  "  //,i5/, &
-                  << "  Frequency (timesteps) of Longwave Radiation calc:   "  //,i5/, &
-                  << "  SW/LW calc done every timestep for first N steps. N="  //,i5/, &
-                  << "  Use average zenith angle:                           "  //,l5/, &
-                  << "  Output spectrally resolved fluxes:                  "  //,l5/, &
-                  << "  Do aerosol radiative calculations:                  "  //,l5/, &
-                  << "  Fixed solar consant (disabled with -1):             "  //f10.4/, &
-                  << "  Enable temperature warnings:                        "; //,l5/ )
+   cld      = real2d("cld", ncol, nlev);
+   cldfsnow = real2d("cldfsnow", ncol, nlev);
+   iclwp    = real2d("iclwp", ncol, nlev);
+   iciwp    = real2d("iciwp", ncol, nlev);
+   icswp    = real2d("icswp", ncol, nlev);
+   dei      = real2d("dei", ncol, nlev);
+   des      = real2d("des", ncol, nlev);
+   lambdac  = real2d("lambdac", ncol, nlev);
+   mu       = real2d("mu", ncol, nlev);
+   rei      = real2d("rei", ncol, nlev);
+   rel      = real2d("rel", ncol, nlev);
+   for (auto* a : {&cld, &cldfsnow, &iclwp, &iciwp, &icswp, &dei, &des, &lambdac, &mu, &rei, &rel}) {
+      yakl::memset(*a, 0.);
+   }
 
+   coszrs = real1d("coszrs", ncol);
+   yakl::memset(coszrs, 0.);
+   yakl::memset(albedo_dir, m_albedo);
+   yakl::memset(albedo_dif, m_albedo);
+
+   cld_tau_gpt_sw = real3d("cld_tau_gpt_sw", ncol, nlev, nswgpts);
+   cld_ssa_gpt_sw = real3d("cld_ssa_gpt_sw", ncol, nlev, nswgpts);
+   cld_asm_gpt_sw = real3d("cld_asm_gpt_sw", ncol, nlev, nswgpts);
+   cld_tau_bnd_sw = real3d("cld_tau_bnd_sw", ncol, nlev, nswbands);
+   cld_ssa_bnd_sw = real3d("cld_ssa_bnd_sw", ncol, nlev, nswbands);
+   cld_asm_bnd_sw = real3d("cld_asm_bnd_sw", ncol, nlev, nswbands);
+   aer_tau_bnd_sw = real3d("aer_tau_bnd_sw", ncol, nlev, nswbands);
+   aer_ssa_bnd_sw = real3d("aer_ssa_bnd_sw", ncol, nlev, nswbands);
+   aer_asm_bnd_sw = real3d("aer_asm_bnd_sw", ncol, nlev, nswbands);
+   cld_tau_bnd_lw = real3d("cld_tau_bnd_lw", ncol, nlev, nlwbands);
+   aer_tau_bnd_lw = real3d("aer_tau_bnd_lw", ncol, nlev, nlwbands);
+   cld_tau_gpt_lw = real3d("cld_tau_gpt_lw", ncol, nlev, nlwgpts);
+   liq_tau_bnd_sw = real3d("liq_tau_bnd_sw", ncol, nlev, nswbands);
+   ice_tau_bnd_sw = real3d("ice_tau_bnd_sw", ncol, nlev, nswbands);
+   snw_tau_bnd_sw = real3d("snw_tau_bnd_sw", ncol, nlev, nswbands);
+   liq_tau_bnd_lw = real3d("liq_tau_bnd_lw", ncol, nlev, nlwbands);
+   ice_tau_bnd_lw = real3d("ice_tau_bnd_lw", ncol, nlev, nlwbands);
+   snw_tau_bnd_lw = real3d("snw_tau_bnd_lw", ncol, nlev, nlwbands);
+
+   // H2O is filled by gather_batch, the other gases keep their default values
+   gas_vmr = real3d("gas_vmr", ngas, ncol, nlev);
+   yakl::memset(gas_vmr, 0.);
+   set_default_gas_vmr();
+
+   day_indices   = int1d("day_indices", ncol);
+   night_indices = int1d("night_indices", ncol);
+
+   gpoint_bands_sw = int1d("gpoint_bands_sw", nswgpts);
+   gpoint_bands_lw = int1d("gpoint_bands_lw", nlwgpts);
+
+   internal::initial_fluxes(ncol, nlev, nswbands, sw_fluxes_allsky);
+   internal::initial_fluxes(ncol, nlev, nswbands, sw_fluxes_clrsky);
+   internal::initial_fluxes(ncol, nlev, nlwbands, lw_fluxes_allsky);
+   internal::initial_fluxes(ncol, nlev, nlwbands, lw_fluxes_clrsky);
+
+   coszrs_day_buf      = real1d("coszrs_day_buf", ncol);
+   albedo_dir_day_buf  = real2d("albedo_dir_day_buf", nswbands, ncol);
+   albedo_dif_day_buf  = real2d("albedo_dif_day_buf", nswbands, ncol);
+   pmid_day_buf        = real2d("pmid_day_buf", ncol, nlev);
+   tmid_day_buf        = real2d("tmid_day_buf", ncol, nlev);
+   pint_day_buf        = real2d("pint_day_buf", ncol, nlev+1);
+   gas_vmr_day_buf     = real3d("gas_vmr_day_buf", ngas, ncol, nlev);
+   cld_tau_gpt_day_buf = real3d("cld_tau_gpt_day_buf", ncol, nlev, nswgpts);
+   cld_ssa_gpt_day_buf = real3d("cld_ssa_gpt_day_buf", ncol, nlev, nswgpts);
+   cld_asm_gpt_day_buf = real3d("cld_asm_gpt_day_buf", ncol, nlev, nswgpts);
+   aer_tau_bnd_day_buf = real3d("aer_tau_bnd_day_buf", ncol, nlev, nswbands);
+   aer_ssa_bnd_day_buf = real3d("aer_ssa_bnd_day_buf", ncol, nlev, nswbands);
+   aer_asm_bnd_day_buf = real3d("aer_asm_bnd_day_buf", ncol, nlev, nswbands);
+   internal::initial_fluxes(ncol, nlev, nswbands, sw_fluxes_allsky_day_buf);
+   internal::initial_fluxes(ncol, nlev, nswbands, sw_fluxes_clrsky_day_buf);
+
+   // Longwave inputs on the radiation vertical grid, which has an empty level above
+   //    model top that stays zero
+   cld_tau_gpt_rad = real3d("cld_tau_gpt_rad", ncol, nlev+1, nlwgpts);
+   aer_tau_bnd_rad = real3d("aer_tau_bnd_rad", ncol, nlev+1, nlwbands);
+   gas_vmr_rad     = real3d("gas_vmr_rad", ngas, ncol, nlev);
+   yakl::memset(cld_tau_gpt_rad, 0.);
+   yakl::memset(aer_tau_bnd_rad, 0.);
+
+   // Set surface emissivity to 1 here. There is a note in the RRTMG
+   // implementation that this is treated in the land model, but the old
+   // RRTMG implementation also sets this to 1. This probably does not make
+   // a lot of difference either way, but if a more intelligent value
+   // exists or is assumed in the model we should use it here as well.
+   // TODO: set this more intelligently?
+   surface_emissivity = real2d("surface_emissivity", nlwbands, ncol);
+   yakl::memset(surface_emissivity, 1.0);
+
+   // Temporary heating rates on radiation vertical grid
+   qrl_rad  = real2d("qrl_rad", ncol, nlev);
+   qrlc_rad = real2d("qrlc_rad", ncol, nlev);
 }
 
-
 // run radiation model
-void Radiation::run() {
-   real2d qrs("qrs", ncol, nlev);   // shortwave radiative heating rate
-   real2d qrl("qrl", ncol, nlev);  // longwave  radiative heating rate
-
-   // Pointers to fields on the physics buffer
-   real2d cld("cld", ncol, nlev), cldfsnow("cldfsnow", ncol, nlev),
-          iclwp("iclwp", ncol, nlev), iciwp("iciwp", ncol, nlev),
-          icswp("icswp", ncol, nlev), dei("dei", ncol, nlev),
-          des("des", ncol, nlev), lambdac("lambdac", ncol, nlev),
-          mu("mu", ncol, nlev), rei("rei", ncol, nlev), rel("rel", ncol, nlev);
-
-   // Clear-sky heating rates are not on the physics buffer, and we have no
-   // reason to put them there, so declare these are regular arrays here
-   real2d qrsc("qrsc", ncol, nlev);
-   real2d qrlc("qrlc", ncol, nlev);
+void Radiation::run(const amrex::MultiFab& cons_in,
+                    const amrex::MultiFab* qmoist_in,
+                    const amrex::Real& time,
+                    amrex::MultiFab& qheating) {
+   BL_PROFILE("Radiation::run()");
 
-   // Temporary variable for heating rate output
-   real2d hr("hr", ncol, nlev);
-
-   real2d tmid("tmid", ncol, nlev),
-          pmid("pmid", ncol, nlev);
-   real2d pint("pint", ncol, nlev+1 ),
-          tint("tint", ncol, nlev+1);
-   real2d albedo_dir("albedo_dir", nswbands, ncol),
-          albedo_dif("albedo_dif", nswbands, ncol);
-
-   // Cosine solar zenith angle for all columns in chunk
-   real1d coszrs("coszrs", ncol);
-
-   // Cloud, snow, and aerosol optical properties
-   real3d cld_tau_gpt_sw("cld_tau_gpt_sw", ncol, nlev, nswgpts),
-          cld_ssa_gpt_sw("cld_ssa_gpt_sw", ncol, nlev, nswgpts),
-          cld_asm_gpt_sw("cld_asm_gpt_sw", ncol, nlev, nswgpts);
-   real3d cld_tau_bnd_sw("cld_tau_bnd_sw", ncol, nlev, nswbands),
-          cld_ssa_bnd_sw("cld_ssa_bnd_sw", ncol, nlev, nswbands),
-          cld_asm_bnd_sw("cld_asm_bnd_sw", ncol, nlev, nswbands);
-   real3d aer_tau_bnd_sw("aer_tau_bnd_sw", ncol, nlev, nswbands),
-          aer_ssa_bnd_sw("aer_ssa_bnd_sw", ncol, nlev, nswbands),
-          aer_asm_bnd_sw("aer_asm_bnd_sw", ncol, nlev, nswbands);
-   real3d cld_tau_bnd_lw("cld_tau_bnd_lw", ncol, nlev, nlwbands),
-          aer_tau_bnd_lw("aer_tau_bnd_lw", ncol, nlev, nlwbands);
-   real3d cld_tau_gpt_lw("cld_tau_gpt_lw", ncol, nlev, nlwgpts);
-   // NOTE: these are diagnostic only
-   real3d liq_tau_bnd_sw("liq_tau_bnd_sw", ncol, nlev, nswbands),
-          ice_tau_bnd_sw("ice_tau_bnd_sw", ncol, nlev, nswbands),
-          snw_tau_bnd_sw("snw_tau_bnd_sw", ncol, nlev, nswbands);
-   real3d liq_tau_bnd_lw("liq_tau_bnd_lw", ncol, nlev, nlwbands),
-          ice_tau_bnd_lw("ice_tau_bnd_lw", ncol, nlev, nlwbands),
-          snw_tau_bnd_lw("snw_tau_bnd_lw", ncol, nlev, nlwbands);
-
-   // Gas volume mixing ratios
-   real3d gas_vmr("gas_vmr", ngas, ncol, nlev);
-
-   // Needed for shortwave aerosol; TODO: remove this dependency
-   int nday, nnight;     // Number of daylight columns
-   int1d day_indices("day_indices", ncol), night_indices("night_indices", ncol);   // Indicies of daylight coumns
-
-   // Flag to carry (QRS,QRL)*dp across time steps.
-   // TODO: what does this mean?
-   bool conserve_energy = true;
+   AMREX_ALWAYS_ASSERT(static_cast<int>(m_box_col_offset.size()) == cons_in.local_size()+1);
 
-   // For loops over diagnostic calls
-   //bool active_calls(0:N_DIAG)
+   // The sun is at the same position for all the columns and batches
+   if (do_short_wave_rad) {
+      yakl::memset(coszrs, cosine_solar_zenith_angle(time));
+   }
+
+   for (int ibatch = 0; ibatch < m_nbatch; ++ibatch) {
+      gather_batch(ibatch, cons_in, qmoist_in);
+      run_batch();
+      scatter_batch(ibatch, qheating);
+   }
+}
+
+void Radiation::gather_batch(int ibatch,
+                             const amrex::MultiFab& cons_in,
+                             const amrex::MultiFab* qmoist_in) {
+   const int col_lo = ibatch*ncol;
+   const int col_hi = std::min(col_lo + ncol, m_ncol_local) - 1;
+   const int nvalid = col_hi - col_lo + 1;
+
+   const int l_nlev = nlev;
+   const int l_zlo  = zlo;
+
+   // Index of H2O in the gas list and the ratio of molar weights of dry air and H2O;
+   //    qv is a mixing ratio so its volume mixing ratio is qv times this ratio
+   const int ih2o = 0;
+   const real h2o_vmr_fac = 28.97 / 18.01528;
+
+   auto l_tmid = tmid;
+   auto l_pmid = pmid;
+   auto l_gas_vmr = gas_vmr;
+
+   int li = 0;
+   for (MFIter mfi(cons_in); mfi.isValid(); ++mfi, ++li) {
+      const int box_lo = m_box_col_offset[li];
+      const int box_hi = m_box_col_offset[li+1] - 1;
+      const int lo_c = std::max(box_lo, col_lo);
+      const int hi_c = std::min(box_hi, col_hi);
+      if (lo_c > hi_c) continue;
+
+      const Box& vbx = mfi.validbox();
+      const int ilo = vbx.smallEnd(0);
+      const int jlo = vbx.smallEnd(1);
+      const int nx  = vbx.length(0);
+
+      const Array4<const Real>& cons_arr = cons_in.const_array(mfi);
+      const bool has_moist = (qmoist_in != nullptr);
+      const Array4<const Real> qv_arr = has_moist ? qmoist_in->const_array(mfi) : Array4<const Real>{};
+
+      Box cbx(IntVect(lo_c - col_lo, 0, 0), IntVect(hi_c - col_lo, l_nlev-1, 0));
+      ParallelFor(cbx, [=] AMREX_GPU_DEVICE (int icol, int ilev, int) noexcept
+      {
+         const int c = icol + col_lo - box_lo;
+         const int i = ilo + c % nx;
+         const int j = jlo + c / nx;
+         const int k = l_zlo + ilev;
+         const Real qv = has_moist ? qv_arr(i,j,k,0) : 0.0;
+         const Real p  = getPgivenRTh(cons_arr(i,j,k,RhoTheta_comp), qv);
+         l_pmid(icol,ilev) = p;
+         l_tmid(icol,ilev) = getTgivenRandRTh(cons_arr(i,j,k,Rho_comp), cons_arr(i,j,k,RhoTheta_comp));
+         l_gas_vmr(ih2o,icol,ilev) = qv * h2o_vmr_fac;
+      });
+   }
+
+   // Pad a partial last batch with copies of its last column so that every
+   //    batch has the same, fixed number of columns
+   if (nvalid < ncol) {
+      yakl::c::parallel_for(yakl::c::Bounds<2>(ncol - nvalid, l_nlev), YAKL_LAMBDA (int ipad, int ilev) {
+         const int icol = nvalid + ipad;
+         l_pmid(icol,ilev) = l_pmid(nvalid-1,ilev);
+         l_tmid(icol,ilev) = l_tmid(nvalid-1,ilev);
+         l_gas_vmr(ih2o,icol,ilev) = l_gas_vmr(ih2o,nvalid-1,ilev);
+      });
+   }
+
+   // Interface values: average of the neighboring layers, extrapolated at the ends
+   auto l_pint = pint;
+   auto l_tint = tint;
+   yakl::c::parallel_for(yakl::c::Bounds<2>(ncol, l_nlev+1), YAKL_LAMBDA (int icol, int ilev) {
+      if (ilev == 0) {
+         l_pint(icol,ilev) = 1.5*l_pmid(icol,0) - 0.5*l_pmid(icol,1);
+         l_tint(icol,ilev) = 1.5*l_tmid(icol,0) - 0.5*l_tmid(icol,1);
+      } else if (ilev == l_nlev) {
+         l_pint(icol,ilev) = 1.5*l_pmid(icol,l_nlev-1) - 0.5*l_pmid(icol,l_nlev-2);
+         l_tint(icol,ilev) = 1.5*l_tmid(icol,l_nlev-1) - 0.5*l_tmid(icol,l_nlev-2);
+      } else {
+         l_pint(icol,ilev) = 0.5*(l_pmid(icol,ilev-1) + l_pmid(icol,ilev));
+         l_tint(icol,ilev) = 0.5*(l_tmid(icol,ilev-1) + l_tmid(icol,ilev));
+      }
+   });
+}
 
-   // Zero-array for cloud properties if not diagnosed by microphysics
-   real2d zeros("zeros", ncol, nlev);
+void Radiation::scatter_batch(int ibatch, amrex::MultiFab& qheating) {
+   const int col_lo = ibatch*ncol;
+   const int col_hi = std::min(col_lo + ncol, m_ncol_local) - 1;
+
+   const int l_nlev = nlev;
+   const int l_zlo  = zlo;
+   auto l_hr = hr;
+
+   int li = 0;
+   for (MFIter mfi(qheating); mfi.isValid(); ++mfi, ++li) {
+      const int box_lo = m_box_col_offset[li];
+      const int box_hi = m_box_col_offset[li+1] - 1;
+      const int lo_c = std::max(box_lo, col_lo);
+      const int hi_c = std::min(box_hi, col_hi);
+      if (lo_c > hi_c) continue;
+
+      const Box& vbx = mfi.validbox();
+      const int ilo = vbx.smallEnd(0);
+      const int jlo = vbx.smallEnd(1);
+      const int nx  = vbx.length(0);
+
+      const Array4<Real>& q_arr = qheating.array(mfi);
+
+      Box cbx(IntVect(lo_c - col_lo, 0, 0), IntVect(hi_c - col_lo, l_nlev-1, 0));
+      ParallelFor(cbx, [=] AMREX_GPU_DEVICE (int icol, int ilev, int) noexcept
+      {
+         const int c = icol + col_lo - box_lo;
+         const int i = ilo + c % nx;
+         const int j = jlo + c / nx;
+         q_arr(i,j,l_zlo+ilev) = l_hr(icol,ilev);
+      });
+   }
+}
 
-   int1d gpoint_bands_sw("gpoint_bands_sw", nswgpts);
-   int1d gpoint_bands_lw("gpoint_bands_lw", nlwgpts);
+// radiative transfer for the batch of columns in the buffers
+void Radiation::run_batch() {
+   // For loops over diagnostic calls
+   //bool active_calls(0:N_DIAG)
 
    // Do shortwave stuff...
    if (do_short_wave_rad) {
       // Radiative fluxes
-      FluxesByband fluxes_allsky, fluxes_clrsky;
-      internal::initial_fluxes(ncol, nlev, nlwbands, fluxes_allsky);
-      internal::initial_fluxes(ncol, nlev, nlwbands, fluxes_clrsky);
+      FluxesByband& fluxes_allsky = sw_fluxes_allsky;
+      FluxesByband& fluxes_clrsky = sw_fluxes_clrsky;
 
-     // Get albedo. This uses CAM routines internally and just provides a
-     // wrapper to improve readability of the code here.
-//      set_albedo(cam_in, albedo_dir(1:nswbands,1:ncol), albedo_dif(1:nswbands,1:ncol))
-
-      // Get cosine solar zenith angle for current time step.
-//      set_cosine_solar_zenith_angle(state, dt_avg, coszrs(1:ncol))
+     // The albedo is set in alloc_buffers and the cosine of the solar zenith
+     // angle of the current time step in run
 
      // Do shortwave cloud optics calculations
      yakl::memset(cld_tau_gpt_sw, 0.);
@@ -261,29 +497,9 @@ void Radiation::run() {
      // We need to fix band ordering because the old input files assume RRTMG
      // band ordering, but this has changed in RRTMGP.
      // TODO: fix the input files themselves!
-     for (auto icol = 1; icol < ncol; ++icol) {
-        for (auto ilay = 1; ilay < nlev; ++ilay) {
-           real1d cld_tau_bnd_sw_1d("cld_tau_bnd_sw_1d", nswbands);
-           real1d cld_ssa_bnd_sw_1d("cld_ssa_bnd_sw_1d", nswbands);
-           real1d cld_asm_bnd_sw_1d("cld_asm_bnd_sw_1d", nswbands);
-           real1d cld_tau_bnd_sw_o_1d("cld_tau_bnd_sw_1d", nswbands);
-           real1d cld_ssa_bnd_sw_o_1d("cld_ssa_bnd_sw_1d", nswbands);
-           real1d cld_asm_bnd_sw_o_1d("cld_asm_bnd_sw_1d", nswbands);
-           for (auto ibnd = 0; ibnd < nswbands; ++ibnd) {
-              cld_tau_bnd_sw_1d(ibnd) = cld_tau_bnd_sw(icol,ilay,ibnd);
-              cld_ssa_bnd_sw_1d(ibnd) = cld_ssa_bnd_sw(icol,ilay,ibnd);
-              cld_asm_bnd_sw_1d(ibnd) = cld_asm_bnd_sw(icol,ilay,ibnd);
-           }
-           internal::reordered(cld_tau_bnd_sw_1d, rrtmg_to_rrtmgp, cld_tau_bnd_sw_o_1d);
-           internal::reordered(cld_ssa_bnd_sw_1d, rrtmg_to_rrtmgp, cld_ssa_bnd_sw_o_1d);
-           internal::reordered(cld_asm_bnd_sw_1d, rrtmg_to_rrtmgp, cld_asm_bnd_sw_o_1d);
-           for (auto ibnd = 0; ibnd < nswbands; ++ibnd) {
-              cld_tau_bnd_sw(icol,ilay,ibnd) = cld_tau_bnd_sw_o_1d(ibnd);
-              cld_ssa_bnd_sw(icol,ilay,ibnd) = cld_ssa_bnd_sw_o_1d(ibnd);
-              cld_asm_bnd_sw(icol,ilay,ibnd) = cld_asm_bnd_sw_o_1d(ibnd);
-           }
-        }
-     }
+     internal::reorder_bands(cld_tau_bnd_sw, rrtmg_to_rrtmgp);
+     internal::reorder_bands(cld_ssa_bnd_sw, rrtmg_to_rrtmgp);
+     internal::reorder_bands(cld_asm_bnd_sw, rrtmg_to_rrtmgp);
 
      // And now do the MCICA sampling to get cloud optical properties by
      // gpoint/cloud state
@@ -297,13 +513,8 @@ void Radiation::run() {
 
      // Aerosol needs night indices
      // TODO: remove this dependency, it's just used to mask aerosol outputs
-     set_daynight_indices(coszrs, day_indices, night_indices);
-     int nday = 0;
-     int nnight = 0;
-     for (auto icol=0; icol<ncol; ++icol) {
-        if (day_indices(icol) > 0) nday++;
-        if (night_indices(icol) > 0) nnight++;
-     }
+     int nday   = set_daynight_indices(coszrs, day_indices, night_indices);
+     int nnight = ncol - nday;
 
      // Loop over diagnostic calls
 //     rad_cnst_get_call_list(active_calls);
@@ -319,35 +530,14 @@ void Radiation::run() {
            yakl::memset(aer_ssa_bnd_sw, 0.);
            yakl::memset(aer_asm_bnd_sw, 0.);
 
-           real2d clear_rh;
-           optics.set_aerosol_optics_sw(icall, ncol, nlev, nswbands, dt, night_indices,
+           optics.set_aerosol_optics_sw(icall, ncol, nlev, nswbands, dt, nnight, night_indices,
                              is_cmip6_volc, aer_tau_bnd_sw, aer_ssa_bnd_sw, aer_asm_bnd_sw, clear_rh);
 
            // Now reorder bands to be consistent with RRTMGP
            // TODO: fix the input files themselves!
-          for (auto icol = 1; icol < ncol; ++icol) {
-             for (auto ilay = 1; ilay < nlev; ++ilay) {
-                real1d aer_tau_bnd_sw_1d("cld_tau_bnd_sw_1d", nswbands);
-                real1d aer_ssa_bnd_sw_1d("cld_ssa_bnd_sw_1d", nswbands);
-                real1d aer_asm_bnd_sw_1d("cld_asm_bnd_sw_1d", nswbands);
-                real1d aer_tau_bnd_sw_o_1d("cld_tau_bnd_sw_1d", nswbands);
-                real1d aer_ssa_bnd_sw_o_1d("cld_ssa_bnd_sw_1d", nswbands);
-                real1d aer_asm_bnd_sw_o_1d("cld_asm_bnd_sw_1d", nswbands);
-                for (auto ibnd = 0; ibnd < nswbands; ++ibnd) {
-                   aer_tau_bnd_sw_1d(ibnd) = aer_tau_bnd_sw(icol,ilay,ibnd);
-                   aer_ssa_bnd_sw_1d(ibnd) = aer_ssa_bnd_sw(icol,ilay,ibnd);
-                   aer_asm_bnd_sw_1d(ibnd) = aer_asm_bnd_sw(icol,ilay,ibnd);
-                }
-                internal::reordered(aer_tau_bnd_sw_1d, rrtmg_to_rrtmgp, aer_tau_bnd_sw_o_1d);
-                internal::reordered(aer_ssa_bnd_sw_1d, rrtmg_to_rrtmgp, aer_ssa_bnd_sw_o_1d);
-                internal::reordered(aer_asm_bnd_sw_1d, rrtmg_to_rrtmgp, aer_asm_bnd_sw_o_1d);
-                for (auto ibnd = 0; ibnd < nswbands; ++ibnd) {
-                   aer_tau_bnd_sw(icol,ilay,ibnd) = aer_tau_bnd_sw_o_1d(ibnd);
-                   aer_ssa_bnd_sw(icol,ilay,ibnd) = aer_ssa_bnd_sw_o_1d(ibnd);
-                   aer_asm_bnd_sw(icol,ilay,ibnd) = aer_asm_bnd_sw_o_1d(ibnd);
-                }
-             }
-          }
+           internal::reorder_bands(aer_tau_bnd_sw, rrtmg_to_rrtmgp);
+           internal::reorder_bands(aer_ssa_bnd_sw, rrtmg_to_rrtmgp);
+           internal::reorder_bands(aer_asm_bnd_sw, rrtmg_to_rrtmgp);
         } else {
            yakl::memset(aer_tau_bnd_sw, 0.);
            yakl::memset(aer_ssa_bnd_sw, 0.);
@@ -376,23 +566,16 @@ void Radiation::run() {
 //        set_net_fluxes_sw(fluxes_allsky, fsds, fsns, fsnt);
    }
    else {
-      // Conserve energy
-     if (conserve_energy) {
-       for (auto icol=0; icol<ncol; ++icol) {
-         for (auto ilev=0; ilev<nlev; ++ilev) {
-           qrs(icol,ilev) = qrs(icol,ilev)/pdel(icol,ilev);
-         }
-       }
-     }
+      // The heating rates are held by the caller between calls, so there is
+      // nothing to carry over here
+      yakl::memset(qrs, 0.);
   }  // dosw
 
   // Do longwave stuff...
   if (do_long_wave_rad) {
-    // Allocate longwave outputs; why is this not part of the
-    // fluxes_t object?
-    FluxesByband fluxes_allsky, fluxes_clrsky;
-    internal::initial_fluxes(ncol, nlev, nlwbands, fluxes_allsky);
-    internal::initial_fluxes(ncol, nlev, nlwbands, fluxes_clrsky);
+    // Longwave outputs
+    FluxesByband& fluxes_allsky = lw_fluxes_allsky;
+    FluxesByband& fluxes_clrsky = lw_fluxes_clrsky;
 
     // NOTE: fluxes defined at interfaces, so initialize to have vertical
     // dimension nlev_rad+1
@@ -443,15 +626,7 @@ void Radiation::run() {
     //call export_surface_fluxes(fluxes_allsky, cam_out, 'longwave')
   }
   else {
-    // Conserve energy (what does this mean exactly?)
-    if (conserve_energy) {
-       for (auto icol=0; icol<ncol; ++icol) {
-          for (auto ilev=0; ilev<nlev; ++ilev) {
-            qrl(icol,ilev) = qrl(icol,ilev)/pdel(icol,ilev);
-          }
-       }
-   }
-
+    yakl::memset(qrl, 0.);
  } // dolw
 
  // Compute net radiative heating tendency
@@ -460,21 +635,13 @@ void Radiation::run() {
 //                 cam_in%asdir, net_flux);
 
  // Compute heating rate for dtheta/dt
- for (auto ilay = 1; ilay < nlev; ++nlev) {
-    for (auto icol = 1; icol < ncol; ++icol) {
-       hr(icol,ilay) = (qrs(icol,ilay) + qrl(icol,ilay)) / Cp_d * (1.e5 / std::pow(pmid(icol,ilay), R_d/Cp_d));
-    }
- }
-
- // convert radiative heating rates to Q*dp for energy conservation
- if (conserve_energy) {
-   for (auto icol=0; icol<ncol; ++icol) {
-      for (auto ilev=0; ilev<nlev; ++ilev) {
-         qrs(icol,ilev) = qrs(icol,ilev)*pdel(icol,ilev);
-         qrl(icol,ilev) = qrl(icol,ilev)*pdel(icol,ilev);
-      }
-   }
- }
+ auto l_hr   = hr;
+ auto l_qrs  = qrs;
+ auto l_qrl  = qrl;
+ auto l_pmid = pmid;
+ yakl::c::parallel_for(yakl::c::Bounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilay) {
+    l_hr(icol,ilay) = (l_qrs(icol,ilay) + l_qrl(icol,ilay)) / Cp_d * std::pow(p_0 / l_pmid(icol,ilay), R_d/Cp_d);
+ });
 }
 
 void Radiation::radiation_driver_sw(int ncol, real3d& gas_vmr,
@@ -482,42 +649,10 @@ void Radiation::radiation_driver_sw(int ncol, real3d& gas_vmr,
                                   real1d& coszrs, real3d& cld_tau_gpt, real3d& cld_ssa_gpt, real3d& cld_asm_gpt,
                                   real3d& aer_tau_bnd, real3d& aer_ssa_bnd, real3d& aer_asm_bnd,
                                   FluxesByband& fluxes_clrsky, FluxesByband& fluxes_allsky, real2d& qrs, real2d& qrsc) {
-      // Incoming solar radiation, scaled for solar zenith angle
-      // and earth-sun distance
-      real2d solar_irradiance_by_gpt("solar_irradiance_by_gpt",ncol,nswgpts);
-
-      // Gathered indicies of day and night columns
-      // chunk_column_index = day_indices(daylight_column_index)
-      int1d day_indices("day_indices",ncol), night_indices("night_indices", ncol);   // Indicies of daylight coumns
-
-      real1d coszrs_day("coszrs_day", ncol);
-      real2d albedo_dir_day("albedo_dir_day", nswbands, ncol), albedo_dif_day("albedo_dif_day", nswbands, ncol);
-      real2d pmid_day("pmid_day", ncol, nlev);
-      real2d tmid_day("tmid_day", ncol, nlev);
-      real2d pint_day("pint_day", ncol, nlev+1);
-
-      real3d gas_vmr_day("gas_vmr_day", ngas, ncol, nlev);
-      real3d gas_vmr_rad("gas_vmr_rad", ngas, ncol, nlev);
-
-      real3d cld_tau_gpt_day("cld_tau_gpt_day", ncol, nlev-1, nswgpts);
-      real3d cld_ssa_gpt_day("cld_ssa_gpt_day", ncol, nlev-1, nswgpts);
-      real3d cld_asm_gpt_day("cld_asm_gpt_day", ncol, nlev-1, nswgpts);
-      real3d aer_tau_bnd_day("aer_tau_bnd_day", ncol, nlev-1, nswbands);
-      real3d aer_ssa_bnd_day("aer_ssa_bnd_day", ncol, nlev-1, nswbands);
-      real3d aer_asm_bnd_day("aer_asm_bnd_day", ncol, nlev-1, nswbands);
-
-      real3d cld_tau_gpt_rad("cld_tau_gpt_rad", ncol, nlev+1, nswgpts);
-      real3d cld_ssa_gpt_rad("cld_ssa_gpt_rad", ncol, nlev+1, nswgpts);
-      real3d cld_asm_gpt_rad("cld_asm_gpt_rad", ncol, nlev+1, nswgpts);
-      real3d aer_tau_bnd_rad("aer_tau_bnd_rad", ncol, nlev+1, nswgpts);
-      real3d aer_ssa_bnd_rad("aer_ssa_bnd_rad", ncol, nlev+1, nswgpts);
-      real3d aer_asm_bnd_rad("aer_asm_bnd_rad", ncol, nlev+1, nswgpts);
-
       // Scaling factor for total sky irradiance; used to account for orbital
       // eccentricity, and could be used to scale total sky irradiance for different
       // climates as well (i.e., paleoclimate simulations)
-      real tsi_scaling;
-
+      real tsi_scaling = 1.0;
 
       if (fixed_total_solar_irradiance<0) {
          // Get orbital eccentricity factor to scale total sky irradiance
@@ -533,74 +668,85 @@ void Radiation::radiation_driver_sw(int ncol, real3d& gas_vmr,
       // do the shortwave radiative transfer during the daytime to save
       // computational cost (and because RRTMGP will fail for cosine solar zenith
       // angles less than or equal to zero)
-      set_daynight_indices(coszrs, day_indices, night_indices);
-      int nday = 0;
-      int nnight = 0;
-      for (auto icol=0; icol<ncol; ++icol) {
-         if (day_indices(icol) > 0) nday++;
-         if (night_indices(icol) > 0) nnight++;
-      }
+      int nday = set_daynight_indices(coszrs, day_indices, night_indices);
 
       // If no daytime columns in this chunk, then we return zeros
       if (nday == 0) {
-//         reset_fluxes(fluxes_allsky)
-//        reset_fluxes(fluxes_clrsky)
+         internal::reset_fluxes(fluxes_allsky);
+         internal::reset_fluxes(fluxes_clrsky);
          yakl::memset(qrs, 0.);
          yakl::memset(qrsc, 0.);
          return;
       }
 
-      // Compress to daytime-only arrays
-      yakl::c::parallel_for(yakl::c::Bounds<3>(nday, nlev, nswgpts), YAKL_LAMBDA (int iday, int ilev, int igpt) {
+      // The daytime-only arrays hold just the nday sunlit columns, so that the cost
+      // of the radiative transfer below scales with the number of day columns; they
+      // are views of the leading part of the buffers allocated for the whole batch
+      real1d coszrs_day("coszrs_day", coszrs_day_buf.data(), nday);
+      real2d albedo_dir_day("albedo_dir_day", albedo_dir_day_buf.data(), nswbands, nday);
+      real2d albedo_dif_day("albedo_dif_day", albedo_dif_day_buf.data(), nswbands, nday);
+      real2d pmid_day("pmid_day", pmid_day_buf.data(), nday, nlev);
+      real2d tmid_day("tmid_day", tmid_day_buf.data(), nday, nlev);
+      real2d pint_day("pint_day", pint_day_buf.data(), nday, nlev+1);
+
+      real3d gas_vmr_day("gas_vmr_day", gas_vmr_day_buf.data(), ngas, nday, nlev);
+
+      real3d cld_tau_gpt_day("cld_tau_gpt_day", cld_tau_gpt_day_buf.data(), nday, nlev, nswgpts);
+      real3d cld_ssa_gpt_day("cld_ssa_gpt_day", cld_ssa_gpt_day_buf.data(), nday, nlev, nswgpts);
+      real3d cld_asm_gpt_day("cld_asm_gpt_day", cld_asm_gpt_day_buf.data(), nday, nlev, nswgpts);
+      real3d aer_tau_bnd_day("aer_tau_bnd_day", aer_tau_bnd_day_buf.data(), nday, nlev, nswbands);
+      real3d aer_ssa_bnd_day("aer_ssa_bnd_day", aer_ssa_bnd_day_buf.data(), nday, nlev, nswbands);
+      real3d aer_asm_bnd_day("aer_asm_bnd_day", aer_asm_bnd_day_buf.data(), nday, nlev, nswbands);
+
+      // Compress to daytime-only arrays, one kernel per shape
+      const int l_nlev = nlev;
+      const int l_ngas = ngas;
+      const int l_nswbands = nswbands;
+      yakl::c::parallel_for(yakl::c::Bounds<2>(nday, l_nlev+1), YAKL_LAMBDA (int iday, int ilev) {
          auto icol = day_indices(iday);
-         tmid_day(iday,ilev) = tmid(icol,ilev);
-         pmid_day(iday,ilev) = pmid(icol,ilev);
          pint_day(iday,ilev) = pint(icol,ilev);
-         albedo_dir_day(igpt,iday) = albedo_dir(igpt,icol);
-         albedo_dif_day(igpt,iday) = albedo_dif(igpt,icol);
-         coszrs_day(iday) = coszrs(icol);
-         gas_vmr_day(igpt,iday,ilev) = gas_vmr(igpt,icol,ilev);
+         if (ilev < l_nlev) {
+            tmid_day(iday,ilev) = tmid(icol,ilev);
+            pmid_day(iday,ilev) = pmid(icol,ilev);
+            for (int igas = 0; igas < l_ngas; ++igas) {
+               gas_vmr_day(igas,iday,ilev) = gas_vmr(igas,icol,ilev);
+            }
+         }
+         if (ilev == 0) {
+            coszrs_day(iday) = coszrs(icol);
+            for (int ibnd = 0; ibnd < l_nswbands; ++ibnd) {
+               albedo_dir_day(ibnd,iday) = albedo_dir(ibnd,icol);
+               albedo_dif_day(ibnd,iday) = albedo_dif(ibnd,icol);
+            }
+         }
+      });
+
+      yakl::c::parallel_for(yakl::c::Bounds<3>(nday, nlev, nswgpts), YAKL_LAMBDA (int iday, int ilev, int igpt) {
+         auto icol = day_indices(iday);
          cld_tau_gpt_day(iday,ilev,igpt) = cld_tau_gpt(icol,ilev,igpt);
          cld_ssa_gpt_day(iday,ilev,igpt) = cld_ssa_gpt(icol,ilev,igpt);
          cld_asm_gpt_day(iday,ilev,igpt) = cld_asm_gpt(icol,ilev,igpt);
-         aer_tau_bnd_day(iday,ilev,igpt) = aer_tau_bnd(icol,ilev,igpt);
-         aer_ssa_bnd_day(iday,ilev,igpt) = aer_ssa_bnd(icol,ilev,igpt);
-         aer_asm_bnd_day(iday,ilev,igpt) = aer_asm_bnd(icol,ilev,igpt);
-     });
-
-      // Allocate shortwave fluxes (allsky and clearsky)
-      // NOTE: fluxes defined at interfaces, so initialize to have vertical
-      // dimension nlev_rad+1, while we initialized the RRTMGP input variables to
-      // have vertical dimension nlev_rad (defined at midpoints).
-      FluxesByband fluxes_clrsky_day, fluxes_allsky_day;
-      internal::initial_fluxes(nday, nlev+1, nswbands, fluxes_allsky_day);
-      internal::initial_fluxes(nday, nlev+1, nswbands, fluxes_clrsky_day);
-
-      // Add an empty level above model top
-      // TODO: combine with day compression above
-      yakl::memset(cld_tau_gpt_rad, 0.);
-      yakl::memset(cld_ssa_gpt_rad, 0.);
-      yakl::memset(cld_asm_gpt_rad, 0.);
-
-      yakl::memset(aer_tau_bnd_rad, 0.);
-      yakl::memset(aer_ssa_bnd_rad, 0);
-      yakl::memset(aer_asm_bnd_rad, 0.);
+      });
 
-      yakl::c::parallel_for(yakl::c::Bounds<3>(nday, nlev, nswgpts), YAKL_LAMBDA (int iday, int ilev, int igpt) {
-         cld_tau_gpt_rad(iday,ilev,igpt) = cld_tau_gpt_day(iday,ilev,igpt);
-         cld_ssa_gpt_rad(iday,ilev,igpt) = cld_ssa_gpt_day(iday,ilev,igpt);
-         cld_asm_gpt_rad(iday,ilev,igpt) = cld_asm_gpt_day(iday,ilev,igpt);
-         aer_tau_bnd_rad(iday,ilev,igpt) = aer_tau_bnd_day(iday,ilev,igpt);
-         aer_ssa_bnd_rad(iday,ilev,igpt) = aer_ssa_bnd_day(iday,ilev,igpt);
-         aer_asm_bnd_rad(iday,ilev,igpt) = aer_asm_bnd_day(iday,ilev,igpt);
-         gas_vmr_rad(igpt,iday,1) = gas_vmr_day(igpt,iday,1);
-         gas_vmr_rad(igpt,iday,ilev) = gas_vmr_day(igpt,iday,ilev);
+      yakl::c::parallel_for(yakl::c::Bounds<3>(nday, nlev, nswbands), YAKL_LAMBDA (int iday, int ilev, int ibnd) {
+         auto icol = day_indices(iday);
+         aer_tau_bnd_day(iday,ilev,ibnd) = aer_tau_bnd(icol,ilev,ibnd);
+         aer_ssa_bnd_day(iday,ilev,ibnd) = aer_ssa_bnd(icol,ilev,ibnd);
+         aer_asm_bnd_day(iday,ilev,ibnd) = aer_asm_bnd(icol,ilev,ibnd);
       });
 
+      // Shortwave fluxes (allsky and clearsky) of the day columns
+      // NOTE: fluxes defined at interfaces, so they have vertical dimension
+      // nlev+1, while the RRTMGP input variables have vertical dimension nlev
+      // (defined at midpoints).
+      FluxesByband fluxes_clrsky_day, fluxes_allsky_day;
+      internal::day_flux_views(sw_fluxes_allsky_day_buf, nday, nlev, nswbands, fluxes_allsky_day);
+      internal::day_flux_views(sw_fluxes_clrsky_day_buf, nday, nlev, nswbands, fluxes_clrsky_day);
+
       // Do shortwave radiative transfer calculations
       radiation.run_shortwave_rrtmgp( ngas, nday, nlev,
-         gas_vmr_rad, pmid_day, tmid_day, pint_day, coszrs_day, albedo_dir_day, albedo_dif_day,
-         cld_tau_gpt_rad, cld_ssa_gpt_rad, cld_asm_gpt_rad, aer_tau_bnd_rad, aer_ssa_bnd_rad, aer_asm_bnd_rad,
+         gas_vmr_day, pmid_day, tmid_day, pint_day, coszrs_day, albedo_dir_day, albedo_dif_day,
+         cld_tau_gpt_day, cld_ssa_gpt_day, cld_asm_gpt_day, aer_tau_bnd_day, aer_ssa_bnd_day, aer_asm_bnd_day,
          fluxes_allsky_day.flux_up    , fluxes_allsky_day.flux_dn    , fluxes_allsky_day.flux_net    , fluxes_allsky_day.flux_dn_dir    ,
          fluxes_allsky_day.bnd_flux_up, fluxes_allsky_day.bnd_flux_dn, fluxes_allsky_day.bnd_flux_net, fluxes_allsky_day.bnd_flux_dn_dir,
          fluxes_clrsky_day.flux_up    , fluxes_clrsky_day.flux_dn    , fluxes_clrsky_day.flux_net    , fluxes_clrsky_day.flux_dn_dir    ,
@@ -608,8 +754,8 @@ void Radiation::radiation_driver_sw(int ncol, real3d& gas_vmr,
          tsi_scaling);
 
       // Expand fluxes from daytime-only arrays to full chunk arrays
-      internal::expand_day_fluxes(fluxes_allsky_day, fluxes_allsky, day_indices);
-      internal::expand_day_fluxes(fluxes_clrsky_day, fluxes_clrsky, day_indices);
+      internal::expand_day_fluxes(fluxes_allsky_day, fluxes_allsky, day_indices, nday);
+      internal::expand_day_fluxes(fluxes_clrsky_day, fluxes_clrsky, day_indices, nday);
 
      // Calculate heating rates
      calculate_heating_rate(fluxes_allsky.flux_up,
@@ -617,7 +763,7 @@ void Radiation::radiation_driver_sw(int ncol, real3d& gas_vmr,
                             pint, qrs);
 
      calculate_heating_rate(fluxes_clrsky.flux_up,
-                            fluxes_allsky.flux_dn,
+                            fluxes_clrsky.flux_dn,
                             pint, qrsc);
  }
 
@@ -626,35 +772,22 @@ void Radiation::radiation_driver_lw(int ncol, int nlev,
                                   real2d& pmid, real2d& pint, real2d& tmid, real2d& tint,
                                   real3d& cld_tau_gpt, real3d& aer_tau_bnd, FluxesByband& fluxes_clrsky,
                                   FluxesByband& fluxes_allsky, real2d& qrl, real2d& qrlc) {
-      real3d cld_tau_gpt_rad("cld_tau_gpt_rad", ncol, nlev+1, nlwgpts);
-      real3d aer_tau_bnd_rad("aer_tau_bnd-rad", ncol, nlev+1, nlwgpts);
-
-      // Surface emissivity needed for longwave
-      real2d surface_emissivity("surface_emissivity", nlwbands, ncol);
-
-      // Temporary heating rates on radiation vertical grid
-      real2d qrl_rad("qrl_rad", ncol, nlev);
-      real2d qrlc_rad("qrlc_rad", ncol, nlev);
-
-      int ngas;
-      real3d gas_vmr_rad("gas_vmr_rad", ngas, ncol, nlev);
-
-      // Set surface emissivity to 1 here. There is a note in the RRTMG
-      // implementation that this is treated in the land model, but the old
-      // RRTMG implementation also sets this to 1. This probably does not make
-      // a lot of difference either way, but if a more intelligent value
-      // exists or is assumed in the model we should use it here as well.
-      // TODO: set this more intelligently?
-      yakl::memset(surface_emissivity, 1.0);
-
-      // Add an empty level above model top
-      yakl::memset(cld_tau_gpt_rad, 0.);
-      yakl::memset(aer_tau_bnd_rad, 0.);
-
-      yakl::c::parallel_for(yakl::c::Bounds<3>(ncol, nlev, nswgpts), YAKL_LAMBDA (int icol, int ilev, int igpt) {
-        cld_tau_gpt_rad(icol,ilev,igpt) = cld_tau_gpt(icol,ilev,igpt);
-        aer_tau_bnd_rad(icol,ilev,igpt) = aer_tau_bnd(icol,ilev,igpt);
-        gas_vmr_rad(igpt,icol,ilev) = gas_vmr(igpt,icol,ilev);
+      // The inputs on the radiation vertical grid have an empty level above model
+      //    top; it is zeroed in alloc_buffers and never written here
+      auto l_cld_tau_gpt_rad = cld_tau_gpt_rad;
+      auto l_aer_tau_bnd_rad = aer_tau_bnd_rad;
+      auto l_gas_vmr_rad     = gas_vmr_rad;
+
+      yakl::c::parallel_for(yakl::c::Bounds<3>(ncol, nlev, nlwgpts), YAKL_LAMBDA (int icol, int ilev, int igpt) {
+        l_cld_tau_gpt_rad(icol,ilev,igpt) = cld_tau_gpt(icol,ilev,igpt);
+      });
+
+      yakl::c::parallel_for(yakl::c::Bounds<3>(ncol, nlev, nlwbands), YAKL_LAMBDA (int icol, int ilev, int ibnd) {
+        l_aer_tau_bnd_rad(icol,ilev,ibnd) = aer_tau_bnd(icol,ilev,ibnd);
+      });
+
+      yakl::c::parallel_for(yakl::c::Bounds<3>(ngas, ncol, nlev), YAKL_LAMBDA (int igas, int icol, int ilev) {
+        l_gas_vmr_rad(igas,icol,ilev) = gas_vmr(igas,icol,ilev);
       });
 
       // Do longwave radiative transfer calculations
@@ -671,38 +804,86 @@ void Radiation::radiation_driver_lw(int ncol, int nlev,
                              fluxes_allsky.flux_dn,
                              pint, qrl_rad);
 
-      calculate_heating_rate(fluxes_allsky.flux_up,
-                             fluxes_allsky.flux_dn,
-                             pint,qrlc_rad);
+      calculate_heating_rate(fluxes_clrsky.flux_up,
+                             fluxes_clrsky.flux_dn,
+                             pint, qrlc_rad);
 
       // Map heating rates to CAM columns and levels
+      auto l_qrl_rad  = qrl_rad;
+      auto l_qrlc_rad = qrlc_rad;
       yakl::c::parallel_for(yakl::c::Bounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
-        qrl(icol,ilev)  = qrl_rad(icol,ilev);
-        qrlc(icol,ilev) = qrlc_rad(icol,ilev);
+        qrl(icol,ilev)  = l_qrl_rad(icol,ilev);
+        qrlc(icol,ilev) = l_qrlc_rad(icol,ilev);
       });
 }
 
-void Radiation::set_daynight_indices(real1d& coszrs, int1d& day_indices, int1d& night_indices) {
-   // Initialize array of daytime indices to be all zero. If any zeros exist when
-   // we are done, something went wrong.
-   yakl::memset(day_indices, 0.);
-   yakl::memset(night_indices, 0.);
-
-   // Loop over columns and identify daytime columns as those where the cosine
-   // solar zenith angle exceeds zero. Note that we wrap the setting of
-   // day_indices in an if-then to make sure we are not accesing day_indices out
-   // of bounds, and stopping with an informative error message if we do for some
-   // reason.
-   int iday = 0;
-   int inight = 0;
-   for (auto icol = 0; icol < ncol; ++icol) {
-      if (coszrs(icol) > 0.) {
-         iday += 1;
-         day_indices(iday) = icol;
+// Compact the indices of the day (coszrs > 0) and night columns into the leading
+//    nday and ncol-nday entries of day_indices and night_indices, in column order,
+//    with a parallel prefix sum over the day flags; returns nday
+int Radiation::set_daynight_indices(real1d& coszrs, int1d& day_indices, int1d& night_indices) {
+   const real* cosz = coszrs.data();
+   int* day   = day_indices.data();
+   int* night = night_indices.data();
+
+   // The exclusive sum of the day flags is the position of a day column among the day
+   //    columns; the position of a night column among the night columns follows from it
+   int nday = amrex::Scan::PrefixSum<int>(ncol,
+        [=] AMREX_GPU_DEVICE (int icol) -> int { return (cosz[icol] > 0.) ? 1 : 0; },
+        [=] AMREX_GPU_DEVICE (int icol, int const& iday) {
+            if (cosz[icol] > 0.) {
+               day[iday] = icol;
+            } else {
+               night[icol - iday] = icol;
+            }
+        },
+        amrex::Scan::Type::exclusive, amrex::Scan::retSum);
+
+   return nday;
+}
+
+// Cosine of the solar zenith angle from the solar declination and hour angle of the
+//    fractional day of the year; the orbit is taken to be circular
+real Radiation::cosine_solar_zenith_angle(const amrex::Real& time) const {
+   const real deg_to_rad = PI / 180.0;
+
+   const real day  = m_day_of_year + (m_utc_hour*3600.0 + time) / 86400.0;
+   const real hour = 24.0 * (day - std::floor(day));
+
+   const real declination = 23.44 * deg_to_rad * std::sin(2.0*PI*(284.0 + day)/365.0);
+   const real hour_angle  = (hour + m_longitude/15.0 - 12.0) * 15.0 * deg_to_rad;
+   const real lat         = m_latitude * deg_to_rad;
+
+   return std::sin(lat)*std::sin(declination) + std::cos(lat)*std::cos(declination)*std::cos(hour_angle);
+}
+
+// Constant, well-mixed volume mixing ratios for the gases that ERF does not carry
+void Radiation::set_default_gas_vmr() {
+   for (int igas = 0; igas < ngas; ++igas) {
+      const std::string& name = active_gases[igas];
+      real vmr;
+      if (name == "H2O") {
+         continue;
+      } else if (name == "CO2") {
+         vmr = 400.0e-6;
+      } else if (name == "O3") {
+         vmr = 30.0e-9;
+      } else if (name == "N2O") {
+         vmr = 320.0e-9;
+      } else if (name == "CO") {
+         vmr = 1.0e-7;
+      } else if (name == "CH4") {
+         vmr = 1.8e-6;
+      } else if (name == "O2") {
+         vmr = 0.209;
+      } else if (name == "N2") {
+         vmr = 0.7906;
       } else {
-         inight += 1;
-         night_indices(inight) = icol;
+         amrex::Abort("Radiation: no default volume mixing ratio for gas " + name);
       }
+      auto l_gas_vmr = gas_vmr;
+      yakl::c::parallel_for(yakl::c::Bounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
+         l_gas_vmr(igas,icol,ilev) = vmr;
+      });
    }
 }
 
@@ -778,12 +959,10 @@ void Radiation::get_gas_vmr(std::vector<std::string>& gas_names, real3d& gas_vmr
   // Why? Something to do with convenience with applying the fluxes to the
   // heating tendency?
 void Radiation::calculate_heating_rate(real2d& flux_up, real2d& flux_dn, real2d& pint, real2d& heating_rate) {
-  for (auto ilev = 0; ilev < nlev; ++ilev) {
-     for (auto icol = 0; icol < ncol; ++icol) {
-         heating_rate(icol,ilev) = (flux_up(icol,ilev+1) - flux_up(icol,ilev)- flux_dn(icol,ilev+1)+flux_dn(icol,ilev))
-                                   *CONST_GRAV/(pint(icol,ilev+1)-pint(icol,ilev));
-     }
-  }
+  yakl::c::parallel_for(yakl::c::Bounds<2>(nlev, ncol), YAKL_LAMBDA (int ilev, int icol) {
+     heating_rate(icol,ilev) = (flux_up(icol,ilev+1) - flux_up(icol,ilev)- flux_dn(icol,ilev+1)+flux_dn(icol,ilev))
+                               *CONST_GRAV/(pint(icol,ilev+1)-pint(icol,ilev));
+  });
 }
 
 // call back
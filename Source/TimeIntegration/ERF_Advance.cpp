@@ -21,6 +21,9 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
     // We must swap the pointers so the previous step's "new" is now this step's "old"
     std::swap(vars_old[lev], vars_new[lev]);
 
+    // Any cached horizontal averages refer to the data before the swap
+    h_averager[lev].clear();
+
     MultiFab& S_old = vars_old[lev][Vars::cons];
     MultiFab& S_new = vars_new[lev][Vars::cons];
 
@@ -32,6 +35,13 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
     MultiFab& V_new = vars_new[lev][Vars::yvel];
     MultiFab& W_new = vars_new[lev][Vars::zvel];
 
+#ifdef ERF_USE_NETCDF
+    // Hold the wrfbdy data needed for this step and read the next time level in the background
+    if (lev == 0 && init_type == "real") {
+        wrfbdy_provider.update(time, time + dt_lev, {&S_old, &U_old, &V_old, &W_old});
+    }
+#endif
+
 
     // configure ABLMost params if used MostWall boundary condition
     if (phys_bc_type[Orientation(Direction::z,Orientation::low)] == ERF_BC::MOST) {
@@ -52,8 +62,13 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
     V_new.setVal(1.e34,V_new.nGrowVect());
     W_new.setVal(1.e34,W_new.nGrowVect());
 
-    FillPatch(lev, time, {&vars_old[lev][Vars::cons], &vars_old[lev][Vars::xvel],
-                          &vars_old[lev][Vars::yvel], &vars_old[lev][Vars::zvel]});
+    // The level 0 ghost cells may already have been filled while the time step was reduced
+    if (lev == 0 && lev0_ghosts_filled) {
+        lev0_ghosts_filled = false;
+    } else {
+        FillPatch(lev, time, {&vars_old[lev][Vars::cons], &vars_old[lev][Vars::xvel],
+                              &vars_old[lev][Vars::yvel], &vars_old[lev][Vars::zvel]});
+    }
 #if defined(ERF_USE_MOISTURE)
     FillPatchMoistVars(lev, qmoist[lev]);
 #endif
@@ -100,8 +115,12 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
 
     int nvars = S_old.nComp();
 
+    ERFScratchArena& scratch = scratch_arena[lev];
+    scratch.reset_counters();
+    fast_coeffs_cache[lev].reset_counters();
+
     // Place-holder for source array -- for now just set to 0
-    MultiFab source(ba,dm,nvars,1);
+    MultiFab& source = scratch.get("source",ba,dm,nvars,1);
     source.setVal(0.0);
 #if defined(ERF_USE_WARM_NO_PRECIP)
     Real tau_cond = solverChoice.tau_cond;
@@ -109,12 +128,19 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
     condensation_source(source, S_new, tau_cond, c_p);
 #endif
 
+#if defined(ERF_USE_RRTMGP)
+    // Radiative heating of (rho theta), recomputed every rad_interval steps
+    if (rad_interval > 0) {
+        advance_radiation(lev, S_old, source, time, dt_lev);
+    }
+#endif
+
     // We don't need to call FillPatch on cons_mf because we have fillpatch'ed S_old above
-    MultiFab cons_mf(ba,dm,nvars,S_old.nGrowVect());
+    MultiFab& cons_mf = scratch.get("cons_mf",ba,dm,nvars,S_old.nGrowVect());
     MultiFab::Copy(cons_mf,S_old,0,0,S_old.nComp(),S_old.nGrowVect());
 
     // Define Multifab for buoyancy term -- only added to vertical velocity
-    MultiFab buoyancy(W_old.boxArray(),W_old.DistributionMap(),1,1);
+    MultiFab& buoyancy = scratch.get("buoyancy",W_old.boxArray(),W_old.DistributionMap(),1,1);
 
     // Update the dycore
     advance_dycore(lev,
@@ -127,16 +153,26 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
                   source, buoyancy,
                   Geom(lev), dt_lev, time, &ifr);
 
+    if (verbose > 1) {
+        scratch.report(lev);
+        fast_coeffs_cache[lev].report(lev);
+    }
+
 #if defined(ERF_USE_MOISTURE)
     // Update the microphysics
     advance_microphysics(lev, S_new, dt_lev);
 #endif
 
 #ifdef ERF_USE_PARTICLES
-    // Update tracer particles on level 0
-    if (lev == 0 && use_tracer_particles) {
+    // Update tracer particles on this level
+    if (use_tracer_particles) {
         MultiFab* Umac = &vars_new[lev][Vars::xvel];
-        tracer_particles->AdvectWithUmac(Umac, lev, dt_lev, *z_phys_nd[0]);
+        tracer_particles->AdvectWithUmac(Umac, lev, dt_lev, *z_phys_nd[lev], box_cost[lev].get());
     }
 #endif
+
+#ifdef ERF_USE_NETCDF
+    // The output after the step may call NetCDF, which is not thread safe
+    if (lev == 0) wrfbdy_provider.wait();
+#endif
 }
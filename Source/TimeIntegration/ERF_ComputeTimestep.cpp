@@ -1,23 +1,73 @@
+#include <AMReX_ParReduce.H>
+#include <AMReX_ParallelReduce.H>
 #include <EOS.H>
 #include <ERF.H>
 
 using namespace amrex;
 
 /**
- * Function that calls estTimeStep for each level
- *
+ * Function that computes the time step at every level.  The local CFL maxima of all
+ * levels are packed into a single vector so that only one global reduction is needed.
  */
 void
 ERF::ComputeDt ()
 {
-    Vector<Real> dt_tmp(finest_level+1);
+    ComputeDtStart();
+    ComputeDtFinish();
+}
+
+/**
+ * Compute the local CFL maxima at all levels and start their global reduction.
+ * If MPI is used and erf.overlap_dt_reduction is set, the reduction is non-blocking and
+ * is completed by ComputeDtFinish, so work that does not depend on dt may be placed
+ * between the two calls.
+ */
+void
+ERF::ComputeDtStart ()
+{
+    BL_PROFILE("ERF::ComputeDtStart()");
+
+    const int nlevs = finest_level+1;
+    dt_inv_buf.resize(2*nlevs);
 
     for (int lev = 0; lev <= finest_level; ++lev)
     {
-        dt_tmp[lev] = estTimeStep(lev, dt_mri_ratio[lev]);
+        estTimeStepLocal(lev, dt_inv_buf[2*lev], dt_inv_buf[2*lev+1]);
+    }
+
+#ifdef AMREX_USE_MPI
+    if (overlap_dt_reduction && ParallelContext::NProcsSub() > 1) {
+        MPI_Iallreduce(MPI_IN_PLACE, dt_inv_buf.data(), 2*nlevs,
+                       ParallelDescriptor::Mpi_typemap<Real>::type(), MPI_MAX,
+                       ParallelContext::CommunicatorSub(), &dt_reduce_request);
+        dt_reduce_pending = true;
+        return;
+    }
+#endif
+    ParallelAllReduce::Max(dt_inv_buf.data(), 2*nlevs, ParallelContext::CommunicatorSub());
+}
+
+/**
+ * Complete the reduction started in ComputeDtStart and set dt at every level
+ */
+void
+ERF::ComputeDtFinish ()
+{
+    BL_PROFILE("ERF::ComputeDtFinish()");
+
+#ifdef AMREX_USE_MPI
+    if (dt_reduce_pending) {
+        MPI_Wait(&dt_reduce_request, MPI_STATUS_IGNORE);
+        dt_reduce_pending = false;
     }
+#endif
 
-    ParallelDescriptor::ReduceRealMin(&dt_tmp[0], dt_tmp.size());
+    Vector<Real> dt_tmp(finest_level+1);
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        dt_tmp[lev] = estTimeStepFromInv(lev, dt_inv_buf[2*lev], dt_inv_buf[2*lev+1], dt_mri_ratio[lev]);
+    }
 
     Real dt_0 = dt_tmp[0];
     int n_factor = 1;
@@ -40,7 +90,7 @@ ERF::ComputeDt ()
 }
 
 /**
- * Function that calls estTimeStep for each level
+ * Function that computes the time step at a single level
  *
  * @param[in] level level of refinement (coarsest level i 0)
  * @param[out] dt_fast_ratio ratio of slow to fast time step
@@ -48,79 +98,106 @@ ERF::ComputeDt ()
 Real
 ERF::estTimeStep(int level, long& dt_fast_ratio) const
 {
-  BL_PROFILE("ERF::estTimeStep()");
+    Real inv_dt[2];
+    estTimeStepLocal(level, inv_dt[0], inv_dt[1]);
+    ParallelAllReduce::Max(inv_dt, 2, ParallelContext::CommunicatorSub());
+    return estTimeStepFromInv(level, inv_dt[0], inv_dt[1], dt_fast_ratio);
+}
 
-  amrex::Real estdt_comp = 1.e20;
-  amrex::Real estdt_lowM = 1.e20;
+/**
+ * Function that computes the local (this rank only) maxima of the inverse acoustic and
+ * advective time step limits at a level.  Both are evaluated in a single pass directly
+ * from the face velocities, i.e. without forming cell-centered velocities first.
+ *
+ * @param[in]  level level of refinement (coarsest level i 0)
+ * @param[out] estdt_comp_inv maximum of (|u|+c)/dx over the level
+ * @param[out] estdt_lowM_inv maximum of |u|/dx over the level
+ */
+void
+ERF::estTimeStepLocal(int level, Real& estdt_comp_inv, Real& estdt_lowM_inv) const
+{
+  BL_PROFILE("ERF::estTimeStepLocal()");
 
   auto const dxinv = geom[level].InvCellSizeArray();
   auto const dzinv = 1.0 / dz_min;
 
   MultiFab const& S_new = vars_new[level][Vars::cons];
 
-  MultiFab ccvel(grids[level],dmap[level],3,0);
-
-  average_face_to_cellcenter(ccvel,0,
-      Array<const MultiFab*,3>{&vars_new[level][Vars::xvel],
-                               &vars_new[level][Vars::yvel],
-                               &vars_new[level][Vars::zvel]});
+  auto const& s_arrays = S_new.const_arrays();
+  auto const& u_arrays = vars_new[level][Vars::xvel].const_arrays();
+  auto const& v_arrays = vars_new[level][Vars::yvel].const_arrays();
+  auto const& w_arrays = vars_new[level][Vars::zvel].const_arrays();
 
   int l_no_substepping = solverChoice.no_substepping;
 
-  Real estdt_comp_inv = amrex::ReduceMax(S_new, ccvel, 0,
-       [=] AMREX_GPU_HOST_DEVICE (Box const& b,
-                                  Array4<Real const> const& s,
-                                  Array4<Real const> const& u) -> Real
+  GpuTuple<Real,Real> inv_max = ParReduce(TypeList<ReduceOpMax,ReduceOpMax>{},
+                                          TypeList<Real,Real>{},
+                                          S_new, IntVect::TheZeroVector(),
+       [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
+            -> GpuTuple<Real,Real>
        {
-           Real new_comp_dt = -1.e100;
-           amrex::Loop(b, [=,&new_comp_dt] (int i, int j, int k) noexcept
-           {
-               const amrex::Real rho      = s(i, j, k, Rho_comp);
-               const amrex::Real rhotheta = s(i, j, k, RhoTheta_comp);
-
-               // NOTE: even when moisture is present,
-               //       we only use the partial pressure of the dry air
-               //       to compute the soundspeed
-               amrex::Real pressure = getPgivenRTh(rhotheta);
-               amrex::Real c = std::sqrt(Gamma * pressure / rho);
-
-               // If we are not doing the acoustic substepping, then the z-direction contributes
-               //    to the computation of the time step
-               if (l_no_substepping) {
-                   new_comp_dt = amrex::max(((amrex::Math::abs(u(i,j,k,0))+c)*dxinv[0]),
-                                            ((amrex::Math::abs(u(i,j,k,1))+c)*dxinv[1]),
-                                            ((amrex::Math::abs(u(i,j,k,2))+c)*dzinv   ), new_comp_dt);
-
-               // If we are     doing the acoustic substepping, then the z-direction does not contribute
-               //    to the computation of the time step
-               } else {
-                   new_comp_dt = amrex::max(((amrex::Math::abs(u(i,j,k,0))+c)*dxinv[0]),
-                                            ((amrex::Math::abs(u(i,j,k,1))+c)*dxinv[1]), new_comp_dt);
-               }
-           });
-           return new_comp_dt;
-       });
+           auto const& s = s_arrays[box_no];
 
-   amrex::ParallelDescriptor::ReduceRealMax(estdt_comp_inv);
-   estdt_comp = cfl / estdt_comp_inv;;
+           const amrex::Real rho      = s(i, j, k, Rho_comp);
+           const amrex::Real rhotheta = s(i, j, k, RhoTheta_comp);
 
-   Real estdt_lowM_inv = amrex::ReduceMax(ccvel, 0,
-       [=] AMREX_GPU_HOST_DEVICE (Box const& b,
-                                  Array4<Real const> const& u) -> Real
-       {
-           Real new_lm_dt = -1.e100;
-           amrex::Loop(b, [=,&new_lm_dt] (int i, int j, int k) noexcept
-           {
-               new_lm_dt = amrex::max(((amrex::Math::abs(u(i,j,k,0)))*dxinv[0]),
-                                      ((amrex::Math::abs(u(i,j,k,1)))*dxinv[1]),
-                                      ((amrex::Math::abs(u(i,j,k,2)))*dxinv[2]), new_lm_dt);
-           });
-           return new_lm_dt;
+           // Cell-centered velocity magnitudes from the face values
+           const amrex::Real abs_u = amrex::Math::abs(0.5 * (u_arrays[box_no](i,j,k) + u_arrays[box_no](i+1,j  ,k  )));
+           const amrex::Real abs_v = amrex::Math::abs(0.5 * (v_arrays[box_no](i,j,k) + v_arrays[box_no](i  ,j+1,k  )));
+           const amrex::Real abs_w = amrex::Math::abs(0.5 * (w_arrays[box_no](i,j,k) + w_arrays[box_no](i  ,j  ,k+1)));
+
+           // NOTE: even when moisture is present,
+           //       we only use the partial pressure of the dry air
+           //       to compute the soundspeed
+           amrex::Real pressure = getPgivenRTh(rhotheta);
+           amrex::Real c = std::sqrt(Gamma * pressure / rho);
+
+           amrex::Real new_comp_dt;
+
+           // If we are not doing the acoustic substepping, then the z-direction contributes
+           //    to the computation of the time step
+           if (l_no_substepping) {
+               new_comp_dt = amrex::max(((abs_u+c)*dxinv[0]),
+                                        ((abs_v+c)*dxinv[1]),
+                                        ((abs_w+c)*dzinv   ));
+
+           // If we are     doing the acoustic substepping, then the z-direction does not contribute
+           //    to the computation of the time step
+           } else {
+               new_comp_dt = amrex::max(((abs_u+c)*dxinv[0]),
+                                        ((abs_v+c)*dxinv[1]));
+           }
+
+           amrex::Real new_lm_dt = amrex::max((abs_u*dxinv[0]),
+                                              (abs_v*dxinv[1]),
+                                              (abs_w*dxinv[2]));
+
+           return {new_comp_dt, new_lm_dt};
        });
 
-   amrex::ParallelDescriptor::ReduceRealMax(estdt_lowM_inv);
-   if (estdt_lowM_inv > 0.0_rt)
-       estdt_lowM = cfl / estdt_lowM_inv;;
+   estdt_comp_inv = amrex::get<0>(inv_max);
+   estdt_lowM_inv = amrex::get<1>(inv_max);
+}
+
+/**
+ * Function that turns the (globally reduced) inverse time step limits at a level into
+ * the time step and the ratio of slow to fast time step
+ *
+ * @param[in]  level level of refinement (coarsest level i 0)
+ * @param[in]  estdt_comp_inv maximum of (|u|+c)/dx over the level
+ * @param[in]  estdt_lowM_inv maximum of |u|/dx over the level
+ * @param[out] dt_fast_ratio ratio of slow to fast time step
+ */
+Real
+ERF::estTimeStepFromInv(int level, Real estdt_comp_inv, Real estdt_lowM_inv, long& dt_fast_ratio) const
+{
+  amrex::Real estdt_comp = cfl / estdt_comp_inv;
+  amrex::Real estdt_lowM = 1.e20;
+
+  if (estdt_lowM_inv > 0.0_rt)
+      estdt_lowM = cfl / estdt_lowM_inv;
+
+  int l_no_substepping = solverChoice.no_substepping;
 
   if (verbose) {
     if (fixed_dt <= 0.0) {
@@ -34,6 +34,13 @@ ERF::timeStep (int lev, Real time, int iteration)
                 int old_finest = finest_level;
                 regrid(lev, time);
 
+#ifdef ERF_USE_PARTICLES
+                // Move the tracer particles onto the new grids
+                if (use_tracer_particles) {
+                    tracer_particles->Redistribute();
+                }
+#endif
+
                 // NOTE: Def & Reg index lev backwards (so we add 1 here)
                 // Redefine & register the ERFFillpatcher objects
                 if (coupling_type=="OneWay" && cf_width>0) {
@@ -87,6 +94,17 @@ ERF::timeStep (int lev, Real time, int iteration)
             AverageDownTo(lev); // average lev+1 down to lev
         }
     }
+
+#ifdef ERF_USE_PARTICLES
+    // Particles that left the grids of this level are moved to the right level and grid.
+    //     On the last substep of a fine level this is left to the coarser level; in between
+    //     particles may stay up to one cell per substep outside the grids of this level,
+    //     where the velocity is still available in the ghost cells.
+    if (use_tracer_particles && (lev == 0 || iteration < nsubsteps[lev])) {
+        int ngrow = (lev == 0) ? 0 : iteration;
+        tracer_particles->Redistribute(lev, finest_level, ngrow);
+    }
+#endif
 }
 
 /**
@@ -6,7 +6,7 @@
 #include <ERF.H>
 #include <TerrainMetrics.H>
 #include <TI_headers.H>
-#include <PlaneAverage.H>
+#include <HorizontalAverager.H>
 #include <Diffusion.H>
 #include <TileNoZ.H>
 #include <Utils.H>
@@ -91,9 +91,11 @@ void ERF::advance_dycore(int level,
     const BoxArray& ba_z          = zvel_old.boxArray();
     const DistributionMapping& dm = cons_old.DistributionMap();
 
-    MultiFab    S_prim  (ba  , dm, NUM_PRIM,          cons_old.nGrowVect());
-    MultiFab  pi_stage  (ba  , dm,        1,          cons_old.nGrowVect());
-    MultiFab fast_coeffs(ba_z, dm,        5,          0);
+    ERFScratchArena& scratch = scratch_arena[level];
+
+    MultiFab&    S_prim   = scratch.get("S_prim"     , ba  , dm, NUM_PRIM, cons_old.nGrowVect());
+    MultiFab&  pi_stage   = scratch.get("pi_stage"   , ba  , dm,        1, cons_old.nGrowVect());
+    MultiFab& fast_coeffs = scratch.get("fast_coeffs", ba_z, dm,        5, 0);
     MultiFab* eddyDiffs = eddyDiffs_lev[level].get();
     MultiFab* SmnSmn    = SmnSmn_lev[level].get();
 
@@ -111,7 +113,9 @@ void ERF::advance_dycore(int level,
     MultiFab* Tau32 = Tau32_lev[level].get();
     {
     BL_PROFILE("erf_advance_strain");
-    if (l_use_diff) {
+    // With use_fused_stress there is no Tau to fill: the strain is computed on the fly
+    //    by the LES model and in the slow RHS
+    if (l_use_diff && !solverChoice.use_fused_stress) {
 
         const amrex::BCRec* bc_ptr_h = domain_bcs_type.data();
         const GpuArray<Real, AMREX_SPACEDIM> dxInv = fine_geom.InvCellSizeArray();
@@ -168,7 +172,7 @@ void ERF::advance_dycore(int level,
     } // profile
 
 
-    MultiFab Omega (zmom_old.boxArray(),dm,1,1);
+    MultiFab& Omega = scratch.get("Omega", zmom_old.boxArray(), dm, 1, 1);
 
 #include "TI_utils.H"
 
@@ -212,13 +216,14 @@ void ERF::advance_dycore(int level,
     // *************************************************************************
     if (l_use_kturb)
     {
-        ComputeTurbulentViscosity(xvel_old, yvel_old,
-                                  *Tau11, *Tau22, *Tau33,
-                                  *Tau12, *Tau13, *Tau23,
+        ComputeTurbulentViscosity(xvel_old, yvel_old, zvel_old,
+                                  Tau11, Tau22, Tau33,
+                                  Tau12, Tau13, Tau23,
                                   state_old[IntVar::cons],
-                                  *eddyDiffs, *Hfx1, *Hfx2, *Hfx3, *Diss, // to be updated
-                                  fine_geom, *mapfac_u[level], *mapfac_v[level],
-                                  solverChoice, m_most);
+                                  *eddyDiffs, Hfx1, Hfx2, Hfx3, Diss, // to be updated
+                                  fine_geom, *mapfac_m[level], *mapfac_u[level], *mapfac_v[level],
+                                  domain_bcs_type.data(), solverChoice, m_most,
+                                  pbl_columns[level]);
     }
 
     // ***********************************************************************************************
@@ -249,25 +254,20 @@ void ERF::advance_dycore(int level,
     } // profile
 
 #ifdef ERF_USE_MOISTURE
-    PlaneAverage qv_ave(&qvapor, geom[level], solverChoice.ave_plane);
-    PlaneAverage qc_ave(&qcloud, geom[level], solverChoice.ave_plane);
-    PlaneAverage qi_ave(&qice, geom[level], solverChoice.ave_plane);
-
-    // Compute plane averages
-    qv_ave.compute_averages(ZDir(), qv_ave.field());
-    qc_ave.compute_averages(ZDir(), qc_ave.field());
-    qi_ave.compute_averages(ZDir(), qi_ave.field());
+    // Compute plane averages of all three in one sweep with one reduction
+    const auto& q_ave = h_averager[level].average("moisture", old_time, geom[level],
+                                                  {{&qvapor, 0}, {&qcloud, 0}, {&qice, 0}});
 
     // get plane averaged data
-    int ncell = qv_ave.ncell_line();
+    int ncell = q_ave.ncell_line;
 
     Gpu::HostVector  <Real> qv_h(ncell), qi_h(ncell), qc_h(ncell);
     Gpu::DeviceVector<Real> qv_d(ncell), qc_d(ncell), qi_d(ncell);
 
     // Fill the vectors with the line averages computed above
-    qv_ave.line_average(0, qv_h);
-    qi_ave.line_average(0, qi_h);
-    qc_ave.line_average(0, qc_h);
+    q_ave.line_average(0, qv_h);
+    q_ave.line_average(2, qi_h);
+    q_ave.line_average(1, qc_h);
 
     // Copy data to device
     Gpu::copyAsync(Gpu::hostToDevice, qv_h.begin(), qv_h.end(), qv_d.begin());
@@ -307,6 +307,9 @@ void ERF::advance_dycore(int level,
 
     mri_integrator.advance(state_old, state_new, old_time, dt_advance);
 
+    // The ghost cells of the last stage are not overlapped with anything
+    if (halo_pending) finish_bcs();
+
     // Register coarse data for coarse-fine fill
     if (level<finest_level && coupling_type=="OneWay" && cf_width>0) {
         FPr_c[level].registerCoarseData({&cons_old, &cons_new}, {old_time, old_time + dt_advance});
@@ -7,10 +7,33 @@ void ERF::advance_microphysics(int lev,
                                MultiFab& cons,
                                const Real& dt_advance)
 {
+    // The column path needs every box to span the vertical domain; the stage
+    //    path below works with any boxes
+    const Box& domain = Geom(lev).Domain();
+    const BoxArray& ba = cons.boxArray();
+    bool full_columns = true;
+    for (int n = 0; n < ba.size(); ++n) {
+        if (ba[n].smallEnd(2) != domain.smallEnd(2) || ba[n].bigEnd(2) != domain.bigEnd(2)) full_columns = false;
+    }
+
+    if (solverChoice.use_column_microphysics && full_columns) {
+        micro.InitTables(cons,
+                         grids_to_evolve[lev],
+                         Geom(lev),
+                         dt_advance,
+                         h_averager[lev],
+                         t_new[lev]);
+
+        micro.AdvanceColumns(cons, qmoist[lev], box_cost[lev].get());
+        return;
+    }
+
     micro.Init(cons, qmoist[lev],
                grids_to_evolve[lev],
                Geom(lev),
-               dt_advance);
+               dt_advance,
+               h_averager[lev],
+               t_new[lev]);
 
     micro.Cloud();
     micro.Diagnose();
@@ -0,0 +1,73 @@
+#include <ERF.H>
+#include "Radiation.H"
+
+using namespace amrex;
+
+#if defined(ERF_USE_RRTMGP)
+/**
+ * Update the radiative heating rates if this is a radiation step, and add the
+ * resulting heating to the (rho theta) source term.
+ *
+ * The heating rates are held between radiation calls; they are recomputed every
+ * rad_interval steps and at the first step after the level has been (re)made.
+ *
+ * @param[in]  lev        level of refinement
+ * @param[in]  cons       conserved state at the start of the step (with qmoist consistent with it)
+ * @param[out] source     source terms for the conserved variables
+ * @param[in]  time       time at the start of the step
+ * @param[in]  dt_advance time step
+ */
+void ERF::advance_radiation (int lev,
+                             MultiFab& cons,
+                             MultiFab& source,
+                             const Real& time,
+                             const Real& dt_advance)
+{
+    BL_PROFILE("ERF::advance_radiation()");
+
+    if (!rad[lev]) {
+        bool do_sw_rad   = rad_do_shortwave;
+        bool do_lw_rad   = true;
+        bool do_aero_rad = false;
+        bool do_snow_opt = false;
+        bool is_cmip6_volcano = false;
+        rad[lev] = std::make_unique<Radiation>();
+        rad[lev]->initialize(Geom(lev), dt_advance,
+                             do_sw_rad, do_lw_rad, do_aero_rad,
+                             do_snow_opt, is_cmip6_volcano,
+                             rad_latitude, rad_longitude, rad_day_of_year,
+                             rad_utc_hour, rad_albedo);
+        rad[lev]->define_columns(cons, rad_batch_size);
+    }
+
+    bool need_rates = !qheating_rates[lev];
+    if (need_rates) {
+        qheating_rates[lev] = std::make_unique<MultiFab>(cons.boxArray(), cons.DistributionMap(), 1, 0);
+    }
+
+    if (need_rates || (istep[lev] % rad_interval == 0)) {
+        const MultiFab* qmoist_ptr = nullptr;
+#if defined(ERF_USE_MOISTURE)
+        qmoist_ptr = &qmoist[lev];
+#endif
+        rad[lev]->run(cons, qmoist_ptr, time, *qheating_rates[lev]);
+    }
+
+    // d(rho theta)/dt = rho d(theta)/dt
+    const MultiFab& qheating = *qheating_rates[lev];
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(source, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const Array4<Real      >& src_arr  = source.array(mfi);
+        const Array4<const Real>& cons_arr = cons.const_array(mfi);
+        const Array4<const Real>& q_arr    = qheating.const_array(mfi);
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            src_arr(i,j,k,RhoTheta_comp) += cons_arr(i,j,k,Rho_comp) * q_arr(i,j,k);
+        });
+    }
+}
+#endif
@@ -8,6 +8,7 @@
 #include <IndexDefines.H>
 #include <TerrainMetrics.H>
 #include <TI_headers.H>
+#include <BoxCost.H>
 #include <prob_common.H>
 
 using namespace amrex;
@@ -43,6 +44,9 @@ using namespace amrex;
  * @param[in] mapfac_m map factor at cell centers
  * @param[in] mapfac_u map factor at x-faces
  * @param[in] mapfac_v map factor at y-faces
+ * @param[in]  scratch level-owned pool for the temporaries used here
+ * @param[in]  tridiag packed factorization of the vertical tridiagonal systems (CPU only)
+ * @param[in,out] cost measured wall time of each box (not measured if null)
  */
 
 void erf_fast_rhs_MT (int step, int /*level*/,
@@ -70,7 +74,10 @@ void erf_fast_rhs_MT (int step, int /*level*/,
                       const Real facinv,
                       std::unique_ptr<MultiFab>& /*mapfac_m*/,
                       std::unique_ptr<MultiFab>& mapfac_u,
-                      std::unique_ptr<MultiFab>& mapfac_v)
+                      std::unique_ptr<MultiFab>& mapfac_v,
+                      ERFScratchArena& scratch,
+                      const BatchedTridiagonalSolver& tridiag,
+                      LayoutData<Real>* cost)
 {
     BL_PROFILE_REGION("erf_fast_rhs_MT()");
 
@@ -99,7 +106,7 @@ void erf_fast_rhs_MT (int step, int /*level*/,
     const    Array<Real,AMREX_SPACEDIM> grav{0.0, 0.0, -solverChoice.gravity};
     const GpuArray<Real,AMREX_SPACEDIM> grav_gpu{grav[0], grav[1], grav[2]};
 
-    MultiFab extrap(S_data[IntVar::cons].boxArray(),S_data[IntVar::cons].DistributionMap(),1,1);
+    MultiFab& extrap = scratch.get("extrap",S_data[IntVar::cons].boxArray(),S_data[IntVar::cons].DistributionMap(),1,1);
 
     // *************************************************************************
     // Define updates in the current RK stg
@@ -117,6 +124,8 @@ void erf_fast_rhs_MT (int step, int /*level*/,
     //        will require additional changes
     for ( MFIter mfi(S_stg_data[IntVar::cons],false); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         // Construct intersection of current tilebox and valid region for updating
         Box valid_bx = grids_to_evolve[mfi.index()];
         Box       bx = mfi.tilebox() & valid_bx;
@@ -476,8 +485,6 @@ void erf_fast_rhs_MT (int step, int /*level*/,
 
                  Real rho_on_bdy = 0.5 * ( prev_cons(i,j,0) + prev_cons(i,j,-1) );
                  RHS_a(i,j,0) = rho_on_bdy * zp_t_arr(i,j,0);
-
-                 soln_a(i,j,0) = RHS_a(i,j,0) * inv_coeffB_a(i,j,0);
              }
         }
 
@@ -487,22 +494,9 @@ void erf_fast_rhs_MT (int step, int /*level*/,
                  RHS_a (i,j,hi.z+1) =  0.0;
              }
         }
-        for (int k = lo.z+1; k <= hi.z+1; ++k) {
-             for (int j = lo.y; j <= hi.y; ++j) {
-                 AMREX_PRAGMA_SIMD
-                 for (int i = lo.x; i <= hi.x; ++i) {
-                     soln_a(i,j,k) = (RHS_a(i,j,k)-coeffA_a(i,j,k)*soln_a(i,j,k-1)) * inv_coeffB_a(i,j,k);
-                 }
-           }
-        }
-        for (int k = hi.z; k >= lo.z; --k) {
-             for (int j = lo.y; j <= hi.y; ++j) {
-                 AMREX_PRAGMA_SIMD
-                 for (int i = lo.x; i <= hi.x; ++i) {
-                     soln_a(i,j,k) -= ( coeffC_a(i,j,k) * inv_coeffB_a(i,j,k) ) * soln_a(i,j,k+1);
-                 }
-             }
-        }
+
+        tridiag.solve(mfi, bx, RHS_fab.const_array(), soln_a);
+        amrex::ignore_unused(coeffA_a, inv_coeffB_a, coeffC_a);
 
         // We assume that Omega == w at the top boundary and that changes in J there are irrelevant
         for (int j = lo.y; j <= hi.y; ++j) {
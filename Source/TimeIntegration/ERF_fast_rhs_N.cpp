@@ -7,6 +7,7 @@
 #include <ERF_Constants.H>
 #include <IndexDefines.H>
 #include <TI_headers.H>
+#include <BoxCost.H>
 #include <prob_common.H>
 
 using namespace amrex;
@@ -33,6 +34,9 @@ using namespace amrex;
  * @param[in] mapfac_m map factor at cell centers
  * @param[in] mapfac_u map factor at x-faces
  * @param[in] mapfac_v map factor at y-faces
+ * @param[in]  scratch level-owned pool for the temporaries used here
+ * @param[in]  tridiag packed factorization of the vertical tridiagonal systems (CPU only)
+ * @param[in,out] cost measured wall time of each box (not measured if null)
  */
 
 void erf_fast_rhs_N (int step, int /*level*/,
@@ -51,7 +55,10 @@ void erf_fast_rhs_N (int step, int /*level*/,
                      const Real facinv,
                      std::unique_ptr<MultiFab>& mapfac_m,
                      std::unique_ptr<MultiFab>& mapfac_u,
-                     std::unique_ptr<MultiFab>& mapfac_v)
+                     std::unique_ptr<MultiFab>& mapfac_v,
+                     ERFScratchArena& scratch,
+                     const BatchedTridiagonalSolver& tridiag,
+                     LayoutData<Real>* cost)
 {
     BL_PROFILE_REGION("erf_fast_rhs_N()");
 
@@ -73,9 +80,9 @@ void erf_fast_rhs_N (int step, int /*level*/,
     const auto& ba = S_stage_data[IntVar::cons].boxArray();
     const auto& dm = S_stage_data[IntVar::cons].DistributionMap();
 
-    MultiFab Delta_rho_w(    convert(ba,IntVect(0,0,1)), dm, 1, IntVect(1,1,0));
-    MultiFab Delta_rho  (            ba                , dm, 1, 1);
-    MultiFab Delta_rho_theta(        ba                , dm, 1, 1);
+    MultiFab& Delta_rho_w     = scratch.get("Delta_rho_w"    , convert(ba,IntVect(0,0,1)), dm, 1, IntVect(1,1,0));
+    MultiFab& Delta_rho       = scratch.get("Delta_rho"      ,         ba                , dm, 1, 1);
+    MultiFab& Delta_rho_theta = scratch.get("Delta_rho_theta",         ba                , dm, 1, 1);
 
     MultiFab     coeff_A_mf(fast_coeffs, amrex::make_alias, 0, 1);
     MultiFab inv_coeff_B_mf(fast_coeffs, amrex::make_alias, 1, 1);
@@ -89,14 +96,14 @@ void erf_fast_rhs_N (int step, int /*level*/,
     const GpuArray<Real,AMREX_SPACEDIM> grav_gpu{grav[0], grav[1], grav[2]};
 
     // This will hold theta extrapolated forward in time
-    MultiFab extrap(S_data[IntVar::cons].boxArray(),S_data[IntVar::cons].DistributionMap(),1,1);
+    MultiFab& extrap = scratch.get("extrap",S_data[IntVar::cons].boxArray(),S_data[IntVar::cons].DistributionMap(),1,1);
 
     // This will hold the update for (rho) and (rho theta)
-    MultiFab temp_rhs(S_stage_data[IntVar::zmom].boxArray(),S_stage_data[IntVar::zmom].DistributionMap(),2,0);
+    MultiFab& temp_rhs = scratch.get("temp_rhs",S_stage_data[IntVar::zmom].boxArray(),S_stage_data[IntVar::zmom].DistributionMap(),2,0);
 
     // This will hold the new x- and y-momenta temporarily (so that we don't overwrite values we need when tiling)
-    MultiFab temp_cur_xmom(S_stage_data[IntVar::xmom].boxArray(),S_stage_data[IntVar::xmom].DistributionMap(),1,0);
-    MultiFab temp_cur_ymom(S_stage_data[IntVar::ymom].boxArray(),S_stage_data[IntVar::ymom].DistributionMap(),1,0);
+    MultiFab& temp_cur_xmom = scratch.get("temp_cur_xmom",S_stage_data[IntVar::xmom].boxArray(),S_stage_data[IntVar::xmom].DistributionMap(),1,0);
+    MultiFab& temp_cur_ymom = scratch.get("temp_cur_ymom",S_stage_data[IntVar::ymom].boxArray(),S_stage_data[IntVar::ymom].DistributionMap(),1,0);
 
     // *************************************************************************
     // First set up some arrays we'll need
@@ -107,6 +114,8 @@ void erf_fast_rhs_N (int step, int /*level*/,
 #endif
     for ( MFIter mfi(S_stage_data[IntVar::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         const Array4<Real>       & cur_cons  = S_data[IntVar::cons].array(mfi);
         const Array4<const Real>& prev_cons  = S_prev[IntVar::cons].const_array(mfi);
         const Array4<const Real>& stage_cons = S_stage_data[IntVar::cons].const_array(mfi);
@@ -157,6 +166,8 @@ void erf_fast_rhs_N (int step, int /*level*/,
 #endif
     for ( MFIter mfi(S_stage_data[IntVar::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         // We define lagged_delta_rt for our next step as the current delta_rt
         Box valid_bx = grids_to_evolve[mfi.index()];
         Box gbx = mfi.tilebox() & valid_bx; gbx.grow(1);
@@ -178,6 +189,8 @@ void erf_fast_rhs_N (int step, int /*level*/,
 #endif
     for ( MFIter mfi(S_stage_data[IntVar::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         const Box& valid_bx = grids_to_evolve[mfi.index()];
 
         // Construct intersection of current tilebox and valid region for updating
@@ -277,6 +290,8 @@ void erf_fast_rhs_N (int step, int /*level*/,
 #endif
     for ( MFIter mfi(S_stage_data[IntVar::cons],TileNoZ()); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         // Construct intersection of current tilebox and valid region for updating
         Box bx = mfi.tilebox() & grids_to_evolve[mfi.index()];
 
@@ -450,7 +465,6 @@ void erf_fast_rhs_N (int step, int /*level*/,
             AMREX_PRAGMA_SIMD
             for (int i = lo.x; i <= hi.x; ++i) {
                 RHS_a   (i,j,0) =  0.0;
-                soln_a(i,j,0) = RHS_a(i,j,0) * inv_coeffB_a(i,j,0);
             }
         }
         // Note that if we ever change this, we will need to include it in avg_zmom at the top
@@ -460,25 +474,14 @@ void erf_fast_rhs_N (int step, int /*level*/,
                 RHS_a   (i,j,hi.z+1) =  0.0;
             }
         }
-        for (int k = lo.z+1; k <= hi.z+1; ++k) {
-            for (int j = lo.y; j <= hi.y; ++j) {
-                AMREX_PRAGMA_SIMD
-                for (int i = lo.x; i <= hi.x; ++i) {
-                    soln_a(i,j,k) = (RHS_a(i,j,k)-coeffA_a(i,j,k)*soln_a(i,j,k-1)) * inv_coeffB_a(i,j,k);
-                }
-            }
-        }
-        for (int j = lo.y; j <= hi.y; ++j) {
-            AMREX_PRAGMA_SIMD
-            for (int i = lo.x; i <= hi.x; ++i) {
-                cur_zmom(i,j,hi.z+1) = stage_zmom(i,j,hi.z+1) + soln_a(i,j,hi.z+1);
-            }
-        }
-        for (int k = hi.z; k >= lo.z; --k) {
+
+        tridiag.solve(mfi, bx, RHS_fab.const_array(), soln_a);
+        amrex::ignore_unused(coeffA_a, inv_coeffB_a, coeffC_a);
+
+        for (int k = lo.z; k <= hi.z+1; ++k) {
             for (int j = lo.y; j <= hi.y; ++j) {
                 AMREX_PRAGMA_SIMD
                 for (int i = lo.x; i <= hi.x; ++i) {
-                    soln_a(i,j,k) -= ( coeffC_a(i,j,k) * inv_coeffB_a(i,j,k) ) * soln_a(i,j,k+1);
                     cur_zmom(i,j,k) = stage_zmom(i,j,k) + soln_a(i,j,k);
                 }
             }
@@ -513,6 +516,8 @@ void erf_fast_rhs_N (int step, int /*level*/,
 #endif
     for ( MFIter mfi(S_stage_data[IntVar::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         const Box& bx =  mfi.tilebox() & grids_to_evolve[mfi.index()];
 
         const Array4<Real>& cur_cons  = S_data[IntVar::cons].array(mfi);
@@ -8,6 +8,7 @@
 #include <IndexDefines.H>
 #include <TerrainMetrics.H>
 #include <TI_headers.H>
+#include <BoxCost.H>
 #include <prob_common.H>
 
 using namespace amrex;
@@ -37,6 +38,9 @@ using namespace amrex;
  * @param[in] mapfac_m map factor at cell centers
  * @param[in] mapfac_u map factor at x-faces
  * @param[in] mapfac_v map factor at y-faces
+ * @param[in]  scratch level-owned pool for the temporaries used here
+ * @param[in]  tridiag packed factorization of the vertical tridiagonal systems (CPU only)
+ * @param[in,out] cost measured wall time of each box (not measured if null)
  */
 
 void erf_fast_rhs_T (int step, int /*level*/,
@@ -58,7 +62,10 @@ void erf_fast_rhs_T (int step, int /*level*/,
                      const Real facinv,
                      std::unique_ptr<MultiFab>& mapfac_m,
                      std::unique_ptr<MultiFab>& mapfac_u,
-                     std::unique_ptr<MultiFab>& mapfac_v)
+                     std::unique_ptr<MultiFab>& mapfac_v,
+                     ERFScratchArena& scratch,
+                     const BatchedTridiagonalSolver& tridiag,
+                     LayoutData<Real>* cost)
 {
     BL_PROFILE_REGION("erf_fast_rhs_T()");
 
@@ -79,14 +86,14 @@ void erf_fast_rhs_T (int step, int /*level*/,
     const auto& ba = S_stage_data[IntVar::cons].boxArray();
     const auto& dm = S_stage_data[IntVar::cons].DistributionMap();
 
-    MultiFab Delta_rho_u(    convert(ba,IntVect(1,0,0)), dm, 1, 1);
-    MultiFab Delta_rho_v(    convert(ba,IntVect(0,1,0)), dm, 1, 1);
-    MultiFab Delta_rho_w(    convert(ba,IntVect(0,0,1)), dm, 1, IntVect(1,1,0));
-    MultiFab Delta_rho  (            ba                , dm, 1, 1);
-    MultiFab Delta_rho_theta(        ba                , dm, 1, 1);
+    MultiFab& Delta_rho_u     = scratch.get("Delta_rho_u"    , convert(ba,IntVect(1,0,0)), dm, 1, 1);
+    MultiFab& Delta_rho_v     = scratch.get("Delta_rho_v"    , convert(ba,IntVect(0,1,0)), dm, 1, 1);
+    MultiFab& Delta_rho_w     = scratch.get("Delta_rho_w"    , convert(ba,IntVect(0,0,1)), dm, 1, IntVect(1,1,0));
+    MultiFab& Delta_rho       = scratch.get("Delta_rho"      ,         ba                , dm, 1, 1);
+    MultiFab& Delta_rho_theta = scratch.get("Delta_rho_theta",         ba                , dm, 1, 1);
 
-    MultiFab New_rho_u(convert(ba,IntVect(1,0,0)), dm, 1, 1);
-    MultiFab New_rho_v(convert(ba,IntVect(0,1,0)), dm, 1, 1);
+    MultiFab& New_rho_u = scratch.get("New_rho_u", convert(ba,IntVect(1,0,0)), dm, 1, 1);
+    MultiFab& New_rho_v = scratch.get("New_rho_v", convert(ba,IntVect(0,1,0)), dm, 1, 1);
 
     MultiFab     coeff_A_mf(fast_coeffs, amrex::make_alias, 0, 1);
     MultiFab inv_coeff_B_mf(fast_coeffs, amrex::make_alias, 1, 1);
@@ -99,7 +106,7 @@ void erf_fast_rhs_T (int step, int /*level*/,
     const    Array<Real,AMREX_SPACEDIM> grav{0.0, 0.0, -solverChoice.gravity};
     const GpuArray<Real,AMREX_SPACEDIM> grav_gpu{grav[0], grav[1], grav[2]};
 
-    MultiFab extrap(S_data[IntVar::cons].boxArray(),S_data[IntVar::cons].DistributionMap(),1,1);
+    MultiFab& extrap = scratch.get("extrap",S_data[IntVar::cons].boxArray(),S_data[IntVar::cons].DistributionMap(),1,1);
 
     // *************************************************************************
     // First set up some arrays we'll need
@@ -110,6 +117,8 @@ void erf_fast_rhs_T (int step, int /*level*/,
 #endif
     for ( MFIter mfi(S_stage_data[IntVar::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         const Array4<Real>       & cur_cons  = S_data[IntVar::cons].array(mfi);
         const Array4<const Real>& prev_cons  = S_prev[IntVar::cons].const_array(mfi);
         const Array4<const Real>& stage_cons = S_stage_data[IntVar::cons].const_array(mfi);
@@ -174,6 +183,8 @@ void erf_fast_rhs_T (int step, int /*level*/,
 #endif
     for ( MFIter mfi(S_stage_data[IntVar::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         // We define lagged_delta_rt for our next step as the current delta_rt
         Box valid_bx = grids_to_evolve[mfi.index()];
         Box gbx = mfi.tilebox() & valid_bx; gbx.grow(1);
@@ -193,6 +204,8 @@ void erf_fast_rhs_T (int step, int /*level*/,
 #endif
     for ( MFIter mfi(S_stage_data[IntVar::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         // Construct intersection of current tilebox and valid region for updating
         Box valid_bx = grids_to_evolve[mfi.index()];
         Box tbx = mfi.nodaltilebox(0) & surroundingNodes(valid_bx,0);
@@ -316,6 +329,8 @@ void erf_fast_rhs_T (int step, int /*level*/,
 #endif
     for ( MFIter mfi(S_stage_data[IntVar::cons],TileNoZ()); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer box_timer(cost, mfi);
+
         // Construct intersection of current tilebox and valid region for updating
         Box valid_bx = grids_to_evolve[mfi.index()];
         Box bx = mfi.tilebox() & valid_bx;
@@ -537,8 +552,7 @@ void erf_fast_rhs_T (int step, int /*level*/,
             AMREX_PRAGMA_SIMD
             for (int i = lo.x; i <= hi.x; ++i) {
                 RHS_a (i,j,0) =  0.0;
-               soln_a(i,j,0) = RHS_a(i,j,0) * inv_coeffB_a(i,j,0);
-           }
+            }
         }
 
         for (int j = lo.y; j <= hi.y; ++j) {
@@ -547,22 +561,10 @@ void erf_fast_rhs_T (int step, int /*level*/,
                  RHS_a (i,j,hi.z+1) =  0.0;
              }
         }
-        for (int k = lo.z+1; k <= hi.z+1; ++k) {
-             for (int j = lo.y; j <= hi.y; ++j) {
-                 AMREX_PRAGMA_SIMD
-                 for (int i = lo.x; i <= hi.x; ++i) {
-                     soln_a(i,j,k) = (RHS_a(i,j,k)-coeffA_a(i,j,k)*soln_a(i,j,k-1)) * inv_coeffB_a(i,j,k);
-                 }
-           }
-        }
-        for (int k = hi.z; k >= lo.z; --k) {
-             for (int j = lo.y; j <= hi.y; ++j) {
-                 AMREX_PRAGMA_SIMD
-                 for (int i = lo.x; i <= hi.x; ++i) {
-                     soln_a(i,j,k) -= (coeffC_a(i,j,k) * inv_coeffB_a(i,j,k)) * soln_a(i,j,k+1);
-                 }
-             }
-        }
+
+        tridiag.solve(mfi, bx, RHS_fab.const_array(), soln_a);
+        amrex::ignore_unused(coeffA_a, inv_coeffB_a, coeffC_a);
+
         for (int j = lo.y; j <= hi.y; ++j) {
              AMREX_PRAGMA_SIMD
              for (int i = lo.x; i <= hi.x; ++i) {
@@ -12,7 +12,7 @@
 
 #include <TerrainMetrics.H>
 #include <IndexDefines.H>
-#include <PlaneAverage.H>
+#include <HorizontalAverager.H>
 
 using namespace amrex;
 
@@ -34,6 +34,8 @@ using namespace amrex;
  * @param[in]  geom   Container for geometric informaiton
  * @param[in]  solverChoice  Container for solver parameters
  * @param[in]  r0     Reference (hydrostatically stratified) density
+ * @param[in]  h_averager engine (and cache) for the horizontal averages
+ * @param[in]  time   time of the data in S_data, used as the cache key for the averages
  */
 
 void make_buoyancy (BoxArray& grids_to_evolve,
@@ -48,7 +50,9 @@ void make_buoyancy (BoxArray& grids_to_evolve,
 #endif
                     const amrex::Geometry geom,
                     const SolverChoice& solverChoice,
-                    const MultiFab* r0)
+                    const MultiFab* r0,
+                    HorizontalAverager& h_averager,
+                    const Real time)
 {
     BL_PROFILE_REGION("make_buoyancy()");
 
@@ -96,17 +100,16 @@ void make_buoyancy (BoxArray& grids_to_evolve,
 
     } else if (solverChoice.buoyancy_type == 2 || solverChoice.buoyancy_type == 3) {
 
-        PlaneAverage state_ave(&(S_data[IntVar::cons]), geom, solverChoice.ave_plane);
-        PlaneAverage prim_ave(&S_prim, geom, solverChoice.ave_plane);
+        // Only the two components we need are averaged, in one sweep with one reduction
+        const auto& havg = h_averager.average("buoyancy", time, geom,
+                                              {{&S_data[IntVar::cons], Rho_comp},
+                                               {&S_prim, PrimTheta_comp}});
 
-        int ncell = state_ave.ncell_line();
-
-        state_ave.compute_averages(ZDir(), state_ave.field());
-        prim_ave.compute_averages(ZDir(), prim_ave.field());
+        int ncell = havg.ncell_line;
 
         Gpu::HostVector<Real> rho_h(ncell), theta_h(ncell);
-        state_ave.line_average(Rho_comp, rho_h);
-        prim_ave.line_average(PrimTheta_comp, theta_h);
+        havg.line_average(0, rho_h);
+        havg.line_average(1, theta_h);
 
         Gpu::DeviceVector<Real>   rho_d(ncell);
         Gpu::DeviceVector<Real> theta_d(ncell);
@@ -193,22 +196,21 @@ void make_buoyancy (BoxArray& grids_to_evolve,
 
     } else {
 
-    PlaneAverage state_ave(&(S_data[IntVar::cons]), geom, solverChoice.ave_plane);
-    PlaneAverage  prim_ave(&S_prim                , geom, solverChoice.ave_plane);
-
-    // Compute horizontal averages of all components of each field
-    state_ave.compute_averages(ZDir(), state_ave.field());
-     prim_ave.compute_averages(ZDir(), prim_ave.field());
+    // Compute horizontal averages of only the components we need, in one sweep with one reduction
+    const auto& havg = h_averager.average("buoyancy", time, geom,
+                                          {{&S_data[IntVar::cons], Rho_comp},
+                                           {&S_prim, PrimTheta_comp},
+                                           {&S_prim, PrimQp_comp}});
 
-    int ncell = state_ave.ncell_line();
+    int ncell = havg.ncell_line;
 
     Gpu::HostVector  <Real> rho_h(ncell), theta_h(ncell), qp_h(ncell);
     Gpu::DeviceVector<Real> rho_d(ncell), theta_d(ncell);
 
-    state_ave.line_average(Rho_comp, rho_h);
+    havg.line_average(0, rho_h);
     Gpu::copyAsync(Gpu::hostToDevice, rho_h.begin(), rho_h.end(), rho_d.begin());
 
-    prim_ave.line_average(PrimTheta_comp, theta_h);
+    havg.line_average(1, theta_h);
     Gpu::copyAsync(Gpu::hostToDevice, theta_h.begin(), theta_h.end(), theta_d.begin());
 
     Real*   rho_d_ptr =   rho_d.data();
@@ -216,7 +218,7 @@ void make_buoyancy (BoxArray& grids_to_evolve,
 
     if (solverChoice.buoyancy_type == 2) {
 
-        prim_ave.line_average(PrimQp_comp, qp_h);
+        havg.line_average(2, qp_h);
 
         Gpu::DeviceVector<Real>    qp_d(ncell);
 
@@ -0,0 +1,323 @@
+#include <AMReX_MultiFab.H>
+#include <AMReX_BCRec.H>
+#include <ERF_Constants.H>
+#include <IndexDefines.H>
+#include <Interpolation.H>
+#include <TI_headers.H>
+
+using namespace amrex;
+
+namespace {
+
+/**
+ * Single-pass kernel for the cell-centered slow RHS of (rho) and (rho theta) without terrain.
+ * Each cell computes its advective fluxes, its diffusive (rho theta) fluxes, and then adds
+ * the external source and Rayleigh damping before the RHS is written once.
+ */
+template<typename InterpType_H, typename InterpType_V>
+void
+FusedSlowRhsWrapper_N (const Box& bx, const Box& valid_bx, const Box& domain,
+                       const Array4<      Real>& cell_rhs,
+                       const Array4<const Real>& cell_data,
+                       const Array4<const Real>& cell_prim,
+                       const Array4<const Real>& rho_u,
+                       const Array4<const Real>& rho_v,
+                       const Array4<const Real>& Omega,
+                       const Array4<      Real>& avg_xmom,
+                       const Array4<      Real>& avg_ymom,
+                       const Array4<      Real>& avg_zmom,
+                       const Array4<const Real>& mf_m,
+                       const Array4<const Real>& mf_u,
+                       const Array4<const Real>& mf_v,
+                       const Array4<const Real>& mu_turb,
+                       const Array4<const Real>& src_arr,
+                       const GpuArray<Real, AMREX_SPACEDIM>& cellSizeInv,
+                       const bool l_use_diff, const bool l_consA, const bool l_turb,
+                       const Real alpha_T,
+                       const bool ext_dir_zlo, const bool ext_dir_zhi,
+                       const Real* dptr_rayleigh_tau,
+                       const Real* dptr_rayleigh_thetabar)
+{
+    InterpType_H interp_prim_h(cell_prim);
+    InterpType_V interp_prim_v(cell_prim);
+
+    const auto dxInv = cellSizeInv[0], dyInv = cellSizeInv[1], dzInv = cellSizeInv[2];
+
+    const auto& vbx_hi = ubound(valid_bx);
+    const int dom_hi_z = ubound(domain).z;
+
+    const bool l_rayleigh = (dptr_rayleigh_tau != nullptr);
+
+    const int prim_index = PrimTheta_comp;
+
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        // *****************************************************************
+        // Advection
+        // *****************************************************************
+        Real xflux_lo = rho_u(i  ,j,k) / mf_u(i  ,j  ,0);
+        Real xflux_hi = rho_u(i+1,j,k) / mf_u(i+1,j  ,0);
+        Real yflux_lo = rho_v(i,j  ,k) / mf_v(i  ,j  ,0);
+        Real yflux_hi = rho_v(i,j+1,k) / mf_v(i  ,j+1,0);
+        Real zflux_lo = Omega(i,j,k  );
+        Real zflux_hi = Omega(i,j,k+1);
+
+        avg_xmom(i  ,j,k) += xflux_lo;
+        if (i == vbx_hi.x) avg_xmom(i+1,j,k) += xflux_hi;
+
+        avg_ymom(i,j  ,k) += yflux_lo;
+        if (j == vbx_hi.y) avg_ymom(i,j+1,k) += yflux_hi;
+
+        avg_zmom(i,j,k  ) += zflux_lo;
+        if (k == vbx_hi.z) avg_zmom(i,j,k+1) += zflux_hi;
+
+        Real mf   = mf_m(i,j,0);
+        Real mfsq = mf*mf;
+
+        Real rhs_rho = -( ( xflux_hi - xflux_lo ) * dxInv * mfsq +
+                          ( yflux_hi - yflux_lo ) * dyInv * mfsq +
+                          ( zflux_hi - zflux_lo ) * dzInv );
+
+        Real interpx_hi(0.), interpx_lo(0.);
+        Real interpy_hi(0.), interpy_lo(0.);
+        Real interpz_hi(0.), interpz_lo(0.);
+
+        interp_prim_h.InterpolateInX(i,j,k,prim_index,interpx_hi,interpx_lo,rho_u(i+1,j  ,k  ),rho_u(i  ,j  ,k  ));
+        interp_prim_h.InterpolateInY(i,j,k,prim_index,interpy_hi,interpy_lo,rho_v(i  ,j+1,k  ),rho_v(i  ,j  ,k  ));
+
+        interp_prim_v.InterpolateInZ_hi(i,j,k,prim_index,interpz_hi,Omega(i  ,j  ,k+1));
+        interp_prim_v.InterpolateInZ_lo(i,j,k,prim_index,interpz_lo,Omega(i  ,j  ,k  ));
+
+        Real rhs_theta = -( ( xflux_hi * interpx_hi - xflux_lo * interpx_lo ) * dxInv * mfsq +
+                            ( yflux_hi * interpy_hi - yflux_lo * interpy_lo ) * dyInv * mfsq +
+                            ( zflux_hi * interpz_hi - zflux_lo * interpz_lo ) * dzInv );
+
+        // *****************************************************************
+        // Diffusion of (rho theta) -- same fluxes as DiffusionSrcForState_N
+        // *****************************************************************
+        if (l_use_diff) {
+            Real th   = cell_prim(i  ,j  ,k  ,prim_index);
+            Real th_w = cell_prim(i-1,j  ,k  ,prim_index);
+            Real th_e = cell_prim(i+1,j  ,k  ,prim_index);
+            Real th_s = cell_prim(i  ,j-1,k  ,prim_index);
+            Real th_n = cell_prim(i  ,j+1,k  ,prim_index);
+            Real th_b = cell_prim(i  ,j  ,k-1,prim_index);
+            Real th_t = cell_prim(i  ,j  ,k+1,prim_index);
+
+            Real a_xlo = alpha_T, a_xhi = alpha_T;
+            Real a_ylo = alpha_T, a_yhi = alpha_T;
+            Real a_zlo = alpha_T, a_zhi = alpha_T;
+            if (l_consA) {
+                Real rho = cell_data(i,j,k,Rho_comp);
+                a_xlo *= 0.5 * ( rho + cell_data(i-1,j  ,k  ,Rho_comp) );
+                a_xhi *= 0.5 * ( cell_data(i+1,j  ,k  ,Rho_comp) + rho );
+                a_ylo *= 0.5 * ( rho + cell_data(i  ,j-1,k  ,Rho_comp) );
+                a_yhi *= 0.5 * ( cell_data(i  ,j+1,k  ,Rho_comp) + rho );
+                a_zlo *= 0.5 * ( rho + cell_data(i  ,j  ,k-1,Rho_comp) );
+                a_zhi *= 0.5 * ( cell_data(i  ,j  ,k+1,Rho_comp) + rho );
+            }
+            if (l_turb) {
+                Real mu_h = mu_turb(i,j,k,EddyDiff::Theta_h);
+                Real mu_v = mu_turb(i,j,k,EddyDiff::Theta_v);
+                a_xlo += 0.5 * ( mu_h + mu_turb(i-1,j  ,k  ,EddyDiff::Theta_h) );
+                a_xhi += 0.5 * ( mu_turb(i+1,j  ,k  ,EddyDiff::Theta_h) + mu_h );
+                a_ylo += 0.5 * ( mu_h + mu_turb(i  ,j-1,k  ,EddyDiff::Theta_h) );
+                a_yhi += 0.5 * ( mu_turb(i  ,j+1,k  ,EddyDiff::Theta_h) + mu_h );
+                a_zlo += 0.5 * ( mu_v + mu_turb(i  ,j  ,k-1,EddyDiff::Theta_v) );
+                a_zhi += 0.5 * ( mu_turb(i  ,j  ,k+1,EddyDiff::Theta_v) + mu_v );
+            }
+
+            Real dflux_xlo = a_xlo * (th   - th_w) * dxInv * mf_u(i  ,j  ,0);
+            Real dflux_xhi = a_xhi * (th_e - th  ) * dxInv * mf_u(i+1,j  ,0);
+            Real dflux_ylo = a_ylo * (th   - th_s) * dyInv * mf_v(i  ,j  ,0);
+            Real dflux_yhi = a_yhi * (th_n - th  ) * dyInv * mf_v(i  ,j+1,0);
+
+            // The low face of cell k is face k, the high face is face k+1
+            Real dflux_zlo, dflux_zhi;
+            if (ext_dir_zlo && k == 0) {
+                dflux_zlo = a_zlo * ( -(8./3.) * th_b + 3. * th - (1./3.) * th_t ) * dzInv;
+            } else if (ext_dir_zhi && k == dom_hi_z) {
+                dflux_zlo = a_zlo * (  (8./3.) * th_b - 3. * th + (1./3.) * th_t ) * dzInv;
+            } else {
+                dflux_zlo = a_zlo * (th - th_b) * dzInv;
+            }
+            if (ext_dir_zhi && k+1 == dom_hi_z) {
+                Real th_tt = cell_prim(i,j,k+2,prim_index);
+                dflux_zhi = a_zhi * (  (8./3.) * th - 3. * th_t + (1./3.) * th_tt ) * dzInv;
+            } else {
+                dflux_zhi = a_zhi * (th_t - th) * dzInv;
+            }
+
+            rhs_theta += (dflux_xhi - dflux_xlo) * dxInv * mf
+                        +(dflux_yhi - dflux_ylo) * dyInv * mf
+                        +(dflux_zhi - dflux_zlo) * dzInv;
+        }
+
+        // *****************************************************************
+        // External source and Rayleigh damping
+        // *****************************************************************
+        rhs_theta += src_arr(i,j,k,RhoTheta_comp);
+
+        if (l_rayleigh) {
+            rhs_theta -= dptr_rayleigh_tau[k] * (cell_prim(i,j,k,prim_index) - dptr_rayleigh_thetabar[k])
+                                              * cell_data(i,j,k,Rho_comp);
+        }
+
+        cell_rhs(i,j,k,Rho_comp)      = rhs_rho;
+        cell_rhs(i,j,k,RhoTheta_comp) = rhs_theta;
+    });
+}
+
+template<typename InterpType_H>
+void
+FusedSlowRhsVert_N (const AdvType vert_adv_type,
+                    const Box& bx, const Box& valid_bx, const Box& domain,
+                    const Array4<      Real>& cell_rhs,
+                    const Array4<const Real>& cell_data,
+                    const Array4<const Real>& cell_prim,
+                    const Array4<const Real>& rho_u,
+                    const Array4<const Real>& rho_v,
+                    const Array4<const Real>& Omega,
+                    const Array4<      Real>& avg_xmom,
+                    const Array4<      Real>& avg_ymom,
+                    const Array4<      Real>& avg_zmom,
+                    const Array4<const Real>& mf_m,
+                    const Array4<const Real>& mf_u,
+                    const Array4<const Real>& mf_v,
+                    const Array4<const Real>& mu_turb,
+                    const Array4<const Real>& src_arr,
+                    const GpuArray<Real, AMREX_SPACEDIM>& cellSizeInv,
+                    const bool l_use_diff, const bool l_consA, const bool l_turb,
+                    const Real alpha_T,
+                    const bool ext_dir_zlo, const bool ext_dir_zhi,
+                    const Real* dptr_rayleigh_tau,
+                    const Real* dptr_rayleigh_thetabar)
+{
+    if (vert_adv_type == AdvType::Centered_2nd) {
+        FusedSlowRhsWrapper_N<InterpType_H,CENTERED2>(bx, valid_bx, domain, cell_rhs, cell_data, cell_prim,
+                                                      rho_u, rho_v, Omega, avg_xmom, avg_ymom, avg_zmom,
+                                                      mf_m, mf_u, mf_v, mu_turb, src_arr, cellSizeInv,
+                                                      l_use_diff, l_consA, l_turb, alpha_T,
+                                                      ext_dir_zlo, ext_dir_zhi,
+                                                      dptr_rayleigh_tau, dptr_rayleigh_thetabar);
+    } else if (vert_adv_type == AdvType::Upwind_3rd) {
+        FusedSlowRhsWrapper_N<InterpType_H,UPWIND3>(bx, valid_bx, domain, cell_rhs, cell_data, cell_prim,
+                                                    rho_u, rho_v, Omega, avg_xmom, avg_ymom, avg_zmom,
+                                                    mf_m, mf_u, mf_v, mu_turb, src_arr, cellSizeInv,
+                                                    l_use_diff, l_consA, l_turb, alpha_T,
+                                                    ext_dir_zlo, ext_dir_zhi,
+                                                    dptr_rayleigh_tau, dptr_rayleigh_thetabar);
+    } else {
+        amrex::Abort("Fused slow RHS only supports Centered_2nd and Upwind_3rd vertical advection");
+    }
+}
+
+} // namespace
+
+/**
+ * Returns true if the fused cell-centered slow RHS supports the current solver configuration:
+ * no terrain, Centered_2nd or Upwind_3rd dycore advection, no LES model other than Smagorinsky,
+ * no PBL model, and no numerical diffusion.
+ *
+ * @param[in] solverChoice container of solver parameters
+ */
+bool
+use_fused_slow_rhs_cc (const SolverChoice& solverChoice)
+{
+    auto supported = [] (AdvType t) {
+        return (t == AdvType::Centered_2nd || t == AdvType::Upwind_3rd);
+    };
+    return ( solverChoice.use_fused_slow_rhs &&
+            !solverChoice.use_terrain &&
+            !solverChoice.use_NumDiff &&
+             supported(solverChoice.dycore_horiz_adv_type) &&
+             supported(solverChoice.dycore_vert_adv_type) &&
+            (solverChoice.les_type == LESType::None || solverChoice.les_type == LESType::Smagorinsky) &&
+             solverChoice.pbl_type == PBLType::None );
+}
+
+/**
+ * Function for computing, in a single pass over the cells, the advective and diffusive
+ * slow RHS for (rho) and (rho theta) plus the external (rho theta) source and Rayleigh
+ * damping.  This replaces the separate calls to AdvectionSrcForRhoAndTheta,
+ * DiffusionSrcForState_N and the source/damping loops in erf_slow_rhs_pre for the
+ * configurations accepted by use_fused_slow_rhs_cc.
+ *
+ * @param[in]  bx cell-centered box to loop over
+ * @param[in]  valid_bx valid box containing bx
+ * @param[in]  domain box of the whole domain
+ * @param[out] cell_rhs RHS for cell-centered variables (only Rho and RhoTheta are written)
+ * @param[in]  cell_data conserved cell-centered variables
+ * @param[in]  cell_prim primitive cell-centered variables
+ * @param[in]  rho_u x-component of momentum
+ * @param[in]  rho_v y-component of momentum
+ * @param[in]  Omega z-component of momentum
+ * @param[out] avg_xmom time-averaged x-momentum (incremented here)
+ * @param[out] avg_ymom time-averaged y-momentum (incremented here)
+ * @param[out] avg_zmom time-averaged z-momentum (incremented here)
+ * @param[in]  mf_m map factor at cell centers
+ * @param[in]  mf_u map factor at x-faces
+ * @param[in]  mf_v map factor at y-faces
+ * @param[in]  mu_turb turbulent viscosity (only used with Smagorinsky)
+ * @param[in]  src_arr external source for the cell-centered variables
+ * @param[in]  cellSizeInv inverse cell size array
+ * @param[in]  solverChoice container of solver parameters
+ * @param[in]  bc_ptr_h host container with boundary conditions
+ * @param[in]  dptr_rayleigh_tau strength of Rayleigh damping (nullptr if not damping theta)
+ * @param[in]  dptr_rayleigh_thetabar reference potential temperature for Rayleigh damping
+ */
+void
+erf_fused_slow_rhs_cc_N (const Box& bx, const Box& valid_bx, const Box& domain,
+                         const Array4<      Real>& cell_rhs,
+                         const Array4<const Real>& cell_data,
+                         const Array4<const Real>& cell_prim,
+                         const Array4<const Real>& rho_u,
+                         const Array4<const Real>& rho_v,
+                         const Array4<const Real>& Omega,
+                         const Array4<      Real>& avg_xmom,
+                         const Array4<      Real>& avg_ymom,
+                         const Array4<      Real>& avg_zmom,
+                         const Array4<const Real>& mf_m,
+                         const Array4<const Real>& mf_u,
+                         const Array4<const Real>& mf_v,
+                         const Array4<const Real>& mu_turb,
+                         const Array4<const Real>& src_arr,
+                         const GpuArray<Real, AMREX_SPACEDIM>& cellSizeInv,
+                         const SolverChoice& solverChoice,
+                         const BCRec* bc_ptr_h,
+                         const Real* dptr_rayleigh_tau,
+                         const Real* dptr_rayleigh_thetabar)
+{
+    BL_PROFILE_VAR("erf_fused_slow_rhs_cc_N()",erf_fused_slow_rhs_cc_N);
+
+    const bool l_consA  = (solverChoice.molec_diff_type == MolecDiffType::ConstantAlpha);
+    const bool l_turb   = (solverChoice.les_type == LESType::Smagorinsky);
+    const bool l_use_diff = ( (solverChoice.molec_diff_type != MolecDiffType::None) || l_turb );
+
+    const Real alpha_T = (l_consA) ? solverChoice.alpha_T : solverChoice.rhoAlpha_T;
+
+    // NOTE: lo(5) is hi(2) -- this matches the test used in DiffusionSrcForState_N
+    const bool ext_dir_zlo = (bc_ptr_h[BCVars::cons_bc+RhoTheta_comp].lo(2) == ERFBCType::ext_dir);
+    const bool ext_dir_zhi = (bc_ptr_h[BCVars::cons_bc+RhoTheta_comp].lo(5) == ERFBCType::ext_dir);
+
+    const AdvType horiz_adv_type = solverChoice.dycore_horiz_adv_type;
+    const AdvType  vert_adv_type = solverChoice.dycore_vert_adv_type;
+
+    if (horiz_adv_type == AdvType::Centered_2nd) {
+        FusedSlowRhsVert_N<CENTERED2>(vert_adv_type, bx, valid_bx, domain, cell_rhs, cell_data, cell_prim,
+                                      rho_u, rho_v, Omega, avg_xmom, avg_ymom, avg_zmom,
+                                      mf_m, mf_u, mf_v, mu_turb, src_arr, cellSizeInv,
+                                      l_use_diff, l_consA, l_turb, alpha_T,
+                                      ext_dir_zlo, ext_dir_zhi,
+                                      dptr_rayleigh_tau, dptr_rayleigh_thetabar);
+    } else if (horiz_adv_type == AdvType::Upwind_3rd) {
+        FusedSlowRhsVert_N<UPWIND3>(vert_adv_type, bx, valid_bx, domain, cell_rhs, cell_data, cell_prim,
+                                    rho_u, rho_v, Omega, avg_xmom, avg_ymom, avg_zmom,
+                                    mf_m, mf_u, mf_v, mu_turb, src_arr, cellSizeInv,
+                                    l_use_diff, l_consA, l_turb, alpha_T,
+                                    ext_dir_zlo, ext_dir_zhi,
+                                    dptr_rayleigh_tau, dptr_rayleigh_thetabar);
+    } else {
+        amrex::Abort("Fused slow RHS only supports Centered_2nd and Upwind_3rd horizontal advection");
+    }
+}
@@ -5,6 +5,7 @@
 #include <NumericalDiffusion.H>
 #include <TI_headers.H>
 #include <TileNoZ.H>
+#include <BoxCost.H>
 #include <ERF.H>
 #include <Utils.H>
 
@@ -21,7 +22,7 @@ using namespace amrex;
  * @param[out]  S_rhs RHS computed here
  * @param[in]  S_old solution at start of time step
  * @param[in]  S_new solution at end of current RK stage
- * @param[in]  S_data current solution
+ * @param[in]  S_data current solution of the fast variables (only rho and rho theta in the cell-centered part)
  * @param[in]  S_prim primitive variables (i.e. conserved variables divided by density)
  * @param[in]  S_scratch scratch space
  * @param[in]  xvel x-component of velocity
@@ -42,6 +43,8 @@ using namespace amrex;
  * @param[in] mapfac_m map factor at cell centers
  * @param[in] mapfac_u map factor at x-faces
  * @param[in] mapfac_v map factor at y-faces
+ * @param[in] scratch level-owned pool for the temporaries used here
+ * @param[in,out] cost measured wall time of each box (not measured if null)
  */
 
 void erf_slow_rhs_post (int /*level*/,
@@ -69,7 +72,9 @@ void erf_slow_rhs_post (int /*level*/,
                         std::unique_ptr<MultiFab>& detJ_new,
                         std::unique_ptr<MultiFab>& mapfac_m,
                         std::unique_ptr<MultiFab>& mapfac_u,
-                        std::unique_ptr<MultiFab>& mapfac_v
+                        std::unique_ptr<MultiFab>& mapfac_v,
+                        ERFScratchArena& scratch,
+                        LayoutData<Real>* cost
 #if defined(ERF_USE_NETCDF) && (defined(ERF_USE_MOISTURE) || defined(ERF_USE_WARM_NO_PRECIP))
                        ,const bool& moist_zero,
                         const Real& bdy_time_interval,
@@ -90,6 +95,7 @@ void erf_slow_rhs_post (int /*level*/,
     if (most) t_mean_mf = most->get_mac_avg(0,2);
 
     const bool l_use_terrain    = solverChoice.use_terrain;
+    const bool l_use_mf         = solverChoice.test_mapfactor;
     const bool l_moving_terrain = (solverChoice.terrain_type == 1);
     if (l_moving_terrain) AMREX_ALWAYS_ASSERT(l_use_terrain);
 
@@ -117,7 +123,7 @@ void erf_slow_rhs_post (int /*level*/,
     // *************************************************************************
     // Pre-computed quantities
     // *************************************************************************
-    int nvars                     = S_data[IntVar::cons].nComp();
+    int nvars                     = S_new[IntVar::cons].nComp();
     const BoxArray& ba            = S_data[IntVar::cons].boxArray();
     const DistributionMapping& dm = S_data[IntVar::cons].DistributionMap();
 
@@ -151,6 +157,8 @@ void erf_slow_rhs_post (int /*level*/,
 #endif
     for ( MFIter mfi(S_data[IntVar::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi) {
 
+        BoxCostTimer box_timer(cost, mfi);
+
         const Box& tbx = mfi.tilebox();
 
         const Array4<      Real> & old_cons   = S_old[IntVar::cons].array(mfi);
@@ -190,20 +198,9 @@ void erf_slow_rhs_post (int /*level*/,
         const Array4<const Real>& SmnSmn_a = l_use_deardorff ? SmnSmn->const_array(mfi) : Array4<const Real>{};
 
         // **************************************************************************
-        // Here we fill the "current" data with "new" data because that is the result of the previous RK stage
+        // The "current" data only holds the fast variables; the slow variables at the
+        // current stage are in new_cons, which the update below overwrites in place
         // **************************************************************************
-        int nsv = Cons::NumVars-2;
-        const amrex::GpuArray<int, IntVar::NumVars> scomp_slow = {  2,0,0,0};
-        const amrex::GpuArray<int, IntVar::NumVars> ncomp_slow = {nsv,0,0,0};
-
-        {
-        BL_PROFILE("rhs_post_7");
-        ParallelFor(tbx, ncomp_slow[IntVar::cons],
-        [=] AMREX_GPU_DEVICE (int i, int j, int k, int nn) {
-            const int n = scomp_slow[IntVar::cons] + nn;
-            cur_cons(i,j,k,n) = new_cons(i,j,k,n);
-        });
-        } // end profile
 
         // We have projected the velocities stored in S_data but we will use
         //    the velocities stored in S_scratch to update the scalars, so
@@ -244,7 +241,7 @@ void erf_slow_rhs_post (int /*level*/,
             AdvectionSrcForScalars(tbx, start_comp, num_comp, avg_xmom, avg_ymom, avg_zmom,
                                    cur_prim, cell_rhs, detJ_arr, dxInv, mf_m,
                                    horiz_adv_type, vert_adv_type,
-                                   l_use_terrain);
+                                   l_use_terrain, l_use_mf, &scratch);
         }
         if (l_use_QKE) {
             start_comp = RhoQKE_comp;
@@ -252,7 +249,7 @@ void erf_slow_rhs_post (int /*level*/,
             AdvectionSrcForScalars(tbx, start_comp, num_comp, avg_xmom, avg_ymom, avg_zmom,
                                    cur_prim, cell_rhs, detJ_arr, dxInv, mf_m,
                                    horiz_adv_type, vert_adv_type,
-                                   l_use_terrain);
+                                   l_use_terrain, l_use_mf, &scratch);
         }
 
         // This is simply an advected scalar for convenience
@@ -262,7 +259,7 @@ void erf_slow_rhs_post (int /*level*/,
         AdvectionSrcForScalars(tbx, start_comp, num_comp, avg_xmom, avg_ymom, avg_zmom,
                               cur_prim, cell_rhs, detJ_arr, dxInv, mf_m,
                               horiz_adv_type, vert_adv_type,
-                              l_use_terrain);
+                              l_use_terrain, l_use_mf, &scratch);
 
 #ifdef ERF_USE_MOISTURE
         start_comp = RhoQt_comp;
@@ -278,7 +275,7 @@ void erf_slow_rhs_post (int /*level*/,
         AdvectionSrcForScalars(tbx, start_comp, num_comp, avg_xmom, avg_ymom, avg_zmom,
                                cur_prim, cell_rhs, detJ_arr, dxInv, mf_m,
                                moist_horiz_adv_type, moist_vert_adv_type,
-                               l_use_terrain);
+                               l_use_terrain, l_use_mf, &scratch);
 
 #elif defined(ERF_USE_WARM_NO_PRECIP)
         start_comp = RhoQv_comp;
@@ -295,7 +292,7 @@ void erf_slow_rhs_post (int /*level*/,
         AdvectionSrcForScalars(tbx, start_comp, num_comp, avg_xmom, avg_ymom, avg_zmom,
                                cur_prim, cell_rhs, detJ_arr, dxInv, mf_m,
                                moist_horiz_adv_type, moist_vert_adv_type,
-                               l_use_terrain);
+                               l_use_terrain, l_use_mf, &scratch);
 #endif
 
         if (l_use_diff) {
@@ -303,8 +300,8 @@ void erf_slow_rhs_post (int /*level*/,
             Array4<Real> diffflux_y = dflux_y->array(mfi);
             Array4<Real> diffflux_z = dflux_z->array(mfi);
 
-            Array4<Real> hfx_z = Hfx3->array(mfi);
-            Array4<Real> diss  = Diss->array(mfi);
+            Array4<Real> hfx_z = Hfx3 ? Hfx3->array(mfi) : Array4<Real>{};
+            Array4<Real> diss  = Diss ? Diss->array(mfi) : Array4<Real>{};
 
             const Array4<const Real> tm_arr = t_mean_mf ? t_mean_mf->const_array(mfi) : Array4<const Real>{};
 
@@ -355,7 +352,7 @@ void erf_slow_rhs_post (int /*level*/,
                 }
             }
             start_comp = RhoScalar_comp;
-              num_comp = S_data[IntVar::cons].nComp() - start_comp;
+              num_comp = S_new[IntVar::cons].nComp() - start_comp;
             if (l_use_terrain) {
                 DiffusionSrcForState_T(tbx, domain, start_comp, num_comp, u, v,
                                        cur_cons, cur_prim, cell_rhs,
@@ -403,13 +400,13 @@ void erf_slow_rhs_post (int /*level*/,
 
         if (l_moving_terrain)
         {
-            num_comp = S_data[IntVar::cons].nComp() - start_comp;
+            num_comp = S_new[IntVar::cons].nComp() - start_comp;
             ParallelFor(tbx, num_comp,
             [=] AMREX_GPU_DEVICE (int i, int j, int k, int nn) noexcept {
                 const int n = start_comp + nn;
                 // NOTE: we don't include additional source terms when terrain is moving
                 Real temp_val = detJ_arr(i,j,k) * old_cons(i,j,k,n) + dt * detJ_arr(i,j,k) * cell_rhs(i,j,k,n);
-                cur_cons(i,j,k,n) = temp_val / detJ_new_arr(i,j,k);
+                new_cons(i,j,k,n) = temp_val / detJ_new_arr(i,j,k);
             });
 
             if (l_use_deardorff) {
@@ -420,7 +417,7 @@ void erf_slow_rhs_post (int /*level*/,
                 const int n = start_comp + nn;
                 // NOTE: we don't include additional source terms when terrain is moving
                 Real temp_val = detJ_arr(i,j,k) * old_cons(i,j,k,n) + dt * detJ_arr(i,j,k) * cell_rhs(i,j,k,n);
-                cur_cons(i,j,k,n) = temp_val / detJ_new_arr(i,j,k);
+                new_cons(i,j,k,n) = temp_val / detJ_new_arr(i,j,k);
               });
             }
             if (l_use_QKE) {
@@ -431,17 +428,17 @@ void erf_slow_rhs_post (int /*level*/,
                 const int n = start_comp + nn;
                 // NOTE: we don't include additional source terms when terrain is moving
                 Real temp_val = detJ_arr(i,j,k) * old_cons(i,j,k,n) + dt * detJ_arr(i,j,k) * cell_rhs(i,j,k,n);
-                cur_cons(i,j,k,n) = temp_val / detJ_new_arr(i,j,k);
+                new_cons(i,j,k,n) = temp_val / detJ_new_arr(i,j,k);
               });
             }
         } else {
             auto const& src_arr = source.const_array(mfi);
-            num_comp = S_data[IntVar::cons].nComp() - start_comp;
+            num_comp = S_new[IntVar::cons].nComp() - start_comp;
             ParallelFor(tbx, num_comp,
             [=] AMREX_GPU_DEVICE (int i, int j, int k, int nn) noexcept {
                 const int n = start_comp + nn;
                 cell_rhs(i,j,k,n) += src_arr(i,j,k,n);
-                cur_cons(i,j,k,n) = old_cons(i,j,k,n) + dt * cell_rhs(i,j,k,n);
+                new_cons(i,j,k,n) = old_cons(i,j,k,n) + dt * cell_rhs(i,j,k,n);
             });
 
             if (l_use_deardorff) {
@@ -452,9 +449,9 @@ void erf_slow_rhs_post (int /*level*/,
               [=] AMREX_GPU_DEVICE (int i, int j, int k, int nn) noexcept {
                 const int n = start_comp + nn;
                 cell_rhs(i,j,k,n) += src_arr(i,j,k,n);
-                cur_cons(i,j,k,n) = old_cons(i,j,k,n) + dt * cell_rhs(i,j,k,n);
+                new_cons(i,j,k,n) = old_cons(i,j,k,n) + dt * cell_rhs(i,j,k,n);
                 // make sure rho*e is positive
-                if (cur_cons(i,j,k,n) < eps) cur_cons(i,j,k,n) = eps;
+                if (new_cons(i,j,k,n) < eps) new_cons(i,j,k,n) = eps;
               });
             }
             if (l_use_QKE) {
@@ -464,7 +461,7 @@ void erf_slow_rhs_post (int /*level*/,
               [=] AMREX_GPU_DEVICE (int i, int j, int k, int nn) noexcept {
                 const int n = start_comp + nn;
                 cell_rhs(i,j,k,n) += src_arr(i,j,k,n);
-                cur_cons(i,j,k,n) = old_cons(i,j,k,n) + dt * cell_rhs(i,j,k,n);
+                new_cons(i,j,k,n) = old_cons(i,j,k,n) + dt * cell_rhs(i,j,k,n);
               });
             }
         }
@@ -472,9 +469,9 @@ void erf_slow_rhs_post (int /*level*/,
 
         {
         BL_PROFILE("rhs_post_9");
-        // This updates all the conserved variables (not just the "slow" ones)
-        int   num_comp_all = S_data[IntVar::cons].nComp();
-        ParallelFor(tbx, num_comp_all,
+        // This copies the "fast" conserved variables; the "slow" ones were updated in place above
+        int   num_comp_fast = S_data[IntVar::cons].nComp();
+        ParallelFor(tbx, num_comp_fast,
         [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept {
             new_cons(i,j,k,n)  = cur_cons(i,j,k,n);
         });
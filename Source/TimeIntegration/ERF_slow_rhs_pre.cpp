@@ -8,6 +8,7 @@
 #include <NumericalDiffusion.H>
 #include <TI_headers.H>
 #include <TileNoZ.H>
+#include <BoxCost.H>
 #include <EOS.H>
 #include <ERF.H>
 
@@ -66,6 +67,8 @@ using namespace amrex;
  * @param[in] dptr_rayleigh_vbar reference value for y-velocity used to define Rayleigh damping
  * @param[in] dptr_rayleigh_wbar reference value for z-velocity used to define Rayleigh damping
  * @param[in] dptr_rayleigh_thetabar reference value for potential temperature used to define Rayleigh damping
+ * @param[in,out] cost measured wall time of each box (not measured if null)
+ * @param[in] region the whole tiles, or only their interior (the cells that need no ghost cells) or the shell around it
  */
 
 void erf_slow_rhs_pre (int /*level*/, int nrk,
@@ -103,7 +106,9 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
                        std::unique_ptr<MultiFab>& mapfac_v,
                        const amrex::Real* dptr_rayleigh_tau, const amrex::Real* dptr_rayleigh_ubar,
                        const amrex::Real* dptr_rayleigh_vbar, const amrex::Real* dptr_rayleigh_wbar,
-                       const amrex::Real* dptr_rayleigh_thetabar)
+                       const amrex::Real* dptr_rayleigh_thetabar,
+                       LayoutData<Real>* cost,
+                       SlowRhsRegion region)
 {
     BL_PROFILE_REGION("erf_slow_rhs_pre()");
 
@@ -117,6 +122,7 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
     const AdvType l_horiz_adv_type = solverChoice.dycore_horiz_adv_type;
     const AdvType l_vert_adv_type  = solverChoice.dycore_vert_adv_type;
     const bool    l_use_terrain    = solverChoice.use_terrain;
+    const bool    l_use_mf         = solverChoice.test_mapfactor;
     const bool    l_moving_terrain = (solverChoice.terrain_type == 1);
     if (l_moving_terrain) AMREX_ALWAYS_ASSERT (l_use_terrain);
 
@@ -128,6 +134,17 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
                                     solverChoice.les_type == LESType::Deardorff   ||
                                     solverChoice.pbl_type == PBLType::MYNN25 );
 
+    // Compute the (rho, rho theta) RHS in a single pass if we can
+    const bool l_use_fused_cc   = use_fused_slow_rhs_cc(solverChoice);
+
+    // Compute the stress of each tile right where it is used instead of storing it in Tau
+    const bool l_use_fused_stress = (l_use_diff && solverChoice.use_fused_stress);
+
+    // The stored stress and the moving terrain need the ghost cells of the whole level
+    if (region != SlowRhsRegion::All) {
+        AMREX_ALWAYS_ASSERT(!l_moving_terrain && (!l_use_diff || l_use_fused_stress));
+    }
+
     const amrex::BCRec* bc_ptr   = domain_bcs_type_d.data();
     const amrex::BCRec* bc_ptr_h = domain_bcs_type.data();
 
@@ -154,17 +171,22 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
     std::unique_ptr<MultiFab> dflux_y;
     std::unique_ptr<MultiFab> dflux_z;
 
-    if (l_use_diff) {
-        expr    = std::make_unique<MultiFab>(ba  , dm, 1, IntVect(1,1,0));
+    if (l_use_diff && !l_use_fused_cc) {
         dflux_x = std::make_unique<MultiFab>(convert(ba,IntVect(1,0,0)), dm, nvars, 0);
         dflux_y = std::make_unique<MultiFab>(convert(ba,IntVect(0,1,0)), dm, nvars, 0);
         dflux_z = std::make_unique<MultiFab>(convert(ba,IntVect(0,0,1)), dm, nvars, 0);
+    }
+
+    if (l_use_diff && !l_use_fused_stress) {
+        expr    = std::make_unique<MultiFab>(ba  , dm, 1, IntVect(1,1,0));
 
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
         for ( MFIter mfi(S_data[IntVar::cons],TileNoZ()); mfi.isValid(); ++mfi)
         {
+            BoxCostTimer box_timer(cost, mfi);
+
             // Construct intersection of current tilebox and valid region for updating
             const Box& valid_bx = grids_to_evolve[mfi.index()];
             Box bx = mfi.tilebox() & valid_bx;
@@ -456,53 +478,20 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
 
 
     // *************************************************************************
-    // Define updates and fluxes in the current RK stage
+    // Perturbational pressure on the cells cbx (grown by one in x and y) and
+    //    contravariant momentum on their z-faces (grown by one in x and y)
     // *************************************************************************
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-    for ( MFIter mfi(S_data[IntVar::cons],TileNoZ()); mfi.isValid(); ++mfi)
-    {
-        const Box& valid_bx = grids_to_evolve[mfi.index()];
-
-        // Construct intersection of current tilebox and valid region for updating
-        Box bx = mfi.tilebox() & valid_bx;
-
-        Box tbx = mfi.nodaltilebox(0) & surroundingNodes(valid_bx,0);
-        Box tby = mfi.nodaltilebox(1) & surroundingNodes(valid_bx,1);
-        Box tbz = mfi.nodaltilebox(2) & surroundingNodes(valid_bx,2);
-
-        // We don't compute a source term for z-momentum on the bottom or top boundary
-        tbz.growLo(2,-1);
-        tbz.growHi(2,-1);
+    const int k_dom_lo = geom.Domain().smallEnd(2);
+    const int k_dom_hi = geom.Domain().bigEnd(2) + 1;
 
+    auto make_pprime_and_omega = [&] (const MFIter& mfi, const Box& cbx, FArrayBox& pprime)
+    {
         const Array4<const Real> & cell_data  = S_data[IntVar::cons].array(mfi);
-        const Array4<const Real> & cell_prim  = S_prim.array(mfi);
-        const Array4<Real>       & cell_rhs   = S_rhs[IntVar::cons].array(mfi);
-        const Array4<const Real> & buoyancy_fab = buoyancy.const_array(mfi);
-
-        // We must initialize these to zero each RK step
-        S_scratch[IntVar::xmom][mfi].template setVal<RunOn::Device>(0.,tbx);
-        S_scratch[IntVar::ymom][mfi].template setVal<RunOn::Device>(0.,tby);
-        S_scratch[IntVar::zmom][mfi].template setVal<RunOn::Device>(0.,tbz);
-
-        Array4<Real> avg_xmom = S_scratch[IntVar::xmom].array(mfi);
-        Array4<Real> avg_ymom = S_scratch[IntVar::ymom].array(mfi);
-        Array4<Real> avg_zmom = S_scratch[IntVar::zmom].array(mfi);
-
-        const Array4<const Real> & u = xvel.array(mfi);
-        const Array4<const Real> & v = yvel.array(mfi);
-        const Array4<const Real> & w = zvel.array(mfi);
 
         const Array4<const Real>& rho_u = S_data[IntVar::xmom].array(mfi);
         const Array4<const Real>& rho_v = S_data[IntVar::ymom].array(mfi);
         const Array4<const Real>& rho_w = S_data[IntVar::zmom].array(mfi);
 
-        // Map factors
-        const Array4<const Real>& mf_m   = mapfac_m->const_array(mfi);
-        const Array4<const Real>& mf_u   = mapfac_u->const_array(mfi);
-        const Array4<const Real>& mf_v   = mapfac_v->const_array(mfi);
-
         const Array4<      Real>& omega_arr = Omega.array(mfi);
 
         Array4<const Real> z_t;
@@ -511,15 +500,8 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
         else
             z_t = Array4<const Real>{};
 
-        const Array4<Real>& rho_u_rhs = S_rhs[IntVar::xmom].array(mfi);
-        const Array4<Real>& rho_v_rhs = S_rhs[IntVar::ymom].array(mfi);
-        const Array4<Real>& rho_w_rhs = S_rhs[IntVar::zmom].array(mfi);
-
-        const Array4<Real const>& mu_turb = l_use_turb ? eddyDiffs->const_array(mfi) : Array4<const Real>{};
-
         // Terrain metrics
-        const Array4<const Real>& z_nd     = l_use_terrain ? z_phys_nd->const_array(mfi) : Array4<const Real>{};
-        const Array4<const Real>& detJ_arr = l_use_terrain ?      detJ->const_array(mfi) : Array4<const Real>{};
+        const Array4<const Real>& z_nd = l_use_terrain ? z_phys_nd->const_array(mfi) : Array4<const Real>{};
 
         // Base state
         const Array4<const Real>& p0_arr = p0->const_array(mfi);
@@ -527,9 +509,8 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
         //-----------------------------------------
         // Perturbational pressure field
         //-----------------------------------------
-        Box gbx = mfi.tilebox() & grids_to_evolve[mfi.index()]; gbx.grow(IntVect(1,1,0));
-        FArrayBox pprime; pprime.resize(gbx,1);
-        Elixir pp_eli = pprime.elixir();
+        Box gbx = cbx; gbx.grow(IntVect(1,1,0));
+        pprime.resize(gbx,1);
         const Array4<Real> & pp_arr  = pprime.array();
 #ifdef ERF_USE_MOISTURE
         const Array4<Real const> & qv_arr  =     qv.const_array(mfi);
@@ -557,21 +538,28 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
         //-----------------------------------------
         {
         BL_PROFILE("slow_rhs_making_omega");
-            Box gbxo = surroundingNodes(bx,2); gbxo.grow(IntVect(1,1,0));
+            Box gbxo = surroundingNodes(cbx,2); gbxo.grow(IntVect(1,1,0));
             // Now create Omega with momentum (not velocity) with z_t subtracted if moving terrain
             if (l_use_terrain) {
 
-                Box gbxo_lo = gbxo; gbxo_lo.setBig(2,0);
-                amrex::ParallelFor(gbxo_lo, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
-                    omega_arr(i,j,k) = 0.;
-                });
-                Box gbxo_hi = gbxo; gbxo_hi.setSmall(2,gbxo.bigEnd(2));
-                amrex::ParallelFor(gbxo_hi, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
-                    omega_arr(i,j,k) = rho_w(i,j,k);
-                });
+                // Omega is zero on the bottom of the domain and equal to rho_w on its top
+                if (gbxo.smallEnd(2) == k_dom_lo) {
+                    Box gbxo_lo = gbxo; gbxo_lo.setBig(2,k_dom_lo);
+                    amrex::ParallelFor(gbxo_lo, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                        omega_arr(i,j,k) = 0.;
+                    });
+                }
+                if (gbxo.bigEnd(2) == k_dom_hi) {
+                    Box gbxo_hi = gbxo; gbxo_hi.setSmall(2,k_dom_hi);
+                    amrex::ParallelFor(gbxo_hi, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                        omega_arr(i,j,k) = rho_w(i,j,k);
+                    });
+                }
 
+                Box gbxo_mid = gbxo;
+                gbxo_mid.setSmall(2,std::max(gbxo.smallEnd(2),k_dom_lo+1));
+                gbxo_mid.setBig  (2,std::min(gbxo.bigEnd(2)  ,k_dom_hi-1));
                 if (z_t) {
-                    Box gbxo_mid = gbxo; gbxo_mid.setSmall(2,1); gbxo_mid.setBig(2,gbxo.bigEnd(2)-1);
                     amrex::ParallelFor(gbxo_mid, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
                         // We define rho on the z-face the same way as in MomentumToVelocity/VelocityToMomentum
                         Real rho_at_face = 0.5 * (cell_data(i,j,k,Rho_comp) + cell_data(i,j,k-1,Rho_comp));
@@ -579,7 +567,6 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
                             rho_at_face * z_t(i,j,k);
                     });
                 } else {
-                    Box gbxo_mid = gbxo; gbxo_mid.setSmall(2,1); gbxo_mid.setBig(2,gbxo.bigEnd(2)-1);
                     amrex::ParallelFor(gbxo_mid, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
                         omega_arr(i,j,k) = OmegaFromW(i,j,k,rho_w(i,j,k),rho_u,rho_v,z_nd,dxInv);
                     });
@@ -590,7 +577,54 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
                 });
             }
         } // end profile
+    }; // make_pprime_and_omega
+
+    // *************************************************************************
+    // Define updates and fluxes in the current RK stage, on the cells bx and
+    //    the faces tbx, tby, tbz of one tile (or of one part of it)
+    // *************************************************************************
+    auto make_slow_rhs = [&] (const MFIter& mfi, const Box& valid_bx,
+                              const Box& bx, const Box& tbx, const Box& tby, const Box& tbz,
+                              const Array4<const Real>& pp_arr)
+    {
+        const Array4<const Real> & cell_data  = S_data[IntVar::cons].array(mfi);
+        const Array4<const Real> & cell_prim  = S_prim.array(mfi);
+        const Array4<Real>       & cell_rhs   = S_rhs[IntVar::cons].array(mfi);
+        const Array4<const Real> & buoyancy_fab = buoyancy.const_array(mfi);
+
+        // We must initialize these to zero each RK step
+        S_scratch[IntVar::xmom][mfi].template setVal<RunOn::Device>(0.,tbx);
+        S_scratch[IntVar::ymom][mfi].template setVal<RunOn::Device>(0.,tby);
+        S_scratch[IntVar::zmom][mfi].template setVal<RunOn::Device>(0.,tbz);
+
+        Array4<Real> avg_xmom = S_scratch[IntVar::xmom].array(mfi);
+        Array4<Real> avg_ymom = S_scratch[IntVar::ymom].array(mfi);
+        Array4<Real> avg_zmom = S_scratch[IntVar::zmom].array(mfi);
 
+        const Array4<const Real> & u = xvel.array(mfi);
+        const Array4<const Real> & v = yvel.array(mfi);
+        const Array4<const Real> & w = zvel.array(mfi);
+
+        const Array4<const Real>& rho_u = S_data[IntVar::xmom].array(mfi);
+        const Array4<const Real>& rho_v = S_data[IntVar::ymom].array(mfi);
+        const Array4<const Real>& rho_w = S_data[IntVar::zmom].array(mfi);
+
+        // Map factors
+        const Array4<const Real>& mf_m   = mapfac_m->const_array(mfi);
+        const Array4<const Real>& mf_u   = mapfac_u->const_array(mfi);
+        const Array4<const Real>& mf_v   = mapfac_v->const_array(mfi);
+
+        const Array4<      Real>& omega_arr = Omega.array(mfi);
+
+        const Array4<Real>& rho_u_rhs = S_rhs[IntVar::xmom].array(mfi);
+        const Array4<Real>& rho_v_rhs = S_rhs[IntVar::ymom].array(mfi);
+        const Array4<Real>& rho_w_rhs = S_rhs[IntVar::zmom].array(mfi);
+
+        const Array4<Real const>& mu_turb = l_use_turb ? eddyDiffs->const_array(mfi) : Array4<const Real>{};
+
+        // Terrain metrics
+        const Array4<const Real>& z_nd     = l_use_terrain ? z_phys_nd->const_array(mfi) : Array4<const Real>{};
+        const Array4<const Real>& detJ_arr = l_use_terrain ?      detJ->const_array(mfi) : Array4<const Real>{};
 
         //-----------------------------------------
         // Diffusive terms (pre-computed above)
@@ -629,80 +663,124 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
             SmnSmn_a = Array4<Real>{};
         }
 
-        // **************************************************************************
-        // Define updates in the RHS of continuity, temperature, and scalar equations
-        // **************************************************************************
-        Real fac = 1.0;
-        AdvectionSrcForRhoAndTheta(bx, valid_bx, cell_rhs,       // these are being used to build the fluxes
-                                   rho_u, rho_v, omega_arr, fac,
-                                   avg_xmom, avg_ymom, avg_zmom, // these are being defined from the rho fluxes
-                                   cell_prim, z_nd, detJ_arr,
-                                   dxInv, mf_m, mf_u, mf_v,
-                                   l_horiz_adv_type, l_vert_adv_type, l_use_terrain);
-
-        if (l_use_diff) {
-            Array4<Real> diffflux_x = dflux_x->array(mfi);
-            Array4<Real> diffflux_y = dflux_y->array(mfi);
-            Array4<Real> diffflux_z = dflux_z->array(mfi);
+        // Strain and stress of this tile only, in tile-local FABs
+        FArrayBox S11,S22,S33,S12,S13,S23;
+        if (l_use_fused_stress) {
+            BL_PROFILE("slow_rhs_making_tile_stress_N");
+            ComputeTileStrain_N(bx, u, v, w,
+                                S11, S22, S33, S12, S13, S23,
+                                bc_ptr_h, dxInv, mf_m, mf_u, mf_v);
+
+            // Populate SmnSmn if using Deardorff (used as diff src in post)
+            // and in the first RK stage (TKE tendencies constant for nrk>0, following WRF)
+            if ((nrk==0) && (solverChoice.les_type == LESType::Deardorff)) {
+                const Array4<const Real> s11 = S11.const_array(); const Array4<const Real> s22 = S22.const_array();
+                const Array4<const Real> s33 = S33.const_array(); const Array4<const Real> s12 = S12.const_array();
+                const Array4<const Real> s13 = S13.const_array(); const Array4<const Real> s23 = S23.const_array();
+                amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    SmnSmn_a(i,j,k) = ComputeSmnSmn(i,j,k,s11,s22,s33,s12,s13,s23);
+                });
+            }
 
-            Array4<Real> hfx_z = Hfx3->array(mfi);
-            Array4<Real> diss  = Diss->array(mfi);
+            Real mu_eff = 2.0 * solverChoice.dynamicViscosity; // Initialized to 0
+            ComputeTileStress_N(bx, mu_eff, mu_turb, u, v, w,
+                                S11, S22, S33, S12, S13, S23,
+                                dxInv, mf_m, mf_u, mf_v);
 
-            const Array4<const Real> tm_arr = t_mean_mf ? t_mean_mf->const_array(mfi) : Array4<const Real>{};
+            tau11 = S11.array(); tau22 = S22.array(); tau33 = S33.array();
+            tau12 = S12.array(); tau13 = S13.array(); tau23 = S23.array();
+        }
+        Elixir S11_eli = S11.elixir(); Elixir S22_eli = S22.elixir(); Elixir S33_eli = S33.elixir();
+        Elixir S12_eli = S12.elixir(); Elixir S13_eli = S13.elixir(); Elixir S23_eli = S23.elixir();
 
-            // NOTE: No diffusion for continuity, so n starts at 1.
-            int n_start = amrex::max(start_comp,RhoTheta_comp);
-            int n_comp  = end_comp - n_start + 1;
+        // **************************************************************************
+        // Define updates in the RHS of continuity, temperature, and scalar equations
+        // **************************************************************************
+        if (l_use_fused_cc) {
+            BL_PROFILE("slow_rhs_pre_fused_cc");
+            const bool l_damp_T = (solverChoice.use_rayleigh_damping && solverChoice.rayleigh_damp_T);
+            erf_fused_slow_rhs_cc_N(bx, valid_bx, domain, cell_rhs, cell_data, cell_prim,
+                                    rho_u, rho_v, omega_arr,
+                                    avg_xmom, avg_ymom, avg_zmom,
+                                    mf_m, mf_u, mf_v, mu_turb, source.const_array(mfi),
+                                    dxInv, solverChoice, bc_ptr_h,
+                                    l_damp_T ? dptr_rayleigh_tau      : nullptr,
+                                    l_damp_T ? dptr_rayleigh_thetabar : nullptr);
+        } else {
+            BL_PROFILE("slow_rhs_pre_unfused_cc");
+            Real fac = 1.0;
+            AdvectionSrcForRhoAndTheta(bx, valid_bx, cell_rhs,       // these are being used to build the fluxes
+                                       rho_u, rho_v, omega_arr, fac,
+                                       avg_xmom, avg_ymom, avg_zmom, // these are being defined from the rho fluxes
+                                       cell_prim, z_nd, detJ_arr,
+                                       dxInv, mf_m, mf_u, mf_v,
+                                       l_horiz_adv_type, l_vert_adv_type, l_use_terrain, l_use_mf);
+
+            if (l_use_diff) {
+                Array4<Real> diffflux_x = dflux_x->array(mfi);
+                Array4<Real> diffflux_y = dflux_y->array(mfi);
+                Array4<Real> diffflux_z = dflux_z->array(mfi);
+
+                Array4<Real> hfx_z = Hfx3 ? Hfx3->array(mfi) : Array4<Real>{};
+                Array4<Real> diss  = Diss ? Diss->array(mfi) : Array4<Real>{};
+
+                const Array4<const Real> tm_arr = t_mean_mf ? t_mean_mf->const_array(mfi) : Array4<const Real>{};
+
+                // NOTE: No diffusion for continuity, so n starts at 1.
+                int n_start = amrex::max(start_comp,RhoTheta_comp);
+                int n_comp  = end_comp - n_start + 1;
+
+                if (l_use_terrain) {
+                    DiffusionSrcForState_T(bx, domain, n_start, n_comp, u, v,
+                                           cell_data, cell_prim, cell_rhs,
+                                           diffflux_x, diffflux_y, diffflux_z, z_nd, detJ_arr,
+                                           dxInv, SmnSmn_a, mf_m, mf_u, mf_v,
+                                           hfx_z, diss,
+                                           mu_turb, solverChoice, tm_arr, grav_gpu, bc_ptr);
+                } else {
+                    DiffusionSrcForState_N(bx, domain, n_start, n_comp, u, v,
+                                           cell_data, cell_prim, cell_rhs,
+                                           diffflux_x, diffflux_y, diffflux_z,
+                                           dxInv, SmnSmn_a, mf_m, mf_u, mf_v,
+                                           hfx_z, diss,
+                                           mu_turb, solverChoice, tm_arr, grav_gpu, bc_ptr);
+                }
+            }
 
-            if (l_use_terrain) {
-                DiffusionSrcForState_T(bx, domain, n_start, n_comp, u, v,
-                                       cell_data, cell_prim, cell_rhs,
-                                       diffflux_x, diffflux_y, diffflux_z, z_nd, detJ_arr,
-                                       dxInv, SmnSmn_a, mf_m, mf_u, mf_v,
-                                       hfx_z, diss,
-                                       mu_turb, solverChoice, tm_arr, grav_gpu, bc_ptr);
-            } else {
-                DiffusionSrcForState_N(bx, domain, n_start, n_comp, u, v,
-                                       cell_data, cell_prim, cell_rhs,
-                                       diffflux_x, diffflux_y, diffflux_z,
-                                       dxInv, SmnSmn_a, mf_m, mf_u, mf_v,
-                                       hfx_z, diss,
-                                       mu_turb, solverChoice, tm_arr, grav_gpu, bc_ptr);
+            if (l_use_ndiff) {
+                NumericalDiffusion(bx, start_comp, num_comp, dt, solverChoice,
+                                   cell_data, cell_rhs, mf_u, mf_v, false, false);
             }
-        }
 
-        if (l_use_ndiff) {
-            NumericalDiffusion(bx, start_comp, num_comp, dt, solverChoice,
-                               cell_data, cell_rhs, mf_u, mf_v, false, false);
-        }
+            // Add source terms for (rho theta)
+            {
+                auto const& src_arr = source.const_array(mfi);
+                if (l_use_terrain && l_moving_terrain) {
+                    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                    {
+                        cell_rhs(i,j,k,RhoTheta_comp) += src_arr(i,j,k,RhoTheta_comp) / detJ_arr(i,j,k);
+                    });
+                } else {
+                    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                    {
+                        cell_rhs(i,j,k,RhoTheta_comp) += src_arr(i,j,k,RhoTheta_comp);
+                    });
+                }
+            }
 
-        // Add source terms for (rho theta)
-        {
-            auto const& src_arr = source.const_array(mfi);
-            if (l_use_terrain && l_moving_terrain) {
-                amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    cell_rhs(i,j,k,RhoTheta_comp) += src_arr(i,j,k,RhoTheta_comp) / detJ_arr(i,j,k);
-                });
-            } else {
+            // Add Rayleigh damping
+            if (solverChoice.use_rayleigh_damping && solverChoice.rayleigh_damp_T) {
+                int n  = RhoTheta_comp;
+                int nr = Rho_comp;
+                int np = PrimTheta_comp;
                 amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
                 {
-                    cell_rhs(i,j,k,RhoTheta_comp) += src_arr(i,j,k,RhoTheta_comp);
+                    Real theta = cell_prim(i,j,k,np);
+                    cell_rhs(i, j, k, n) -= dptr_rayleigh_tau[k] * (theta - dptr_rayleigh_thetabar[k]) * cell_data(i,j,k,nr);
                 });
             }
-        }
-
-        // Add Rayleigh damping
-        if (solverChoice.use_rayleigh_damping && solverChoice.rayleigh_damp_T) {
-            int n  = RhoTheta_comp;
-            int nr = Rho_comp;
-            int np = PrimTheta_comp;
-            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                Real theta = cell_prim(i,j,k,np);
-                cell_rhs(i, j, k, n) -= dptr_rayleigh_tau[k] * (theta - dptr_rayleigh_thetabar[k]) * cell_data(i,j,k,nr);
-            });
-        }
+        } // l_use_fused_cc
 
         // Multiply the slow RHS for rho and rhotheta by detJ here so we don't have to later
         if (l_use_terrain && l_moving_terrain) {
@@ -720,7 +798,7 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
                            rho_u_rhs, rho_v_rhs, rho_w_rhs, u, v, w,
                            rho_u    , rho_v    , omega_arr,
                            z_nd, detJ_arr, dxInv, mf_m, mf_u, mf_v,
-                           l_horiz_adv_type, l_vert_adv_type, l_use_terrain, domhi_z);
+                           l_horiz_adv_type, l_vert_adv_type, l_use_terrain, l_use_mf, domhi_z);
 
         if (l_use_diff) {
             if (l_use_terrain) {
@@ -1071,5 +1149,72 @@ void erf_slow_rhs_pre (int /*level*/, int nrk,
          ApplySpongeZoneBCs(solverChoice, geom, tbx, tby, tbz, rho_u_rhs, rho_v_rhs, rho_w_rhs, rho_u, rho_v,
                             rho_w, bx, cell_rhs, cell_data);
         } // end profile
+    }; // make_slow_rhs
+
+    // Cells farther than this from the edges of their box only need valid data; the extra
+    //    cell keeps out the velocities on the faces of the box, which need the ghost density
+    const int ng_stencil = S_data[IntVar::cons].nGrow() + 1;
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( MFIter mfi(S_data[IntVar::cons],TileNoZ()); mfi.isValid(); ++mfi)
+    {
+        BoxCostTimer box_timer(cost, mfi);
+
+        const Box& valid_bx = grids_to_evolve[mfi.index()];
+
+        // Construct intersection of current tilebox and valid region for updating
+        Box bx = mfi.tilebox() & valid_bx;
+
+        Box tbx = mfi.nodaltilebox(0) & surroundingNodes(valid_bx,0);
+        Box tby = mfi.nodaltilebox(1) & surroundingNodes(valid_bx,1);
+        Box tbz = mfi.nodaltilebox(2) & surroundingNodes(valid_bx,2);
+
+        // We don't compute a source term for z-momentum on the bottom or top boundary
+        tbz.growLo(2,-1);
+        tbz.growHi(2,-1);
+
+        FArrayBox pprime;
+        Elixir pp_eli;
+
+        if (region == SlowRhsRegion::All) {
+            make_pprime_and_omega(mfi, bx, pprime);
+            pp_eli = pprime.elixir();
+            make_slow_rhs(mfi, valid_bx, bx, tbx, tby, tbz, pprime.const_array());
+        } else {
+            // The interior of the tile is done before its ghost cells are filled, the
+            //    shell around it afterwards
+            const Box interior = bx & amrex::grow(valid_bx, -ng_stencil);
+            BoxList parts;
+            if (region == SlowRhsRegion::Interior) {
+                if (interior.ok()) parts.push_back(interior);
+            } else {
+                parts = (interior.ok()) ? amrex::boxDiff(bx, interior) : BoxList(bx);
+            }
+
+            // The pressure and Omega are made once for all the parts: for the interior on
+            //    the cells it reaches, which are all valid, and for the shell on the whole
+            //    column of the tile once its ghost cells are filled
+            if (parts.isEmpty()) continue;
+            if (region == SlowRhsRegion::Interior) {
+                make_pprime_and_omega(mfi, amrex::grow(interior, IntVect(0,0,1)), pprime);
+            } else {
+                make_pprime_and_omega(mfi, bx, pprime);
+            }
+            pp_eli = pprime.elixir();
+
+            for (const Box& pbx : parts) {
+                // Each face belongs to the part holding the cell on its high side
+                Box ptbx = surroundingNodes(pbx,0) & tbx;
+                Box ptby = surroundingNodes(pbx,1) & tby;
+                Box ptbz = surroundingNodes(pbx,2) & tbz;
+                if (pbx.bigEnd(0) < bx.bigEnd(0)) ptbx.growHi(0,-1);
+                if (pbx.bigEnd(1) < bx.bigEnd(1)) ptby.growHi(1,-1);
+                if (pbx.bigEnd(2) < bx.bigEnd(2)) ptbz.growHi(2,-1);
+
+                make_slow_rhs(mfi, valid_bx, pbx, ptbx, ptby, ptbz, pprime.const_array());
+            }
+        }
     } // mfi
 }
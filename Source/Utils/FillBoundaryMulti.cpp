@@ -0,0 +1,197 @@
+#include <Utils.H>
+
+#include <map>
+
+using namespace amrex;
+
+/**
+ * Fill the ghost cells shared with other grids of several MultiFabs at once
+ *
+ * This does the same as calling FillBoundary on each MultiFab, but the data going to
+ * (or coming from) the same rank is packed into a single message for all of the
+ * MultiFabs, so there is one message per neighbor instead of one per neighbor and
+ * MultiFab.  The MultiFabs may have different index types and BoxArrays.
+ *
+ * @param[in,out] mfs    MultiFabs whose ghost cells are filled
+ * @param[in]     scomp  first component to fill, for each MultiFab
+ * @param[in]     ncomp  number of components to fill, for each MultiFab
+ * @param[in]     nghost number of ghost cells to fill, for each MultiFab
+ * @param[in]     period periodicity of the domain
+ */
+
+void
+FillBoundaryMulti (const Vector<MultiFab*>& mfs,
+                   const Vector<int>& scomp,
+                   const Vector<int>& ncomp,
+                   const Vector<IntVect>& nghost,
+                   const Periodicity& period)
+{
+    BL_PROFILE("FillBoundaryMulti()");
+
+    const int nmfs = mfs.size();
+    AMREX_ALWAYS_ASSERT(scomp.size() == nmfs && ncomp.size() == nmfs && nghost.size() == nmfs);
+
+    // The communication pattern of each MultiFab is cached by AMReX
+    Vector<const FabArrayBase::FB*> fbs(nmfs, nullptr);
+    for (int i = 0; i < nmfs; i++) {
+        AMREX_ALWAYS_ASSERT(nghost[i].allLE(mfs[i]->nGrowVect()));
+        if (nghost[i].max() > 0 && ncomp[i] > 0) {
+            fbs[i] = &(mfs[i]->getFB(nghost[i], period));
+        }
+    }
+
+#ifdef AMREX_USE_MPI
+    const int SeqNum = ParallelDescriptor::SeqNum();
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+
+    // Size (in Reals) of the single message to and from every neighbor
+    std::map<int,Long> send_size, recv_size;
+    for (int i = 0; i < nmfs; i++) {
+        if (fbs[i] == nullptr) continue;
+        for (const auto& kv : *(fbs[i]->m_SndTags)) {
+            for (const auto& tag : kv.second) {
+                send_size[kv.first] += tag.sbox.numPts() * ncomp[i];
+            }
+        }
+        for (const auto& kv : *(fbs[i]->m_RcvTags)) {
+            for (const auto& tag : kv.second) {
+                recv_size[kv.first] += tag.dbox.numPts() * ncomp[i];
+            }
+        }
+    }
+
+    Long send_total = 0, recv_total = 0;
+    for (const auto& kv : send_size) send_total += kv.second;
+    for (const auto& kv : recv_size) recv_total += kv.second;
+
+    Real* send_data = (send_total > 0) ?
+        static_cast<Real*>(The_Comms_Arena()->alloc(send_total*sizeof(Real))) : nullptr;
+    Real* recv_data = (recv_total > 0) ?
+        static_cast<Real*>(The_Comms_Arena()->alloc(recv_total*sizeof(Real))) : nullptr;
+
+    // Post the receives first
+    Vector<MPI_Request> recv_reqs;
+    std::map<int,Real*> recv_ptr;
+    {
+        Long offset = 0;
+        for (const auto& kv : recv_size) {
+            recv_ptr[kv.first] = recv_data + offset;
+            recv_reqs.push_back(ParallelDescriptor::Arecv(recv_data + offset, kv.second,
+                                                          ParallelContext::global_to_local_rank(kv.first),
+                                                          SeqNum, comm).req());
+            offset += kv.second;
+        }
+    }
+
+    // Pack the data for every neighbor: all the tags of the first MultiFab,
+    //     then all the tags of the second, and so on.  The receiver walks
+    //     its tags in the same order.
+    Vector<MPI_Request> send_reqs;
+    {
+        Long offset = 0;
+        std::map<int,Real*> send_ptr;
+        for (const auto& kv : send_size) {
+            send_ptr[kv.first] = send_data + offset;
+            offset += kv.second;
+        }
+
+        std::map<int,Long> packed;
+        for (int i = 0; i < nmfs; i++) {
+            if (fbs[i] == nullptr) continue;
+            const int sc = scomp[i];
+            const int nc = ncomp[i];
+            for (const auto& kv : *(fbs[i]->m_SndTags)) {
+                Long& pos = packed[kv.first];
+                for (const auto& tag : kv.second) {
+                    const Array4<const Real> src = mfs[i]->const_array(tag.srcIndex);
+                    Real* buf = send_ptr[kv.first] + pos;
+                    const Box& bx  = tag.sbox;
+                    const Dim3 lo  = lbound(bx);
+                    const Dim3 len = length(bx);
+                    const Long npts = bx.numPts();
+                    ParallelFor(bx, nc, [=] AMREX_GPU_DEVICE (int ii, int jj, int kk, int n) noexcept
+                    {
+                        Long idx = (static_cast<Long>(kk-lo.z)*len.y + (jj-lo.y))*len.x + (ii-lo.x);
+                        buf[idx + n*npts] = src(ii,jj,kk,n+sc);
+                    });
+                    pos += npts * nc;
+                }
+            }
+        }
+        Gpu::streamSynchronize();
+
+        for (const auto& kv : send_size) {
+            send_reqs.push_back(ParallelDescriptor::Asend(send_ptr[kv.first], kv.second,
+                                                          ParallelContext::global_to_local_rank(kv.first),
+                                                          SeqNum, comm).req());
+        }
+    }
+#endif
+
+    // Copies between grids on this rank, done while the messages are in flight
+    for (int i = 0; i < nmfs; i++) {
+        if (fbs[i] == nullptr) continue;
+        const int sc = scomp[i];
+        const int nc = ncomp[i];
+        const auto& loc_tags = *(fbs[i]->m_LocTags);
+        const int ntags = loc_tags.size();
+#if defined(_OPENMP) && !defined(AMREX_USE_GPU)
+#pragma omp parallel for if (fbs[i]->m_threadsafe_loc)
+#endif
+        for (int it = 0; it < ntags; it++) {
+            const auto& tag = loc_tags[it];
+            const Array4<const Real> src = mfs[i]->const_array(tag.srcIndex);
+            const Array4<      Real> dst = mfs[i]->array(tag.dstIndex);
+            const IntVect shift = tag.sbox.smallEnd() - tag.dbox.smallEnd();
+            const int si = shift[0], sj = shift[1], sk = shift[2];
+            ParallelFor(tag.dbox, nc, [=] AMREX_GPU_DEVICE (int ii, int jj, int kk, int n) noexcept
+            {
+                dst(ii,jj,kk,n+sc) = src(ii+si,jj+sj,kk+sk,n+sc);
+            });
+        }
+    }
+
+#ifdef AMREX_USE_MPI
+    if (!recv_reqs.empty()) {
+        Vector<MPI_Status> stats(recv_reqs.size());
+        MPI_Waitall(recv_reqs.size(), recv_reqs.data(), stats.data());
+    }
+
+    // Unpack in the order the data was packed
+    {
+        std::map<int,Long> unpacked;
+        for (int i = 0; i < nmfs; i++) {
+            if (fbs[i] == nullptr) continue;
+            const int sc = scomp[i];
+            const int nc = ncomp[i];
+            for (const auto& kv : *(fbs[i]->m_RcvTags)) {
+                Long& pos = unpacked[kv.first];
+                for (const auto& tag : kv.second) {
+                    const Array4<Real> dst = mfs[i]->array(tag.dstIndex);
+                    const Real* buf = recv_ptr[kv.first] + pos;
+                    const Box& bx  = tag.dbox;
+                    const Dim3 lo  = lbound(bx);
+                    const Dim3 len = length(bx);
+                    const Long npts = bx.numPts();
+                    ParallelFor(bx, nc, [=] AMREX_GPU_DEVICE (int ii, int jj, int kk, int n) noexcept
+                    {
+                        Long idx = (static_cast<Long>(kk-lo.z)*len.y + (jj-lo.y))*len.x + (ii-lo.x);
+                        dst(ii,jj,kk,n+sc) = buf[idx + n*npts];
+                    });
+                    pos += npts * nc;
+                }
+            }
+        }
+    }
+
+    if (!send_reqs.empty()) {
+        Vector<MPI_Status> stats(send_reqs.size());
+        MPI_Waitall(send_reqs.size(), send_reqs.data(), stats.data());
+    }
+
+    // The receive buffer is read by the unpacking kernels
+    Gpu::streamSynchronize();
+    if (send_data) The_Comms_Arena()->free(send_data);
+    if (recv_data) The_Comms_Arena()->free(recv_data);
+#endif
+}
@@ -133,7 +133,21 @@ wrfbdy_compute_interior_ghost_RHS(const Real& bdy_time_interval,
     AMREX_ALWAYS_ASSERT( alpha >= 0. && alpha <= 1.0);
     amrex::Real oma   = 1.0 - alpha;
 
-    // Temporary FABs for storage (owned/filled on all ranks)
+    // A rank only holds the boundary data on the faces its grids are near (see WRFBdyProvider),
+    //    so the halo boxes of the other faces are left empty
+    const bool has_xlo = bdy_data_xlo[n_time][WRFBdyVars::U].isAllocated();
+    const bool has_xhi = bdy_data_xhi[n_time][WRFBdyVars::U].isAllocated();
+    const bool has_ylo = bdy_data_ylo[n_time][WRFBdyVars::U].isAllocated();
+    const bool has_yhi = bdy_data_yhi[n_time][WRFBdyVars::U].isAllocated();
+    auto drop_missing_faces = [=] (Box& bx_xlo, Box& bx_xhi, Box& bx_ylo, Box& bx_yhi)
+    {
+        if (!has_xlo) bx_xlo = Box();
+        if (!has_xhi) bx_xhi = Box();
+        if (!has_ylo) bx_ylo = Box();
+        if (!has_yhi) bx_yhi = Box();
+    };
+
+    // Temporary FABs for storage (owned on all ranks, filled where the data is held)
     FArrayBox U_xlo, U_xhi, U_ylo, U_yhi;
     FArrayBox V_xlo, V_xhi, V_ylo, V_yhi;
     FArrayBox R_xlo, R_xhi, R_ylo, R_yhi;
@@ -218,6 +232,7 @@ wrfbdy_compute_interior_ghost_RHS(const Real& bdy_time_interval,
                                       bx_xlo, bx_xhi,
                                       bx_ylo, bx_yhi,
                                       ng_vect, true);
+        drop_missing_faces(bx_xlo, bx_xhi, bx_ylo, bx_yhi);
 
         Array4<Real> arr_xlo;  Array4<Real> arr_xhi;
         Array4<Real> arr_ylo;  Array4<Real> arr_yhi;
@@ -307,6 +322,7 @@ wrfbdy_compute_interior_ghost_RHS(const Real& bdy_time_interval,
                                       bx_xlo, bx_xhi,
                                       bx_ylo, bx_yhi,
                                       ng_vect, true);
+        drop_missing_faces(bx_xlo, bx_xhi, bx_ylo, bx_yhi);
 
         Array4<Real> rarr_xlo = R_xlo.array();  Array4<Real> rarr_xhi = R_xhi.array();
         Array4<Real> rarr_ylo = R_ylo.array();  Array4<Real> rarr_yhi = R_yhi.array();
@@ -17,12 +17,14 @@ using namespace amrex;
  * @param[in] xmom_in x-component of momentum
  * @param[in] ymom_in y-component of momentum
  * @param[in] zmom_in z-component of momentum
+ * @param[in] ngrow number of ghost cells of the tiles on whose faces the velocity is computed
  */
 
 void
 MomentumToVelocity(MultiFab& xvel, MultiFab& yvel, MultiFab& zvel,
                    const MultiFab& density,
-                   const MultiFab& xmom_in, const MultiFab& ymom_in, const MultiFab& zmom_in)
+                   const MultiFab& xmom_in, const MultiFab& ymom_in, const MultiFab& zmom_in,
+                   const IntVect& ngrow)
 {
     BL_PROFILE_VAR("MomentumToVelocity()",MomentumToVelocity);
 
@@ -32,7 +34,7 @@ MomentumToVelocity(MultiFab& xvel, MultiFab& yvel, MultiFab& zvel,
     for ( MFIter mfi(density,TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
         // We need velocity in the interior ghost cells (init == real)
-        Box bx = mfi.tilebox();
+        Box bx = mfi.growntilebox(ngrow);
 
         const Box& tbx = surroundingNodes(bx,0);
         const Box& tby = surroundingNodes(bx,1);
@@ -89,15 +89,18 @@ int main(int argc, char* argv[])
         amrex::Array<int,AMREX_SPACEDIM> is_per = {1,1,1};
         amrex::Vector<amrex::IntVect> ref_rat = {amrex::IntVect(1,1,1)};
 
-        // Parse max steps for the block
+        // Parse the number of blocks and max steps for the blocks
+        int num_blocks{2};
         {
             ParmParse pp;
             pp.query("max_step", max_step);
+            pp.query("num_blocks", num_blocks);
         }
 
-        // Parse data for erf1 constructor
-        {
-            ParmParse pp("erf1");
+        // Parse data for the erf1, erf2, ... constructors
+        for (int b = 0; b < num_blocks; ++b) {
+            const std::string prefix = "erf" + std::to_string(b+1);
+            ParmParse pp(prefix);
             amrex::Vector<amrex::Real> lo  = {0.,0.,0.};
             amrex::Vector<amrex::Real> hi  = {0.,0.,0.};
             amrex::Vector<int> periodicity = {1,1,1};
@@ -120,36 +123,7 @@ int main(int argc, char* argv[])
             n_cell_v.push_back(n_cell);
             is_per_v.push_back(is_per);
             ref_rat_v.push_back(ref_rat);
-            prefix_v.push_back("erf1");
-        }
-
-        // Parse data for erf2 constructor
-        {
-            ParmParse pp("erf2");
-            amrex::Vector<amrex::Real> lo  = {0.,0.,0.};
-            amrex::Vector<amrex::Real> hi  = {0.,0.,0.};
-            amrex::Vector<int> periodicity = {1,1,1};
-            pp.queryarr("prob_lo",lo);
-            pp.queryarr("prob_hi",hi);
-            rb.setLo(lo);
-            rb.setHi(hi);
-            pp.query("max_level",max_level);
-            pp.query("coord",coord);
-            pp.queryarr("n_cell",n_cell);
-            pp.queryarr("is_periodic",periodicity);
-            {
-                for( int i(0); i<AMREX_SPACEDIM; i++ ) is_per[i] = periodicity[i];
-            }
-            pp.queryarr("ref_ratio",ref_rat);
-
-            rb_v.push_back(rb);
-            max_level_v.push_back(max_level);
-            coord_v.push_back(coord);
-            n_cell_v.push_back(n_cell);
-            is_per_v.push_back(is_per);
-            ref_rat_v.push_back(ref_rat);
-            prefix_v.push_back("erf2");
-
+            prefix_v.push_back(prefix);
         }
 
         // Construct a MultiBlockContainer